@@ -1,5 +1,6 @@
 #include <EditorPluginAssetsPCH.h>
 
+#include <Core/Collection/CollectionUtils.h>
 #include <EditorFramework/Assets/AssetCurator.h>
 #include <EditorFramework/EditorApp/EditorApp.moc.h>
 #include <EditorPluginAssets/CollectionAsset/CollectionAsset.h>
@@ -67,6 +68,36 @@ ezStatus ezCollectionAssetDocument::InternalTransformAsset(ezStreamWriter& strea
     desc.m_Resources.PushBack(entry);
   }
 
+  // store what each asset references, so that loading one of these resources queues everything it needs right away
+  ezCollectionUtils::AddResourceDependencies(desc, [](const char* szResourceID, ezDynamicArray<ezCollectionUtils::Dependency>& out_Dependencies) {
+    ezHybridArray<ezString, 16> references;
+
+    {
+      ezAssetCurator::ezLockedSubAsset pInfo = ezAssetCurator::GetSingleton()->FindSubAsset(szResourceID);
+
+      if (pInfo == nullptr)
+        return;
+
+      for (const ezString& ref : pInfo->m_pAssetInfo->m_Info->m_RuntimeDependencies)
+      {
+        references.PushBack(ref);
+      }
+    }
+
+    for (const ezString& ref : references)
+    {
+      // references to plain files are not loaded as resources of an asset type
+      ezAssetCurator::ezLockedSubAsset pInfo = ezAssetCurator::GetSingleton()->FindSubAsset(ref);
+
+      if (pInfo == nullptr)
+        continue;
+
+      auto& dependency = out_Dependencies.ExpandAndGetRef();
+      dependency.m_sAssetTypeName = pInfo->m_Data.m_sSubAssetsDocumentTypeName.GetString();
+      dependency.m_sResourceID = ref;
+    }
+  });
+
   desc.Save(stream);
 
   return ezStatus(EZ_SUCCESS);
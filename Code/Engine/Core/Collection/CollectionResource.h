@@ -10,6 +10,7 @@ struct EZ_CORE_DLL ezCollectionEntry
   ezString m_sResourceID; ///< The ID / path to the resource to load.
   ezHashedString m_sAssetTypeName;
   ezUInt64 m_uiFileSize = 0;
+  ezHybridArray<ezUInt32, 4> m_Dependencies; ///< Indices of the entries that this resource needs, see ezResourceManager::RegisterResourceDependency().
 };
 
 /// \brief Describes a full ezCollectionResource, ie. lists all the resources that the collection contains
@@ -85,6 +86,8 @@ private:
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
+  void RegisterDependencies();
+
   mutable ezMutex m_preloadMutex;
   bool m_bRegistered = false;
   ezCollectionResourceDescriptor m_Collection;
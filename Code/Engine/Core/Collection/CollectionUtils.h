@@ -27,4 +27,26 @@ namespace ezCollectionUtils
   EZ_CORE_DLL void AddResourceHandle(
     ezCollectionResourceDescriptor& collection, ezTypelessResourceHandle handle, const char* szAssetTypeName, const char* szAbsFolderpath);
 
+  /// \brief Adds the dependencies that the ezResourceManager knows about for the resources in \a collection, and their dependencies in turn.
+  ///
+  /// Missing dependencies are added as new entries and all edges are stored in ezCollectionEntry::m_Dependencies, so that loading the
+  /// collection makes the dependency graph available again, see ezResourceManager::SetRecordResourceDependencies().
+  /// Dependencies whose resource type was not registered for any asset type are skipped.
+  EZ_CORE_DLL void AddResourceDependencies(ezCollectionResourceDescriptor& collection);
+
+  /// \brief A resource that another resource needs, identified the same way as a collection entry.
+  struct Dependency
+  {
+    ezString m_sAssetTypeName;
+    ezString m_sResourceID;
+  };
+
+  /// \brief Returns the direct dependencies of the resource \a szResourceID.
+  using GetDependenciesCallback = ezDelegate<void(const char* szResourceID, ezDynamicArray<Dependency>& out_Dependencies)>;
+
+  /// \brief Same as AddResourceDependencies() above, but the dependencies are queried from \a getDependencies.
+  ///
+  /// This is used by the collection asset transform, which knows the references of each asset, but does not load any resources.
+  EZ_CORE_DLL void AddResourceDependencies(ezCollectionResourceDescriptor& collection, GetDependenciesCallback getDependencies);
+
 };
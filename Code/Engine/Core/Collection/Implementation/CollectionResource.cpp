@@ -118,6 +118,7 @@ const ezCollectionResourceDescriptor& ezCollectionResource::GetDescriptor() cons
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezCollectionResource, ezCollectionResourceDescriptor)
 {
   m_Collection = descriptor;
+  RegisterDependencies();
 
   ezResourceLoadDesc res;
   res.m_uiQualityLevelsDiscardable = 0;
@@ -173,6 +174,7 @@ ezResourceLoadDesc ezCollectionResource::UpdateContent(ezStreamReader* Stream)
   AssetHash.Read(*Stream);
 
   m_Collection.Load(*Stream);
+  RegisterDependencies();
 
   res.m_State = ezResourceState::Loaded;
   return res;
@@ -186,6 +188,25 @@ void ezCollectionResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
     static_cast<ezUInt32>(m_hPreloadedResources.GetHeapMemoryUsage() + m_Collection.m_Resources.GetHeapMemoryUsage());
 }
 
+void ezCollectionResource::RegisterDependencies()
+{
+  for (const auto& entry : m_Collection.m_Resources)
+  {
+    for (ezUInt32 uiDependency : entry.m_Dependencies)
+    {
+      if (uiDependency >= m_Collection.m_Resources.GetCount())
+        continue;
+
+      const ezCollectionEntry& dependency = m_Collection.m_Resources[uiDependency];
+
+      if (const ezRTTI* pRtti = ezResourceManager::FindResourceForAssetType(dependency.m_sAssetTypeName))
+      {
+        ezResourceManager::RegisterResourceDependency(entry.m_sResourceID, pRtti, dependency.m_sResourceID);
+      }
+    }
+  }
+}
+
 
 void ezCollectionResource::RegisterNames()
 {
@@ -226,7 +247,7 @@ void ezCollectionResource::UnregisterNames()
 
 void ezCollectionResourceDescriptor::Save(ezStreamWriter& stream) const
 {
-  const ezUInt8 uiVersion = 3;
+  const ezUInt8 uiVersion = 4;
   const ezUInt8 uiIdentifier = 0xC0;
   const ezUInt32 uiNumResources = m_Resources.GetCount();
 
@@ -240,6 +261,7 @@ void ezCollectionResourceDescriptor::Save(ezStreamWriter& stream) const
     stream << m_Resources[i].m_sOptionalNiceLookupName;
     stream << m_Resources[i].m_sResourceID;
     stream << m_Resources[i].m_uiFileSize;
+    stream.WriteArray(m_Resources[i].m_Dependencies);
   }
 }
 
@@ -264,7 +286,7 @@ void ezCollectionResourceDescriptor::Load(ezStreamReader& stream)
   }
 
   EZ_ASSERT_DEV(uiIdentifier == 0xC0, "File does not contain a valid ezCollectionResourceDescriptor");
-  EZ_ASSERT_DEV(uiVersion > 0 && uiVersion <= 3, "Invalid file version {0}", uiVersion);
+  EZ_ASSERT_DEV(uiVersion > 0 && uiVersion <= 4, "Invalid file version {0}", uiVersion);
 
   m_Resources.SetCount(uiNumResources);
 
@@ -277,6 +299,10 @@ void ezCollectionResourceDescriptor::Load(ezStreamReader& stream)
     {
       stream >> m_Resources[i].m_uiFileSize;
     }
+    if (uiVersion >= 4)
+    {
+      stream.ReadArray(m_Resources[i].m_Dependencies);
+    }
   }
 }
 
@@ -47,16 +47,41 @@ void ezCollectionUtils::AddFiles(ezCollectionResourceDescriptor& collection, con
 EZ_CORE_DLL void ezCollectionUtils::MergeCollections(
   ezCollectionResourceDescriptor& result, ezArrayPtr<const ezCollectionResourceDescriptor*> inputCollections)
 {
-  ezMap<ezString, const ezCollectionEntry*> firstEntryOfID;
+  ezMap<ezString, ezUInt32> resultIndexOfID;
 
   for (const ezCollectionResourceDescriptor* inputDesc : inputCollections)
   {
     for (const ezCollectionEntry& inputEntry : inputDesc->m_Resources)
     {
-      if (!firstEntryOfID.Contains(inputEntry.m_sResourceID))
+      if (!resultIndexOfID.Contains(inputEntry.m_sResourceID))
       {
-        firstEntryOfID.Insert(inputEntry.m_sResourceID, &inputEntry);
-        result.m_Resources.PushBack(inputEntry);
+        resultIndexOfID.Insert(inputEntry.m_sResourceID, result.m_Resources.GetCount());
+
+        ezCollectionEntry& entry = result.m_Resources.ExpandAndGetRef();
+        entry = inputEntry;
+        entry.m_Dependencies.Clear();
+      }
+    }
+  }
+
+  // dependency indices refer to the input collections, remap them once all entries are known
+  for (const ezCollectionResourceDescriptor* inputDesc : inputCollections)
+  {
+    for (const ezCollectionEntry& inputEntry : inputDesc->m_Resources)
+    {
+      ezCollectionEntry& entry = result.m_Resources[resultIndexOfID[inputEntry.m_sResourceID]];
+
+      for (ezUInt32 uiDependency : inputEntry.m_Dependencies)
+      {
+        if (uiDependency >= inputDesc->m_Resources.GetCount())
+          continue;
+
+        const ezUInt32 uiResultIndex = resultIndexOfID[inputDesc->m_Resources[uiDependency].m_sResourceID];
+
+        if (!entry.m_Dependencies.Contains(uiResultIndex))
+        {
+          entry.m_Dependencies.PushBack(uiResultIndex);
+        }
       }
     }
   }
@@ -103,4 +128,68 @@ void ezCollectionUtils::AddResourceHandle(
   }
 }
 
+void ezCollectionUtils::AddResourceDependencies(ezCollectionResourceDescriptor& collection)
+{
+  ezDynamicArray<ezResourceManager::ResourceDependency> dependencies;
+
+  AddResourceDependencies(collection, [&dependencies](const char* szResourceID, ezDynamicArray<Dependency>& out_Dependencies) {
+    ezResourceManager::GetResourceDependencies(szResourceID, dependencies);
+
+    for (const auto& dependency : dependencies)
+    {
+      const char* szAssetTypeName = ezResourceManager::FindAssetTypeForResource(dependency.m_pResourceType);
+      if (szAssetTypeName == nullptr)
+      {
+        ezLog::Warning("No asset type is registered for resource type '{}'. Dependency '{}' of '{}' is not added to the collection.",
+          dependency.m_pResourceType->GetTypeName(), dependency.m_sResourceID, szResourceID);
+        continue;
+      }
+
+      auto& result = out_Dependencies.ExpandAndGetRef();
+      result.m_sAssetTypeName = szAssetTypeName;
+      result.m_sResourceID = dependency.m_sResourceID;
+    }
+  });
+}
+
+void ezCollectionUtils::AddResourceDependencies(ezCollectionResourceDescriptor& collection, GetDependenciesCallback getDependencies)
+{
+  ezMap<ezString, ezUInt32> indexOfID;
+
+  for (ezUInt32 i = 0; i < collection.m_Resources.GetCount(); ++i)
+  {
+    indexOfID.Insert(collection.m_Resources[i].m_sResourceID, i);
+  }
+
+  ezDynamicArray<Dependency> dependencies;
+
+  // entries that get added are visited as well, which adds the dependencies of the dependencies
+  for (ezUInt32 i = 0; i < collection.m_Resources.GetCount(); ++i)
+  {
+    dependencies.Clear();
+    getDependencies(collection.m_Resources[i].m_sResourceID, dependencies);
+
+    for (const auto& dependency : dependencies)
+    {
+      bool bExisted = false;
+      auto it = indexOfID.FindOrAdd(dependency.m_sResourceID, &bExisted);
+
+      if (!bExisted)
+      {
+        it.Value() = collection.m_Resources.GetCount();
+
+        auto& entry = collection.m_Resources.ExpandAndGetRef();
+        entry.m_sAssetTypeName.Assign(dependency.m_sAssetTypeName.GetData());
+        entry.m_sResourceID = dependency.m_sResourceID;
+      }
+
+      ezCollectionEntry& entry = collection.m_Resources[i];
+      if (it.Value() != i && !entry.m_Dependencies.Contains(it.Value()))
+      {
+        entry.m_Dependencies.PushBack(it.Value());
+      }
+    }
+  }
+}
+
 EZ_STATICLINK_FILE(Core, Core_Collection_Implementation_CollectionUtils);
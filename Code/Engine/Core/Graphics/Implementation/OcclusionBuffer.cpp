@@ -0,0 +1,267 @@
+#include <CorePCH.h>
+
+#include <Core/Graphics/OcclusionBuffer.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  // Triangles that reach this far outside of the screen are skipped, the edge functions would lose too much precision otherwise.
+  constexpr float s_fMaxScreenCoordinate = 1024.0f * 1024.0f;
+} // namespace
+
+ezOcclusionBuffer::ezOcclusionBuffer()
+{
+  SetResolution(256, 128);
+}
+
+ezOcclusionBuffer::~ezOcclusionBuffer() = default;
+
+void ezOcclusionBuffer::SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight)
+{
+  uiWidth = ezMath::Max((uiWidth + 3) & ~3u, 4u);
+  uiHeight = ezMath::Max(uiHeight, 1u);
+
+  m_Levels.Clear();
+
+  while (true)
+  {
+    Level& level = m_Levels.ExpandAndGetRef();
+    level.m_uiWidth = uiWidth;
+    level.m_uiHeight = uiHeight;
+    level.m_Depth.SetCount(uiWidth * uiHeight, ezMath::MaxValue<float>());
+
+    if (uiWidth == 1 && uiHeight == 1)
+      break;
+
+    uiWidth = (uiWidth + 1) / 2;
+    uiHeight = (uiHeight + 1) / 2;
+  }
+}
+
+void ezOcclusionBuffer::Clear(const ezMat4& viewProjection, ezClipSpaceDepthRange::Enum depthRange /*= ezClipSpaceDepthRange::Default*/)
+{
+  m_ViewProjection = ezSimdConversion::ToMat4(viewProjection);
+  m_DepthRange = depthRange;
+  m_uiNumRasterizedTriangles = 0;
+
+  for (float& fDepth : m_Levels[0].m_Depth)
+  {
+    fDepth = ezMath::MaxValue<float>();
+  }
+}
+
+bool ezOcclusionBuffer::Project(const ezSimdVec4f& vPosition, ezVec3& out_vScreenPos) const
+{
+  const ezVec4 clipPos = ezSimdConversion::ToVec4(m_ViewProjection.TransformPosition(vPosition));
+
+  const float fNearZ = m_DepthRange == ezClipSpaceDepthRange::ZeroToOne ? 0.0f : -clipPos.w;
+  if (clipPos.w <= ezMath::SmallEpsilon<float>() || clipPos.z < fNearZ)
+    return false;
+
+  const float fInvW = 1.0f / clipPos.w;
+  out_vScreenPos.x = (clipPos.x * fInvW * 0.5f + 0.5f) * m_Levels[0].m_uiWidth;
+  out_vScreenPos.y = (0.5f - clipPos.y * fInvW * 0.5f) * m_Levels[0].m_uiHeight;
+  out_vScreenPos.z = clipPos.z * fInvW;
+  return true;
+}
+
+void ezOcclusionBuffer::RasterizeTriangle(const ezVec3& a, const ezVec3& b, const ezVec3& c)
+{
+  ezVec3 v[3];
+  if (!Project(ezSimdConversion::ToVec3(a), v[0]) || !Project(ezSimdConversion::ToVec3(b), v[1]) || !Project(ezSimdConversion::ToVec3(c), v[2]))
+    return;
+
+  float fArea = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+  if (ezMath::Abs(fArea) < ezMath::SmallEpsilon<float>())
+    return;
+
+  // flip back facing triangles, so that all edge functions are positive inside of the triangle
+  if (fArea < 0.0f)
+  {
+    ezMath::Swap(v[1], v[2]);
+    fArea = -fArea;
+  }
+
+  const float fWidth = (float)m_Levels[0].m_uiWidth;
+  const float fHeight = (float)m_Levels[0].m_uiHeight;
+
+  const float fMinX = ezMath::Min(v[0].x, v[1].x, v[2].x);
+  const float fMaxX = ezMath::Max(v[0].x, v[1].x, v[2].x);
+  const float fMinY = ezMath::Min(v[0].y, v[1].y, v[2].y);
+  const float fMaxY = ezMath::Max(v[0].y, v[1].y, v[2].y);
+
+  if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= fWidth || fMinY >= fHeight)
+    return;
+
+  if (ezMath::Max(-fMinX, -fMinY, fMaxX, fMaxY) > s_fMaxScreenCoordinate)
+    return;
+
+  // only whole blocks of four pixels are processed, the width of the buffer is a multiple of four
+  const ezInt32 iMinX = ezMath::Max((ezInt32)ezMath::Floor(fMinX), 0) & ~3;
+  const ezInt32 iMaxX = ezMath::Min((ezInt32)ezMath::Floor(fMaxX), (ezInt32)m_Levels[0].m_uiWidth - 1);
+  const ezInt32 iMinY = ezMath::Max((ezInt32)ezMath::Floor(fMinY), 0);
+  const ezInt32 iMaxY = ezMath::Min((ezInt32)ezMath::Floor(fMaxY), (ezInt32)m_Levels[0].m_uiHeight - 1);
+
+  // Edge i goes from vertex i to vertex i + 1 and is evaluated as A * x + B * y + C. It is zero for the opposite vertex' barycentric coordinate,
+  // so the depth can be interpolated from the edge functions as well.
+  float fA[3], fB[3], fC[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezVec3& p = v[i];
+    const ezVec3& q = v[(i + 1) % 3];
+    fA[i] = p.y - q.y;
+    fB[i] = q.x - p.x;
+    fC[i] = -fA[i] * p.x - fB[i] * p.y;
+  }
+
+  // edge 1 is opposite of vertex 0, edge 2 opposite of vertex 1 and edge 0 opposite of vertex 2
+  const float fInvArea = 1.0f / fArea;
+  const float fDepthA = (fA[1] * v[0].z + fA[2] * v[1].z + fA[0] * v[2].z) * fInvArea;
+  const float fDepthB = (fB[1] * v[0].z + fB[2] * v[1].z + fB[0] * v[2].z) * fInvArea;
+  const float fDepthC = (fC[1] * v[0].z + fC[2] * v[1].z + fC[0] * v[2].z) * fInvArea;
+
+  const ezSimdVec4f vPixelOffsets(0.5f, 1.5f, 2.5f, 3.5f);
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+
+  ezSimdVec4f vEdgeStepX[3];
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    vEdgeStepX[i] = ezSimdVec4f(fA[i] * 4.0f);
+  }
+
+  const ezSimdVec4f vDepthStepX(fDepthA * 4.0f);
+
+  for (ezInt32 y = iMinY; y <= iMaxY; ++y)
+  {
+    const float fCenterY = y + 0.5f;
+    const ezSimdVec4f vX = vPixelOffsets + ezSimdVec4f((float)iMinX);
+
+    ezSimdVec4f vEdge[3];
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      vEdge[i] = ezSimdVec4f::MulAdd(vX, ezSimdVec4f(fA[i]), ezSimdVec4f(fB[i] * fCenterY + fC[i]));
+    }
+
+    ezSimdVec4f vDepth = ezSimdVec4f::MulAdd(vX, ezSimdVec4f(fDepthA), ezSimdVec4f(fDepthB * fCenterY + fDepthC));
+
+    float* pRow = m_Levels[0].m_Depth.GetData() + y * m_Levels[0].m_uiWidth;
+
+    for (ezInt32 x = iMinX; x <= iMaxX; x += 4)
+    {
+      const ezSimdVec4b vInside = (vEdge[0] >= vZero) && (vEdge[1] >= vZero) && (vEdge[2] >= vZero);
+
+      if (vInside.AnySet())
+      {
+        ezSimdVec4f vOldDepth;
+        vOldDepth.Load<4>(pRow + x);
+
+        ezSimdVec4f::Select(vInside, vOldDepth.CompMin(vDepth), vOldDepth).Store<4>(pRow + x);
+      }
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        vEdge[i] += vEdgeStepX[i];
+      }
+
+      vDepth += vDepthStepX;
+    }
+  }
+
+  ++m_uiNumRasterizedTriangles;
+}
+
+void ezOcclusionBuffer::RasterizeGeometry(const ezWorldGeoExtractionUtil::Geometry& geo)
+{
+  for (const auto& triangle : geo.m_Triangles)
+  {
+    RasterizeTriangle(geo.m_Vertices[triangle.m_uiVertexIndices[0]].m_vPosition, geo.m_Vertices[triangle.m_uiVertexIndices[1]].m_vPosition,
+      geo.m_Vertices[triangle.m_uiVertexIndices[2]].m_vPosition);
+  }
+}
+
+void ezOcclusionBuffer::BuildHierarchy()
+{
+  for (ezUInt32 uiLevel = 1; uiLevel < m_Levels.GetCount(); ++uiLevel)
+  {
+    const Level& src = m_Levels[uiLevel - 1];
+    Level& dst = m_Levels[uiLevel];
+
+    for (ezUInt32 y = 0; y < dst.m_uiHeight; ++y)
+    {
+      const float* pRow0 = src.m_Depth.GetData() + (y * 2) * src.m_uiWidth;
+      const float* pRow1 = src.m_Depth.GetData() + ezMath::Min(y * 2 + 1, src.m_uiHeight - 1) * src.m_uiWidth;
+
+      for (ezUInt32 x = 0; x < dst.m_uiWidth; ++x)
+      {
+        const ezUInt32 x0 = x * 2;
+        const ezUInt32 x1 = ezMath::Min(x0 + 1, src.m_uiWidth - 1);
+
+        dst.m_Depth[y * dst.m_uiWidth + x] = ezMath::Max(ezMath::Max(pRow0[x0], pRow0[x1]), ezMath::Max(pRow1[x0], pRow1[x1]));
+      }
+    }
+  }
+}
+
+bool ezOcclusionBuffer::IsOccluded(const ezBoundingBox& box) const
+{
+  ezVec3 corners[8];
+  box.GetCorners(corners);
+
+  ezVec3 vMin = ezVec3(ezMath::MaxValue<float>());
+  ezVec3 vMax = ezVec3(-ezMath::MaxValue<float>());
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    ezVec3 screenPos;
+    if (!Project(ezSimdConversion::ToVec3(corners[i]), screenPos))
+      return false;
+
+    vMin = vMin.CompMin(screenPos);
+    vMax = vMax.CompMax(screenPos);
+  }
+
+  const Level& level0 = m_Levels[0];
+
+  if (vMax.x < 0.0f || vMax.y < 0.0f || vMin.x >= level0.m_uiWidth || vMin.y >= level0.m_uiHeight)
+    return false;
+
+  const ezUInt32 uiMinX = (ezUInt32)ezMath::Max((ezInt32)ezMath::Floor(vMin.x), 0);
+  const ezUInt32 uiMaxX = (ezUInt32)ezMath::Min((ezInt32)ezMath::Floor(vMax.x), (ezInt32)level0.m_uiWidth - 1);
+  const ezUInt32 uiMinY = (ezUInt32)ezMath::Max((ezInt32)ezMath::Floor(vMin.y), 0);
+  const ezUInt32 uiMaxY = (ezUInt32)ezMath::Min((ezInt32)ezMath::Floor(vMax.y), (ezInt32)level0.m_uiHeight - 1);
+
+  // pick the level at which the box covers at most 3x3 texels
+  const ezUInt32 uiExtent = ezMath::Max(uiMaxX - uiMinX, uiMaxY - uiMinY);
+
+  ezUInt32 uiLevel = 0;
+  while ((uiExtent >> uiLevel) > 1 && uiLevel + 1 < m_Levels.GetCount())
+  {
+    ++uiLevel;
+  }
+
+  const Level& level = m_Levels[uiLevel];
+
+  for (ezUInt32 y = uiMinY >> uiLevel; y <= (uiMaxY >> uiLevel); ++y)
+  {
+    for (ezUInt32 x = uiMinX >> uiLevel; x <= (uiMaxX >> uiLevel); ++x)
+    {
+      if (level.m_Depth[y * level.m_uiWidth + x] >= vMin.z)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+ezArrayPtr<const float> ezOcclusionBuffer::GetDepthValues(ezUInt32 uiLevel, ezUInt32& out_uiWidth, ezUInt32& out_uiHeight) const
+{
+  const Level& level = m_Levels[uiLevel];
+  out_uiWidth = level.m_uiWidth;
+  out_uiHeight = level.m_uiHeight;
+
+  return level.m_Depth;
+}
+
+
+
+EZ_STATICLINK_FILE(Core, Core_Graphics_Implementation_OcclusionBuffer);
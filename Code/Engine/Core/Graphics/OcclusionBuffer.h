@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Core/Utils/WorldGeoExtractionUtil.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+
+/// \brief A low resolution software depth buffer that is used to cull objects that are hidden behind occluders.
+///
+/// Occluder triangles are rasterized on the CPU into a small depth buffer, four pixels at a time. BuildHierarchy() then computes
+/// a mip chain that stores the farthest depth of every texel, so that IsOccluded() only needs to look at a handful of texels per
+/// bounding box, independent of its size on screen.
+///
+/// The depth buffer stores z/w, so it works with perspective and orthographic projections and both clip space depth ranges.
+/// The buffer is conservative where it matters: triangles that cross the near plane are not rasterized and boxes that cross it are
+/// never occluded.
+class EZ_CORE_DLL ezOcclusionBuffer
+{
+public:
+  ezOcclusionBuffer();
+  ~ezOcclusionBuffer();
+
+  /// \brief Sets the resolution of the depth buffer. The width is rounded up to a multiple of four.
+  void SetResolution(ezUInt32 uiWidth, ezUInt32 uiHeight);
+
+  ezUInt32 GetWidth() const { return m_Levels[0].m_uiWidth; }
+  ezUInt32 GetHeight() const { return m_Levels[0].m_uiHeight; }
+
+  /// \brief Resets all depth values to the far plane and sets the matrix that projects occluders and bounding boxes into the buffer.
+  void Clear(const ezMat4& viewProjection, ezClipSpaceDepthRange::Enum depthRange = ezClipSpaceDepthRange::Default);
+
+  /// \brief Rasterizes a single triangle given in world space. Both windings are rasterized.
+  void RasterizeTriangle(const ezVec3& a, const ezVec3& b, const ezVec3& c);
+
+  /// \brief Rasterizes all triangles of the given geometry, e.g. as extracted with ezWorldGeoExtractionUtil::ExtractionMode::OcclusionMesh.
+  void RasterizeGeometry(const ezWorldGeoExtractionUtil::Geometry& geo);
+
+  /// \brief Builds the hierarchical depth buffer. Has to be called after all occluders have been rasterized and before IsOccluded().
+  void BuildHierarchy();
+
+  /// \brief Returns true if the given world space box is completely hidden behind the rasterized occluders.
+  bool IsOccluded(const ezBoundingBox& box) const;
+
+  /// \brief Returns the number of triangles that have been rasterized since the last Clear().
+  ezUInt32 GetNumRasterizedTriangles() const { return m_uiNumRasterizedTriangles; }
+
+  ezUInt32 GetNumLevels() const { return m_Levels.GetCount(); }
+
+  /// \brief Returns the depth values of the given hierarchy level, row by row. Level 0 is the full resolution buffer.
+  ezArrayPtr<const float> GetDepthValues(ezUInt32 uiLevel, ezUInt32& out_uiWidth, ezUInt32& out_uiHeight) const;
+
+private:
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezOcclusionBuffer);
+
+  struct Level
+  {
+    ezUInt32 m_uiWidth = 0;
+    ezUInt32 m_uiHeight = 0;
+    ezDynamicArray<float> m_Depth;
+  };
+
+  /// \brief Projects a world space position. Returns false if it is in front of the near plane.
+  bool Project(const ezSimdVec4f& vPosition, ezVec3& out_vScreenPos) const;
+
+  ezHybridArray<Level, 16> m_Levels;
+
+  ezSimdMat4f m_ViewProjection;
+  ezClipSpaceDepthRange::Enum m_DepthRange = ezClipSpaceDepthRange::Default;
+  ezUInt32 m_uiNumRasterizedTriangles = 0;
+};
@@ -9,6 +9,7 @@
 
 class ezResource;
 class ezResourceManager;
+class ezRTTI;
 class ezResourceTypeLoader;
 class ezStreamReader;
 
@@ -44,9 +45,22 @@ struct ezResourceManagerEvent
   {
     ManagerShuttingDown,      ///< Sent first thing by ezResourceManager::OnEngineShutdown().
     ReloadAllResources,       ///< Sent by ezResourceManager::ReloadAllResources() if any resource got unloaded (not yet reloaded)
+    MemoryBudgetExceeded,     ///< Sent by ezResourceManager::PerFrameUpdate() when a memory budget got exceeded or resources were unloaded
+                              ///< because of it, after the least recently acquired resources have been unloaded. See ezResourceManager::SetMemoryBudget().
   };
 
   Type m_Type;
+
+  // The following members are only set for MemoryBudgetExceeded
+
+  const ezRTTI* m_pResourceType = nullptr; ///< The resource type whose budget was exceeded, nullptr for the global budget.
+  ezUInt64 m_uiBudgetCPU = 0;
+  ezUInt64 m_uiBudgetGPU = 0;
+  ezUInt64 m_uiMemoryCPU = 0;              ///< The memory usage before any resources were unloaded.
+  ezUInt64 m_uiMemoryGPU = 0;
+  ezUInt64 m_uiFreedMemoryCPU = 0;         ///< How much memory was freed by unloading resources. This may not suffice to get back into the budget.
+  ezUInt64 m_uiFreedMemoryGPU = 0;
+  ezUInt32 m_uiNumUnloadedResources = 0;   ///< How many resources were unloaded or reduced to a lower quality level.
 };
 
 /// \brief The flags of an ezResource instance.
@@ -236,6 +236,16 @@ void ezResource::SetPriority(ezResourcePriority priority)
 
   m_Priority = priority;
 
+  {
+    EZ_LOCK(ezResourceManager::GetMutex());
+
+    // move the resource to its new place in the loading queue right away
+    if (m_uiLoadingQueueIndex != ezInvalidIndex)
+    {
+      ezResourceManager::UpdateLoadingQueuePriority(this, GetLoadingPriority(ezResourceManager::GetLastFrameUpdate()));
+    }
+  }
+
   ezResourceEvent e;
   e.m_pResource = this;
   e.m_Type = ezResourceEvent::Type::ResourcePriorityChanged;
@@ -6,6 +6,12 @@
 
 ezTypelessResourceHandle ezResourceManager::LoadResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
+  RecordResourceDependency(pResourceType, szResourceID);
+
+  ezTypelessResourceHandle hResource;
+  if (TryGetResourceFromLookup(pResourceType, szResourceID, hResource))
+    return hResource;
+
   // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
   EZ_LOCK(s_ResourceMutex);
   return ezTypelessResourceHandle(GetResource(pResourceType, szResourceID, true));
@@ -50,14 +56,105 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   else
   {
     AddToLoadingQueue(pResource, bHighestPriority);
+    PreloadResourceDependencies(pResource);
+
+    // a data load task that needs this resource right away would otherwise wait for a slot that it occupies itself
+    const bool bIgnoreMaxConcurrentDataLoads = bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess;
+
+    RunWorkerTask(pResource, bIgnoreMaxConcurrentDataLoads);
+  }
+}
+
+void ezResourceManager::RecordResourceDependency(const ezRTTI* pDependencyType, const char* szDependencyID)
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  const ezResource* pResource = ezResource::GetCurrentlyUpdatingContent();
+  if (pResource == nullptr || !s_State->s_bRecordResourceDependencies || ezStringUtils::IsNullOrEmpty(szDependencyID))
+    return;
+
+  RegisterResourceDependency(pResource->GetResourceID(), pDependencyType, szDependencyID);
+#endif
+}
+
+void ezResourceManager::PreloadResourceDependencies(ezResource* pResource)
+{
+  if (s_State->s_ResourceDependencies.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("PreloadResourceDependencies");
+
+  // anything that is already queued or loaded is not visited again, which also stops at cycles
+  ezHybridArray<ezResource*, 32> todo;
+  todo.PushBack(pResource);
 
-    if (bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
+  while (!todo.IsEmpty())
+  {
+    const ezResource* pCurrent = todo.PeekBack();
+    todo.PopBack();
+
+    const ezHybridArray<ResourceDependency, 4>* pDependencies = nullptr;
+    if (!s_State->s_ResourceDependencies.TryGetValue(ezTempHashedString(pCurrent->GetResourceID().GetData()), pDependencies))
+      continue;
+
+    for (const ResourceDependency& dependency : *pDependencies)
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      ezResource* pDependency = GetResource(dependency.m_pResourceType, dependency.m_sResourceID, true);
+
+      if (pDependency == nullptr || IsQueuedForLoading(pDependency) || pDependency->GetLoadingState() == ezResourceState::LoadedResourceMissing)
+        continue;
+
+      if (pDependency->GetLoadingState() == ezResourceState::Loaded && pDependency->GetNumQualityLevelsLoadable() == 0)
+        continue;
+
+      // nobody holds a handle yet, prevent the resource from being freed as unused right away
+      pDependency->m_LastAcquire = s_State->s_LastFrameUpdate;
+
+      AddToLoadingQueue(pDependency, false);
+      todo.PushBack(pDependency);
     }
+  }
+}
 
-    RunWorkerTask(pResource);
+void ezResourceManager::SetRecordResourceDependencies(bool bRecord)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_bRecordResourceDependencies = bRecord;
+}
+
+void ezResourceManager::RegisterResourceDependency(const char* szResourceID, const ezRTTI* pDependencyType, const char* szDependencyID)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  auto& dependencies = s_State->s_ResourceDependencies[ezTempHashedString(szResourceID)];
+
+  for (const ResourceDependency& dependency : dependencies)
+  {
+    if (dependency.m_pResourceType == pDependencyType && dependency.m_sResourceID == szDependencyID)
+      return;
   }
+
+  ResourceDependency& dependency = dependencies.ExpandAndGetRef();
+  dependency.m_pResourceType = pDependencyType;
+  dependency.m_sResourceID = szDependencyID;
+}
+
+void ezResourceManager::GetResourceDependencies(const char* szResourceID, ezDynamicArray<ResourceDependency>& out_Dependencies)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  out_Dependencies.Clear();
+
+  const ezHybridArray<ResourceDependency, 4>* pDependencies = nullptr;
+  if (s_State->s_ResourceDependencies.TryGetValue(ezTempHashedString(szResourceID), pDependencies))
+  {
+    out_Dependencies = *pDependencies;
+  }
+}
+
+void ezResourceManager::ClearResourceDependencies()
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_ResourceDependencies.Clear();
 }
 
 void ezResourceManager::SetupWorkerTasks()
@@ -93,7 +190,7 @@ void ezResourceManager::SetupWorkerTasks()
   }
 }
 
-void ezResourceManager::RunWorkerTask(ezResource* pResource)
+void ezResourceManager::RunWorkerTask(ezResource* pResource, bool bIgnoreMaxConcurrentDataLoads)
 {
   if (s_State->s_bShutdown)
     return;
@@ -102,52 +199,61 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
 
   SetupWorkerTasks();
 
-  if (s_State->s_bAllowLaunchDataLoadTask && !s_State->s_LoadingQueue.IsEmpty())
+  const ezUInt32 uiMaxConcurrentDataLoads = GetMaxConcurrentDataLoads();
+
+  // every data load task takes the next resource from the front of the queue once it runs,
+  // so starting several tasks reads several resources in parallel, without changing the loading order
+  while (!s_State->s_LoadingQueue.IsEmpty() && (bIgnoreMaxConcurrentDataLoads || s_State->s_uiDataLoadTasksRunning < uiMaxConcurrentDataLoads))
   {
-    s_State->s_bAllowLaunchDataLoadTask = false;
+    bIgnoreMaxConcurrentDataLoads = false;
+    ++s_State->s_uiDataLoadTasksRunning;
+
+    if (!s_State->s_bLoadingBurstActive)
+    {
+      s_State->s_bLoadingBurstActive = true;
+      s_State->s_LoadingBurstStart = ezTime::Now();
+    }
+
+    ezResourceManagerState::TaskDataDataLoad* pData = nullptr;
 
     for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
     {
       if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
       {
-        s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask.Borrow(), ezTaskPriority::FileAccess);
-        return;
+        pData = &s_State->s_WorkerTasksDataLoad[i];
+        break;
       }
     }
 
     // could not find any unused task -> need to create a new one
+    if (pData == nullptr)
     {
       ezStringBuilder s;
       s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
-      auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
-      data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
-      data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
-      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask.Borrow(), ezTaskPriority::FileAccess);
+      pData = &s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
+      pData->m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
+      pData->m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
     }
+
+    pData->m_GroupId = ezTaskSystem::StartSingleTask(pData->m_pTask.Borrow(), ezTaskPriority::FileAccess);
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+void ezResourceManager::SetMaxConcurrentDataLoads(ezUInt32 uiMaxConcurrentDataLoads)
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
-  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_uiMaxConcurrentDataLoads = uiMaxConcurrentDataLoads;
 
-  const ezUInt32 uiCount = data.GetCount();
+  // allow more tasks to start right away
+  RunWorkerTask(nullptr);
+}
 
-  for (ezUInt32 i = uiCount; i > 1; --i)
-  {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
+ezUInt32 ezResourceManager::GetMaxConcurrentDataLoads()
+{
+  if (s_State->s_uiMaxConcurrentDataLoads > 0)
+    return s_State->s_uiMaxConcurrentDataLoads;
 
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
-    {
-      ezMath::Swap(data[idx1], data[idx2]);
-    }
-  }
+  return ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::FileAccess), 1u);
 }
 
 void ezResourceManager::UpdateLoadingDeadlines()
@@ -160,35 +266,21 @@ void ezResourceManager::UpdateLoadingDeadlines()
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
   const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
-  s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
-
-  ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
 
-  if (uiUpdateCount == 0)
-  {
+  // the priorities change over time (see ezResource::GetLoadingPriority()), so re-evaluate a few entries per call
+  // entries move around in the heap while doing so, which is fine, as long as all of them get re-evaluated eventually
+  if (s_State->s_uiLastResourcePriorityUpdateIdx >= uiCount)
     s_State->s_uiLastResourcePriorityUpdateIdx = 0;
-    uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
-  }
 
-  if (uiUpdateCount > 0)
-  {
-    {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+  const ezUInt32 uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
 
-      const ezTime tNow = ezTime::Now();
-
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
-      {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
-      }
-    }
+  const ezTime tNow = ezTime::Now();
 
-    {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
-    }
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
+  {
+    ezResource* pResource = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx].m_pResource;
+    UpdateLoadingQueuePriority(pResource, pResource->GetLoadingPriority(tNow));
+    ++s_State->s_uiLastResourcePriorityUpdateIdx;
   }
 }
 
@@ -220,16 +312,26 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
+  // queued, but not in the queue anymore means that some task is already loading it
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  if (uiIndex == ezInvalidIndex)
+    return EZ_FAILURE;
+
+  auto& queue = s_State->s_LoadingQueue;
+
+  const LoadingInfo last = queue.PeekBack();
+  queue.PopBack();
 
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
+  if (uiIndex < queue.GetCount())
   {
-    pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
-    return EZ_SUCCESS;
+    queue[uiIndex] = last;
+    LoadingQueueSiftUp(uiIndex);
+    LoadingQueueSiftDown(last.m_pResource->m_uiLoadingQueueIndex);
   }
 
-  return EZ_FAILURE;
+  pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+  return EZ_SUCCESS;
 }
 
 void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPriority)
@@ -239,20 +341,111 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   pResource->m_Flags.Add(ezResourceFlags::IsQueuedForLoading);
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
   if (bHighestPriority)
   {
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
   }
+
+  LoadingInfo& li = s_State->s_LoadingQueue.ExpandAndGetRef();
+  li.m_pResource = pResource;
+  li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
+  li.m_uiSequence = s_State->s_uiLoadingQueueSequence++;
+  li.m_bHighestPriority = bHighestPriority;
+
+  LoadingQueueSiftUp(s_State->s_LoadingQueue.GetCount() - 1);
+}
+
+ezResource* ezResourceManager::PopFromLoadingQueue()
+{
+  EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Resource mutex must be locked");
+
+  auto& queue = s_State->s_LoadingQueue;
+
+  if (queue.IsEmpty())
+    return nullptr;
+
+  ezResource* pResource = queue[0].m_pResource;
+  pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const LoadingInfo last = queue.PeekBack();
+  queue.PopBack();
+
+  if (!queue.IsEmpty())
+  {
+    queue[0] = last;
+    LoadingQueueSiftDown(0);
+  }
+
+  // the resource stays flagged as 'queued for loading' until the task that loads it is done
+  return pResource;
+}
+
+void ezResourceManager::UpdateLoadingQueuePriority(ezResource* pResource, float fPriority)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Resource mutex must be locked");
+
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  LoadingInfo& li = s_State->s_LoadingQueue[uiIndex];
+
+  if (li.m_fPriority == fPriority)
+    return;
+
+  const bool bMoreImportant = fPriority < li.m_fPriority;
+  li.m_fPriority = fPriority;
+
+  if (bMoreImportant)
+    LoadingQueueSiftUp(uiIndex);
   else
+    LoadingQueueSiftDown(uiIndex);
+}
+
+void ezResourceManager::LoadingQueueSiftUp(ezUInt32 uiIndex)
+{
+  auto& queue = s_State->s_LoadingQueue;
+  const LoadingInfo li = queue[uiIndex];
+
+  while (uiIndex > 0)
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    const ezUInt32 uiParent = (uiIndex - 1) / 2;
+
+    if (!(li < queue[uiParent]))
+      break;
+
+    queue[uiIndex] = queue[uiParent];
+    queue[uiIndex].m_pResource->m_uiLoadingQueueIndex = uiIndex;
+    uiIndex = uiParent;
   }
+
+  queue[uiIndex] = li;
+  li.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+}
+
+void ezResourceManager::LoadingQueueSiftDown(ezUInt32 uiIndex)
+{
+  auto& queue = s_State->s_LoadingQueue;
+  const ezUInt32 uiCount = queue.GetCount();
+  const LoadingInfo li = queue[uiIndex];
+
+  while (true)
+  {
+    ezUInt32 uiChild = uiIndex * 2 + 1;
+
+    if (uiChild >= uiCount)
+      break;
+
+    if (uiChild + 1 < uiCount && queue[uiChild + 1] < queue[uiChild])
+      ++uiChild;
+
+    if (!(queue[uiChild] < li))
+      break;
+
+    queue[uiIndex] = queue[uiChild];
+    queue[uiIndex].m_pResource->m_uiLoadingQueueIndex = uiIndex;
+    uiIndex = uiChild;
+  }
+
+  queue[uiIndex] = li;
+  li.m_pResource->m_uiLoadingQueueIndex = uiIndex;
 }
 
 bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
@@ -284,10 +477,7 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (pResource->m_uiLoadingQueueIndex == ezInvalidIndex)
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
@@ -2,10 +2,12 @@
 
 #include <Core/ResourceManager/Implementation/ResourceManagerState.h>
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Algorithm/HashingUtils.h>
 #include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 /// \todo Do not unload resources while they are acquired
 /// \todo Resource Type Memory Thresholds
@@ -141,6 +143,17 @@ const ezRTTI* ezResourceManager::FindResourceForAssetType(const char* szAssetTyp
   return s_State->s_AssetToResourceType.GetValueOrDefault(s, nullptr);
 }
 
+const char* ezResourceManager::FindAssetTypeForResource(const ezRTTI* pResourceType)
+{
+  for (auto it = s_State->s_AssetToResourceType.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Value() == pResourceType)
+      return it.Key();
+  }
+
+  return nullptr;
+}
+
 void ezResourceManager::ForceNoFallbackAcquisition(ezUInt32 uiNumFrames /*= 0xFFFFFFFF*/)
 {
   s_State->s_uiForceNoFallbackAcquisition = ezMath::Max(s_State->s_uiForceNoFallbackAcquisition, uiNumFrames);
@@ -317,6 +330,196 @@ void ezResourceManager::SetAutoFreeUnused(ezTime timeout, ezTime lastAcquireThre
   s_State->m_AutoFreeUnusedThreshold = lastAcquireThreshold;
 }
 
+void ezResourceManager::SetMemoryBudget(ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  s_State->m_uiMemoryBudgetCPU = uiBudgetCPU;
+  s_State->m_uiMemoryBudgetGPU = uiBudgetGPU;
+  s_State->m_bOverMemoryBudget = false;
+  UpdateAnyMemoryBudget();
+}
+
+void ezResourceManager::SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  auto& info = GetResourceTypeInfo(pResourceType);
+  info.m_uiMemoryBudgetCPU = uiBudgetCPU;
+  info.m_uiMemoryBudgetGPU = uiBudgetGPU;
+  info.m_bOverMemoryBudget = false;
+  UpdateAnyMemoryBudget();
+}
+
+void ezResourceManager::UpdateAnyMemoryBudget()
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  bool bAnyMemoryBudget = s_State->m_uiMemoryBudgetCPU > 0 || s_State->m_uiMemoryBudgetGPU > 0;
+
+  for (auto it = s_State->m_TypeInfo.GetIterator(); it.IsValid() && !bAnyMemoryBudget; ++it)
+  {
+    bAnyMemoryBudget = it.Value().m_uiMemoryBudgetCPU > 0 || it.Value().m_uiMemoryBudgetGPU > 0;
+  }
+
+  s_State->m_bAnyMemoryBudget = bAnyMemoryBudget;
+}
+
+static bool IsOverMemoryBudget(ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU, ezUInt64 uiMemoryCPU, ezUInt64 uiMemoryGPU)
+{
+  return (uiBudgetCPU > 0 && uiMemoryCPU > uiBudgetCPU) || (uiBudgetGPU > 0 && uiMemoryGPU > uiBudgetGPU);
+}
+
+void ezResourceManager::EnforceMemoryBudgets(ezTime tPreviousFrameUpdate)
+{
+  if (!s_State->m_bAnyMemoryBudget)
+    return;
+
+  EZ_PROFILE_SCOPE("EnforceMemoryBudgets");
+
+  ezHybridArray<ezResourceManagerEvent, 4> events;
+
+  {
+    EZ_LOCK(s_ResourceMutex);
+
+    auto& candidates = s_State->m_MemoryBudgetCandidates;
+
+    // anything that was acquired since the previous frame is in use and would just get loaded again right away
+    auto CollectCandidates = [&](const LoadedResources& resources) {
+      for (auto it = resources.m_Resources.GetIterator(); it.IsValid(); ++it)
+      {
+        ezResource* pResource = it.Value();
+
+        if (pResource->GetLoadingState() != ezResourceState::Loaded || pResource->m_iLockCount > 0 || IsQueuedForLoading(pResource) ||
+            !pResource->m_Flags.IsSet(ezResourceFlags::IsReloadable) || pResource->GetLastAcquireTime() >= tPreviousFrameUpdate)
+          continue;
+
+        candidates.PushBack(pResource);
+      }
+    };
+
+    ezUInt64 uiTotalCPU = 0;
+    ezUInt64 uiTotalGPU = 0;
+
+    for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+    {
+      ezUInt64 uiTypeCPU = 0;
+      ezUInt64 uiTypeGPU = 0;
+
+      for (auto it = itType.Value().m_Resources.GetIterator(); it.IsValid(); ++it)
+      {
+        uiTypeCPU += it.Value()->GetMemoryUsage().m_uiMemoryCPU;
+        uiTypeGPU += it.Value()->GetMemoryUsage().m_uiMemoryGPU;
+      }
+
+      auto itInfo = s_State->m_TypeInfo.Find(itType.Key());
+
+      if (itInfo.IsValid() && IsOverMemoryBudget(itInfo.Value().m_uiMemoryBudgetCPU, itInfo.Value().m_uiMemoryBudgetGPU, uiTypeCPU, uiTypeGPU))
+      {
+        ResourceTypeInfo& info = itInfo.Value();
+
+        ezResourceManagerEvent e;
+        e.m_Type = ezResourceManagerEvent::Type::MemoryBudgetExceeded;
+        e.m_pResourceType = itType.Key();
+        e.m_uiBudgetCPU = info.m_uiMemoryBudgetCPU;
+        e.m_uiBudgetGPU = info.m_uiMemoryBudgetGPU;
+        e.m_uiMemoryCPU = uiTypeCPU;
+        e.m_uiMemoryGPU = uiTypeGPU;
+
+        candidates.Clear();
+        CollectCandidates(itType.Value());
+        e.m_uiNumUnloadedResources = UnloadLeastRecentlyAcquired(candidates, e.m_uiBudgetCPU, e.m_uiBudgetGPU, uiTypeCPU, uiTypeGPU);
+        s_State->s_ResourcesUnloadedByBudgetMetric.Add(e.m_uiNumUnloadedResources);
+        e.m_uiFreedMemoryCPU = e.m_uiMemoryCPU - uiTypeCPU;
+        e.m_uiFreedMemoryGPU = e.m_uiMemoryGPU - uiTypeGPU;
+
+        // a budget that stays exceeded because nothing can be unloaded is only reported once
+        if (!info.m_bOverMemoryBudget || e.m_uiNumUnloadedResources > 0)
+        {
+          events.PushBack(e);
+        }
+
+        info.m_bOverMemoryBudget = IsOverMemoryBudget(e.m_uiBudgetCPU, e.m_uiBudgetGPU, uiTypeCPU, uiTypeGPU);
+      }
+      else if (itInfo.IsValid())
+      {
+        itInfo.Value().m_bOverMemoryBudget = false;
+      }
+
+      uiTotalCPU += uiTypeCPU;
+      uiTotalGPU += uiTypeGPU;
+    }
+
+    if (IsOverMemoryBudget(s_State->m_uiMemoryBudgetCPU, s_State->m_uiMemoryBudgetGPU, uiTotalCPU, uiTotalGPU))
+    {
+      ezResourceManagerEvent e;
+      e.m_Type = ezResourceManagerEvent::Type::MemoryBudgetExceeded;
+      e.m_uiBudgetCPU = s_State->m_uiMemoryBudgetCPU;
+      e.m_uiBudgetGPU = s_State->m_uiMemoryBudgetGPU;
+      e.m_uiMemoryCPU = uiTotalCPU;
+      e.m_uiMemoryGPU = uiTotalGPU;
+
+      candidates.Clear();
+      for (auto itType = s_State->s_LoadedResources.GetIterator(); itType.IsValid(); ++itType)
+      {
+        CollectCandidates(itType.Value());
+      }
+
+      e.m_uiNumUnloadedResources = UnloadLeastRecentlyAcquired(candidates, e.m_uiBudgetCPU, e.m_uiBudgetGPU, uiTotalCPU, uiTotalGPU);
+      s_State->s_ResourcesUnloadedByBudgetMetric.Add(e.m_uiNumUnloadedResources);
+      e.m_uiFreedMemoryCPU = e.m_uiMemoryCPU - uiTotalCPU;
+      e.m_uiFreedMemoryGPU = e.m_uiMemoryGPU - uiTotalGPU;
+
+      if (!s_State->m_bOverMemoryBudget || e.m_uiNumUnloadedResources > 0)
+      {
+        events.PushBack(e);
+      }
+
+      s_State->m_bOverMemoryBudget = IsOverMemoryBudget(e.m_uiBudgetCPU, e.m_uiBudgetGPU, uiTotalCPU, uiTotalGPU);
+    }
+    else
+    {
+      s_State->m_bOverMemoryBudget = false;
+    }
+
+    candidates.Clear();
+  }
+
+  for (const auto& e : events)
+  {
+    s_State->s_ManagerEvents.Broadcast(e);
+  }
+}
+
+ezUInt32 ezResourceManager::UnloadLeastRecentlyAcquired(ezDynamicArray<ezResource*>& candidates, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU, ezUInt64& inout_uiMemoryCPU, ezUInt64& inout_uiMemoryGPU)
+{
+  candidates.Sort([](const ezResource* lhs, const ezResource* rhs) -> bool { return lhs->GetLastAcquireTime() < rhs->GetLastAcquireTime(); });
+
+  ezUInt32 uiNumUnloaded = 0;
+
+  for (ezResource* pResource : candidates)
+  {
+    if (!IsOverMemoryBudget(uiBudgetCPU, uiBudgetGPU, inout_uiMemoryCPU, inout_uiMemoryGPU))
+      break;
+
+    const ezResource::MemoryUsage before = pResource->GetMemoryUsage();
+
+    // prefer dropping to a lower quality level over unloading the resource entirely
+    pResource->CallUnloadData(pResource->GetNumQualityLevelsDiscardable() > 0 ? ezResource::Unload::OneQualityLevel : ezResource::Unload::AllQualityLevels);
+
+    ezResource::MemoryUsage after;
+    pResource->UpdateMemoryUsage(after);
+    pResource->m_MemoryUsage = after;
+
+    inout_uiMemoryCPU = inout_uiMemoryCPU - before.m_uiMemoryCPU + after.m_uiMemoryCPU;
+    inout_uiMemoryGPU = inout_uiMemoryGPU - before.m_uiMemoryGPU + after.m_uiMemoryGPU;
+
+    ++uiNumUnloaded;
+  }
+
+  return uiNumUnloaded;
+}
+
 void ezResourceManager::AllowResourceTypeAcquireDuringUpdateContent(const ezRTTI* pTypeBeingUpdated, const ezRTTI* pTypeItWantsToAcquire)
 {
   auto& info = s_State->m_TypeInfo[pTypeBeingUpdated];
@@ -394,6 +597,10 @@ ezResult ezResourceManager::DeallocateResource(ezResource* pResource)
 {
   EZ_ASSERT_DEBUG(pResource->m_iLockCount == 0, "Resource '{0}' has a refcount of zero, but is still in an acquired state.", pResource->GetResourceID());
 
+  // this fails if another thread just got a new handle to the resource through the lookup, which does not lock s_ResourceMutex
+  if (RemoveFromLookup(pResource).Failed())
+    return EZ_FAILURE;
+
   if (RemoveFromLoadingQueue(pResource).Failed())
   {
     // cannot deallocate resources that are currently queued for loading,
@@ -445,6 +652,7 @@ void ezResourceManager::PerFrameUpdate()
 {
   EZ_PROFILE_SCOPE("ezResourceManagerUpdate");
 
+  const ezTime tPreviousFrameUpdate = s_State->s_LastFrameUpdate;
   s_State->s_LastFrameUpdate = ezTime::Now();
 
   if (s_State->s_bBroadcastExistsEvent)
@@ -502,6 +710,38 @@ void ezResourceManager::PerFrameUpdate()
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
   }
+
+  EnforceMemoryBudgets(tPreviousFrameUpdate);
+
+  UpdateLoadingStats();
+}
+
+void ezResourceManager::UpdateLoadingStats()
+{
+  const bool bLoading = IsAnyLoadingInProgress();
+
+  EZ_LOCK(s_ResourceMutex);
+
+  ezStats::SetStat("Resource Manager/Loading Queue", s_State->s_LoadingQueue.GetCount());
+  ezStats::SetStat("Resource Manager/Data Loads In Flight", s_State->s_uiDataLoadTasksRunning);
+
+  s_State->s_LoadingQueueMetric.Set(s_State->s_LoadingQueue.GetCount());
+  s_State->s_DataLoadsInFlightMetric.Set(s_State->s_uiDataLoadTasksRunning);
+
+  // the burst is started by RunWorkerTask(), but it is only over once all content updates are done as well
+  if (!bLoading && s_State->s_bLoadingBurstActive)
+  {
+    s_State->s_bLoadingBurstActive = false;
+
+    const ezTime burstDuration = ezTime::Now() - s_State->s_LoadingBurstStart;
+
+    ezStats::SetStat("Resource Manager/Last Loading Duration", burstDuration);
+    ezStats::SetStat("Resource Manager/Last Loading Resources", s_State->s_uiLoadingBurstResources);
+
+    s_State->s_LoadingBurstDurationMetric.RecordTime(burstDuration);
+
+    s_State->s_uiLoadingBurstResources = 0;
+  }
 }
 
 const ezEvent<const ezResourceEvent&, ezMutex>& ezResourceManager::GetResourceEvents()
@@ -541,9 +781,14 @@ void ezResourceManager::OnCoreStartup()
   s_State = EZ_DEFAULT_NEW(ezResourceManagerState);
 
   EZ_LOCK(s_ResourceMutex);
-  s_State->s_bAllowLaunchDataLoadTask = true;
   s_State->s_bShutdown = false;
 
+  s_State->s_LoadingQueueMetric = ezMetrics::RegisterGauge("ResourceManager/LoadingQueue");
+  s_State->s_DataLoadsInFlightMetric = ezMetrics::RegisterGauge("ResourceManager/DataLoadsInFlight");
+  s_State->s_ResourcesLoadedMetric = ezMetrics::RegisterCounter("ResourceManager/ResourcesLoaded");
+  s_State->s_ResourcesUnloadedByBudgetMetric = ezMetrics::RegisterCounter("ResourceManager/ResourcesUnloadedByBudget");
+  s_State->s_LoadingBurstDurationMetric = ezMetrics::RegisterHistogram("ResourceManager/LoadingBurstDuration");
+
   ezPlugin::s_PluginEvents.AddEventHandler(PluginEventHandler);
 }
 
@@ -558,8 +803,7 @@ void ezResourceManager::EngineAboutToShutdown()
       return;
     }
 
-    s_State->s_bAllowLaunchDataLoadTask = false; // prevent a new one from starting
-    s_State->s_bShutdown = true;
+    s_State->s_bShutdown = true; // prevent a new one from starting
   }
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
@@ -578,6 +822,7 @@ void ezResourceManager::EngineAboutToShutdown()
     for (auto entry : s_State->s_LoadingQueue)
     {
       entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      entry.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
     }
 
     s_State->s_LoadingQueue.Clear();
@@ -690,6 +935,7 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
   EZ_ASSERT_DEV(s_ResourceMutex.IsLocked(), "Calling code must lock the mutex until the resource pointer is stored in a handle");
 
   // redirect requested type to override type, if available
+  const ezRTTI* pRequestedRtti = pRtti;
   pRtti = FindResourceTypeOverride(pRtti, szResourceID);
 
   EZ_ASSERT_DEBUG(pRtti != nullptr, "There is no RTTI information available for the given resource type '{0}'", EZ_STRINGIZE(ResourceType));
@@ -699,7 +945,7 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
   ezResource* pResource = nullptr;
   ezTempHashedString sHashedResourceID(szResourceID);
 
-  ezHashedString* redirection;
+  ezHashedString* redirection = nullptr;
   if (s_State->s_NamedResources.TryGetValue(sHashedResourceID, redirection))
   {
     sHashedResourceID = *redirection;
@@ -708,17 +954,106 @@ ezResource* ezResourceManager::GetResource(const ezRTTI* pRtti, const char* szRe
 
   LoadedResources& lr = s_State->s_LoadedResources[pRtti];
 
-  if (lr.m_Resources.TryGetValue(sHashedResourceID, pResource))
-    return pResource;
+  if (!lr.m_Resources.TryGetValue(sHashedResourceID, pResource))
+  {
+    pResource = pRtti->GetAllocator()->Allocate<ezResource>();
+    pResource->m_Priority = s_State->s_ResourceTypePriorities.GetValueOrDefault(pRtti, ezResourcePriority::Medium);
+    pResource->SetUniqueID(szResourceID, bIsReloadable);
+    pResource->m_Flags.AddOrRemove(ezResourceFlags::ResourceHasTypeFallback, pResource->HasResourceTypeLoadingFallback());
 
-  ezResource* pNewResource = pRtti->GetAllocator()->Allocate<ezResource>();
-  pNewResource->m_Priority = s_State->s_ResourceTypePriorities.GetValueOrDefault(pRtti, ezResourcePriority::Medium);
-  pNewResource->SetUniqueID(szResourceID, bIsReloadable);
-  pNewResource->m_Flags.AddOrRemove(ezResourceFlags::ResourceHasTypeFallback, pNewResource->HasResourceTypeLoadingFallback());
+    lr.m_Resources.Insert(sHashedResourceID, pResource);
+  }
 
-  lr.m_Resources.Insert(sHashedResourceID, pNewResource);
+  // only direct requests can be answered by the lookup, it does not know about type overrides and named resources
+  if (pRtti == pRequestedRtti && redirection == nullptr)
+  {
+    AddToLookup(pResource);
+  }
 
-  return pNewResource;
+  return pResource;
+}
+
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt64 GetLookupKey(const ezRTTI* pRtti, ezUInt32 uiResourceIDHash)
+  {
+    return (static_cast<ezUInt64>(uiResourceIDHash) << 32) | ezHashingUtils::xxHash32(&pRtti, sizeof(pRtti));
+  }
+} // namespace
+
+bool ezResourceManager::TryGetResourceFromLookup(const ezRTTI* pRtti, const char* szResourceID, ezTypelessResourceHandle& out_hResource)
+{
+  if (ezStringUtils::IsNullOrEmpty(szResourceID))
+    return false;
+
+  const ezUInt32 uiResourceIDHash = ezTempHashedString(szResourceID).GetHash();
+  auto& shard = s_State->s_LookupShards[uiResourceIDHash % ezResourceManagerState::s_uiNumLookupShards];
+
+  EZ_LOCK(shard.m_Mutex);
+
+  ezResource* pResource = nullptr;
+  if (!shard.m_Resources.TryGetValue(GetLookupKey(pRtti, uiResourceIDHash), pResource) || pResource->GetDynamicRTTI() != pRtti)
+    return false;
+
+  // the handle must take its reference while the shard is locked, see RemoveFromLookup()
+  out_hResource = ezTypelessResourceHandle(pResource);
+  return true;
+}
+
+void ezResourceManager::AddToLookup(ezResource* pResource)
+{
+  const ezUInt32 uiResourceIDHash = ezTempHashedString(pResource->GetResourceID().GetData()).GetHash();
+  auto& shard = s_State->s_LookupShards[uiResourceIDHash % ezResourceManagerState::s_uiNumLookupShards];
+
+  EZ_LOCK(shard.m_Mutex);
+  shard.m_Resources[GetLookupKey(pResource->GetDynamicRTTI(), uiResourceIDHash)] = pResource;
+}
+
+ezResult ezResourceManager::RemoveFromLookup(ezResource* pResource)
+{
+  const ezUInt32 uiResourceIDHash = ezTempHashedString(pResource->GetResourceID().GetData()).GetHash();
+  auto& shard = s_State->s_LookupShards[uiResourceIDHash % ezResourceManagerState::s_uiNumLookupShards];
+
+  EZ_LOCK(shard.m_Mutex);
+
+  if (pResource->GetReferenceCount() > 0)
+    return EZ_FAILURE;
+
+  const ezUInt64 uiKey = GetLookupKey(pResource->GetDynamicRTTI(), uiResourceIDHash);
+
+  ezResource* pStored = nullptr;
+  if (shard.m_Resources.TryGetValue(uiKey, pStored) && pStored == pResource)
+  {
+    shard.m_Resources.Remove(uiKey);
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezResourceManager::RemoveFromLookup(const ezTempHashedString& sResourceID)
+{
+  const ezUInt32 uiResourceIDHash = sResourceID.GetHash();
+  auto& shard = s_State->s_LookupShards[uiResourceIDHash % ezResourceManagerState::s_uiNumLookupShards];
+
+  EZ_LOCK(shard.m_Mutex);
+
+  // the ID may be registered for several resource types
+  for (auto it = shard.m_Resources.GetIterator(); it.IsValid();)
+  {
+    if (static_cast<ezUInt32>(it.Key() >> 32) == uiResourceIDHash)
+      it = shard.m_Resources.Remove(it);
+    else
+      ++it;
+  }
+}
+
+void ezResourceManager::ClearLookup()
+{
+  for (auto& shard : s_State->s_LookupShards)
+  {
+    EZ_LOCK(shard.m_Mutex);
+    shard.m_Resources.Clear();
+  }
 }
 
 void ezResourceManager::RegisterResourceOverrideType(
@@ -733,6 +1068,8 @@ void ezResourceManager::RegisterResourceOverrideType(
 
     pParentType = pParentType->GetParentType();
   }
+
+  ClearLookup();
 }
 
 void ezResourceManager::UnregisterResourceOverrideType(const ezRTTI* pDerivedTypeToUse)
@@ -754,6 +1091,8 @@ void ezResourceManager::UnregisterResourceOverrideType(const ezRTTI* pDerivedTyp
         infos.RemoveAtAndSwap(i - 1);
     }
   }
+
+  ClearLookup();
 }
 
 const ezRTTI* ezResourceManager::FindResourceTypeOverride(const ezRTTI* pRtti, const char* szResourceID)
@@ -793,6 +1132,12 @@ ezString ezResourceManager::GenerateUniqueResourceID(const char* prefix)
 
 ezTypelessResourceHandle ezResourceManager::GetExistingResourceByType(const ezRTTI* pResourceType, const char* szResourceID)
 {
+  {
+    ezTypelessResourceHandle hResource;
+    if (TryGetResourceFromLookup(pResourceType, szResourceID, hResource))
+      return hResource;
+  }
+
   ezResource* pResource = nullptr;
 
   const ezTempHashedString sResourceHash(szResourceID);
@@ -831,6 +1176,9 @@ void ezResourceManager::RegisterNamedResource(const char* szLookupName, const ch
   redirection.Assign(szRedirectionResource);
 
   s_State->s_NamedResources[lookup] = redirection;
+
+  // resources that were looked up under this name so far are not what the name refers to anymore
+  RemoveFromLookup(lookup);
 }
 
 void ezResourceManager::UnregisterNamedResource(const char* szLookupName)
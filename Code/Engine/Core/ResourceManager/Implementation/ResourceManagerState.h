@@ -4,6 +4,7 @@
 EZ_CORE_INTERNAL_HEADER
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Utilities/Metrics.h>
 
 class ezResourceManagerState
 {
@@ -50,14 +51,39 @@ private:
   bool s_bBroadcastExistsEvent = false;
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
 
-  // resources in this queue are waiting for a task to load them
-  ezDeque<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  // resources in this queue are waiting for a task to load them (a binary heap, see ezResourceManager::PopFromLoadingQueue())
+  ezDynamicArray<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  ezUInt32 s_uiLoadingQueueSequence = 0;
 
   ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
 
-  bool s_bAllowLaunchDataLoadTask = true;
+  // see ezResourceManager::TryGetResourceFromLookup(), the shard is selected by the hash of the resource ID
+  struct LookupShard
+  {
+    ezMutex m_Mutex;
+    ezHashTable<ezUInt64, ezResource*> m_Resources;
+  };
+
+  static constexpr ezUInt32 s_uiNumLookupShards = 32;
+  LookupShard s_LookupShards[s_uiNumLookupShards];
+
+  // number of data load tasks that have been started and not yet handed over their resource, see SetMaxConcurrentDataLoads()
+  ezUInt32 s_uiDataLoadTasksRunning = 0;
+  ezUInt32 s_uiMaxConcurrentDataLoads = 0;
   bool s_bShutdown = false;
 
+  // a loading burst lasts from the first queued resource until nothing is loading anymore (e.g. a level load)
+  bool s_bLoadingBurstActive = false;
+  ezTime s_LoadingBurstStart;
+  ezUInt32 s_uiLoadingBurstResources = 0;
+
+  // the gauges and the burst duration are published once per frame by UpdateLoadingStats()
+  ezMetricGauge s_LoadingQueueMetric;
+  ezMetricGauge s_DataLoadsInFlightMetric;
+  ezMetricCounter s_ResourcesLoadedMetric;
+  ezMetricCounter s_ResourcesUnloadedByBudgetMetric;
+  ezMetricHistogram s_LoadingBurstDurationMetric;
+
   ezHybridArray<TaskDataUpdateContent, 24> s_WorkerTasksUpdateContent;
   ezHybridArray<TaskDataDataLoad, 8> s_WorkerTasksDataLoad;
 
@@ -87,6 +113,11 @@ private:
 
   ezHashTable<ezTempHashedString, ezHashedString> s_NamedResources;
 
+  // Resource dependencies
+
+  bool s_bRecordResourceDependencies = false;
+  ezHashTable<ezTempHashedString, ezHybridArray<ezResourceManager::ResourceDependency, 4>> s_ResourceDependencies;
+
   // Asset system interaction
 
   ezMap<ezString, const ezRTTI*> s_AssetToResourceType;
@@ -101,5 +132,12 @@ private:
   ezTime m_AutoFreeUnusedTimeout = ezTime::Zero();
   ezTime m_AutoFreeUnusedThreshold = ezTime::Zero();
 
+  // Memory Budgets
+  ezUInt64 m_uiMemoryBudgetCPU = 0;
+  ezUInt64 m_uiMemoryBudgetGPU = 0;
+  bool m_bAnyMemoryBudget = false;
+  bool m_bOverMemoryBudget = false; ///< Whether the global budget was still exceeded after the last EnforceMemoryBudgets().
+  ezDynamicArray<ezResource*> m_MemoryBudgetCandidates;
+
   ezMap<const ezRTTI*, ezResourceManager::ResourceTypeInfo> m_TypeInfo;
 };
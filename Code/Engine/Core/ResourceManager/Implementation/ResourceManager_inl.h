@@ -11,6 +11,12 @@ ResourceType* ezResourceManager::GetResource(const char* szResourceID, bool bIsR
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(const char* szResourceID)
 {
+  RecordResourceDependency(ezGetStaticRTTI<ResourceType>(), szResourceID);
+
+  ezTypedResourceHandle<ResourceType> hResource;
+  if (TryGetResourceFromLookup(ezGetStaticRTTI<ResourceType>(), szResourceID, hResource.m_Typeless))
+    return hResource;
+
   // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
   EZ_LOCK(s_ResourceMutex);
   return ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
@@ -20,12 +26,7 @@ template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(
   const char* szResourceID, ezTypedResourceHandle<ResourceType> hLoadingFallback)
 {
-  ezTypedResourceHandle<ResourceType> hResource;
-  {
-    // the mutex here is necessary to prevent a race between resource unloading and storing the pointer in the handle
-    EZ_LOCK(s_ResourceMutex);
-    hResource = ezTypedResourceHandle<ResourceType>(GetResource<ResourceType>(szResourceID, true));
-  }
+  ezTypedResourceHandle<ResourceType> hResource = LoadResource<ResourceType>(szResourceID);
 
   ResourceType* pResource = ezResourceManager::BeginAcquireResource(hResource, ezResourceAcquireMode::PointerOnly, ezTypedResourceHandle<ResourceType>());
 
@@ -42,6 +43,12 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::LoadResource(
 template <typename ResourceType>
 ezTypedResourceHandle<ResourceType> ezResourceManager::GetExistingResource(const char* szResourceID)
 {
+  {
+    ezTypedResourceHandle<ResourceType> hResource;
+    if (TryGetResourceFromLookup(ezGetStaticRTTI<ResourceType>(), szResourceID, hResource.m_Typeless))
+      return hResource;
+  }
+
   ezResource* pResource = nullptr;
 
   const ezTempHashedString sResourceHash(szResourceID);
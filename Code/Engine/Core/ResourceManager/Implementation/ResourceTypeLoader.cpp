@@ -8,10 +8,34 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 
+/// \brief Reads the absolute path of the file from a small buffer and then the file content straight from the direct view of the file.
+class FileResourceViewReader : public ezStreamReader
+{
+public:
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+  {
+    const ezUInt64 uiHeaderBytes = m_Header.ReadBytes(pReadBuffer, uiBytesToRead);
+    return uiHeaderBytes + m_Content.ReadBytes(ezMemoryUtils::AddByteOffset(pReadBuffer, static_cast<ptrdiff_t>(uiHeaderBytes)), uiBytesToRead - uiHeaderBytes);
+  }
+
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override
+  {
+    const ezUInt64 uiHeaderBytes = m_Header.SkipBytes(uiBytesToSkip);
+    return uiHeaderBytes + m_Content.SkipBytes(uiBytesToSkip - uiHeaderBytes);
+  }
+
+  ezRawMemoryStreamReader m_Header;
+  ezRawMemoryStreamReader m_Content;
+};
+
 struct FileResourceLoadData
 {
   ezBlob m_Storage;
   ezRawMemoryStreamReader m_Reader;
+
+  // if the data directory provides a direct view of the file, it stays open and only the path is copied into m_Storage
+  ezFileReader m_File;
+  FileResourceViewReader m_ViewReader;
 };
 
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
@@ -20,9 +44,14 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   ezResourceLoadData res;
 
-  ezFileReader File;
+  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+  ezFileReader& File = pData->m_File;
+
   if (File.Open(pResource->GetResourceID().GetData()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pData);
     return res;
+  }
 
   res.m_sResourceDescription = File.GetFilePathRelative().GetData();
 
@@ -35,9 +64,8 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
 #endif
 
-  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
-
-  const ezUInt64 uiFileSize = File.GetFileSize();
+  const ezArrayPtr<const ezUInt8> directView = File.GetDirectView();
+  const ezUInt64 uiFileSize = directView.IsEmpty() ? File.GetFileSize() : 0;
 
   const ezUInt64 uiBlobCapacity = uiFileSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
   pData->m_Storage.SetCountUninitialized(uiBlobCapacity);
@@ -49,9 +77,21 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
   // write the absolute path to the read file into the memory stream
   w << File.GetFilePathAbsolute();
 
+  if (!directView.IsEmpty())
+  {
+    // the resource parses the file content straight from the data directory's memory, e.g. a memory mapped archive
+    pData->m_ViewReader.m_Header.Reset(pBlobPtr, w.GetNumWrittenBytes());
+    pData->m_ViewReader.m_Content.Reset(directView.GetPtr(), directView.GetCount());
+    res.m_pDataStream = &pData->m_ViewReader;
+    res.m_pCustomLoaderData = pData;
+
+    return res;
+  }
+
   const ezUInt64 uiOffset = w.GetNumWrittenBytes();
 
   File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  File.Close();
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
@@ -21,15 +21,15 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
     if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      --ezResourceManager::s_State->s_uiDataLoadTasksRunning;
       return;
     }
 
     ezResourceManager::UpdateLoadingDeadlines();
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+    pResourceToLoad = ezResourceManager::PopFromLoadingQueue();
+    ++ezResourceManager::s_State->s_uiLoadingBurstResources;
+    ezResourceManager::s_State->s_ResourcesLoadedMetric.Increment();
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -95,8 +95,8 @@ void ezResourceManagerWorkerDataLoad::Execute()
     // schedule the task to run, either on the main thread or on some other thread
     *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
 
-    // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+    // this task is about to finish, hand its slot over to the next loading task
+    --ezResourceManager::s_State->s_uiDataLoadTasksRunning;
     ezResourceManager::RunWorkerTask(nullptr);
 
     pCustomLoader.Clear();
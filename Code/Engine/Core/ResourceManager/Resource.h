@@ -227,6 +227,7 @@ private:
 
   ezTime m_LastAcquire;
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex; ///< Position in the resource manager's loading queue, while the resource is in it.
   ezTimestamp m_LoadedFileModificationTime;
 
 private:
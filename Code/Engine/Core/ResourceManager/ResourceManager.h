@@ -65,6 +65,17 @@ public:
   /// \brief Checks whether any resource loading is in progress
   static bool IsAnyLoadingInProgress();
 
+  /// \brief Sets how many resources may be read (ezResourceTypeLoader::OpenDataStream()) at the same time.
+  ///
+  /// Every data load task reads one resource and then hands the data over to a content update task, so while one resource gets
+  /// updated, the next ones are already being read. Data load tasks run with ezTaskPriority::FileAccess, so to actually read files in
+  /// parallel, the task system needs as many file access threads, see ezTaskSystem::SetWorkerThreadCount().
+  /// If set to zero (the default), the number of file access threads is used.
+  static void SetMaxConcurrentDataLoads(ezUInt32 uiMaxConcurrentDataLoads);
+
+  /// \brief Returns how many resources may be read at the same time. See SetMaxConcurrentDataLoads().
+  static ezUInt32 GetMaxConcurrentDataLoads();
+
   /// \brief Generates a unique resource ID with the given prefix.
   ///
   /// Provide a prefix that is preferably not used anywhere else (i.e., closely related to your code).
@@ -188,6 +199,26 @@ public:
   /// \brief If timeout is not zero, FreeUnusedResources() is called once every frame with the given parameters.
   static void SetAutoFreeUnused(ezTime timeout, ezTime lastAcquireThreshold);
 
+  /// \brief Sets a budget for the memory that all resources together may use. Zero means unlimited.
+  ///
+  /// Every frame, PerFrameUpdate() sums up the memory usage that the resources report (ezResource::GetMemoryUsage()). If a budget is
+  /// exceeded, the least recently acquired resources are unloaded until the usage is back within the budget. Resources that can
+  /// discard quality levels are only reduced by one quality level at a time. Resources that are currently acquired, queued for
+  /// loading, were acquired during the last frame or cannot be reloaded (e.g. created resources) are never unloaded.
+  /// An ezResourceManagerEvent::Type::MemoryBudgetExceeded event is sent when a budget gets exceeded and in every frame in which resources
+  /// were unloaded because of it. A budget that stays exceeded, because nothing can be unloaded, is not reported again.
+  static void SetMemoryBudget(ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU);
+
+  /// \brief Sets a memory budget for all resources of the given type. Zero means unlimited. See SetMemoryBudget().
+  template <typename ResourceType>
+  static void SetMemoryBudgetForResourceType(ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU)
+  {
+    SetMemoryBudgetForResourceType(ezGetStaticRTTI<ResourceType>(), uiBudgetCPU, uiBudgetGPU);
+  }
+
+  /// \brief Sets a memory budget for all resources of the given type. Zero means unlimited. See SetMemoryBudget().
+  static void SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU);
+
   /// \brief If set to 'false' resources of the given type will not be incrementally unloaded in the background, when they are not referenced anymore.
   template <typename ResourceType>
   static void SetIncrementalUnloadForResourceType(bool bActive);
@@ -268,6 +299,40 @@ public:
   /// \brief Removes a previously registered name from the redirection table.
   static void UnregisterNamedResource(const char* szLookupName);
 
+  ///@}
+  /// \name Resource dependencies
+  ///@{
+
+public:
+  /// \brief Another resource that a resource needs, see RegisterResourceDependency().
+  struct ResourceDependency
+  {
+    const ezRTTI* m_pResourceType = nullptr;
+    ezString m_sResourceID;
+  };
+
+  /// \brief If enabled, every LoadResource() call that happens while another resource updates its content is recorded as a dependency of
+  /// that resource. Only available in development builds.
+  ///
+  /// The recorded dependencies can be stored in a collection (see ezCollectionUtils::AddResourceDependencies()), which registers them
+  /// again when it gets loaded in a build that does not record anything.
+  ///
+  /// Recording is off by default. The collection asset transform does not need it, it stores the references that the editor knows for each
+  /// asset, which a loaded collection registers through RegisterResourceDependency().
+  static void SetRecordResourceDependencies(bool bRecord);
+
+  /// \brief Registers that the resource \a szResourceID needs the resource \a szDependencyID when it gets loaded.
+  ///
+  /// Whenever a resource gets queued for loading, all its known dependencies and their dependencies are queued right away as well,
+  /// instead of being discovered one level at a time once the resource that references them has been loaded.
+  static void RegisterResourceDependency(const char* szResourceID, const ezRTTI* pDependencyType, const char* szDependencyID);
+
+  /// \brief Returns the direct dependencies of the given resource that were recorded or registered so far.
+  static void GetResourceDependencies(const char* szResourceID, ezDynamicArray<ResourceDependency>& out_Dependencies);
+
+  /// \brief Forgets all recorded and registered resource dependencies.
+  static void ClearResourceDependencies();
+
 
   ///@}
   /// \name Asset system interaction
@@ -281,6 +346,9 @@ public:
   /// registered for this asset type.
   static const ezRTTI* FindResourceForAssetType(const char* szAssetTypeName);
 
+  /// \brief Returns an asset type name that was registered for the given resource type. nullptr if there is none.
+  static const char* FindAssetTypeForResource(const ezRTTI* pResourceType);
+
   ///@}
   /// \name Export mode
   ///@{
@@ -423,10 +491,24 @@ private:
   struct LoadingInfo
   {
     float m_fPriority = 0;
+    ezUInt32 m_uiSequence = 0; ///< Resources with equal priority are loaded in the order in which they were queued.
+    bool m_bHighestPriority = false; ///< Somebody waits for the resource. These come before all others, the most recently queued one first.
     ezResource* m_pResource = nullptr;
 
     EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
+    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const
+    {
+      if (m_bHighestPriority != rhs.m_bHighestPriority)
+        return m_bHighestPriority;
+
+      if (m_bHighestPriority)
+        return m_uiSequence > rhs.m_uiSequence;
+
+      if (m_fPriority != rhs.m_fPriority)
+        return m_fPriority < rhs.m_fPriority;
+
+      return m_uiSequence < rhs.m_uiSequence;
+    }
   };
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
@@ -435,12 +517,17 @@ private:
   template <typename ResourceType>
   static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
-  static void RunWorkerTask(ezResource* pResource);
+  static void RunWorkerTask(ezResource* pResource, bool bIgnoreMaxConcurrentDataLoads = false);
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
+  static void RecordResourceDependency(const ezRTTI* pDependencyType, const char* szDependencyID);
+  static void PreloadResourceDependencies(ezResource* pResource);
+  static void UpdateLoadingStats();
+  static void UpdateAnyMemoryBudget();
+  static void EnforceMemoryBudgets(ezTime tPreviousFrameUpdate);
+  static ezUInt32 UnloadLeastRecentlyAcquired(ezDynamicArray<ezResource*>& candidates, ezUInt64 uiBudgetCPU, ezUInt64 uiBudgetGPU, ezUInt64& inout_uiMemoryCPU, ezUInt64& inout_uiMemoryGPU);
   static ezTime GetLastFrameUpdate();
   static ezHashTable<const ezRTTI*, LoadedResources>& GetLoadedResources();
   static ezDynamicArray<ezResource*>& GetLoadedResourceOfTypeTempContainer();
@@ -449,11 +536,40 @@ private:
   [[nodiscard]] static ezResult RemoveFromLoadingQueue(ezResource* pResource);
   static void AddToLoadingQueue(ezResource* pResource, bool bHighPriority);
 
+  /// \name Loading queue
+  /// The loading queue is a binary min-heap on the loading priority. Every queued resource knows its index in the heap,
+  /// so changing its priority or removing it from the queue only costs O(log n).
+  ///@{
+
+  static ezResource* PopFromLoadingQueue();
+  static void UpdateLoadingQueuePriority(ezResource* pResource, float fPriority);
+  static void LoadingQueueSiftUp(ezUInt32 uiIndex);
+  static void LoadingQueueSiftDown(ezUInt32 uiIndex);
+
+  ///@}
+  /// \name Resource lookup
+  /// Resources that exist under their own type and ID are also stored in a table that is split into shards with one lock each.
+  /// LoadResource() and GetExistingResource() look there first, so finding a resource that already exists does not need
+  /// s_ResourceMutex and never waits for loading tasks or the per frame update.
+  ///@{
+
+  static bool TryGetResourceFromLookup(const ezRTTI* pRtti, const char* szResourceID, ezTypelessResourceHandle& out_hResource);
+  static void AddToLookup(ezResource* pResource);
+  [[nodiscard]] static ezResult RemoveFromLookup(ezResource* pResource);
+  static void RemoveFromLookup(const ezTempHashedString& sResourceID);
+  static void ClearLookup();
+
+  ///@}
+
   struct ResourceTypeInfo
   {
     bool m_bIncrementalUnload = true;
     bool m_bAllowNestedAcquireCached = false;
 
+    ezUInt64 m_uiMemoryBudgetCPU = 0;
+    ezUInt64 m_uiMemoryBudgetGPU = 0;
+    bool m_bOverMemoryBudget = false; ///< Whether the type was still over its budget after the last EnforceMemoryBudgets().
+
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
   };
 
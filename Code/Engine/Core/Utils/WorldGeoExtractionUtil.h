@@ -58,6 +58,7 @@ public:
     RenderMesh,        ///< The render geometry is desired. Typically for exporting it to file.
     CollisionMesh,     ///< The collision geometry is desired. Typically for exporting it to file.
     NavMeshGeneration, ///< The geometry that participates in navmesh generation is desired.
+    OcclusionMesh,     ///< The geometry of occluders is desired, which is rasterized by ezOcclusionBuffer to cull hidden objects.
   };
 
   /// \brief Extracts the desired geometry from all objects in a world
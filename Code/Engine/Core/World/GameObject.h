@@ -512,6 +512,7 @@ private:
     void ConditionalUpdateGlobalBounds(ezSpatialSystem* pSpatialSytem);
     void UpdateGlobalBounds();
     void UpdateGlobalBoundsAndSpatialData(ezSpatialSystem& spatialSytem);
+    bool UpdateGlobalBoundsAndCheckSpatialData(bool& out_bWasAlwaysVisible);
 
     void UpdateVelocity(const ezSimdFloat& fInvDeltaSeconds);
 
@@ -1,5 +1,7 @@
 #include <CorePCH.h>
 
+#include <Core/Graphics/OcclusionBuffer.h>
+#include <Core/World/GameObject.h>
 #include <Core/World/SpatialSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -182,7 +184,7 @@ void ezSpatialSystem::FindObjectsInBox(const ezBoundingBox& box, ezUInt32 uiCate
 }
 
 void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-  QueryStats* pStats /*= nullptr*/) const
+  QueryStats* pStats /*= nullptr*/, const ezOcclusionBuffer* pOcclusionBuffer /*= nullptr*/) const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
@@ -195,8 +197,15 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
   }
 #endif
 
+  const ezUInt32 uiFirstObject = out_Objects.GetCount();
+
   FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats);
 
+  if (pOcclusionBuffer != nullptr)
+  {
+    RemoveOccludedObjects(*pOcclusionBuffer, out_Objects, uiFirstObject, pStats);
+  }
+
   for (auto pData : m_DataAlwaysVisible)
   {
     if ((pData->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
@@ -213,6 +222,45 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
 #endif
 }
 
+void ezSpatialSystem::RemoveOccludedObjects(const ezOcclusionBuffer& occlusionBuffer, ezDynamicArray<const ezGameObject*>& inout_Objects,
+  ezUInt32 uiFirstObject, QueryStats* pStats) const
+{
+  const ezUInt32 uiOccluderBitmask = ezDefaultSpatialDataCategories::Occluder.GetBitmask();
+  const ezUInt32 uiNumObjects = inout_Objects.GetCount();
+
+  ezUInt32 uiNumVisibleObjects = uiFirstObject;
+
+  for (ezUInt32 i = uiFirstObject; i < uiNumObjects; ++i)
+  {
+    const ezGameObject* pObject = inout_Objects[i];
+
+    const ezSpatialData* pData = nullptr;
+    if (TryGetSpatialData(pObject->GetSpatialData(), pData))
+    {
+      // occluders would otherwise hide themselves
+      if ((pData->m_uiCategoryBitmask & uiOccluderBitmask) == 0)
+      {
+        const ezSimdBBox box = pData->m_Bounds.GetBox();
+        if (occlusionBuffer.IsOccluded(ezBoundingBox(ezSimdConversion::ToVec3(box.m_Min), ezSimdConversion::ToVec3(box.m_Max))))
+          continue;
+      }
+    }
+
+    inout_Objects[uiNumVisibleObjects] = pObject;
+    ++uiNumVisibleObjects;
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsOccluded += uiNumObjects - uiNumVisibleObjects;
+    pStats->m_uiNumObjectsPassed -= uiNumObjects - uiNumVisibleObjects;
+  }
+#endif
+
+  inout_Objects.SetCountUninitialized(uiNumVisibleObjects);
+}
+
 
 
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem);
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <Core/World/SpatialData.h>
+#include <Foundation/Math/Frustum.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+// Helpers that test the bounding spheres of a spatial system against queries, four at a time.
+
+namespace ezInternal
+{
+  /// Bounding spheres of four objects in SoA layout, so that all four can be tested against a query with a few SIMD instructions.
+  struct EZ_ALIGN_16(SphereBlock)
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_CenterX[4];
+    float m_CenterY[4];
+    float m_CenterZ[4];
+    float m_Radius[4];
+  };
+
+  /// Array of bounding spheres that is stored in blocks of four. Unused entries of the last block are zero.
+  struct BoundingSphereArray
+  {
+    BoundingSphereArray(ezAllocatorBase* pAllocator)
+      : m_Blocks(pAllocator)
+    {
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_uiCount; }
+
+    /// \brief Returns a mask of the used entries of the given block.
+    EZ_ALWAYS_INLINE ezUInt32 GetValidMask(ezUInt32 uiBlockIndex) const
+    {
+      const ezUInt32 uiNumValid = m_uiCount - uiBlockIndex * 4;
+      return uiNumValid >= 4 ? 0xF : EZ_BIT(uiNumValid) - 1;
+    }
+
+    void PushBack(const ezSimdBSphere& sphere)
+    {
+      if ((m_uiCount & 3) == 0)
+      {
+        ezMemoryUtils::ZeroFill(&m_Blocks.ExpandAndGetRef(), 1);
+      }
+
+      Set(m_uiCount, sphere);
+      ++m_uiCount;
+    }
+
+    void RemoveAtAndSwap(ezUInt32 uiIndex)
+    {
+      const ezUInt32 uiLastIndex = m_uiCount - 1;
+
+      if (uiIndex != uiLastIndex)
+      {
+        SphereBlock& block = m_Blocks[uiIndex >> 2];
+        const SphereBlock& lastBlock = m_Blocks[uiLastIndex >> 2];
+        const ezUInt32 uiLane = uiIndex & 3;
+        const ezUInt32 uiLastLane = uiLastIndex & 3;
+
+        block.m_CenterX[uiLane] = lastBlock.m_CenterX[uiLastLane];
+        block.m_CenterY[uiLane] = lastBlock.m_CenterY[uiLastLane];
+        block.m_CenterZ[uiLane] = lastBlock.m_CenterZ[uiLastLane];
+        block.m_Radius[uiLane] = lastBlock.m_Radius[uiLastLane];
+      }
+
+      if ((uiLastIndex & 3) == 0)
+      {
+        m_Blocks.PopBack();
+      }
+      else
+      {
+        Set(uiLastIndex, ezSimdBSphere(ezSimdVec4f::ZeroVector(), 0.0f));
+      }
+
+      m_uiCount = uiLastIndex;
+    }
+
+    void Reserve(ezUInt32 uiCount) { m_Blocks.Reserve((uiCount + 3) / 4); }
+
+    void Clear()
+    {
+      m_Blocks.Clear();
+      m_uiCount = 0;
+    }
+
+    EZ_FORCE_INLINE void Set(ezUInt32 uiIndex, const ezSimdBSphere& sphere)
+    {
+      SphereBlock& block = m_Blocks[uiIndex >> 2];
+      const ezUInt32 uiLane = uiIndex & 3;
+
+      const ezVec4 centerAndRadius = ezSimdConversion::ToVec4(sphere.m_CenterAndRadius);
+      block.m_CenterX[uiLane] = centerAndRadius.x;
+      block.m_CenterY[uiLane] = centerAndRadius.y;
+      block.m_CenterZ[uiLane] = centerAndRadius.z;
+      block.m_Radius[uiLane] = centerAndRadius.w;
+    }
+
+    ezDynamicArray<SphereBlock> m_Blocks;
+    ezUInt32 m_uiCount = 0;
+  };
+
+  /// Calls func with the index of every sphere for which testFunc returns a set bit, until func returns ezVisitorExecution::Stop.
+  template <typename TestFunctor, typename Functor>
+  EZ_FORCE_INLINE ezVisitorExecution::Enum ForEachPassingSphere(const BoundingSphereArray& spheres, TestFunctor testFunc, Functor func)
+  {
+    const ezUInt32 uiNumBlocks = spheres.m_Blocks.GetCount();
+    for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < uiNumBlocks; ++uiBlockIndex)
+    {
+      ezUInt32 mask = testFunc(spheres.m_Blocks[uiBlockIndex]) & spheres.GetValidMask(uiBlockIndex);
+
+      while (mask > 0)
+      {
+        const ezUInt32 i = ezMath::FirstBitLow(mask);
+        mask &= mask - 1;
+
+        if (func(uiBlockIndex * 4 + i) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+      }
+    }
+
+    return ezVisitorExecution::Continue;
+  }
+
+  /// The frustum planes, every component splatted into a separate vector so they can be tested against four spheres at once.
+  struct PlaneData
+  {
+    ezSimdVec4f m_NormalX[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_NormalY[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_NormalZ[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_NegDistance[ezFrustum::PLANE_COUNT];
+
+    void SetFrustum(const ezFrustum& frustum)
+    {
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        const ezPlane& plane = frustum.GetPlane(i);
+        m_NormalX[i] = ezSimdVec4f(plane.m_vNormal.x);
+        m_NormalY[i] = ezSimdVec4f(plane.m_vNormal.y);
+        m_NormalZ[i] = ezSimdVec4f(plane.m_vNormal.z);
+        m_NegDistance[i] = ezSimdVec4f(plane.m_fNegDistance);
+      }
+    }
+  };
+
+  /// Returns a mask with bit i set, if sphere i of the block intersects the frustum.
+  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const SphereBlock& block, const PlaneData& planeData)
+  {
+    ezSimdVec4f x, y, z, r;
+    x.Load<4>(block.m_CenterX);
+    y.Load<4>(block.m_CenterY);
+    z.Load<4>(block.m_CenterZ);
+    r.Load<4>(block.m_Radius);
+
+    ezSimdVec4b outside(false);
+
+    for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+    {
+      ezSimdVec4f dist = ezSimdVec4f::MulAdd(x, planeData.m_NormalX[i], planeData.m_NegDistance[i]);
+      dist = ezSimdVec4f::MulAdd(y, planeData.m_NormalY[i], dist);
+      dist = ezSimdVec4f::MulAdd(z, planeData.m_NormalZ[i], dist);
+
+      outside = outside || (dist > r);
+    }
+
+    return (!outside).GetBitmask();
+  }
+
+  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
+  {
+    SphereBlock block;
+    ezMemoryUtils::ZeroFill(&block, 1);
+
+    const ezVec4 centerAndRadius = ezSimdConversion::ToVec4(sphere.m_CenterAndRadius);
+    block.m_CenterX[0] = centerAndRadius.x;
+    block.m_CenterY[0] = centerAndRadius.y;
+    block.m_CenterZ[0] = centerAndRadius.z;
+    block.m_Radius[0] = centerAndRadius.w;
+
+    return (SphereFrustumIntersect(block, planeData) & 1) != 0;
+  }
+
+  /// Returns a mask with bit i set, if sphere i of the block overlaps the given sphere (splatted into x, y, z and radius vectors).
+  EZ_FORCE_INLINE ezUInt32 SphereSphereOverlap(const SphereBlock& block, const ezSimdVec4f& sphereX, const ezSimdVec4f& sphereY, const ezSimdVec4f& sphereZ,
+    const ezSimdVec4f& sphereR)
+  {
+    ezSimdVec4f x, y, z, r;
+    x.Load<4>(block.m_CenterX);
+    y.Load<4>(block.m_CenterY);
+    z.Load<4>(block.m_CenterZ);
+    r.Load<4>(block.m_Radius);
+
+    const ezSimdVec4f dx = x - sphereX;
+    const ezSimdVec4f dy = y - sphereY;
+    const ezSimdVec4f dz = z - sphereZ;
+    const ezSimdVec4f radius = r + sphereR;
+
+    ezSimdVec4f distSquared = dx.CompMul(dx);
+    distSquared = ezSimdVec4f::MulAdd(dy, dy, distSquared);
+    distSquared = ezSimdVec4f::MulAdd(dz, dz, distSquared);
+
+    return (distSquared < radius.CompMul(radius)).GetBitmask();
+  }
+
+  /// Returns a mask with bit i set, if sphere i of the block overlaps the given box (min and max splatted into separate vectors).
+  EZ_FORCE_INLINE ezUInt32 SphereBoxOverlap(const SphereBlock& block, const ezSimdVec4f (&boxMin)[3], const ezSimdVec4f (&boxMax)[3])
+  {
+    ezSimdVec4f x, y, z, r;
+    x.Load<4>(block.m_CenterX);
+    y.Load<4>(block.m_CenterY);
+    z.Load<4>(block.m_CenterZ);
+    r.Load<4>(block.m_Radius);
+
+    // distance of the sphere centers to the closest point in the box
+    const ezSimdVec4f dx = x.CompMax(boxMin[0]).CompMin(boxMax[0]) - x;
+    const ezSimdVec4f dy = y.CompMax(boxMin[1]).CompMin(boxMax[1]) - y;
+    const ezSimdVec4f dz = z.CompMax(boxMin[2]).CompMin(boxMax[2]) - z;
+
+    ezSimdVec4f distSquared = dx.CompMul(dx);
+    distSquared = ezSimdVec4f::MulAdd(dy, dy, distSquared);
+    distSquared = ezSimdVec4f::MulAdd(dz, dz, distSquared);
+
+    return (distSquared <= r.CompMul(r)).GetBitmask();
+  }
+} // namespace ezInternal
@@ -0,0 +1,732 @@
+#include <CorePCH.h>
+
+#include <Core/World/Implementation/SpatialSystemCulling.h>
+#include <Core/World/SpatialSystem_Octree.h>
+
+namespace
+{
+  using ezInternal::BoundingSphereArray;
+  using ezInternal::ForEachPassingSphere;
+  using ezInternal::PlaneData;
+  using ezInternal::SphereBlock;
+  using ezInternal::SphereBoxOverlap;
+  using ezInternal::SphereFrustumIntersect;
+  using ezInternal::SphereSphereOverlap;
+
+  struct NodeTestResult
+  {
+    enum Enum
+    {
+      Outside,
+      Intersecting,
+      Inside, ///< The node and all of its children are completely inside the query volume, so their objects don't need to be tested.
+    };
+  };
+
+  /// The frustum planes for testing the loose bounds of the octree nodes.
+  struct NodePlaneData
+  {
+    ezPlane m_Planes[ezFrustum::PLANE_COUNT];
+    float m_fAbsNormalSum[ezFrustum::PLANE_COUNT];
+
+    void SetFrustum(const ezFrustum& frustum)
+    {
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        m_Planes[i] = frustum.GetPlane(i);
+        m_fAbsNormalSum[i] = ezMath::Abs(m_Planes[i].m_vNormal.x) + ezMath::Abs(m_Planes[i].m_vNormal.y) + ezMath::Abs(m_Planes[i].m_vNormal.z);
+      }
+    }
+  };
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_Octree::SpatialUserData
+{
+  ezUInt32 m_uiNodeIndex = 0;
+  ezUInt32 m_uiDataIndex = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_Octree::Node
+{
+  EZ_DECLARE_POD_TYPE();
+
+  void Init(const ezVec3& vCenter, float fHalfExtents, ezUInt32 uiParent, ezUInt32 uiDepth)
+  {
+    m_vCenter = vCenter;
+    m_fHalfExtents = fHalfExtents;
+    m_uiParent = uiParent;
+    m_uiFirstChild = ezInvalidIndex;
+    m_uiDepth = uiDepth;
+    m_uiNumObjectsInSubTree = 0;
+    m_uiCategoryBitmask = 0;
+    m_uiObjectsIndex = ezInvalidIndex;
+  }
+
+  EZ_ALWAYS_INLINE bool HasChildren() const { return m_uiFirstChild != ezInvalidIndex; }
+  EZ_ALWAYS_INLINE bool HasObjects() const { return m_uiObjectsIndex != ezInvalidIndex; }
+
+  /// \brief Returns whether the given position is inside the cell of this node. The loose bounds of the node are twice as large.
+  EZ_ALWAYS_INLINE bool IsInCell(const ezVec3& vPosition) const
+  {
+    const ezVec3 vDiff = vPosition - m_vCenter;
+    return ezMath::Abs(vDiff.x) <= m_fHalfExtents && ezMath::Abs(vDiff.y) <= m_fHalfExtents && ezMath::Abs(vDiff.z) <= m_fHalfExtents;
+  }
+
+  /// \brief Returns whether an object of the given radius can be stored in the children of this node.
+  EZ_ALWAYS_INLINE bool FitsIntoChild(float fRadius) const { return fRadius <= m_fHalfExtents * 0.5f; }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetChildIndex(const ezVec3& vPosition) const
+  {
+    return (vPosition.x >= m_vCenter.x ? 1 : 0) | (vPosition.y >= m_vCenter.y ? 2 : 0) | (vPosition.z >= m_vCenter.z ? 4 : 0);
+  }
+
+  EZ_ALWAYS_INLINE ezVec3 GetChildCenter(ezUInt32 uiChildIndex) const
+  {
+    const float fOffset = m_fHalfExtents * 0.5f;
+    return m_vCenter + ezVec3((uiChildIndex & 1) ? fOffset : -fOffset, (uiChildIndex & 2) ? fOffset : -fOffset, (uiChildIndex & 4) ? fOffset : -fOffset);
+  }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetLooseBounds() const
+  {
+    const ezSimdVec4f center = ezSimdConversion::ToVec3(m_vCenter);
+    const ezSimdVec4f looseHalfExtents(m_fHalfExtents * 2.0f);
+    return ezSimdBBox(center - looseHalfExtents, center + looseHalfExtents);
+  }
+
+  EZ_ALWAYS_INLINE ezBoundingBox GetBoundingBox() const
+  {
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(m_vCenter, ezVec3(m_fHalfExtents * 2.0f));
+    return box;
+  }
+
+  NodeTestResult::Enum TestFrustum(const NodePlaneData& planeData) const
+  {
+    // the loose bounds are a cube, so the distance of its nearest corner to a plane only depends on the absolute values of the plane normal
+    const float fLooseHalfExtents = m_fHalfExtents * 2.0f;
+    NodeTestResult::Enum result = NodeTestResult::Inside;
+
+    for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+    {
+      const float fDist = planeData.m_Planes[i].GetDistanceTo(m_vCenter);
+      const float fRadius = fLooseHalfExtents * planeData.m_fAbsNormalSum[i];
+
+      if (fDist > fRadius)
+        return NodeTestResult::Outside;
+
+      if (fDist > -fRadius)
+        result = NodeTestResult::Intersecting;
+    }
+
+    return result;
+  }
+
+  ezVec3 m_vCenter;
+  float m_fHalfExtents;
+
+  ezUInt32 m_uiParent;
+  ezUInt32 m_uiFirstChild;
+  ezUInt32 m_uiDepth;
+  ezUInt32 m_uiNumObjectsInSubTree;
+  ezUInt32 m_uiCategoryBitmask; ///< Categories of all objects in this node and its children. Only reset when the children are merged.
+  ezUInt32 m_uiObjectsIndex;    ///< Index into m_NodeObjects, ezInvalidIndex if the node doesn't contain objects itself.
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_Octree::NodeObjects
+{
+  NodeObjects(ezAllocatorBase* pAlignedAllocator, ezAllocatorBase* pAllocator)
+    : m_BoundingSpheres(pAlignedAllocator)
+    , m_DataPointers(pAllocator)
+    , m_CategoryBitmasks(pAllocator)
+  {
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_DataPointers.GetCount(); }
+
+  void Reserve(ezUInt32 uiCount)
+  {
+    m_BoundingSpheres.Reserve(uiCount);
+    m_DataPointers.Reserve(uiCount);
+    m_CategoryBitmasks.Reserve(uiCount);
+  }
+
+  EZ_FORCE_INLINE void PushBack(ezSpatialData* pData)
+  {
+    m_BoundingSpheres.PushBack(pData->m_Bounds.GetSphere());
+    m_DataPointers.PushBack(pData);
+    m_CategoryBitmasks.PushBack(pData->m_uiCategoryBitmask);
+  }
+
+  EZ_FORCE_INLINE void RemoveAtAndSwap(ezUInt32 uiIndex)
+  {
+    m_BoundingSpheres.RemoveAtAndSwap(uiIndex);
+    m_DataPointers.RemoveAtAndSwap(uiIndex);
+    m_CategoryBitmasks.RemoveAtAndSwap(uiIndex);
+  }
+
+  void Clear()
+  {
+    m_BoundingSpheres.Clear();
+    m_DataPointers.Clear();
+    m_CategoryBitmasks.Clear();
+  }
+
+  BoundingSphereArray m_BoundingSpheres;
+  ezDynamicArray<ezSpatialData*> m_DataPointers;
+  ezDynamicArray<ezUInt32> m_CategoryBitmasks;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_Octree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_Octree::ezSpatialSystem_Octree(float fWorldSize /*= 1024 * 1024.0f*/, ezUInt32 uiMaxObjectsPerNode /*= 64*/, ezUInt32 uiMaxDepth /*= 20*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_uiMaxObjectsPerNode(ezMath::Max(uiMaxObjectsPerNode, 2u))
+  , m_uiMaxDepth(uiMaxDepth)
+  , m_Nodes(&m_Allocator)
+  , m_FreeChildBlocks(&m_Allocator)
+  , m_NodeObjects(&m_Allocator)
+  , m_FreeNodeObjects(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_Octree::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
+
+  m_Nodes.ExpandAndGetRef().Init(ezVec3::ZeroVector(), fWorldSize * 0.5f, ezInvalidIndex, 0);
+}
+
+ezSpatialSystem_Octree::~ezSpatialSystem_Octree() = default;
+
+ezResult ezSpatialSystem_Octree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  ezSpatialData* pData;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData) || pData->m_Flags.IsSet(ezSpatialData::Flags::AlwaysVisible))
+    return EZ_FAILURE;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  out_BoundingBox = m_Nodes[pUserData->m_uiNodeIndex].GetBoundingBox();
+  return EZ_SUCCESS;
+}
+
+void ezSpatialSystem_Octree::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory) const
+{
+  const ezUInt32 uiCategoryBitmask = filterCategory == ezInvalidSpatialDataCategory ? 0xFFFFFFFF : filterCategory.GetBitmask();
+
+  ForEachNode(
+    uiCategoryBitmask, [](const Node& node) { return NodeTestResult::Intersecting; },
+    [&](const Node& node, const NodeObjects& objects, bool bFullyInside) {
+      for (ezUInt32 uiCategories : objects.m_CategoryBitmasks)
+      {
+        if ((uiCategories & uiCategoryBitmask) != 0)
+        {
+          out_BoundingBoxes.ExpandAndGetRef() = node.GetBoundingBox();
+          break;
+        }
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+}
+
+void ezSpatialSystem_Octree::FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+  QueryStats* pStats) const
+{
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+
+  const ezSimdVec4f sphereX = simdSphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+  const ezSimdVec4f sphereY = simdSphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+  const ezSimdVec4f sphereZ = simdSphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+  const ezSimdVec4f sphereR = simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+
+  auto nodeTestFunc = [&](const Node& node) {
+    return node.GetLooseBounds().Overlaps(simdSphere) ? NodeTestResult::Intersecting : NodeTestResult::Outside;
+  };
+
+  ForEachNode(uiCategoryBitmask, nodeTestFunc, [&](const Node& node, const NodeObjects& objects, bool bFullyInside) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += objects.GetCount();
+    }
+#endif
+
+    auto testFunc = [&](const SphereBlock& block) { return SphereSphereOverlap(block, sphereX, sphereY, sphereZ, sphereR); };
+
+    auto visitFunc = [&](ezUInt32 i) {
+      if ((objects.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        return ezVisitorExecution::Continue;
+
+      if (callback(objects.m_DataPointers[i]->m_pObject) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+
+      return ezVisitorExecution::Continue;
+    };
+
+    return ForEachPassingSphere(objects.m_BoundingSpheres, testFunc, visitFunc);
+  });
+}
+
+void ezSpatialSystem_Octree::FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  const ezSimdVec4f boxMin[3] = {simdBox.m_Min.Get<ezSwizzle::XXXX>(), simdBox.m_Min.Get<ezSwizzle::YYYY>(), simdBox.m_Min.Get<ezSwizzle::ZZZZ>()};
+  const ezSimdVec4f boxMax[3] = {simdBox.m_Max.Get<ezSwizzle::XXXX>(), simdBox.m_Max.Get<ezSwizzle::YYYY>(), simdBox.m_Max.Get<ezSwizzle::ZZZZ>()};
+
+  auto nodeTestFunc = [&](const Node& node) {
+    return node.GetLooseBounds().Overlaps(simdBox) ? NodeTestResult::Intersecting : NodeTestResult::Outside;
+  };
+
+  ForEachNode(uiCategoryBitmask, nodeTestFunc, [&](const Node& node, const NodeObjects& objects, bool bFullyInside) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += objects.GetCount();
+    }
+#endif
+
+    auto testFunc = [&](const SphereBlock& block) { return SphereBoxOverlap(block, boxMin, boxMax); };
+
+    auto visitFunc = [&](ezUInt32 i) {
+      if ((objects.m_CategoryBitmasks[i] & uiCategoryBitmask) == 0)
+        return ezVisitorExecution::Continue;
+
+      const ezSpatialData* pData = objects.m_DataPointers[i];
+      if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
+        return ezVisitorExecution::Continue;
+
+      if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+        return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      if (pStats != nullptr)
+      {
+        pStats->m_uiNumObjectsPassed++;
+      }
+#endif
+
+      return ezVisitorExecution::Continue;
+    };
+
+    return ForEachPassingSphere(objects.m_BoundingSpheres, testFunc, visitFunc);
+  });
+}
+
+void ezSpatialSystem_Octree::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  QueryStats* pStats) const
+{
+  PlaneData planeData;
+  planeData.SetFrustum(frustum);
+
+  NodePlaneData nodePlaneData;
+  nodePlaneData.SetFrustum(frustum);
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  ForEachNode(
+    uiCategoryBitmask, [&](const Node& node) { return node.TestFrustum(nodePlaneData); },
+    [&](const Node& node, const NodeObjects& objects, bool bFullyInside) {
+      const ezUInt32 uiNumObjects = objects.GetCount();
+      uiNumObjectsTested += uiNumObjects;
+
+      if (bFullyInside)
+      {
+        for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+        {
+          if ((objects.m_CategoryBitmasks[i] & uiCategoryBitmask) != 0)
+          {
+            out_Objects.PushBack(objects.m_DataPointers[i]->m_pObject);
+            ++uiNumObjectsPassed;
+          }
+        }
+      }
+      else
+      {
+        ForEachPassingSphere(
+          objects.m_BoundingSpheres, [&](const SphereBlock& block) { return SphereFrustumIntersect(block, planeData); },
+          [&](ezUInt32 i) {
+            if ((objects.m_CategoryBitmasks[i] & uiCategoryBitmask) != 0)
+            {
+              out_Objects.PushBack(objects.m_DataPointers[i]->m_pObject);
+              ++uiNumObjectsPassed;
+            }
+
+            return ezVisitorExecution::Continue;
+          });
+      }
+
+      return ezVisitorExecution::Continue;
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_Octree::SpatialDataAdded(ezSpatialData* pData)
+{
+  const ezUInt32 uiNodeIndex = FindNode(pData->m_Bounds.GetSphere());
+  AddDataToNode(uiNodeIndex, pData);
+
+  const Node& node = m_Nodes[uiNodeIndex];
+  if (!node.HasChildren() && m_NodeObjects[node.m_uiObjectsIndex]->GetCount() > m_uiMaxObjectsPerNode && node.m_uiDepth < m_uiMaxDepth)
+  {
+    SplitNode(uiNodeIndex);
+  }
+}
+
+void ezSpatialSystem_Octree::SpatialDataRemoved(ezSpatialData* pData)
+{
+  RemoveDataFromNode(pData);
+}
+
+void ezSpatialSystem_Octree::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+  if (pData->m_uiCategoryBitmask != uiOldCategoryBitmask)
+  {
+    // The categories are stored next to the bounding spheres, so a changed category doesn't require re-inserting the object.
+    m_NodeObjects[m_Nodes[pUserData->m_uiNodeIndex].m_uiObjectsIndex]->m_CategoryBitmasks[pUserData->m_uiDataIndex] = pData->m_uiCategoryBitmask;
+
+    for (ezUInt32 uiNodeIndex = pUserData->m_uiNodeIndex; uiNodeIndex != ezInvalidIndex; uiNodeIndex = m_Nodes[uiNodeIndex].m_uiParent)
+    {
+      m_Nodes[uiNodeIndex].m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+    }
+  }
+
+  if (pData->m_Bounds == oldBounds)
+    return;
+
+  const ezSimdBSphere sphere = pData->m_Bounds.GetSphere();
+  if (FindNode(sphere) == pUserData->m_uiNodeIndex)
+  {
+    m_NodeObjects[m_Nodes[pUserData->m_uiNodeIndex].m_uiObjectsIndex]->m_BoundingSpheres.Set(pUserData->m_uiDataIndex, sphere);
+  }
+  else
+  {
+    SpatialDataRemoved(pData);
+    SpatialDataAdded(pData);
+  }
+}
+
+void ezSpatialSystem_Octree::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
+  m_NodeObjects[m_Nodes[pUserData->m_uiNodeIndex].m_uiObjectsIndex]->m_DataPointers[pUserData->m_uiDataIndex] = pNewPtr;
+}
+
+ezUInt32 ezSpatialSystem_Octree::FindNode(const ezSimdBSphere& sphere) const
+{
+  const ezVec4 centerAndRadius = ezSimdConversion::ToVec4(sphere.m_CenterAndRadius);
+  const ezVec3 vCenter = centerAndRadius.GetAsVec3();
+
+  // objects outside of the octree are stored in the root node
+  if (!m_Nodes[0].IsInCell(vCenter))
+    return 0;
+
+  ezUInt32 uiNodeIndex = 0;
+  while (true)
+  {
+    const Node& node = m_Nodes[uiNodeIndex];
+    if (!node.HasChildren() || !node.FitsIntoChild(centerAndRadius.w))
+      return uiNodeIndex;
+
+    uiNodeIndex = node.m_uiFirstChild + node.GetChildIndex(vCenter);
+  }
+}
+
+void ezSpatialSystem_Octree::AddDataToNode(ezUInt32 uiNodeIndex, ezSpatialData* pData)
+{
+  AppendData(uiNodeIndex, pData);
+
+  for (; uiNodeIndex != ezInvalidIndex; uiNodeIndex = m_Nodes[uiNodeIndex].m_uiParent)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    node.m_uiNumObjectsInSubTree++;
+    node.m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+  }
+}
+
+void ezSpatialSystem_Octree::RemoveDataFromNode(ezSpatialData* pData)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  const ezUInt32 uiDataNodeIndex = pUserData->m_uiNodeIndex;
+
+  RemoveDataAtIndex(uiDataNodeIndex, pUserData->m_uiDataIndex);
+
+  // Merge the highest node whose sub-tree became small enough. Only merging at half the split threshold
+  // prevents nodes from being split and merged over and over again when objects move around.
+  ezUInt32 uiMergeNodeIndex = ezInvalidIndex;
+
+  for (ezUInt32 uiNodeIndex = uiDataNodeIndex; uiNodeIndex != ezInvalidIndex; uiNodeIndex = m_Nodes[uiNodeIndex].m_uiParent)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    node.m_uiNumObjectsInSubTree--;
+
+    if (node.HasChildren() && node.m_uiNumObjectsInSubTree <= m_uiMaxObjectsPerNode / 2)
+    {
+      uiMergeNodeIndex = uiNodeIndex;
+    }
+  }
+
+  if (uiMergeNodeIndex != ezInvalidIndex)
+  {
+    MergeChildren(uiMergeNodeIndex);
+  }
+}
+
+ezSpatialSystem_Octree::NodeObjects& ezSpatialSystem_Octree::GetOrCreateNodeObjects(ezUInt32 uiNodeIndex)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+
+  if (!node.HasObjects())
+  {
+    // reuse the storage of nodes that became empty, it still has the memory allocated
+    if (!m_FreeNodeObjects.IsEmpty())
+    {
+      node.m_uiObjectsIndex = m_FreeNodeObjects.PeekBack();
+      m_FreeNodeObjects.PopBack();
+    }
+    else
+    {
+      node.m_uiObjectsIndex = m_NodeObjects.GetCount();
+      m_NodeObjects.PushBack(EZ_NEW(&m_Allocator, NodeObjects, &m_AlignedAllocator, &m_Allocator));
+    }
+  }
+
+  return *m_NodeObjects[node.m_uiObjectsIndex];
+}
+
+void ezSpatialSystem_Octree::AppendData(ezUInt32 uiNodeIndex, ezSpatialData* pData)
+{
+  NodeObjects& objects = GetOrCreateNodeObjects(uiNodeIndex);
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  pUserData->m_uiNodeIndex = uiNodeIndex;
+  pUserData->m_uiDataIndex = objects.GetCount();
+
+  objects.PushBack(pData);
+}
+
+void ezSpatialSystem_Octree::RemoveDataAtIndex(ezUInt32 uiNodeIndex, ezUInt32 uiDataIndex)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+  NodeObjects& objects = *m_NodeObjects[node.m_uiObjectsIndex];
+
+  if (uiDataIndex != objects.GetCount() - 1)
+  {
+    ezSpatialData* pLastData = objects.m_DataPointers.PeekBack();
+    reinterpret_cast<SpatialUserData*>(&pLastData->m_uiUserData[0])->m_uiDataIndex = uiDataIndex;
+  }
+
+  objects.RemoveAtAndSwap(uiDataIndex);
+
+  if (objects.GetCount() == 0)
+  {
+    ReleaseNodeObjects(node);
+  }
+}
+
+void ezSpatialSystem_Octree::ReleaseNodeObjects(Node& node)
+{
+  m_NodeObjects[node.m_uiObjectsIndex]->Clear();
+  m_FreeNodeObjects.PushBack(node.m_uiObjectsIndex);
+  node.m_uiObjectsIndex = ezInvalidIndex;
+}
+
+void ezSpatialSystem_Octree::SplitNode(ezUInt32 uiNodeIndex)
+{
+  ezUInt32 uiFirstChild = 0;
+  if (!m_FreeChildBlocks.IsEmpty())
+  {
+    uiFirstChild = m_FreeChildBlocks.PeekBack();
+    m_FreeChildBlocks.PopBack();
+  }
+  else
+  {
+    uiFirstChild = m_Nodes.GetCount();
+    m_Nodes.SetCountUninitialized(uiFirstChild + 8);
+  }
+
+  Node& node = m_Nodes[uiNodeIndex];
+  node.m_uiFirstChild = uiFirstChild;
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    m_Nodes[uiFirstChild + i].Init(node.GetChildCenter(i), node.m_fHalfExtents * 0.5f, uiNodeIndex, node.m_uiDepth + 1);
+  }
+
+  // Count the objects of every child first, so their storage only needs to be allocated once.
+  // Objects that are too large or outside of the octree stay where they are.
+  const bool bIsRoot = uiNodeIndex == 0;
+  NodeObjects& objects = *m_NodeObjects[node.m_uiObjectsIndex];
+  ezHybridArray<ezUInt32, 256> childIndices;
+  childIndices.SetCountUninitialized(objects.GetCount());
+
+  ezUInt32 uiNumObjectsPerChild[8] = {};
+
+  for (ezUInt32 i = 0; i < objects.GetCount(); ++i)
+  {
+    const ezVec4 centerAndRadius = ezSimdConversion::ToVec4(objects.m_DataPointers[i]->m_Bounds.m_CenterAndRadius);
+    const ezVec3 vCenter = centerAndRadius.GetAsVec3();
+
+    if (!node.FitsIntoChild(centerAndRadius.w) || (bIsRoot && !node.IsInCell(vCenter)))
+    {
+      childIndices[i] = ezInvalidIndex;
+      continue;
+    }
+
+    childIndices[i] = node.GetChildIndex(vCenter);
+    uiNumObjectsPerChild[childIndices[i]]++;
+  }
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    if (uiNumObjectsPerChild[i] > 0)
+    {
+      GetOrCreateNodeObjects(uiFirstChild + i).Reserve(uiNumObjectsPerChild[i]);
+    }
+  }
+
+  // Move the objects down, back to front so that removing them doesn't change the indices of the objects that still need to be moved.
+  // The number of objects in the sub-tree of the node and its parents stays the same.
+  for (ezUInt32 i = objects.GetCount(); i-- > 0;)
+  {
+    if (childIndices[i] == ezInvalidIndex)
+      continue;
+
+    ezSpatialData* pData = objects.m_DataPointers[i];
+    const ezUInt32 uiChildNodeIndex = uiFirstChild + childIndices[i];
+
+    AppendData(uiChildNodeIndex, pData);
+    RemoveDataAtIndex(uiNodeIndex, i);
+
+    Node& child = m_Nodes[uiChildNodeIndex];
+    child.m_uiNumObjectsInSubTree++;
+    child.m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+  }
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    const Node& child = m_Nodes[uiFirstChild + i];
+    if (child.m_uiNumObjectsInSubTree > m_uiMaxObjectsPerNode && child.m_uiDepth < m_uiMaxDepth)
+    {
+      SplitNode(uiFirstChild + i);
+    }
+  }
+}
+
+void ezSpatialSystem_Octree::MergeChildren(ezUInt32 uiNodeIndex)
+{
+  const ezUInt32 uiFirstChild = m_Nodes[uiNodeIndex].m_uiFirstChild;
+
+  GetOrCreateNodeObjects(uiNodeIndex).Reserve(m_Nodes[uiNodeIndex].m_uiNumObjectsInSubTree);
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    if (m_Nodes[uiFirstChild + i].HasChildren())
+    {
+      MergeChildren(uiFirstChild + i);
+    }
+
+    Node& child = m_Nodes[uiFirstChild + i];
+    if (child.HasObjects())
+    {
+      for (ezSpatialData* pData : m_NodeObjects[child.m_uiObjectsIndex]->m_DataPointers)
+      {
+        AppendData(uiNodeIndex, pData);
+      }
+
+      ReleaseNodeObjects(child);
+    }
+  }
+
+  Node& node = m_Nodes[uiNodeIndex];
+  node.m_uiFirstChild = ezInvalidIndex;
+  m_FreeChildBlocks.PushBack(uiFirstChild);
+
+  // recompute the categories, this removes the bits of objects that have been deleted in the meantime
+  node.m_uiCategoryBitmask = 0;
+
+  const NodeObjects& objects = *m_NodeObjects[node.m_uiObjectsIndex];
+  for (ezUInt32 uiCategories : objects.m_CategoryBitmasks)
+  {
+    node.m_uiCategoryBitmask |= uiCategories;
+  }
+
+  if (objects.GetCount() == 0)
+  {
+    ReleaseNodeObjects(node);
+  }
+}
+
+template <typename NodeTestFunctor, typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_Octree::ForEachNode(ezUInt32 uiCategoryBitmask, NodeTestFunctor nodeTestFunc, Functor func) const
+{
+  enum
+  {
+    FULLY_INSIDE_FLAG = EZ_BIT(31)
+  };
+
+  // The root is always visited, since it also contains all objects outside of the octree bounds.
+  ezHybridArray<ezUInt32, 64> nodeStack;
+  nodeStack.PushBack(0);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezUInt32 uiStackEntry = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const Node& node = m_Nodes[uiStackEntry & ~FULLY_INSIDE_FLAG];
+    if (node.m_uiNumObjectsInSubTree == 0 || (node.m_uiCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    bool bFullyInside = (uiStackEntry & FULLY_INSIDE_FLAG) != 0;
+    if (!bFullyInside && node.m_uiParent != ezInvalidIndex)
+    {
+      const NodeTestResult::Enum result = nodeTestFunc(node);
+      if (result == NodeTestResult::Outside)
+        continue;
+
+      bFullyInside = result == NodeTestResult::Inside;
+    }
+
+    if (node.HasObjects())
+    {
+      if (func(node, *m_NodeObjects[node.m_uiObjectsIndex], bFullyInside) == ezVisitorExecution::Stop)
+        return;
+    }
+
+    if (node.HasChildren())
+    {
+      for (ezUInt32 i = 0; i < 8; ++i)
+      {
+        nodeStack.PushBack((node.m_uiFirstChild + i) | (bFullyInside ? FULLY_INSIDE_FLAG : 0));
+      }
+    }
+  }
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_Octree);
@@ -1,11 +1,20 @@
 #include <CorePCH.h>
 
+#include <Core/World/Implementation/SpatialSystemCulling.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Containers/HashSet.h>
-#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 namespace
 {
+  using ezInternal::BoundingSphereArray;
+  using ezInternal::ForEachPassingSphere;
+  using ezInternal::PlaneData;
+  using ezInternal::SphereBlock;
+  using ezInternal::SphereBoxOverlap;
+  using ezInternal::SphereFrustumIntersect;
+  using ezInternal::SphereSphereOverlap;
+
   enum
   {
     MAX_CELL_INDEX = (1 << 20) - 1,
@@ -29,6 +38,15 @@ namespace
     return (sx << 42) | (sy << 21) | sz;
   }
 
+  EZ_ALWAYS_INLINE ezSimdVec4i GetCellIndex(ezUInt64 cellKey)
+  {
+    ezInt32 x = static_cast<ezInt32>((cellKey >> 42) & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+    ezInt32 y = static_cast<ezInt32>((cellKey >> 21) & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+    ezInt32 z = static_cast<ezInt32>(cellKey & CELL_INDEX_MASK) - MAX_CELL_INDEX;
+
+    return ezSimdVec4i(x, y, z);
+  }
+
   EZ_ALWAYS_INLINE ezSimdBBox ComputeCellBoundingBox(const ezSimdVec4i& cellIndex, const ezSimdVec4i& iCellSize)
   {
     ezSimdVec4i overlapSize = iCellSize >> 2;
@@ -39,86 +57,6 @@ namespace
 
     return ezSimdBBox(bmin, bmax);
   }
-
-  struct PlaneData
-  {
-    ezSimdVec4f m_x0x1x2x3;
-    ezSimdVec4f m_y0y1y2y3;
-    ezSimdVec4f m_z0z1z2z3;
-    ezSimdVec4f m_w0w1w2w3;
-
-    ezSimdVec4f m_x4x5x4x5;
-    ezSimdVec4f m_y4y5y4y5;
-    ezSimdVec4f m_z4z5z4z5;
-    ezSimdVec4f m_w4w5w4w5;
-  };
-
-  EZ_FORCE_INLINE bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const PlaneData& planeData)
-  {
-    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
-    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
-    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
-    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
-
-    ezSimdVec4f dot_0123;
-    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y0y1y2y3, dot_0123);
-    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z0z1z2z3, dot_0123);
-
-    ezSimdVec4f dot_4545;
-    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, planeData.m_y4y5y4y5, dot_4545);
-    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, planeData.m_z4z5z4z5, dot_4545);
-
-    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
-    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
-    return (cmp_0123 || cmp_4545).NoneSet<4>();
-  }
-
-  EZ_FORCE_INLINE ezUInt32 SphereFrustumIntersect(const ezSimdBSphere& sphereA, const ezSimdBSphere& sphereB, const PlaneData& planeData)
-  {
-    ezSimdVec4f posA_xxxx(sphereA.m_CenterAndRadius.x());
-    ezSimdVec4f posA_yyyy(sphereA.m_CenterAndRadius.y());
-    ezSimdVec4f posA_zzzz(sphereA.m_CenterAndRadius.z());
-    ezSimdVec4f posA_rrrr(sphereA.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotA_0123;
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_yyyy, planeData.m_y0y1y2y3, dotA_0123);
-    dotA_0123 = ezSimdVec4f::MulAdd(posA_zzzz, planeData.m_z0z1z2z3, dotA_0123);
-
-    ezSimdVec4f posB_xxxx(sphereB.m_CenterAndRadius.x());
-    ezSimdVec4f posB_yyyy(sphereB.m_CenterAndRadius.y());
-    ezSimdVec4f posB_zzzz(sphereB.m_CenterAndRadius.z());
-    ezSimdVec4f posB_rrrr(sphereB.m_CenterAndRadius.w());
-
-    ezSimdVec4f dotB_0123;
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_xxxx, planeData.m_x0x1x2x3, planeData.m_w0w1w2w3);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_yyyy, planeData.m_y0y1y2y3, dotB_0123);
-    dotB_0123 = ezSimdVec4f::MulAdd(posB_zzzz, planeData.m_z0z1z2z3, dotB_0123);
-
-    ezSimdVec4f posAB_xxxx = posA_xxxx.GetCombined<ezSwizzle::XXXX>(posB_xxxx);
-    ezSimdVec4f posAB_yyyy = posA_yyyy.GetCombined<ezSwizzle::XXXX>(posB_yyyy);
-    ezSimdVec4f posAB_zzzz = posA_zzzz.GetCombined<ezSwizzle::XXXX>(posB_zzzz);
-    ezSimdVec4f posAB_rrrr = posA_rrrr.GetCombined<ezSwizzle::XXXX>(posB_rrrr);
-
-    ezSimdVec4f dot_A45B45;
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_xxxx, planeData.m_x4x5x4x5, planeData.m_w4w5w4w5);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_yyyy, planeData.m_y4y5y4y5, dot_A45B45);
-    dot_A45B45 = ezSimdVec4f::MulAdd(posAB_zzzz, planeData.m_z4z5z4z5, dot_A45B45);
-
-    ezSimdVec4b cmp_A0123 = dotA_0123 > posA_rrrr;
-    ezSimdVec4b cmp_B0123 = dotB_0123 > posB_rrrr;
-    ezSimdVec4b cmp_A45B45 = dot_A45B45 > posAB_rrrr;
-
-    ezSimdVec4b cmp_A45 = cmp_A45B45.Get<ezSwizzle::XYXY>();
-    ezSimdVec4b cmp_B45 = cmp_A45B45.Get<ezSwizzle::ZWZW>();
-
-    ezUInt32 result = (cmp_A0123 || cmp_A45).NoneSet<4>() ? 1 : 0;
-    result |= (cmp_B0123 || cmp_B45).NoneSet<4>() ? 2 : 0;
-
-    return result;
-  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -150,7 +88,7 @@ struct ezSpatialSystem_RegularGrid::Cell
 
     while (m_BoundingSpheres.GetCount() <= highestCategory)
     {
-      m_BoundingSpheres.PushBack(ezDynamicArray<ezSimdBSphere>(pAlignedAllocator));
+      m_BoundingSpheres.PushBack(BoundingSphereArray(pAlignedAllocator));
       m_DataPointers.PushBack(ezDynamicArray<ezSpatialData*>(m_DataPointers.GetAllocator()));
     }
 
@@ -253,7 +191,7 @@ struct ezSpatialSystem_RegularGrid::Cell
     ezUInt32 dataIndex = pUserData->m_uiCachedDataIndex;
     EZ_ASSERT_DEBUG(pUserData->m_uiCachedCategory == category, "Implementation error");
 
-    m_BoundingSpheres[category][dataIndex] = pData->m_Bounds.GetSphere();
+    m_BoundingSpheres[category].Set(dataIndex, pData->m_Bounds.GetSphere());
 
     while (mask > 0)
     {
@@ -263,10 +201,35 @@ struct ezSpatialSystem_RegularGrid::Cell
       const bool found = m_DataPointersToIndex[category].TryGetValue(pData, dataIndex);
       EZ_ASSERT_DEBUG(found, "Implementation error");
 
-      m_BoundingSpheres[category][dataIndex] = pData->m_Bounds.GetSphere();
+      m_BoundingSpheres[category].Set(dataIndex, pData->m_Bounds.GetSphere());
     }
   }
 
+  /// Writes all objects of the given categories whose bounding sphere intersects the frustum to pOutObjects and returns their number.
+  EZ_FORCE_INLINE ezUInt32 FindVisibleObjects(ezUInt32 uiCategoryBitmask, const PlaneData& planeData, const ezGameObject** pOutObjects) const
+  {
+    ezUInt32 uiNumObjectsPassed = 0;
+
+    ezUInt32 mask = uiCategoryBitmask;
+    while (mask > 0)
+    {
+      ezUInt32 category = ezMath::FirstBitLow(mask);
+      mask &= mask - 1;
+
+      auto& dataPointers = m_DataPointers[category];
+
+      ForEachPassingSphere(
+        m_BoundingSpheres[category], [&](const SphereBlock& block) { return SphereFrustumIntersect(block, planeData); },
+        [&](ezUInt32 i) {
+          pOutObjects[uiNumObjectsPassed] = dataPointers[i]->m_pObject;
+          ++uiNumObjectsPassed;
+          return ezVisitorExecution::Continue;
+        });
+    }
+
+    return uiNumObjectsPassed;
+  }
+
   EZ_ALWAYS_INLINE ezBoundingBox GetBoundingBox() const
   {
     return ezSimdConversion::ToBBoxSphere(m_Bounds).GetBox();
@@ -275,7 +238,7 @@ struct ezSpatialSystem_RegularGrid::Cell
   ezSimdBBoxSphere m_Bounds;
   ezUInt32 m_uiCategoryBitmask = 0;
 
-  ezHybridArray<ezDynamicArray<ezSimdBSphere>, 4> m_BoundingSpheres;
+  ezHybridArray<BoundingSphereArray, 4> m_BoundingSpheres;
   ezHybridArray<ezDynamicArray<ezSpatialData*>, 4> m_DataPointers;
   ezHybridArray<ezHashTable<ezSpatialData*, ezUInt32>, 4> m_DataPointersToIndex;
 };
@@ -355,6 +318,11 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphereInternal(const ezBoundingSp
   ezSimdBBox simdBox;
   simdBox.SetCenterAndHalfExtents(simdSphere.m_CenterAndRadius, simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
 
+  const ezSimdVec4f sphereX = simdSphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+  const ezSimdVec4f sphereY = simdSphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+  const ezSimdVec4f sphereZ = simdSphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+  const ezSimdVec4f sphereR = simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBBox cellBox = cell.m_Bounds.GetBox();
     if (!cellBox.Overlaps(simdSphere))
@@ -369,26 +337,21 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphereInternal(const ezBoundingSp
       auto& boundingSpheres = cell.m_BoundingSpheres[category];
       auto& dataPointers = cell.m_DataPointers[category];
 
-      const ezUInt32 numSpheres = boundingSpheres.GetCount();
-
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
       if (pStats != nullptr)
       {
-        pStats->m_uiNumObjectsTested += numSpheres;
+        pStats->m_uiNumObjectsTested += boundingSpheres.GetCount();
       }
 #endif
 
-      for (ezUInt32 i = 0; i < numSpheres; ++i)
-      {
-        auto& objectSphere = boundingSpheres[i];
-        if (!simdSphere.Overlaps(objectSphere))
-          continue;
+      auto testFunc = [&](const SphereBlock& block) { return SphereSphereOverlap(block, sphereX, sphereY, sphereZ, sphereR); };
 
+      auto visitFunc = [&](ezUInt32 i) {
         const ezSpatialData* pData = dataPointers[i];
 
         // TODO: The return value has to have more control
         if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
-          return;
+          return ezVisitorExecution::Stop;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
         if (pStats != nullptr)
@@ -396,7 +359,12 @@ void ezSpatialSystem_RegularGrid::FindObjectsInSphereInternal(const ezBoundingSp
           pStats->m_uiNumObjectsPassed++;
         }
 #endif
-      }
+
+        return ezVisitorExecution::Continue;
+      };
+
+      if (ForEachPassingSphere(boundingSpheres, testFunc, visitFunc) == ezVisitorExecution::Stop)
+        return;
     }
   });
 }
@@ -405,6 +373,9 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
 {
   ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
 
+  const ezSimdVec4f boxMin[3] = {simdBox.m_Min.Get<ezSwizzle::XXXX>(), simdBox.m_Min.Get<ezSwizzle::YYYY>(), simdBox.m_Min.Get<ezSwizzle::ZZZZ>()};
+  const ezSimdVec4f boxMax[3] = {simdBox.m_Max.Get<ezSwizzle::XXXX>(), simdBox.m_Max.Get<ezSwizzle::YYYY>(), simdBox.m_Max.Get<ezSwizzle::ZZZZ>()};
+
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezUInt32 mask = uiFilteredCategoryBitmask;
     while (mask > 0)
@@ -415,28 +386,23 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
       auto& boundingSpheres = cell.m_BoundingSpheres[category];
       auto& dataPointers = cell.m_DataPointers[category];
 
-      const ezUInt32 numSpheres = boundingSpheres.GetCount();
-
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
       if (pStats != nullptr)
       {
-        pStats->m_uiNumObjectsTested += numSpheres;
+        pStats->m_uiNumObjectsTested += boundingSpheres.GetCount();
       }
 #endif
 
-      for (ezUInt32 i = 0; i < numSpheres; ++i)
-      {
-        auto& objectSphere = boundingSpheres[i];
-        if (!simdBox.Overlaps(objectSphere))
-          continue;
+      auto testFunc = [&](const SphereBlock& block) { return SphereBoxOverlap(block, boxMin, boxMax); };
 
+      auto visitFunc = [&](ezUInt32 i) {
         const ezSpatialData* pData = dataPointers[i];
         if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
-          continue;
+          return ezVisitorExecution::Continue;
 
         // TODO: The return value has to have more control
         if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
-          return;
+          return ezVisitorExecution::Stop;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
         if (pStats != nullptr)
@@ -444,7 +410,12 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
           pStats->m_uiNumObjectsPassed++;
         }
 #endif
-      }
+
+        return ezVisitorExecution::Continue;
+      };
+
+      if (ForEachPassingSphere(boundingSpheres, testFunc, visitFunc) == ezVisitorExecution::Stop)
+        return;
     }
   });
 }
@@ -465,110 +436,104 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
   simdBox.SetFromPoints(simdCornerPoints, 8);
 
   PlaneData planeData;
+  planeData.SetFrustum(frustum);
+
+  // First find all cells that intersect the frustum and reserve room for all of their objects in the output array,
+  // so that the cells can be culled independently of each other.
+  struct VisibleCell
   {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
-
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
-
-    planeData.m_x0x1x2x3 = helperMat.m_col0;
-    planeData.m_y0y1y2y3 = helperMat.m_col1;
-    planeData.m_z0z1z2z3 = helperMat.m_col2;
-    planeData.m_w0w1w2w3 = helperMat.m_col3;
-
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
-
-    planeData.m_x4x5x4x5 = helperMat.m_col0;
-    planeData.m_y4y5y4y5 = helperMat.m_col1;
-    planeData.m_z4z5z4z5 = helperMat.m_col2;
-    planeData.m_w4w5w4w5 = helperMat.m_col3;
-  }
+    EZ_DECLARE_POD_TYPE();
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  ezUInt32 uiNumObjectsTested = 0;
-  ezUInt32 uiNumObjectsPassed = 0;
-#endif
+    const Cell* m_pCell;
+    ezUInt32 m_uiCategoryBitmask;
+    ezUInt32 m_uiFirstObject; // offset of the cell's objects in the output array
+    ezUInt32 m_uiNumObjectsPassed;
+  };
+
+  ezHybridArray<VisibleCell, 64> visibleCells;
+  const ezUInt32 uiFirstOutputIndex = out_Objects.GetCount();
+  ezUInt32 uiNumCandidates = 0;
 
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
     if (!SphereFrustumIntersect(cellSphere, planeData))
       return;
 
+    ezUInt32 uiNumObjects = 0;
+
     ezUInt32 filteredMask = uiFilteredCategoryBitmask;
     while (filteredMask > 0)
     {
       ezUInt32 category = ezMath::FirstBitLow(filteredMask);
       filteredMask &= filteredMask - 1;
 
-      auto& boundingSpheres = cell.m_BoundingSpheres[category];
-      auto& dataPointers = cell.m_DataPointers[category];
-
-      const ezUInt32 numSpheres = boundingSpheres.GetCount();
+      uiNumObjects += cell.m_BoundingSpheres[category].GetCount();
+    }
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-      uiNumObjectsTested += numSpheres;
-#endif
-      ezUInt32 currentIndex = 0;
+    if (uiNumObjects == 0)
+      return;
 
-      while (currentIndex < numSpheres)
-      {
-        if (numSpheres - currentIndex >= 32)
-        {
-          ezUInt32 mask = 0;
+    VisibleCell& visibleCell = visibleCells.ExpandAndGetRef();
+    visibleCell.m_pCell = &cell;
+    visibleCell.m_uiCategoryBitmask = uiFilteredCategoryBitmask;
+    visibleCell.m_uiFirstObject = uiFirstOutputIndex + uiNumCandidates;
+    visibleCell.m_uiNumObjectsPassed = 0;
 
-          for (ezUInt32 i = 0; i < 32; i += 2)
-          {
-            auto& objectSphereA = boundingSpheres[currentIndex + i + 0];
-            auto& objectSphereB = boundingSpheres[currentIndex + i + 1];
+    uiNumCandidates += uiNumObjects;
+  });
 
-            mask |= SphereFrustumIntersect(objectSphereA, objectSphereB, planeData) << i;
-          }
+  out_Objects.SetCountUninitialized(uiFirstOutputIndex + uiNumCandidates);
+  const ezGameObject** pOutObjects = out_Objects.GetData();
 
-          while (mask > 0)
-          {
-            ezUInt32 i = ezMath::FirstBitLow(mask);
-            mask &= mask - 1;
+  if (m_uiMultithreadedCullingThreshold > 0 && uiNumCandidates >= m_uiMultithreadedCullingThreshold && visibleCells.GetCount() > 1)
+  {
+    struct CullingData
+    {
+      const PlaneData* m_pPlaneData;
+      const ezGameObject** m_pOutObjects;
+    };
 
-            ezSpatialData* pData = dataPointers[currentIndex + i];
-            out_Objects.PushBack(pData->m_pObject);
+    CullingData cullingData;
+    cullingData.m_pPlaneData = &planeData;
+    cullingData.m_pOutObjects = pOutObjects;
 
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
-#endif
-          }
+    // the number of objects per cell varies a lot, so let idle workers steal cells from the busy ones
+    ezParallelForParams params;
+    params.splitting = ezParallelForSplitting::Adaptive;
+    params.uiGrainSize = 1;
 
-          currentIndex += 32;
-        }
-        else
+    ezTaskSystem::ParallelFor(visibleCells.GetArrayPtr(),
+      [pCullingData = &cullingData](ezArrayPtr<VisibleCell> cellsSlice) {
+        for (VisibleCell& visibleCell : cellsSlice)
         {
-          ezUInt32 i = currentIndex;
-          ++currentIndex;
-
-          auto& objectSphere = boundingSpheres[i];
-          if (!SphereFrustumIntersect(objectSphere, planeData))
-            continue;
-
-          ezSpatialData* pData = dataPointers[i];
-          out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          uiNumObjectsPassed++;
-#endif
+          visibleCell.m_uiNumObjectsPassed = visibleCell.m_pCell->FindVisibleObjects(visibleCell.m_uiCategoryBitmask, *pCullingData->m_pPlaneData,
+            pCullingData->m_pOutObjects + visibleCell.m_uiFirstObject);
         }
-      }
+      },
+      "Frustum Culling", params);
+  }
+  else
+  {
+    for (VisibleCell& visibleCell : visibleCells)
+    {
+      visibleCell.m_uiNumObjectsPassed = visibleCell.m_pCell->FindVisibleObjects(visibleCell.m_uiCategoryBitmask, planeData, pOutObjects + visibleCell.m_uiFirstObject);
     }
-  });
+  }
+
+  // close the gaps between the visible objects of the individual cells, this keeps the output in the same order as the cells
+  ezUInt32 uiNumObjectsPassed = 0;
+  for (const VisibleCell& visibleCell : visibleCells)
+  {
+    ezMemoryUtils::CopyOverlapped(pOutObjects + uiFirstOutputIndex + uiNumObjectsPassed, pOutObjects + visibleCell.m_uiFirstObject, visibleCell.m_uiNumObjectsPassed);
+    uiNumObjectsPassed += visibleCell.m_uiNumObjectsPassed;
+  }
+
+  out_Objects.SetCountUninitialized(uiFirstOutputIndex + uiNumObjectsPassed);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   if (pStats != nullptr)
   {
-    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
+    pStats->m_uiNumObjectsTested = uiNumCandidates;
     pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
   }
 #endif
@@ -697,33 +662,58 @@ EZ_FORCE_INLINE void ezSpatialSystem_RegularGrid::ForEachCellInBox(const ezSimdB
   const ezInt32 iDiffX = diff.x();
   const ezInt32 iDiffY = diff.y();
   const ezInt32 iDiffZ = diff.z();
-  const ezInt32 iNumIterations = iDiffX * iDiffY * iDiffZ;
+  const ezUInt64 uiNumIterations = static_cast<ezUInt64>(iDiffX) * iDiffY * iDiffZ;
 
-  for (ezInt32 i = 0; i < iNumIterations; ++i)
+  if (uiNumIterations > m_Cells.GetCount())
   {
-    ezInt32 index = i;
-    ezInt32 z = i / (iDiffX * iDiffY);
-    index -= z * iDiffX * iDiffY;
-    ezInt32 y = index / iDiffX;
-    ezInt32 x = index - (y * iDiffX);
-
-    x += iMinX;
-    y += iMinY;
-    z += iMinZ;
+    // The box spans more cell indices than there are cells, e.g. for a frustum with a far away far plane.
+    // Looking at every existing cell is cheaper than a hash table lookup per cell index then.
+    for (auto it = m_Cells.GetIterator(); it.IsValid(); ++it)
+    {
+      const ezUInt64 cellKey = it.Key();
+      const ezSimdVec4i cellIndex = GetCellIndex(cellKey);
 
-    ezUInt64 cellKey = GetCellKey(x, y, z);
+      if (!(cellIndex >= minIndex && cellIndex <= maxIndex).AllSet<3>())
+        continue;
 
-    if (auto ppCell = m_Cells.GetValue(cellKey))
-    {
-      const Cell& constCell = *(*ppCell);
+      const Cell& constCell = *it.Value();
       ezUInt32 uiFilteredCategoryBitmask = constCell.m_uiCategoryBitmask & uiCategoryBitmask;
       if (uiFilteredCategoryBitmask != 0)
       {
-        ezSimdVec4i cellIndex(x, y, z);
         func(cellIndex, cellKey, constCell, uiFilteredCategoryBitmask);
       }
     }
   }
+  else
+  {
+    const ezInt32 iNumIterations = static_cast<ezInt32>(uiNumIterations);
+
+    for (ezInt32 i = 0; i < iNumIterations; ++i)
+    {
+      ezInt32 index = i;
+      ezInt32 z = i / (iDiffX * iDiffY);
+      index -= z * iDiffX * iDiffY;
+      ezInt32 y = index / iDiffX;
+      ezInt32 x = index - (y * iDiffX);
+
+      x += iMinX;
+      y += iMinY;
+      z += iMinZ;
+
+      ezUInt64 cellKey = GetCellKey(x, y, z);
+
+      if (auto ppCell = m_Cells.GetValue(cellKey))
+      {
+        const Cell& constCell = *(*ppCell);
+        ezUInt32 uiFilteredCategoryBitmask = constCell.m_uiCategoryBitmask & uiCategoryBitmask;
+        if (uiFilteredCategoryBitmask != 0)
+        {
+          ezSimdVec4i cellIndex(x, y, z);
+          func(cellIndex, cellKey, constCell, uiFilteredCategoryBitmask);
+        }
+      }
+    }
+  }
 
   ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
   if (uiFilteredCategoryBitmask != 0)
@@ -285,12 +285,10 @@ namespace ezInternal
     struct UserData
     {
       ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
     };
 
     UserData userData;
     userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
 
     struct RootLevel
     {
@@ -312,21 +310,17 @@ namespace ezInternal
 
     struct RootLevelWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      EZ_ALWAYS_INLINE static void Visit(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDt, SpatialDataUpdates& out_Updates)
       {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        WorldData::UpdateGlobalTransformAndCollectSpatialData(pData, fInvDt, out_Updates);
       }
     };
 
     struct WithParentWithSpatialData
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      EZ_ALWAYS_INLINE static void Visit(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDt, SpatialDataUpdates& out_Updates)
       {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
+        WorldData::UpdateGlobalTransformWithParentAndCollectSpatialData(pData, fInvDt, out_Updates);
       }
     };
 
@@ -335,8 +329,6 @@ namespace ezInternal
     {
       auto dataPtr = hierarchy.m_Data.GetData();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
       if (m_pSpatialSystem == nullptr)
       {
         TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
@@ -348,11 +340,25 @@ namespace ezInternal
       }
       else
       {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
+        // The spatial system can't be modified concurrently, so the hierarchy levels are updated in parallel
+        // and all spatial data changes are applied in one batch afterwards.
+        // The spatial data is not read during the transform update, so it doesn't matter that it lags behind until then.
+        m_SpatialDataUpdates.Clear();
+
+        TraverseHierarchyLevelAndCollectSpatialDataMultiThreaded<RootLevelWithSpatialData>(*dataPtr[0], userData.m_fInvDt);
 
         for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
         {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
+          TraverseHierarchyLevelAndCollectSpatialDataMultiThreaded<WithParentWithSpatialData>(*dataPtr[i], userData.m_fInvDt);
+        }
+
+        ezSpatialSystem& spatialSystem = *m_pSpatialSystem;
+        for (const SpatialDataUpdate& update : m_SpatialDataUpdates)
+        {
+          ezGameObject::TransformationData* pData = update.m_pData;
+          const bool bIsAlwaysVisible = pData->m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+
+          pData->UpdateSpatialData(spatialSystem, update.m_bWasAlwaysVisible, bIsAlwaysVisible);
         }
       }
     }
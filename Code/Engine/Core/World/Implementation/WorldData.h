@@ -5,6 +5,7 @@
 #include <Foundation/Math/Random.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Time/Clock.h>
 
 #include <Core/World/GameObject.h>
@@ -133,11 +134,29 @@ namespace ezInternal
     static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
     static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    struct SpatialDataUpdate
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezGameObject::TransformationData* m_pData;
+      bool m_bWasAlwaysVisible;
+    };
+
+    typedef ezHybridArray<SpatialDataUpdate, 256> SpatialDataUpdates;
+
+    static void UpdateGlobalTransformAndCollectSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataUpdates& out_Updates);
+    static void UpdateGlobalTransformWithParentAndCollectSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, SpatialDataUpdates& out_Updates);
+
+    template <typename VISITOR>
+    void TraverseHierarchyLevelAndCollectSpatialDataMultiThreaded(Hierarchy::DataBlockArray& blocks, const ezSimdFloat& fInvDeltaSeconds);
 
     void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
+    // Spatial data changes are collected while the transforms are updated in parallel and applied to the spatial system afterwards,
+    // since the spatial system does not support concurrent modifications.
+    ezMutex m_SpatialDataUpdatesMutex;
+    ezDynamicArray<SpatialDataUpdate, ezLocalAllocatorWrapper> m_SpatialDataUpdates;
+
     // game object lookups
     ezHashTable<ezUInt32, ezGameObjectId, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
     ezHashTable<ezUInt32, ezHashedString, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_IdToGlobalKeyTable;
@@ -73,20 +73,71 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
-    ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndCollectSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    SpatialDataUpdates& out_Updates)
   {
     pData->UpdateGlobalTransform();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    bool bWasAlwaysVisible = false;
+    if (pData->UpdateGlobalBoundsAndCheckSpatialData(bWasAlwaysVisible))
+    {
+      auto& update = out_Updates.ExpandAndGetRef();
+      update.m_pData = pData;
+      update.m_bWasAlwaysVisible = bWasAlwaysVisible;
+    }
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
+  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndCollectSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
+    SpatialDataUpdates& out_Updates)
   {
     pData->UpdateGlobalTransformWithParent();
     pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+
+    bool bWasAlwaysVisible = false;
+    if (pData->UpdateGlobalBoundsAndCheckSpatialData(bWasAlwaysVisible))
+    {
+      auto& update = out_Updates.ExpandAndGetRef();
+      update.m_pData = pData;
+      update.m_bWasAlwaysVisible = bWasAlwaysVisible;
+    }
+  }
+
+  template <typename VISITOR>
+  EZ_FORCE_INLINE void WorldData::TraverseHierarchyLevelAndCollectSpatialDataMultiThreaded(Hierarchy::DataBlockArray& blocks, const ezSimdFloat& fInvDeltaSeconds)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 100;
+    parallelForParams.uiMaxTasksPerThread = 2;
+
+    const float fInvDt = fInvDeltaSeconds;
+
+    ezTaskSystem::ParallelFor(blocks.GetArrayPtr(),
+      [this, fInvDt](ezArrayPtr<WorldData::Hierarchy::DataBlock> blocksSlice) {
+        const ezSimdFloat fInvDeltaSeconds = fInvDt;
+        SpatialDataUpdates updates;
+
+        for (WorldData::Hierarchy::DataBlock& block : blocksSlice)
+        {
+          ezGameObject::TransformationData* pCurrentData = block.m_pData;
+          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
+
+          while (pCurrentData < pEndData)
+          {
+            VISITOR::Visit(pCurrentData, fInvDeltaSeconds, updates);
+            ++pCurrentData;
+          }
+        }
+
+        if (!updates.IsEmpty())
+        {
+          // only one lock per slice, the spatial system itself is updated later on the calling thread
+          EZ_LOCK(m_SpatialDataUpdatesMutex);
+          m_SpatialDataUpdates.PushBackRange(updates);
+        }
+      },
+      "World DataBlock Traversal Task", parallelForParams);
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
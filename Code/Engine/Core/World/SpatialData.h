@@ -68,6 +68,7 @@ struct EZ_CORE_DLL ezDefaultSpatialDataCategories
 {
   static ezSpatialData::Category RenderStatic;
   static ezSpatialData::Category RenderDynamic;
+  static ezSpatialData::Category Occluder; ///< Objects that hide other objects, see ezOcclusionBuffer. Never culled by occlusion themselves.
 };
 
 #define ezInvalidSpatialDataCategory ezSpatialData::Category()
@@ -5,6 +5,8 @@
 #include <Foundation/Math/Frustum.h>
 #include <Foundation/Memory/CommonAllocators.h>
 
+class ezOcclusionBuffer;
+
 class EZ_CORE_DLL ezSpatialSystem : public ezReflectedClass
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem, ezReflectedClass);
@@ -36,6 +38,7 @@ public:
     ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
     ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
     ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumObjectsOccluded; ///< Number of objects that passed the frustum test but were hidden by occluders.
     ezTime m_TimeTaken;            ///< Time taken to execute the query
 
     EZ_ALWAYS_INLINE QueryStats()
@@ -43,6 +46,7 @@ public:
       m_uiTotalNumObjects = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
+      m_uiNumObjectsOccluded = 0;
     }
   };
 
@@ -56,7 +60,12 @@ public:
   /// \name Visibility Queries
   ///@{
 
-  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
+  /// \brief Finds all objects inside the frustum.
+  ///
+  /// If an occlusion buffer is given, objects whose bounding box is hidden behind the occluders rasterized into it are removed as well.
+  /// Objects in the ezDefaultSpatialDataCategories::Occluder category and objects that are always visible are never removed that way.
+  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr,
+    const ezOcclusionBuffer* pOcclusionBuffer = nullptr) const;
 
   ///@}
 
@@ -70,6 +79,9 @@ protected:
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) = 0;
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) = 0;
 
+  void RemoveOccludedObjects(const ezOcclusionBuffer& occlusionBuffer, ezDynamicArray<const ezGameObject*>& inout_Objects, ezUInt32 uiFirstObject,
+    QueryStats* pStats) const;
+
   ezProxyAllocator m_Allocator;
   ezLocalAllocatorWrapper m_AllocatorWrapper;
   ezInternal::WorldLargeBlockAllocator m_BlockAllocator;
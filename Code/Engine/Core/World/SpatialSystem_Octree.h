@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Types/UniquePtr.h>
+
+/// \brief A spatial system that sorts all objects into a loose octree.
+///
+/// The nodes of a loose octree overlap their neighbors by half their size, so every object can be stored in the smallest node
+/// that is at least as large as the object itself. Large objects therefore end up close to the root and small objects further down,
+/// which makes this system a better fit than ezSpatialSystem_RegularGrid for worlds that mix huge and tiny objects or that are very sparse.
+///
+/// Nodes are only split once they contain more than uiMaxObjectsPerNode objects and merged again once their sub-tree contains less than half of that.
+/// Objects outside of the octree bounds are stored in the root node and are tested by every query.
+///
+/// To use it for a world, set ezWorldDesc::m_pSpatialSystem to an instance of this class.
+class EZ_CORE_DLL ezSpatialSystem_Octree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_Octree, ezSpatialSystem);
+
+public:
+  /// \brief The octree is a cube with an edge length of fWorldSize, centered around the origin.
+  ezSpatialSystem_Octree(float fWorldSize = 1024 * 1024.0f, ezUInt32 uiMaxObjectsPerNode = 64, ezUInt32 uiMaxDepth = 20);
+  ~ezSpatialSystem_Octree();
+
+  /// \brief Returns the loose bounding box of the node that stores the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the loose bounding boxes of all nodes that contain objects.
+  void GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+    QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats = nullptr) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  ezProxyAllocator m_AlignedAllocator;
+  ezUInt32 m_uiMaxObjectsPerNode;
+  ezUInt32 m_uiMaxDepth;
+
+  struct SpatialUserData;
+  struct Node;
+  struct NodeObjects;
+
+  // Node 0 is the root, the 8 children of a node are always stored next to each other.
+  ezDynamicArray<Node> m_Nodes;
+  ezDynamicArray<ezUInt32> m_FreeChildBlocks;
+
+  // The objects are stored separately, so the tree can be traversed without touching them. Only nodes that contain objects have any.
+  ezDynamicArray<ezUniquePtr<NodeObjects>> m_NodeObjects;
+  ezDynamicArray<ezUInt32> m_FreeNodeObjects;
+
+  ezUInt32 FindNode(const ezSimdBSphere& sphere) const;
+  void AddDataToNode(ezUInt32 uiNodeIndex, ezSpatialData* pData);
+  void RemoveDataFromNode(ezSpatialData* pData);
+
+  NodeObjects& GetOrCreateNodeObjects(ezUInt32 uiNodeIndex);
+  void AppendData(ezUInt32 uiNodeIndex, ezSpatialData* pData);
+  void RemoveDataAtIndex(ezUInt32 uiNodeIndex, ezUInt32 uiDataIndex);
+  void ReleaseNodeObjects(Node& node);
+
+  void SplitNode(ezUInt32 uiNodeIndex);
+  void MergeChildren(ezUInt32 uiNodeIndex);
+
+  template <typename NodeTestFunctor, typename Functor>
+  void ForEachNode(ezUInt32 uiCategoryBitmask, NodeTestFunctor nodeTestFunc, Functor func) const;
+};
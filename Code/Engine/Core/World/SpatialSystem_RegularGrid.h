@@ -18,6 +18,11 @@ public:
   /// \brief Returns bounding boxes of all existing cells.
   void GetAllCellBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
 
+  /// \brief Frustum culling is distributed over the task system, if the cells that intersect the frustum contain at least this many objects.
+  /// 0 disables multi-threaded culling.
+  void SetMultithreadedCullingThreshold(ezUInt32 uiNumObjects) { m_uiMultithreadedCullingThreshold = uiNumObjects; }
+  ezUInt32 GetMultithreadedCullingThreshold() const { return m_uiMultithreadedCullingThreshold; }
+
 private:
   // ezSpatialSystem implementation
   virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
@@ -36,6 +41,7 @@ private:
   ezSimdVec4i m_iCellSize;
   ezSimdVec4f m_fOverlapSize;
   ezSimdFloat m_fInvCellSize;
+  ezUInt32 m_uiMultithreadedCullingThreshold = 16 * 1024;
 
   struct SpatialUserData;
   struct Cell;
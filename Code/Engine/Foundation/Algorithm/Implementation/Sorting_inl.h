@@ -154,3 +154,69 @@ void ezSorting::InsertionSort(ezArrayPtr<T>& arrayPtr, ezUInt32 uiStartIndex, ez
   }
 }
 
+template <typename T, typename KeyFunc>
+void ezSorting::RadixSort(ezArrayPtr<T> arrayPtr, ezArrayPtr<T> tempArrayPtr, const KeyFunc& keyFunc)
+{
+  using KeyType = typename std::decay<decltype(keyFunc(arrayPtr[0]))>::type;
+  static_assert(std::is_integral<KeyType>::value && std::is_unsigned<KeyType>::value, "RadixSort requires unsigned integer keys");
+
+  constexpr ezUInt32 uiNumPasses = sizeof(KeyType);
+
+  const ezUInt32 uiCount = arrayPtr.GetCount();
+  if (uiCount <= 1)
+    return;
+
+  EZ_ASSERT_DEV(tempArrayPtr.GetCount() >= uiCount, "The temp array needs to hold at least {0} elements", uiCount);
+
+  // gather the histograms of all passes at once
+  ezUInt32 histograms[uiNumPasses][256] = {};
+
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const ezUInt64 uiKey = keyFunc(arrayPtr[i]);
+
+    for (ezUInt32 uiPass = 0; uiPass < uiNumPasses; ++uiPass)
+    {
+      ++histograms[uiPass][(uiKey >> (uiPass * 8)) & 0xFF];
+    }
+  }
+
+  T* pSrc = arrayPtr.GetPtr();
+  T* pDst = tempArrayPtr.GetPtr();
+
+  for (ezUInt32 uiPass = 0; uiPass < uiNumPasses; ++uiPass)
+  {
+    ezUInt32* pHistogram = histograms[uiPass];
+    const ezUInt32 uiShift = uiPass * 8;
+
+    // all keys have the same value in this byte, the pass would not change the order
+    const ezUInt64 uiFirstKey = keyFunc(pSrc[0]);
+    if (pHistogram[(uiFirstKey >> uiShift) & 0xFF] == uiCount)
+      continue;
+
+    // turn the histogram into the start offsets of the buckets
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 uiBucket = 0; uiBucket < 256; ++uiBucket)
+    {
+      const ezUInt32 uiBucketSize = pHistogram[uiBucket];
+      pHistogram[uiBucket] = uiOffset;
+      uiOffset += uiBucketSize;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      const ezUInt64 uiKey = keyFunc(pSrc[i]);
+      pDst[pHistogram[(uiKey >> uiShift) & 0xFF]++] = std::move(pSrc[i]);
+    }
+
+    ezMath::Swap(pSrc, pDst);
+  }
+
+  if (pSrc != arrayPtr.GetPtr())
+  {
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      arrayPtr[i] = std::move(pSrc[i]);
+    }
+  }
+}
@@ -27,6 +27,15 @@ public:
   template <typename T, typename Comparer>
   static void InsertionSort(ezArrayPtr<T>& arrayPtr, const Comparer& comparer = Comparer()); // [tested]
 
+
+  /// \brief Sorts the elements in the array by an unsigned integer key using a least significant digit radix sort (stable, not in-place).
+  ///
+  /// keyFunc(element) has to return an unsigned integer with up to 64 bits. The elements are distributed by one byte of the key per pass,
+  /// passes over bytes that are the same for all keys are skipped. tempArrayPtr is used as scratch memory and has to be at least as large as arrayPtr.
+  /// For arrays with more than a few hundred elements this is a lot faster than QuickSort, since it does not compare elements at all.
+  template <typename T, typename KeyFunc>
+  static void RadixSort(ezArrayPtr<T> arrayPtr, ezArrayPtr<T> tempArrayPtr, const KeyFunc& keyFunc); // [tested]
+
 private:
   enum
   {
@@ -6,6 +6,10 @@
 typedef ezGuardedAllocator DefaultHeapType;
 typedef ezGuardedAllocator DefaultAlignedHeapType;
 typedef ezGuardedAllocator DefaultStaticHeapType;
+#elif EZ_ENABLED(EZ_USE_POOL_ALLOCATIONS)
+typedef ezPoolAllocator DefaultHeapType;
+typedef ezAlignedHeapAllocator DefaultAlignedHeapType;
+typedef ezHeapAllocator DefaultStaticHeapType;
 #else
 typedef ezHeapAllocator DefaultHeapType;
 typedef ezAlignedHeapAllocator DefaultAlignedHeapType;
@@ -15,11 +19,12 @@ typedef ezHeapAllocator DefaultStaticHeapType;
 enum
 {
   HEAP_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultHeapType),
+  STATIC_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultStaticHeapType),
   ALIGNED_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultAlignedHeapType)
 };
 
 EZ_ALIGN_VARIABLE(static ezUInt8 s_DefaultAllocatorBuffer[HEAP_ALLOCATOR_BUFFER_SIZE], EZ_ALIGNMENT_MINIMUM);
-EZ_ALIGN_VARIABLE(static ezUInt8 s_StaticAllocatorBuffer[HEAP_ALLOCATOR_BUFFER_SIZE], EZ_ALIGNMENT_MINIMUM);
+EZ_ALIGN_VARIABLE(static ezUInt8 s_StaticAllocatorBuffer[STATIC_ALLOCATOR_BUFFER_SIZE], EZ_ALIGNMENT_MINIMUM);
 
 EZ_ALIGN_VARIABLE(static ezUInt8 s_AlignedAllocatorBuffer[ALIGNED_ALLOCATOR_BUFFER_SIZE], EZ_ALIGNMENT_MINIMUM);
 
@@ -60,6 +60,8 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_Archive);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveBuilder);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveChunkedReader);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveDictionaryReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveUtils);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_DataDirTypeArchive);
@@ -90,6 +92,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_StreamOperations);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_StreamOperationsOther);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_StringDeduplicationContext);
+  EZ_STATICLINK_REFERENCE(Foundation_Logging_Implementation_AsyncLog);
   EZ_STATICLINK_REFERENCE(Foundation_Logging_Implementation_ConsoleWriter);
   EZ_STATICLINK_REFERENCE(Foundation_Logging_Implementation_ETWWriter);
   EZ_STATICLINK_REFERENCE(Foundation_Logging_Implementation_HTMLWriter);
@@ -111,6 +114,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_PoolAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyPath);
@@ -154,6 +158,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemTasks);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemThreads);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkStealingQueue);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkerThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Thread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ThreadSignal);
@@ -177,6 +182,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_ConversionUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_DGMLWriter);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_GraphicsUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Metrics);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Node);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Progress);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Stats);
@@ -12,6 +12,8 @@ enum class ezArchiveCompressionMode : ezUInt8
   Uncompressed,
   Compressed_zstd,
   Compressed_zip,
+  Compressed_zstd_chunked, ///< The data is split into chunks of ezArchiveTOC::m_uiChunkSize bytes, which are compressed independently.
+  Compressed_zstd_dictionary, ///< The data is compressed as a single zstd frame, using one of the dictionaries in ezArchiveTOC::m_Dictionaries.
 };
 
 /// \brief Data for a single file entry in an ezArchive file
@@ -23,6 +25,8 @@ public:
   ezUInt64 m_uiStoredDataSize = 0;       ///< The amount of (compressed) bytes actually stored in the ezArchive.
   ezUInt32 m_uiPathStringOffset = 0;     ///< Byte offset into ezArchiveTOC::m_AllPathStrings where the path string for this entry resides.
   ezArchiveCompressionMode m_CompressionMode = ezArchiveCompressionMode::Uncompressed;
+  ezUInt32 m_uiFirstChunk = 0;           ///< For chunked entries, the index of the first chunk in ezArchiveTOC::m_ChunkOffsets. Not serialized, computed when the TOC is read.
+  ezUInt16 m_uiDictionary = 0;           ///< For dictionary compressed entries, the index into ezArchiveTOC::m_Dictionaries. Serialized as part of the TOC.
 
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
@@ -99,19 +103,43 @@ struct ezHashHelper<ezArchiveStoredString>
 /// \brief Table-of-contents for an ezArchive file
 class EZ_FOUNDATION_DLL ezArchiveTOC
 {
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveTOC);
+
 public:
+  ezArchiveTOC();
+  ~ezArchiveTOC();
+
   /// all files stored in the ezArchive
   ezDynamicArray<ezArchiveEntry> m_Entries;
   /// allows to map a hashed string to the index of the file entry for the file path
   ezHashTable<ezArchiveStoredString, ezUInt32> m_PathToEntryIndex;
   /// one large array holding all path strings for the file entries, to reduce allocations
   ezDynamicArray<ezUInt8> m_AllPathStrings;
+  /// the uncompressed size of a chunk of a ezArchiveCompressionMode::Compressed_zstd_chunked entry, only the last chunk of an entry may be smaller
+  ezUInt32 m_uiChunkSize = 256 * 1024;
+  /// for all chunked entries, one after the other, the offsets of their compressed chunks relative to the entry's data start offset
+  ezDynamicArray<ezUInt64> m_ChunkOffsets;
+  /// zstd dictionaries that ezArchiveCompressionMode::Compressed_zstd_dictionary entries are compressed with
+  ezDynamicArray<ezDynamicArray<ezUInt8>> m_Dictionaries;
 
   /// \brief Returns the entry index for the given file or ezInvalidIndex, if not found.
   ezUInt32 FindEntry(const char* szFile) const;
 
   const char* GetEntryPathString(ezUInt32 uiEntryIdx) const;
 
+  /// \brief Returns how many chunks the given entry is stored in. Zero, if the entry is not chunked.
+  ezUInt32 GetNumChunks(const ezArchiveEntry& entry) const;
+
+  /// \brief Returns the digested zstd dictionary (a ZSTD_DDict) for m_Dictionaries[uiDictionary], or nullptr if there is none.
+  ///
+  /// Deserialize() creates these once for all dictionaries, so that decompressing an entry doesn't have to digest its dictionary again.
+  const void* GetDecompressionDictionary(ezUInt32 uiDictionary) const;
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
+
+private:
+  void FreeDecompressionDictionaries();
+
+  ezDynamicArray</*ZSTD_DDict*/ void*> m_DecompressionDictionaries;
 };
@@ -8,6 +8,7 @@
 /// \brief Utility class to build an ezArchive file from files/folders on disk
 ///
 /// All functionality for writing an ezArchive file is available through ezArchiveUtils.
+/// The files are compressed in parallel on the ezTaskSystem and then written to the archive in the order of m_Entries.
 class EZ_FOUNDATION_DLL ezArchiveBuilder
 {
 public:
@@ -21,6 +22,26 @@ public:
   // all the source files from disk that should be put into the ezArchive
   ezDeque<SourceEntry> m_Entries;
 
+  /// zstd compressed files that are larger than this are stored as independently compressed chunks of this size (see
+  /// ezArchiveCompressionMode::Compressed_zstd_chunked), which allows to seek in them and to decompress them in parallel.
+  /// Set this to 0 to store all zstd compressed files as a single stream.
+  ezUInt32 m_uiChunkSize = 256 * 1024;
+
+  /// zstd compressed files up to this size are compressed with a dictionary (see ezArchiveCompressionMode::Compressed_zstd_dictionary),
+  /// which greatly improves the compression of small files. One dictionary is built per file extension, from the files of that type.
+  /// Set this to 0 to disable dictionaries.
+  ezUInt32 m_uiMaxDictionaryFileSize = 0;
+
+  /// The maximum size of each dictionary.
+  ezUInt32 m_uiMaxDictionarySize = 64 * 1024;
+
+  /// How many small files with the same extension there have to be, for a dictionary to be built for them.
+  ezUInt32 m_uiMinFilesPerDictionary = 8;
+
+  /// If enabled, files with identical content are only stored once and all their TOC entries reference the same data.
+  /// Files are matched by a hash of their content and then compared byte by byte.
+  bool m_bDeduplicateFiles = false;
+
   enum class InclusionMode
   {
     Exclude,       ///< Do not add this file to the archive
@@ -46,9 +67,19 @@ public:
   ezResult WriteArchive(ezStreamWriter& stream) const;
 
 protected:
+  /// Builds the dictionaries for the small files and returns for every entry the dictionary index or ezInvalidIndex.
+  ezResult BuildDictionaries(ezArchiveTOC& toc, ezDynamicArray<ezUInt32>& out_EntryDictionaries) const;
+
+  struct CompressedEntry;
+
+  /// Writes the given entry to \a stream and advances \a inout_uiStreamPos. Called on worker threads for the entries that are compressed into memory,
+  /// and by WriteArchive() for the entries that are written to the archive directly.
+  ezResult CompressEntry(ezUInt32 uiEntryIdx, const ezArchiveTOC& toc, ezUInt32 uiDictionary, ezStreamWriter& stream, ezUInt64& inout_uiStreamPos, CompressedEntry& out_Result) const;
+
   /// Override this to get a callback when the next file is being written to the output
   virtual bool WriteNextFileCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, const char* szSourceFile) const;
-  /// Override this to get a progress report for writing a single file to the output
+  /// Override this to get a progress report for writing a single file to the output.
+  /// Since files are compressed in parallel, this may be called from several threads at the same time.
   virtual bool WriteFileProgressCallback(ezUInt64 bytesWritten, ezUInt64 bytesTotal) const;
 };
 
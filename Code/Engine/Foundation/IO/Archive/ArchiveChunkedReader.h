@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Stream.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief A stream reader for archive entries that are stored with ezArchiveCompressionMode::Compressed_zstd_chunked.
+///
+/// Such entries are split into chunks of ezArchiveTOC::m_uiChunkSize bytes, which are compressed independently of each other.
+/// The reader only decompresses the chunk that contains the current read position, so SkipBytes() and SetReadPosition()
+/// can jump to any position in the entry without decompressing the data in front of it.
+/// Reads that cover several entire chunks decompress those chunks in parallel, directly into the target buffer.
+class EZ_FOUNDATION_DLL ezArchiveChunkedReaderZstd : public ezStreamReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveChunkedReaderZstd);
+
+public:
+  ezArchiveChunkedReaderZstd();
+  ~ezArchiveChunkedReaderZstd();
+
+  /// \brief Configures the reader to read the given entry. The TOC and the archive data must stay alive while the reader is in use.
+  ///
+  /// Calling this a second time on the same instance is valid and allows to reuse the chunk cache.
+  void Configure(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData);
+
+  /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the entry into pReadBuffer.
+  ///
+  /// It is valid to pass nullptr for pReadBuffer, in this case the read position is only advanced by the given number of bytes.
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
+
+  /// \brief Advances the read position without decompressing any of the skipped data.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
+  /// \brief Moves the read position to the given byte offset in the uncompressed data. Must not be larger than GetByteCount().
+  void SetReadPosition(ezUInt64 uiReadPosition);
+
+  /// \brief Returns the current read position in the uncompressed data.
+  ezUInt64 GetReadPosition() const { return m_uiReadPosition; }
+
+  /// \brief Returns the uncompressed size of the entry.
+  ezUInt64 GetByteCount() const { return m_uiUncompressedSize; }
+
+private:
+  ezUInt32 GetNumChunks() const { return m_ChunkOffsets.GetCount(); }
+  ezUInt64 GetChunkUncompressedSize(ezUInt32 uiChunk) const;
+  ezResult DecompressChunk(ezUInt32 uiChunk, void* pTarget) const;
+  ezResult DecompressChunks(ezUInt32 uiFirstChunk, ezUInt32 uiNumChunks, void* pTarget) const;
+
+  const ezUInt8* m_pEntryData = nullptr;
+  ezUInt64 m_uiStoredSize = 0;
+  ezUInt64 m_uiUncompressedSize = 0;
+  ezUInt64 m_uiChunkSize = 0;
+  ezArrayPtr<const ezUInt64> m_ChunkOffsets;
+
+  ezUInt64 m_uiReadPosition = 0;
+  ezUInt32 m_uiCachedChunk = ezInvalidIndex;
+  ezDynamicArray<ezUInt8> m_ChunkCache;
+};
+
+#endif
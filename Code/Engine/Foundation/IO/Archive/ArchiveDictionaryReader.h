@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/MemoryStream.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief A stream reader for archive entries that are stored with ezArchiveCompressionMode::Compressed_zstd_dictionary.
+///
+/// Only small files are compressed with a dictionary, so the entry is decompressed entirely in Configure()
+/// and then read from memory. This also makes SkipBytes() cheap.
+class EZ_FOUNDATION_DLL ezArchiveDictionaryReaderZstd : public ezStreamReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveDictionaryReaderZstd);
+
+public:
+  ezArchiveDictionaryReaderZstd();
+  ~ezArchiveDictionaryReaderZstd();
+
+  /// \brief Decompresses the given entry. The TOC must stay alive while the reader is in use.
+  ///
+  /// Calling this a second time on the same instance is valid and allows to reuse the decompression context and buffer.
+  /// If decompression fails, the reader returns no data.
+  ezResult Configure(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData);
+
+  /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the entry into pReadBuffer.
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
+
+  /// \brief Advances the read position without copying any data.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
+  /// \brief Returns the entire decompressed entry, independent of the read position.
+  ezArrayPtr<const ezUInt8> GetData() const { return m_DataReader.GetByteCount() > 0 ? m_Data.GetArrayPtr() : ezArrayPtr<const ezUInt8>(); }
+
+private:
+  /*ZSTD_DCtx*/ void* m_pZstdDCtx = nullptr;
+  ezDynamicArray<ezUInt8> m_Data;
+  ezRawMemoryStreamReader m_DataReader;
+};
+
+#endif
@@ -6,6 +6,8 @@
 
 class ezRawMemoryStreamReader;
 class ezStreamReader;
+class ezArchiveChunkedReaderZstd;
+class ezArchiveDictionaryReaderZstd;
 
 /// \brief A utility class for reading from ezArchive files
 class EZ_FOUNDATION_DLL ezArchiveReader
@@ -30,7 +32,18 @@ public:
   /// \brief Sets up \a memReader for reading the raw (potentially compressed) data that is stored for the given entry in the archive.
   void ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawMemoryStreamReader& memReader) const;
 
-  /// \brief Creates a reader that will decompress the given file entry.
+  /// \brief Returns the raw (potentially compressed) data that is stored for the given entry, directly from the memory mapped archive.
+  ///
+  /// Returns an empty array for entries that are too large to be addressed with an ezArrayPtr.
+  ezArrayPtr<const ezUInt8> GetEntryRawData(ezUInt32 uiEntryIdx) const;
+
+  /// \brief Sets up \a reader for reading the given entry, which must be stored with ezArchiveCompressionMode::Compressed_zstd_chunked.
+  void ConfigureChunkedReader(ezUInt32 uiEntryIdx, ezArchiveChunkedReaderZstd& reader) const;
+
+  /// \brief Sets up \a reader for reading the given entry, which must be stored with ezArchiveCompressionMode::Compressed_zstd_dictionary.
+  ezResult ConfigureDictionaryReader(ezUInt32 uiEntryIdx, ezArchiveDictionaryReaderZstd& reader) const;
+
+  /// \brief Creates a reader that will decompress the given file entry. Returns nullptr, if the entry can't be decompressed.
   ezUniquePtr<ezStreamReader> CreateEntryReader(ezUInt32 uiEntryIdx) const;
 
 protected:
@@ -51,6 +51,31 @@ namespace ezArchiveUtils
     ezArchiveCompressionMode compression, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition,
     FileWriteProgressCallback progress = FileWriteProgressCallback());
 
+  /// \brief Writes a single file entry to an ezArchive stream as independently zstd compressed chunks of \a uiChunkSize bytes.
+  ///
+  /// The chunk offsets are appended to \a inout_ChunkOffsets, which has to be ezArchiveTOC::m_ChunkOffsets.
+  /// Files that fit into a single chunk are written with WriteEntryOptimal() and regular zstd compression instead.
+  /// Every chunk is written to \a stream as soon as it is compressed, so the file is never held in memory entirely.
+  /// The file is stored uncompressed instead, if compression does not reduce the size of the first chunk enough.
+  EZ_FOUNDATION_DLL ezResult WriteEntryChunked(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
+    ezUInt32 uiChunkSize, ezArchiveEntry& tocEntry, ezDynamicArray<ezUInt64>& inout_ChunkOffsets, ezUInt64& inout_uiCurrentStreamPosition,
+    FileWriteProgressCallback progress = FileWriteProgressCallback());
+
+  /// \brief Builds a zstd dictionary of at most \a uiMaxDictionarySize bytes from the content of the given sample files.
+  ///
+  /// The dictionary is made up of the beginning of every sample file, which is where files of the same type usually share the most data
+  /// (headers, type names, default values). Samples that already compress well with the dictionary built so far are left out,
+  /// so the dictionary only grows with content that it does not cover yet. zstd uses it as a raw content dictionary.
+  EZ_FOUNDATION_DLL ezResult BuildDictionary(ezArrayPtr<const ezString> sampleFiles, ezUInt32 uiMaxDictionarySize, ezDynamicArray<ezUInt8>& out_Dictionary);
+
+  /// \brief Writes a single file entry to an ezArchive stream, compressed with the dictionary ezArchiveTOC::m_Dictionaries[uiDictionary].
+  ///
+  /// Meant for small files, which compress poorly on their own. The entire file is compressed as one zstd frame.
+  /// Like WriteEntryOptimal(), the file is stored uncompressed, if compression does not reduce the file size enough.
+  EZ_FOUNDATION_DLL ezResult WriteEntryWithDictionary(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
+    const ezArchiveTOC& toc, ezUInt16 uiDictionary, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition,
+    FileWriteProgressCallback progress = FileWriteProgressCallback());
+
   /// \brief Configures \a memReader as a view into the data stored for \a entry in the archive file.
   ///
   /// The raw memory stream may be compressed or uncompressed. This only creates a view for the stored data, it does not interpret it.
@@ -60,8 +85,15 @@ namespace ezArchiveUtils
   /// \brief Creates a new stream reader which allows to read the uncompressed data for the given archive entry.
   ///
   /// Under the hood it may create different types of stream readers to uncompress or decode the data.
+  /// Chunked and dictionary compressed entries can't be read this way, since they need data from the TOC. Use the overload that takes the TOC instead.
   EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveEntry& entry, const void* pStartOfArchiveData);
 
+  /// \brief Creates a new stream reader which allows to read the uncompressed data for the given archive entry.
+  ///
+  /// Supports all compression modes, including ezArchiveCompressionMode::Compressed_zstd_chunked and Compressed_zstd_dictionary.
+  /// Returns nullptr, if a dictionary compressed entry can't be decompressed.
+  EZ_FOUNDATION_DLL ezUniquePtr<ezStreamReader> CreateEntryReader(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData);
+
   EZ_FOUNDATION_DLL ezResult ReadZipHeader(ezStreamReader& stream, ezUInt8& out_uiVersion);
   EZ_FOUNDATION_DLL ezResult ExtractZipTOC(ezMemoryMappedFile& memFile, ezArchiveTOC& toc);
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/IO/Archive/ArchiveChunkedReader.h>
+#include <Foundation/IO/Archive/ArchiveDictionaryReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/CompressedStreamZlib.h>
@@ -15,6 +17,8 @@ namespace ezDataDirectory
 {
   class ArchiveReaderUncompressed;
   class ArchiveReaderZstd;
+  class ArchiveReaderZstdChunked;
+  class ArchiveReaderZstdDictionary;
   class ArchiveReaderZip;
 
   class EZ_FOUNDATION_DLL ArchiveType : public ezDataDirectoryType
@@ -53,6 +57,10 @@ namespace ezDataDirectory
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZstd>, 4> m_ReadersZstd;
     ezHybridArray<ArchiveReaderZstd*, 4> m_FreeReadersZstd;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdChunked>, 4> m_ReadersZstdChunked;
+    ezHybridArray<ArchiveReaderZstdChunked*, 4> m_FreeReadersZstdChunked;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdDictionary>, 4> m_ReadersZstdDictionary;
+    ezHybridArray<ArchiveReaderZstdDictionary*, 4> m_FreeReadersZstdDictionary;
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZip>, 4> m_ReadersZip;
@@ -69,7 +77,9 @@ namespace ezDataDirectory
     ~ArchiveReaderUncompressed();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
+    virtual ezArrayPtr<const ezUInt8> GetDirectView() const override { return m_DirectView; }
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -80,6 +90,7 @@ namespace ezDataDirectory
     ezUInt64 m_uiUncompressedSize = 0;
     ezUInt64 m_uiCompressedSize = 0;
     ezRawMemoryStreamReader m_MemStreamReader;
+    ezArrayPtr<const ezUInt8> m_DirectView;
   };
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -92,6 +103,7 @@ namespace ezDataDirectory
     ~ArchiveReaderZstd();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -100,6 +112,42 @@ namespace ezDataDirectory
 
     ezCompressedStreamReaderZstd m_CompressedStreamReader;
   };
+
+  /// \brief Reads entries stored with ezArchiveCompressionMode::Compressed_zstd_chunked. Skipping does not decompress the skipped chunks.
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdChunked : public ArchiveReaderUncompressed
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdChunked);
+
+  public:
+    ArchiveReaderZstdChunked(ezInt32 iDataDirUserData);
+    ~ArchiveReaderZstdChunked();
+
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
+
+  protected:
+    friend class ArchiveType;
+
+    ezArchiveChunkedReaderZstd m_ChunkedReader;
+  };
+
+  /// \brief Reads entries stored with ezArchiveCompressionMode::Compressed_zstd_dictionary.
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdDictionary : public ArchiveReaderUncompressed
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdDictionary);
+
+  public:
+    ArchiveReaderZstdDictionary(ezInt32 iDataDirUserData);
+    ~ArchiveReaderZstdDictionary();
+
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
+
+  protected:
+    friend class ArchiveType;
+
+    ezArchiveDictionaryReaderZstd m_DictionaryReader;
+  };
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -112,6 +160,7 @@ namespace ezDataDirectory
     ~ArchiveReaderZip();
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
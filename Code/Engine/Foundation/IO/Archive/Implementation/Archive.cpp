@@ -3,6 +3,10 @@
 #include <Foundation/IO/Archive/Archive.h>
 #include <Foundation/Logging/Log.h>
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+#  include <zstd/zstd.h>
+#endif
+
 void operator<<(ezStreamWriter& stream, const ezArchiveStoredString& value)
 {
   stream << value.m_uiLowerCaseHash;
@@ -15,6 +19,33 @@ void operator>>(ezStreamReader& stream, ezArchiveStoredString& value)
   stream >> value.m_uiSrcStringOffset;
 }
 
+ezArchiveTOC::ezArchiveTOC() = default;
+
+ezArchiveTOC::~ezArchiveTOC()
+{
+  FreeDecompressionDictionaries();
+}
+
+const void* ezArchiveTOC::GetDecompressionDictionary(ezUInt32 uiDictionary) const
+{
+  if (uiDictionary >= m_DecompressionDictionaries.GetCount())
+    return nullptr;
+
+  return m_DecompressionDictionaries[uiDictionary];
+}
+
+void ezArchiveTOC::FreeDecompressionDictionaries()
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  for (void* pDictionary : m_DecompressionDictionaries)
+  {
+    ZSTD_freeDDict(reinterpret_cast<ZSTD_DDict*>(pDictionary));
+  }
+#endif
+
+  m_DecompressionDictionaries.Clear();
+}
+
 ezUInt32 ezArchiveTOC::FindEntry(const char* szFile) const
 {
   ezStringBuilder sLowerCasePath = szFile;
@@ -36,9 +67,17 @@ const char* ezArchiveTOC::GetEntryPathString(ezUInt32 uiEntryIdx) const
   return reinterpret_cast<const char*>(&m_AllPathStrings[m_Entries[uiEntryIdx].m_uiPathStringOffset]);
 }
 
+ezUInt32 ezArchiveTOC::GetNumChunks(const ezArchiveEntry& entry) const
+{
+  if (entry.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_chunked)
+    return 0;
+
+  return static_cast<ezUInt32>((entry.m_uiUncompressedDataSize + m_uiChunkSize - 1) / m_uiChunkSize);
+}
+
 ezResult ezArchiveTOC::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(2);
+  stream.WriteVersion(4);
 
   EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_Entries));
 
@@ -47,12 +86,38 @@ ezResult ezArchiveTOC::Serialize(ezStreamWriter& stream) const
 
   EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_AllPathStrings));
 
+  // version 3 added chunked entries
+  stream << m_uiChunkSize;
+  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_ChunkOffsets));
+
+  // version 4 added dictionary compressed entries
+  {
+    stream << m_Dictionaries.GetCount();
+
+    for (const auto& dictionary : m_Dictionaries)
+    {
+      EZ_SUCCEED_OR_RETURN(stream.WriteArray(dictionary));
+    }
+
+    ezDynamicArray<ezUInt16> entryDictionaries;
+
+    for (const ezArchiveEntry& entry : m_Entries)
+    {
+      if (entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary)
+      {
+        entryDictionaries.PushBack(entry.m_uiDictionary);
+      }
+    }
+
+    EZ_SUCCEED_OR_RETURN(stream.WriteArray(entryDictionaries));
+  }
+
   return EZ_SUCCESS;
 }
 
 ezResult ezArchiveTOC::Deserialize(ezStreamReader& stream)
 {
-  ezTypeVersion version = stream.ReadVersion(2);
+  ezTypeVersion version = stream.ReadVersion(4);
 
   EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_Entries));
 
@@ -71,6 +136,35 @@ ezResult ezArchiveTOC::Deserialize(ezStreamReader& stream)
 
   EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_AllPathStrings));
 
+  if (version >= 3)
+  {
+    stream >> m_uiChunkSize;
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_ChunkOffsets));
+  }
+
+  ezDynamicArray<ezUInt16> entryDictionaries;
+
+  if (version >= 4)
+  {
+    ezUInt32 uiNumDictionaries = 0;
+    stream >> uiNumDictionaries;
+
+    if (uiNumDictionaries > ezMath::MaxValue<ezUInt16>())
+    {
+      ezLog::Error("Archive is corrupt. Invalid number of dictionaries.");
+      return EZ_FAILURE;
+    }
+
+    m_Dictionaries.SetCount(uiNumDictionaries);
+
+    for (auto& dictionary : m_Dictionaries)
+    {
+      EZ_SUCCEED_OR_RETURN(stream.ReadArray(dictionary));
+    }
+
+    EZ_SUCCEED_OR_RETURN(stream.ReadArray(entryDictionaries));
+  }
+
   if (version == 1)
   {
     // version 1 stores an older way for the path/hash -> entry lookup table, which is prone to hash collisions
@@ -106,6 +200,68 @@ ezResult ezArchiveTOC::Deserialize(ezStreamReader& stream)
     return EZ_FAILURE;
   }
 
+  // the chunks of all chunked entries are stored one after the other, so the first chunk of each entry follows from the previous ones
+  {
+    if (m_uiChunkSize == 0)
+    {
+      ezLog::Error("Archive is corrupt. Invalid chunk size.");
+      return EZ_FAILURE;
+    }
+
+    ezUInt64 uiNextChunk = 0;
+
+    for (ezArchiveEntry& entry : m_Entries)
+    {
+      entry.m_uiFirstChunk = static_cast<ezUInt32>(uiNextChunk);
+      uiNextChunk += GetNumChunks(entry);
+    }
+
+    if (uiNextChunk != m_ChunkOffsets.GetCount())
+    {
+      ezLog::Error("Archive is corrupt. Invalid chunk data.");
+      return EZ_FAILURE;
+    }
+  }
+
+  // the dictionary indices are only stored for the entries that use a dictionary
+  {
+    ezUInt32 uiNextEntryDictionary = 0;
+
+    for (ezArchiveEntry& entry : m_Entries)
+    {
+      if (entry.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd_dictionary)
+        continue;
+
+      if (uiNextEntryDictionary >= entryDictionaries.GetCount() || entryDictionaries[uiNextEntryDictionary] >= m_Dictionaries.GetCount())
+      {
+        ezLog::Error("Archive is corrupt. Invalid dictionary data.");
+        return EZ_FAILURE;
+      }
+
+      entry.m_uiDictionary = entryDictionaries[uiNextEntryDictionary];
+      ++uiNextEntryDictionary;
+    }
+  }
+
+  FreeDecompressionDictionaries();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  m_DecompressionDictionaries.Reserve(m_Dictionaries.GetCount());
+
+  for (const auto& dictionary : m_Dictionaries)
+  {
+    ZSTD_DDict* pDictionary = ZSTD_createDDict(dictionary.GetData(), dictionary.GetCount());
+
+    if (pDictionary == nullptr)
+    {
+      ezLog::Error("Archive is corrupt. Invalid dictionary.");
+      return EZ_FAILURE;
+    }
+
+    m_DecompressionDictionaries.PushBack(pDictionary);
+  }
+#endif
+
   return EZ_SUCCESS;
 }
 
@@ -1,10 +1,96 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Containers/Map.h>
 #include <Foundation/IO/Archive/ArchiveBuilder.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+struct ezArchiveBuilder::CompressedEntry
+{
+  ezMemoryStreamStorage m_Data;
+  ezArchiveEntry m_Entry;
+  ezDynamicArray<ezUInt64> m_ChunkOffsets;
+  ezUInt64 m_uiContentHash = 0;
+  ezUInt32 m_uiDuplicateOf = ezInvalidIndex;
+  ezResult m_Result = EZ_SUCCESS;
+  bool m_bWriteDirectly = false;
+};
+
+namespace
+{
+  // the files are compressed in batches, to limit how much compressed data is held in memory before it is written
+  constexpr ezUInt32 s_uiMaxBatchEntries = 256;
+  constexpr ezUInt64 s_uiMaxBatchBytes = 256 * 1024 * 1024;
+
+  // larger files are not compressed into memory, but written to the archive directly, one after the other
+  constexpr ezUInt64 s_uiMaxBufferedEntryBytes = 16 * 1024 * 1024;
+
+  ezUInt64 GetSourceFileSize(const char* szFile)
+  {
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+    ezFileStats stats;
+    if (ezOSFile::GetFileStats(szFile, stats).Succeeded())
+      return stats.m_uiFileSize;
+#endif
+
+    return 0;
+  }
+
+  ezResult ComputeContentHash(const char* szFile, ezUInt64& out_uiHash)
+  {
+    ezFileReader file;
+    if (file.Open(szFile, 1024 * 1024).Failed())
+    {
+      ezLog::Error("Could not open '{}' for reading", szFile);
+      return EZ_FAILURE;
+    }
+
+    ezDynamicArray<ezUInt8> buffer;
+    buffer.SetCountUninitialized(1024 * 1024);
+
+    out_uiHash = 0;
+
+    while (true)
+    {
+      const ezUInt64 uiRead = file.ReadBytes(buffer.GetData(), buffer.GetCount());
+
+      if (uiRead == 0)
+        break;
+
+      // chain the blocks through the seed
+      out_uiHash = ezHashingUtils::xxHash64(buffer.GetData(), static_cast<size_t>(uiRead), out_uiHash);
+    }
+
+    return EZ_SUCCESS;
+  }
+
+  bool AreFilesEqual(const char* szFile1, const char* szFile2)
+  {
+    ezFileReader file1, file2;
+    if (file1.Open(szFile1).Failed() || file2.Open(szFile2).Failed() || file1.GetFileSize() != file2.GetFileSize())
+      return false;
+
+    ezUInt8 uiTemp1[1024 * 8];
+    ezUInt8 uiTemp2[1024 * 8];
+
+    while (true)
+    {
+      const ezUInt64 uiRead1 = file1.ReadBytes(uiTemp1, EZ_ARRAY_SIZE(uiTemp1));
+      const ezUInt64 uiRead2 = file2.ReadBytes(uiTemp2, EZ_ARRAY_SIZE(uiTemp2));
+
+      if (uiRead1 != uiRead2 || !ezMemoryUtils::IsEqual(uiTemp1, uiTemp2, static_cast<size_t>(uiRead1)))
+        return false;
+
+      if (uiRead1 == 0)
+        return true;
+    }
+  }
+} // namespace
 
 void ezArchiveBuilder::AddFolder(const char* szAbsFolderPath,
   ezArchiveCompressionMode defaultMode /*= ezArchiveCompressionMode::Uncompressed*/, InclusionCallback callback /*= InclusionCallback()*/)
@@ -81,29 +167,153 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
 
   ezArchiveTOC toc;
 
+  if (m_uiChunkSize > 0)
+  {
+    toc.m_uiChunkSize = m_uiChunkSize;
+  }
+
+  ezDynamicArray<ezUInt32> entryDictionaries;
+  EZ_SUCCEED_OR_RETURN(BuildDictionaries(toc, entryDictionaries));
+
   ezStringBuilder sHashablePath;
 
   ezUInt64 uiStreamSize = 0;
   const ezUInt32 uiNumEntries = m_Entries.GetCount();
 
-  for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+  // maps a content hash to the first entry with that content
+  ezHashTable<ezUInt64, ezUInt32> contentToEntry;
+
+  ezParallelForParams parallelForParams;
+  parallelForParams.splitting = ezParallelForSplitting::Adaptive; // file sizes vary a lot
+
+  ezDeque<CompressedEntry> batch;
+  ezDynamicArray<ezUInt64> duplicateChunkOffsets;
+
+  for (ezUInt32 uiBatchStart = 0; uiBatchStart < uiNumEntries;)
   {
-    const SourceEntry& e = m_Entries[i];
+    ezUInt32 uiBatchEnd = uiBatchStart;
+    ezUInt64 uiBatchBytes = 0;
 
-    const ezUInt32 uiPathStringOffset = toc.m_AllPathStrings.GetCount();
-    toc.m_AllPathStrings.PushBackRange(
-      ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(e.m_sRelTargetPath.GetData()), e.m_sRelTargetPath.GetElementCount() + 1));
+    batch.Clear();
 
-    sHashablePath = e.m_sRelTargetPath;
-    sHashablePath.ToLower();
+    while (uiBatchEnd < uiNumEntries && uiBatchEnd - uiBatchStart < s_uiMaxBatchEntries)
+    {
+      const SourceEntry& e = m_Entries[uiBatchEnd];
+      const ezUInt64 uiFileSize = GetSourceFileSize(e.m_sAbsSourcePath);
 
-    toc.m_PathToEntryIndex[ezArchiveStoredString(ezTempHashedString::ComputeHash(sHashablePath.GetData()), uiPathStringOffset)] = toc.m_Entries.GetCount();
+      // uncompressed and large files are streamed to the archive, they never count towards the memory that a batch holds
+      const bool bWriteDirectly = e.m_CompressionMode == ezArchiveCompressionMode::Uncompressed || uiFileSize > s_uiMaxBufferedEntryBytes;
+      const ezUInt64 uiBufferedBytes = bWriteDirectly ? 0 : uiFileSize;
 
-    if (!WriteNextFileCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath))
-      return EZ_FAILURE;
+      if (uiBatchEnd > uiBatchStart && uiBatchBytes + uiBufferedBytes > s_uiMaxBatchBytes)
+        break;
+
+      uiBatchBytes += uiBufferedBytes;
+      batch.ExpandAndGetRef().m_bWriteDirectly = bWriteDirectly;
+      ++uiBatchEnd;
+    }
+
+    if (m_bDeduplicateFiles)
+    {
+      ezTaskSystem::ParallelForIndexed(
+        0, batch.GetCount(),
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            batch[i].m_Result = ComputeContentHash(m_Entries[uiBatchStart + i].m_sAbsSourcePath, batch[i].m_uiContentHash);
+          }
+        },
+        "Hash Archive Files", parallelForParams);
+
+      for (ezUInt32 i = 0; i < batch.GetCount(); ++i)
+      {
+        if (batch[i].m_Result.Failed())
+          return EZ_FAILURE;
+
+        ezUInt32 uiOriginal = ezInvalidIndex;
+        if (!contentToEntry.TryGetValue(batch[i].m_uiContentHash, uiOriginal))
+        {
+          contentToEntry.Insert(batch[i].m_uiContentHash, uiBatchStart + i);
+        }
+        else if (AreFilesEqual(m_Entries[uiOriginal].m_sAbsSourcePath, m_Entries[uiBatchStart + i].m_sAbsSourcePath))
+        {
+          batch[i].m_uiDuplicateOf = uiOriginal;
+        }
+      }
+    }
+
+    ezTaskSystem::ParallelForIndexed(
+      0, batch.GetCount(),
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          if (batch[i].m_uiDuplicateOf == ezInvalidIndex && !batch[i].m_bWriteDirectly)
+          {
+            ezMemoryStreamWriter writer(&batch[i].m_Data);
+
+            // the data start offset is fixed when the data is appended to the archive
+            ezUInt64 uiStreamPos = 0;
+            batch[i].m_Result = CompressEntry(uiBatchStart + i, toc, entryDictionaries[uiBatchStart + i], writer, uiStreamPos, batch[i]);
+          }
+        }
+      },
+      "Compress Archive Files", parallelForParams);
+
+    // append the compressed data in order and build the TOC
+    for (ezUInt32 i = 0; i < batch.GetCount(); ++i)
+    {
+      const ezUInt32 uiEntryIdx = uiBatchStart + i;
+      const SourceEntry& e = m_Entries[uiEntryIdx];
+      CompressedEntry& result = batch[i];
+
+      const ezUInt32 uiPathStringOffset = toc.m_AllPathStrings.GetCount();
+      toc.m_AllPathStrings.PushBackRange(
+        ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(e.m_sRelTargetPath.GetData()), e.m_sRelTargetPath.GetElementCount() + 1));
+
+      sHashablePath = e.m_sRelTargetPath;
+      sHashablePath.ToLower();
+
+      toc.m_PathToEntryIndex[ezArchiveStoredString(ezTempHashedString::ComputeHash(sHashablePath.GetData()), uiPathStringOffset)] = toc.m_Entries.GetCount();
+
+      if (!WriteNextFileCallback(uiEntryIdx + 1, uiNumEntries, e.m_sAbsSourcePath))
+        return EZ_FAILURE;
+
+      if (result.m_Result.Failed())
+        return EZ_FAILURE;
+
+      if (result.m_uiDuplicateOf != ezInvalidIndex)
+      {
+        // reference the data of the original entry
+        const ezArchiveEntry& original = toc.m_Entries[result.m_uiDuplicateOf];
+
+        duplicateChunkOffsets = toc.m_ChunkOffsets.GetArrayPtr().GetSubArray(original.m_uiFirstChunk, toc.GetNumChunks(original));
+        result.m_Entry = original;
+        result.m_ChunkOffsets.Swap(duplicateChunkOffsets);
+      }
+      else if (result.m_bWriteDirectly)
+      {
+        EZ_SUCCEED_OR_RETURN(CompressEntry(uiEntryIdx, toc, entryDictionaries[uiEntryIdx], stream, uiStreamSize, result));
+      }
+      else
+      {
+        result.m_Entry.m_uiDataStartOffset = uiStreamSize;
+
+        EZ_SUCCEED_OR_RETURN(stream.WriteBytes(result.m_Data.GetData(), result.m_Data.GetStorageSize()));
+        uiStreamSize += result.m_Data.GetStorageSize();
+
+        // free the memory right away, the batch may be large
+        result.m_Data.Clear();
+        result.m_Data.Compact();
+      }
 
-    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode,
-      toc.m_Entries.ExpandAndGetRef(), uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+      result.m_Entry.m_uiPathStringOffset = uiPathStringOffset;
+      result.m_Entry.m_uiFirstChunk = toc.m_ChunkOffsets.GetCount();
+      toc.m_ChunkOffsets.PushBackRange(result.m_ChunkOffsets);
+
+      toc.m_Entries.PushBack(result.m_Entry);
+    }
+
+    uiBatchStart = uiBatchEnd;
   }
 
   EZ_SUCCEED_OR_RETURN(ezArchiveUtils::AppendTOC(stream, toc));
@@ -111,6 +321,91 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& stream) const
   return EZ_SUCCESS;
 }
 
+ezResult ezArchiveBuilder::BuildDictionaries(ezArchiveTOC& toc, ezDynamicArray<ezUInt32>& out_EntryDictionaries) const
+{
+  out_EntryDictionaries.SetCount(m_Entries.GetCount(), ezInvalidIndex);
+
+#if defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+  if (m_uiMaxDictionaryFileSize == 0)
+    return EZ_SUCCESS;
+
+  // group the small files by their extension, files of the same type share the most data
+  ezMap<ezString, ezDynamicArray<ezUInt32>> filesByExtension;
+
+  ezStringBuilder sExtension;
+  ezFileStats stats;
+
+  for (ezUInt32 i = 0; i < m_Entries.GetCount(); ++i)
+  {
+    const SourceEntry& e = m_Entries[i];
+
+    if (e.m_CompressionMode != ezArchiveCompressionMode::Compressed_zstd)
+      continue;
+
+    if (ezOSFile::GetFileStats(e.m_sAbsSourcePath, stats).Failed() || stats.m_uiFileSize == 0 || stats.m_uiFileSize > m_uiMaxDictionaryFileSize)
+      continue;
+
+    sExtension = ezPathUtils::GetFileExtension(e.m_sAbsSourcePath);
+    sExtension.ToLower();
+
+    filesByExtension[sExtension].PushBack(i);
+  }
+
+  ezDynamicArray<ezString> sampleFiles;
+
+  for (auto it = filesByExtension.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Value().GetCount() < ezMath::Max(m_uiMinFilesPerDictionary, 1u) || toc.m_Dictionaries.GetCount() >= ezMath::MaxValue<ezUInt16>())
+      continue;
+
+    sampleFiles.Clear();
+    for (ezUInt32 uiEntry : it.Value())
+    {
+      sampleFiles.PushBack(m_Entries[uiEntry].m_sAbsSourcePath);
+    }
+
+    ezDynamicArray<ezUInt8> dictionary;
+    if (ezArchiveUtils::BuildDictionary(sampleFiles, m_uiMaxDictionarySize, dictionary).Failed())
+    {
+      ezLog::Warning("Failed to build a dictionary for '{}' files", it.Key());
+      continue;
+    }
+
+    for (ezUInt32 uiEntry : it.Value())
+    {
+      out_EntryDictionaries[uiEntry] = toc.m_Dictionaries.GetCount();
+    }
+
+    toc.m_Dictionaries.PushBack(std::move(dictionary));
+  }
+#endif
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezArchiveBuilder::CompressEntry(ezUInt32 uiEntryIdx, const ezArchiveTOC& toc, ezUInt32 uiDictionary, ezStreamWriter& stream, ezUInt64& inout_uiStreamPos, CompressedEntry& out_Result) const
+{
+  const SourceEntry& e = m_Entries[uiEntryIdx];
+
+  // the path string offset is filled out when the entry is added to the TOC
+  const bool bZstd = e.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd || e.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked;
+
+  if (uiDictionary != ezInvalidIndex)
+  {
+    return ezArchiveUtils::WriteEntryWithDictionary(stream, e.m_sAbsSourcePath, 0, toc, static_cast<ezUInt16>(uiDictionary), out_Result.m_Entry,
+      inout_uiStreamPos, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this));
+  }
+
+  if (bZstd && m_uiChunkSize > 0)
+  {
+    return ezArchiveUtils::WriteEntryChunked(stream, e.m_sAbsSourcePath, 0, toc.m_uiChunkSize, out_Result.m_Entry, out_Result.m_ChunkOffsets,
+      inout_uiStreamPos, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this));
+  }
+
+  return ezArchiveUtils::WriteEntryOptimal(stream, e.m_sAbsSourcePath, 0, bZstd ? ezArchiveCompressionMode::Compressed_zstd : e.m_CompressionMode,
+    out_Result.m_Entry, inout_uiStreamPos, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this));
+}
+
 bool ezArchiveBuilder::WriteNextFileCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, const char* szSourceFile) const
 {
   return true;
@@ -0,0 +1,153 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/IO/Archive/ArchiveChunkedReader.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <zstd/zstd.h>
+
+ezArchiveChunkedReaderZstd::ezArchiveChunkedReaderZstd() = default;
+ezArchiveChunkedReaderZstd::~ezArchiveChunkedReaderZstd() = default;
+
+void ezArchiveChunkedReaderZstd::Configure(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData)
+{
+  const ezArchiveEntry& entry = toc.m_Entries[uiEntryIdx];
+  EZ_ASSERT_DEV(entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked, "Archive entry {} is not stored in chunks", uiEntryIdx);
+
+  const ezUInt32 uiNumChunks = toc.GetNumChunks(entry);
+
+  m_pEntryData = static_cast<const ezUInt8*>(ezMemoryUtils::AddByteOffset(pStartOfArchiveData, entry.m_uiDataStartOffset));
+  m_uiStoredSize = entry.m_uiStoredDataSize;
+  m_uiUncompressedSize = entry.m_uiUncompressedDataSize;
+  m_uiChunkSize = toc.m_uiChunkSize;
+  m_ChunkOffsets = toc.m_ChunkOffsets.GetArrayPtr().GetSubArray(entry.m_uiFirstChunk, uiNumChunks);
+
+  m_uiReadPosition = 0;
+  m_uiCachedChunk = ezInvalidIndex;
+  m_ChunkCache.SetCountUninitialized(toc.m_uiChunkSize);
+}
+
+ezUInt64 ezArchiveChunkedReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  if (pReadBuffer == nullptr)
+    return SkipBytes(uiBytesToRead);
+
+  uiBytesToRead = ezMath::Min(uiBytesToRead, m_uiUncompressedSize - m_uiReadPosition);
+
+  ezUInt8* pTarget = static_cast<ezUInt8*>(pReadBuffer);
+  ezUInt64 uiBytesRead = 0;
+
+  while (uiBytesRead < uiBytesToRead)
+  {
+    const ezUInt32 uiChunk = static_cast<ezUInt32>(m_uiReadPosition / m_uiChunkSize);
+    const ezUInt64 uiOffsetInChunk = m_uiReadPosition % m_uiChunkSize;
+    const ezUInt64 uiBytesLeft = uiBytesToRead - uiBytesRead;
+
+    // entire chunks are decompressed directly into the target buffer, without going through the cache
+    if (uiOffsetInChunk == 0 && uiChunk != m_uiCachedChunk && uiBytesLeft >= GetChunkUncompressedSize(uiChunk))
+    {
+      ezUInt32 uiNumChunks = 0;
+      ezUInt64 uiDecompressed = 0;
+
+      while (uiChunk + uiNumChunks < GetNumChunks() && uiDecompressed + GetChunkUncompressedSize(uiChunk + uiNumChunks) <= uiBytesLeft)
+      {
+        uiDecompressed += GetChunkUncompressedSize(uiChunk + uiNumChunks);
+        ++uiNumChunks;
+      }
+
+      if (DecompressChunks(uiChunk, uiNumChunks, pTarget + uiBytesRead).Failed())
+        break;
+
+      m_uiReadPosition += uiDecompressed;
+      uiBytesRead += uiDecompressed;
+      continue;
+    }
+
+    if (uiChunk != m_uiCachedChunk)
+    {
+      if (DecompressChunk(uiChunk, m_ChunkCache.GetData()).Failed())
+        break;
+
+      m_uiCachedChunk = uiChunk;
+    }
+
+    const ezUInt64 uiCopy = ezMath::Min(uiBytesLeft, GetChunkUncompressedSize(uiChunk) - uiOffsetInChunk);
+    ezMemoryUtils::Copy(pTarget + uiBytesRead, m_ChunkCache.GetData() + uiOffsetInChunk, static_cast<size_t>(uiCopy));
+
+    m_uiReadPosition += uiCopy;
+    uiBytesRead += uiCopy;
+  }
+
+  return uiBytesRead;
+}
+
+ezUInt64 ezArchiveChunkedReaderZstd::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  const ezUInt64 uiBytes = ezMath::Min(uiBytesToSkip, m_uiUncompressedSize - m_uiReadPosition);
+
+  m_uiReadPosition += uiBytes;
+
+  return uiBytes;
+}
+
+void ezArchiveChunkedReaderZstd::SetReadPosition(ezUInt64 uiReadPosition)
+{
+  EZ_ASSERT_RELEASE(uiReadPosition <= m_uiUncompressedSize, "Read position must be between 0 and GetByteCount()!");
+  m_uiReadPosition = uiReadPosition;
+}
+
+ezUInt64 ezArchiveChunkedReaderZstd::GetChunkUncompressedSize(ezUInt32 uiChunk) const
+{
+  return ezMath::Min(m_uiChunkSize, m_uiUncompressedSize - static_cast<ezUInt64>(uiChunk) * m_uiChunkSize);
+}
+
+ezResult ezArchiveChunkedReaderZstd::DecompressChunk(ezUInt32 uiChunk, void* pTarget) const
+{
+  const ezUInt64 uiStart = m_ChunkOffsets[uiChunk];
+  const ezUInt64 uiEnd = (uiChunk + 1 < GetNumChunks()) ? m_ChunkOffsets[uiChunk + 1] : m_uiStoredSize;
+  const ezUInt64 uiExpectedSize = GetChunkUncompressedSize(uiChunk);
+
+  const size_t res = ZSTD_decompress(pTarget, static_cast<size_t>(uiExpectedSize), m_pEntryData + uiStart, static_cast<size_t>(uiEnd - uiStart));
+
+  if (ZSTD_isError(res))
+  {
+    EZ_REPORT_FAILURE("Decompressing archive chunk {} failed: '{}'", uiChunk, ZSTD_getErrorName(res));
+    return EZ_FAILURE;
+  }
+
+  if (res != uiExpectedSize)
+  {
+    EZ_REPORT_FAILURE("Archive chunk {} decompressed to {} bytes, expected {} bytes", uiChunk, static_cast<ezUInt64>(res), uiExpectedSize);
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezArchiveChunkedReaderZstd::DecompressChunks(ezUInt32 uiFirstChunk, ezUInt32 uiNumChunks, void* pTarget) const
+{
+  if (uiNumChunks == 1)
+    return DecompressChunk(uiFirstChunk, pTarget);
+
+  ezAtomicBool bFailed = false;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumChunks,
+    [this, uiFirstChunk, pTarget, &bFailed](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        void* pChunkTarget = ezMemoryUtils::AddByteOffset(pTarget, static_cast<ptrdiff_t>(i * m_uiChunkSize));
+
+        if (DecompressChunk(uiFirstChunk + i, pChunkTarget).Failed())
+          bFailed = true;
+      }
+    },
+    "Decompress Archive Chunks");
+
+  return bFailed ? EZ_FAILURE : EZ_SUCCESS;
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Archive_Implementation_ArchiveChunkedReader);
@@ -0,0 +1,80 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/IO/Archive/ArchiveDictionaryReader.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <zstd/zstd.h>
+
+ezArchiveDictionaryReaderZstd::ezArchiveDictionaryReaderZstd() = default;
+
+ezArchiveDictionaryReaderZstd::~ezArchiveDictionaryReaderZstd()
+{
+  if (m_pZstdDCtx != nullptr)
+  {
+    ZSTD_freeDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx));
+    m_pZstdDCtx = nullptr;
+  }
+}
+
+ezResult ezArchiveDictionaryReaderZstd::Configure(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData)
+{
+  const ezArchiveEntry& entry = toc.m_Entries[uiEntryIdx];
+  EZ_ASSERT_DEV(entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary, "Archive entry {} is not compressed with a dictionary", uiEntryIdx);
+
+  m_DataReader.Reset(nullptr, 0);
+
+  if (m_pZstdDCtx == nullptr)
+  {
+    m_pZstdDCtx = ZSTD_createDCtx();
+  }
+
+  m_Data.SetCountUninitialized(static_cast<ezUInt32>(entry.m_uiUncompressedDataSize));
+
+  const void* pCompressedData = ezMemoryUtils::AddByteOffset(pStartOfArchiveData, entry.m_uiDataStartOffset);
+  const size_t uiCompressedSize = static_cast<size_t>(entry.m_uiStoredDataSize);
+
+  size_t res = 0;
+
+  if (const ZSTD_DDict* pDictionary = reinterpret_cast<const ZSTD_DDict*>(toc.GetDecompressionDictionary(entry.m_uiDictionary)))
+  {
+    res = ZSTD_decompress_usingDDict(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx), m_Data.GetData(), m_Data.GetCount(), pCompressedData, uiCompressedSize, pDictionary);
+  }
+  else
+  {
+    // TOCs that were not deserialized have no digested dictionaries
+    const ezDynamicArray<ezUInt8>& dictionary = toc.m_Dictionaries[entry.m_uiDictionary];
+
+    res = ZSTD_decompress_usingDict(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx), m_Data.GetData(), m_Data.GetCount(), pCompressedData, uiCompressedSize,
+      dictionary.GetData(), dictionary.GetCount());
+  }
+
+  if (ZSTD_isError(res))
+  {
+    EZ_REPORT_FAILURE("Decompressing archive entry {} failed: '{}'", uiEntryIdx, ZSTD_getErrorName(res));
+    return EZ_FAILURE;
+  }
+
+  if (res != m_Data.GetCount())
+  {
+    EZ_REPORT_FAILURE("Archive entry {} decompressed to {} bytes, expected {} bytes", uiEntryIdx, static_cast<ezUInt64>(res), m_Data.GetCount());
+    return EZ_FAILURE;
+  }
+
+  m_DataReader.Reset(m_Data.GetData(), m_Data.GetCount());
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezArchiveDictionaryReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  return m_DataReader.ReadBytes(pReadBuffer, uiBytesToRead);
+}
+
+ezUInt64 ezArchiveDictionaryReaderZstd::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  return m_DataReader.SkipBytes(uiBytesToSkip);
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Archive_Implementation_ArchiveDictionaryReader);
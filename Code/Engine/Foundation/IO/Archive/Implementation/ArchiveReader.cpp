@@ -1,5 +1,7 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveChunkedReader.h>
+#include <Foundation/IO/Archive/ArchiveDictionaryReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
@@ -81,6 +83,20 @@ ezResult ezArchiveReader::OpenArchive(const char* szPath)
         ezLog::Error("Archive is corrupt. Invalid entry path-string offset.");
         return EZ_FAILURE;
       }
+
+      // chunk offsets must be increasing and lie within the entry's data
+      const ezUInt32 uiNumChunks = m_ArchiveTOC.GetNumChunks(e);
+      for (ezUInt32 c = 0; c < uiNumChunks; ++c)
+      {
+        const ezUInt64 uiChunkOffset = m_ArchiveTOC.m_ChunkOffsets[e.m_uiFirstChunk + c];
+        const ezUInt64 uiNextChunkOffset = (c + 1 < uiNumChunks) ? m_ArchiveTOC.m_ChunkOffsets[e.m_uiFirstChunk + c + 1] : e.m_uiStoredDataSize;
+
+        if (uiChunkOffset >= uiNextChunkOffset)
+        {
+          ezLog::Error("Archive is corrupt. Invalid entry chunk offset.");
+          return EZ_FAILURE;
+        }
+      }
     }
   }
 
@@ -120,9 +136,39 @@ void ezArchiveReader::ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawM
   ezArchiveUtils::ConfigureRawMemoryStreamReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, memReader);
 }
 
+ezArrayPtr<const ezUInt8> ezArchiveReader::GetEntryRawData(ezUInt32 uiEntryIdx) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  if (entry.m_uiStoredDataSize > ezMath::MaxValue<ezUInt32>())
+    return ezArrayPtr<const ezUInt8>();
+
+  return ezArrayPtr<const ezUInt8>(static_cast<const ezUInt8*>(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset))),
+    static_cast<ezUInt32>(entry.m_uiStoredDataSize));
+}
+
+void ezArchiveReader::ConfigureChunkedReader(ezUInt32 uiEntryIdx, ezArchiveChunkedReaderZstd& reader) const
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  reader.Configure(m_ArchiveTOC, uiEntryIdx, m_pDataStart);
+#else
+  EZ_REPORT_FAILURE("zstd support is not compiled in");
+#endif
+}
+
+ezResult ezArchiveReader::ConfigureDictionaryReader(ezUInt32 uiEntryIdx, ezArchiveDictionaryReaderZstd& reader) const
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  return reader.Configure(m_ArchiveTOC, uiEntryIdx, m_pDataStart);
+#else
+  EZ_REPORT_FAILURE("zstd support is not compiled in");
+  return EZ_FAILURE;
+#endif
+}
+
 ezUniquePtr<ezStreamReader> ezArchiveReader::CreateEntryReader(ezUInt32 uiEntryIdx) const
 {
-  return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart);
+  return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC, uiEntryIdx, m_pDataStart);
 }
 
 ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, const char* szTargetFolder) const
@@ -131,6 +177,8 @@ ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, const char* szTargetF
   const ezUInt64 uiMaxSize = m_ArchiveTOC.m_Entries[uiEntryIdx].m_uiUncompressedDataSize;
 
   ezUniquePtr<ezStreamReader> pReader = CreateEntryReader(uiEntryIdx);
+  if (pReader == nullptr)
+    return EZ_FAILURE;
 
   ezStringBuilder sOutputFile = szTargetFolder;
   sOutputFile.AppendPath(szFilePath);
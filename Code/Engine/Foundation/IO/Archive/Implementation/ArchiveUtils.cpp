@@ -1,5 +1,7 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveChunkedReader.h>
+#include <Foundation/IO/Archive/ArchiveDictionaryReader.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
 #include <Foundation/IO/CompressedStreamZlib.h>
@@ -8,6 +10,11 @@
 #include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Types/ScopeExit.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+#  include <zstd/zstd.h>
+#endif
 
 ezHybridArray<ezString, 4, ezStaticAllocatorWrapper>& ezArchiveUtils::GetAcceptedArchiveFileExtensions()
 {
@@ -37,8 +44,10 @@ ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& stream)
   const char* szTag = "EZARCHIVE";
   EZ_SUCCEED_OR_RETURN(stream.WriteBytes(szTag, 10));
 
-  const ezUInt8 uiArchiveVersion = 2;
+  const ezUInt8 uiArchiveVersion = 4;
   // Version 2: Added end-of-file marker for file corruption (cutoff) detection
+  // Version 3: Added chunked zstd entries (TOC version 3)
+  // Version 4: Added zstd dictionaries (TOC version 4)
   stream << uiArchiveVersion;
 
   const ezUInt8 uiPadding[5] = {0, 0, 0, 0, 0};
@@ -59,7 +68,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& stream, ezUInt8& out_uiVersi
   out_uiVersion = 0;
   stream >> out_uiVersion;
 
-  if (out_uiVersion != 1 && out_uiVersion != 2)
+  if (out_uiVersion < 1 || out_uiVersion > 4)
   {
     ezLog::Error("Unsupported archive version '{}'.", out_uiVersion);
     return EZ_FAILURE;
@@ -195,6 +204,192 @@ ezResult ezArchiveUtils::WriteEntryOptimal(ezStreamWriter& stream, const char* s
   }
 }
 
+ezResult ezArchiveUtils::WriteEntryChunked(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
+  ezUInt32 uiChunkSize, ezArchiveEntry& tocEntry, ezDynamicArray<ezUInt64>& inout_ChunkOffsets, ezUInt64& inout_uiCurrentStreamPosition,
+  FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/)
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  ezFileReader file;
+  EZ_SUCCEED_OR_RETURN(file.Open(szAbsSourcePath, 1024 * 1024));
+
+  const ezUInt64 uiMaxBytes = file.GetFileSize();
+
+  if (uiMaxBytes <= uiChunkSize)
+  {
+    file.Close();
+    return WriteEntryOptimal(stream, szAbsSourcePath, uiPathStringOffset, ezArchiveCompressionMode::Compressed_zstd, tocEntry, inout_uiCurrentStreamPosition, progress);
+  }
+
+  tocEntry.m_uiPathStringOffset = uiPathStringOffset;
+  tocEntry.m_uiDataStartOffset = inout_uiCurrentStreamPosition;
+  tocEntry.m_uiUncompressedDataSize = 0;
+  tocEntry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_chunked;
+  tocEntry.m_uiFirstChunk = inout_ChunkOffsets.GetCount();
+
+  ezDynamicArray<ezUInt8> uncompressedChunk;
+  uncompressedChunk.SetCountUninitialized(uiChunkSize);
+
+  ezDynamicArray<ezUInt8> compressedChunk;
+  compressedChunk.SetCountUninitialized(static_cast<ezUInt32>(ZSTD_compressBound(uiChunkSize)));
+
+  tocEntry.m_uiStoredDataSize = 0;
+
+  while (true)
+  {
+    const ezUInt64 uiRead = file.ReadBytes(uncompressedChunk.GetData(), uiChunkSize);
+
+    if (uiRead == 0)
+      break;
+
+    const size_t uiCompressedSize = ZSTD_compress(compressedChunk.GetData(), compressedChunk.GetCount(), uncompressedChunk.GetData(),
+      static_cast<size_t>(uiRead), ezCompressedStreamWriterZstd::Compression::Default);
+
+    if (ZSTD_isError(uiCompressedSize))
+    {
+      ezLog::Error("Compressing '{}' failed: '{}'", szAbsSourcePath, ZSTD_getErrorName(uiCompressedSize));
+      return EZ_FAILURE;
+    }
+
+    // the chunks are written as soon as they are compressed, so the decision is made on the first one
+    if (tocEntry.m_uiUncompressedDataSize == 0 && uiCompressedSize * 12 >= uiRead * 10)
+    {
+      // less than 20% size saving -> go uncompressed
+      file.Close();
+      return WriteEntry(stream, szAbsSourcePath, uiPathStringOffset, ezArchiveCompressionMode::Uncompressed, tocEntry, inout_uiCurrentStreamPosition, progress);
+    }
+
+    inout_ChunkOffsets.PushBack(tocEntry.m_uiStoredDataSize);
+    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(compressedChunk.GetData(), uiCompressedSize));
+
+    tocEntry.m_uiStoredDataSize += uiCompressedSize;
+    tocEntry.m_uiUncompressedDataSize += uiRead;
+
+    if (progress.IsValid())
+    {
+      if (!progress(tocEntry.m_uiUncompressedDataSize, uiMaxBytes))
+        return EZ_FAILURE;
+    }
+  }
+
+  inout_uiCurrentStreamPosition += tocEntry.m_uiStoredDataSize;
+
+  return EZ_SUCCESS;
+#else
+  return WriteEntryOptimal(stream, szAbsSourcePath, uiPathStringOffset, ezArchiveCompressionMode::Compressed_zstd, tocEntry, inout_uiCurrentStreamPosition, progress);
+#endif
+}
+
+ezResult ezArchiveUtils::BuildDictionary(ezArrayPtr<const ezString> sampleFiles, ezUInt32 uiMaxDictionarySize, ezDynamicArray<ezUInt8>& out_Dictionary)
+{
+  out_Dictionary.Clear();
+
+  if (sampleFiles.IsEmpty())
+    return EZ_FAILURE;
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  // every file may contribute the same amount, so that no single file dominates the dictionary
+  const ezUInt32 uiBytesPerFile = ezMath::Max(uiMaxDictionarySize / sampleFiles.GetCount(), 1024u);
+
+  ezDynamicArray<ezUInt8> sample;
+  ezDynamicArray<ezUInt8> compressed;
+  compressed.SetCountUninitialized(static_cast<ezUInt32>(ZSTD_compressBound(uiBytesPerFile)));
+
+  ZSTD_CCtx* pContext = ZSTD_createCCtx();
+  EZ_SCOPE_EXIT(ZSTD_freeCCtx(pContext));
+
+  for (const ezString& sFile : sampleFiles)
+  {
+    const ezUInt32 uiBytesToRead = ezMath::Min(uiBytesPerFile, uiMaxDictionarySize - out_Dictionary.GetCount());
+
+    if (uiBytesToRead == 0)
+      break;
+
+    ezFileReader file;
+    EZ_SUCCEED_OR_RETURN(file.Open(sFile, uiBytesToRead));
+
+    sample.SetCountUninitialized(uiBytesToRead);
+    sample.SetCount(static_cast<ezUInt32>(file.ReadBytes(sample.GetData(), uiBytesToRead)));
+
+    if (sample.IsEmpty())
+      continue;
+
+    if (!out_Dictionary.IsEmpty())
+    {
+      // skip samples that the dictionary already covers well, to keep it small and free of redundant content
+      const size_t uiCompressedSize = ZSTD_compress_usingDict(pContext, compressed.GetData(), compressed.GetCount(), sample.GetData(),
+        sample.GetCount(), out_Dictionary.GetData(), out_Dictionary.GetCount(), ezCompressedStreamWriterZstd::Compression::Default);
+
+      if (!ZSTD_isError(uiCompressedSize) && uiCompressedSize * 4 < sample.GetCount())
+        continue;
+    }
+
+    out_Dictionary.PushBackRange(sample);
+  }
+#endif
+
+  return out_Dictionary.IsEmpty() ? EZ_FAILURE : EZ_SUCCESS;
+}
+
+ezResult ezArchiveUtils::WriteEntryWithDictionary(ezStreamWriter& stream, const char* szAbsSourcePath, ezUInt32 uiPathStringOffset,
+  const ezArchiveTOC& toc, ezUInt16 uiDictionary, ezArchiveEntry& tocEntry, ezUInt64& inout_uiCurrentStreamPosition,
+  FileWriteProgressCallback progress /*= FileWriteProgressCallback()*/)
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  ezDynamicArray<ezUInt8> uncompressed;
+
+  {
+    ezFileReader file;
+    EZ_SUCCEED_OR_RETURN(file.Open(szAbsSourcePath));
+
+    uncompressed.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+    uncompressed.SetCount(static_cast<ezUInt32>(file.ReadBytes(uncompressed.GetData(), uncompressed.GetCount())));
+  }
+
+  tocEntry.m_uiPathStringOffset = uiPathStringOffset;
+  tocEntry.m_uiDataStartOffset = inout_uiCurrentStreamPosition;
+  tocEntry.m_uiUncompressedDataSize = uncompressed.GetCount();
+  tocEntry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_dictionary;
+  tocEntry.m_uiDictionary = uiDictionary;
+
+  ezDynamicArray<ezUInt8> compressed;
+  compressed.SetCountUninitialized(static_cast<ezUInt32>(ZSTD_compressBound(uncompressed.GetCount())));
+
+  const ezDynamicArray<ezUInt8>& dictionary = toc.m_Dictionaries[uiDictionary];
+
+  ZSTD_CCtx* pContext = ZSTD_createCCtx();
+  EZ_SCOPE_EXIT(ZSTD_freeCCtx(pContext));
+
+  const size_t uiCompressedSize = ZSTD_compress_usingDict(pContext, compressed.GetData(), compressed.GetCount(), uncompressed.GetData(),
+    uncompressed.GetCount(), dictionary.GetData(), dictionary.GetCount(), ezCompressedStreamWriterZstd::Compression::Default);
+
+  if (ZSTD_isError(uiCompressedSize))
+  {
+    ezLog::Error("Compressing '{}' failed: '{}'", szAbsSourcePath, ZSTD_getErrorName(uiCompressedSize));
+    return EZ_FAILURE;
+  }
+
+  tocEntry.m_uiStoredDataSize = uiCompressedSize;
+
+  if (progress.IsValid())
+  {
+    if (!progress(tocEntry.m_uiUncompressedDataSize, tocEntry.m_uiUncompressedDataSize))
+      return EZ_FAILURE;
+  }
+
+  if (tocEntry.m_uiStoredDataSize * 12 >= tocEntry.m_uiUncompressedDataSize * 10)
+  {
+    // less than 20% size saving -> go uncompressed
+    return WriteEntry(stream, szAbsSourcePath, uiPathStringOffset, ezArchiveCompressionMode::Uncompressed, tocEntry, inout_uiCurrentStreamPosition, progress);
+  }
+
+  inout_uiCurrentStreamPosition += tocEntry.m_uiStoredDataSize;
+
+  return stream.WriteBytes(compressed.GetData(), uiCompressedSize);
+#else
+  return WriteEntryOptimal(stream, szAbsSourcePath, uiPathStringOffset, ezArchiveCompressionMode::Compressed_zstd, tocEntry, inout_uiCurrentStreamPosition, progress);
+#endif
+}
+
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
 class ezCompressedStreamReaderZstdWithSource : public ezCompressedStreamReaderZstd
@@ -258,6 +453,31 @@ ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEnt
   return std::move(reader);
 }
 
+ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveTOC& toc, ezUInt32 uiEntryIdx, const void* pStartOfArchiveData)
+{
+  const ezArchiveEntry& entry = toc.m_Entries[uiEntryIdx];
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked)
+  {
+    ezUniquePtr<ezArchiveChunkedReaderZstd> reader = EZ_DEFAULT_NEW(ezArchiveChunkedReaderZstd);
+    reader->Configure(toc, uiEntryIdx, pStartOfArchiveData);
+    return std::move(reader);
+  }
+
+  if (entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary)
+  {
+    ezUniquePtr<ezArchiveDictionaryReaderZstd> reader = EZ_DEFAULT_NEW(ezArchiveDictionaryReaderZstd);
+    if (reader->Configure(toc, uiEntryIdx, pStartOfArchiveData).Failed())
+      return nullptr;
+
+    return std::move(reader);
+  }
+#endif
+
+  return CreateEntryReader(entry, pStartOfArchiveData);
+}
+
 void ezArchiveUtils::ConfigureRawMemoryStreamReader(
   const ezArchiveEntry& entry, const void* pStartOfArchiveData, ezRawMemoryStreamReader& memReader)
 {
@@ -87,6 +87,41 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
         }
         break;
       }
+
+      case ezArchiveCompressionMode::Compressed_zstd_chunked:
+      {
+        ArchiveReaderZstdChunked* pChunkedReader = nullptr;
+
+        if (!m_FreeReadersZstdChunked.IsEmpty())
+        {
+          pChunkedReader = m_FreeReadersZstdChunked.PeekBack();
+          m_FreeReadersZstdChunked.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdChunked.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdChunked, 3));
+          pChunkedReader = m_ReadersZstdChunked.PeekBack().Borrow();
+        }
+
+        m_ArchiveReader.ConfigureChunkedReader(uiEntryIndex, pChunkedReader->m_ChunkedReader);
+        pReader = pChunkedReader;
+        break;
+      }
+
+      case ezArchiveCompressionMode::Compressed_zstd_dictionary:
+      {
+        if (!m_FreeReadersZstdDictionary.IsEmpty())
+        {
+          pReader = m_FreeReadersZstdDictionary.PeekBack();
+          m_FreeReadersZstdDictionary.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdDictionary.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdDictionary, 4));
+          pReader = m_ReadersZstdDictionary.PeekBack().Borrow();
+        }
+        break;
+      }
 #endif
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
       case ezArchiveCompressionMode::Compressed_zip:
@@ -116,6 +151,26 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(const char*
 
   m_ArchiveReader.ConfigureRawMemoryStreamReader(uiEntryIndex, pReader->m_MemStreamReader);
 
+  // uncompressed data can be accessed straight in the memory mapped archive
+  pReader->m_DirectView = (pEntry->m_CompressionMode == ezArchiveCompressionMode::Uncompressed) ? m_ArchiveReader.GetEntryRawData(uiEntryIndex) : ezArrayPtr<const ezUInt8>();
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  // the whole entry is decompressed up front, which is done outside the lock, so that other files can be opened meanwhile
+  if (pEntry->m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary)
+  {
+    ArchiveReaderZstdDictionary* pDictionaryReader = static_cast<ArchiveReaderZstdDictionary*>(pReader);
+
+    if (m_ArchiveReader.ConfigureDictionaryReader(uiEntryIndex, pDictionaryReader->m_DictionaryReader).Failed())
+    {
+      EZ_LOCK(m_ReaderMutex);
+      m_FreeReadersZstdDictionary.PushBack(pDictionaryReader);
+      return nullptr;
+    }
+
+    pReader->m_DirectView = pDictionaryReader->m_DictionaryReader.GetData();
+  }
+#endif
+
   if (pReader->Open(sArchivePath, this, FileShareMode).Failed())
   {
     EZ_DEFAULT_DELETE(pReader);
@@ -240,6 +295,18 @@ void ezDataDirectory::ArchiveType::OnReaderWriterClose(ezDataDirectoryReaderWrit
     m_FreeReadersZstd.PushBack(static_cast<ArchiveReaderZstd*>(pClosed));
     return;
   }
+
+  if (pClosed->GetDataDirUserData() == 3)
+  {
+    m_FreeReadersZstdChunked.PushBack(static_cast<ArchiveReaderZstdChunked*>(pClosed));
+    return;
+  }
+
+  if (pClosed->GetDataDirUserData() == 4)
+  {
+    m_FreeReadersZstdDictionary.PushBack(static_cast<ArchiveReaderZstdDictionary*>(pClosed));
+    return;
+  }
 #endif
 
 #ifdef BUILDSYSTEM_ENABLE_ZLIB_SUPPORT
@@ -267,6 +334,11 @@ ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::Read(void* pBuffer, ezUInt6
   return m_MemStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::Skip(ezUInt64 uiBytes)
+{
+  return m_MemStreamReader.SkipBytes(uiBytes);
+}
+
 ezUInt64 ezDataDirectory::ArchiveReaderUncompressed::GetFileSize() const
 {
   return m_uiUncompressedSize;
@@ -301,6 +373,12 @@ ezUInt64 ezDataDirectory::ArchiveReaderZstd::Read(void* pBuffer, ezUInt64 uiByte
   return m_CompressedStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderZstd::Skip(ezUInt64 uiBytes)
+{
+  // the stream has to be decompressed up to the target position
+  return ezDataDirectoryReader::Skip(uiBytes);
+}
+
 ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -309,6 +387,44 @@ ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdChunked::ArchiveReaderZstdChunked(ezInt32 iDataDirUserData)
+  : ArchiveReaderUncompressed(iDataDirUserData)
+{
+}
+
+ezDataDirectory::ArchiveReaderZstdChunked::~ArchiveReaderZstdChunked() = default;
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdChunked::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_ChunkedReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdChunked::Skip(ezUInt64 uiBytes)
+{
+  return m_ChunkedReader.SkipBytes(uiBytes);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdDictionary::ArchiveReaderZstdDictionary(ezInt32 iDataDirUserData)
+  : ArchiveReaderUncompressed(iDataDirUserData)
+{
+}
+
+ezDataDirectory::ArchiveReaderZstdDictionary::~ArchiveReaderZstdDictionary() = default;
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdDictionary::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_DictionaryReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdDictionary::Skip(ezUInt64 uiBytes)
+{
+  return m_DictionaryReader.SkipBytes(uiBytes);
+}
+
 #endif
 
 //////////////////////////////////////////////////////////////////////////
@@ -327,6 +443,12 @@ ezUInt64 ezDataDirectory::ArchiveReaderZip::Read(void* pBuffer, ezUInt64 uiBytes
   return m_CompressedStreamReader.ReadBytes(pBuffer, uiBytes);
 }
 
+ezUInt64 ezDataDirectory::ArchiveReaderZip::Skip(ezUInt64 uiBytes)
+{
+  // the stream has to be decompressed up to the target position
+  return ezDataDirectoryReader::Skip(uiBytes);
+}
+
 ezResult ezDataDirectory::ArchiveReaderZip::InternalOpen(ezFileShareMode::Enum FileShareMode)
 {
   EZ_ASSERT_DEBUG(FileShareMode != ezFileShareMode::Exclusive, "Archives only support shared reading of files. Exclusive access cannot be guaranteed.");
@@ -85,6 +85,7 @@ namespace ezDataDirectory
     }
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 Skip(ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
 
   protected:
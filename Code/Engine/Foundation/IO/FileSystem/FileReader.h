@@ -36,6 +36,15 @@ public:
   /// \brief Attempts to read the given number of bytes into the buffer. Returns the actual number of bytes read.
   virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
 
+  /// \brief Skips the given number of bytes. Skips beyond the cached data are passed on to the data directory reader, which may be able to seek.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
+  /// \brief Returns the entire content of the file without copying it, if the data directory supports this. Otherwise an empty array.
+  ///
+  /// This works for uncompressed entries in ezArchive files, which are memory mapped. The view is independent of the read position
+  /// and stays valid until the file is closed. Code that parses an entire file can use this and fall back to ReadBytes(), if the view is empty.
+  ezArrayPtr<const ezUInt8> GetDirectView() const;
+
 private:
   ezUInt64 m_uiBytesCached;
   ezUInt64 m_uiCacheReadPosition;
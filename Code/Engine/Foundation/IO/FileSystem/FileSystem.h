@@ -4,6 +4,8 @@
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
 #include <Foundation/Threading/Mutex.h>
 
 /// \brief The ezFileSystem provides high-level functionality to manage files in a virtual file system.
@@ -228,6 +230,34 @@ public:
   /// \brief Returns true, if any data directory knows how to redirect the given path. Otherwise the original string is returned in out_sRedirection.
   static bool ResolveAssetRedirection(const char* szPathOrAssetGuid, ezStringBuilder& out_sRedirection);
 
+public:
+  /// \name Asynchronous Reads
+  ///@{
+
+  /// \brief Called once an asynchronous read has finished.
+  ///
+  /// The result is EZ_FAILURE, if the file could not be opened or is shorter than the requested offset.
+  /// Otherwise the second parameter is the number of bytes that were read, which is less than requested, if the end of the file was reached.
+  using AsyncReadCallback = ezDelegate<void(ezResult, ezUInt64)>;
+
+  /// \brief Reads uiBytes bytes from szFile, starting at uiOffset, into pBuffer without blocking the calling thread.
+  ///
+  /// The reads are executed on a ezTaskPriority::FileAccess task. All requests that come in while that task is busy are executed
+  /// together in the next batch, sorted by file and offset, such that every file is opened only once per batch and read front to back.
+  /// This works with every data directory type, but it is most efficient with those that can skip data cheaply (folders, uncompressed or chunked archive entries).
+  ///
+  /// Once the data is read, the callback is executed in a task with the given priority.
+  /// pBuffer must stay valid until then.
+  static void ReadAsync(const char* szFile, ezUInt64 uiOffset, ezUInt64 uiBytes, void* pBuffer, AsyncReadCallback callback,
+    ezTaskPriority::Enum completionPriority = ezTaskPriority::ThisFrame); // [tested]
+
+  /// \brief Blocks until all asynchronous reads that were issued so far have finished and their callbacks were executed.
+  ///
+  /// Helps executing tasks while waiting. Must not be called from within a completion callback.
+  static void WaitForAsyncReads(); // [tested]
+
+  ///@}
+
 private:
   friend class ezDataDirectoryReaderWriterBase;
   friend class ezFileReaderBase;
@@ -279,6 +309,19 @@ private:
     ezDataDirFactory m_Factory;
   };
 
+  struct AsyncReadRequest
+  {
+    ezString m_sFile;
+    ezUInt64 m_uiOffset = 0;
+    ezUInt64 m_uiBytes = 0;
+    void* m_pBuffer = nullptr;
+    AsyncReadCallback m_Callback;
+    ezTaskPriority::Enum m_CompletionPriority = ezTaskPriority::ThisFrame;
+
+    ezResult m_Result = EZ_FAILURE;
+    ezUInt64 m_uiBytesRead = 0;
+  };
+
   struct FileSystemData
   {
     ezHybridArray<Factory, 4> m_DataDirFactories;
@@ -286,8 +329,19 @@ private:
 
     ezEvent<const FileEvent&, ezMutex> m_Event;
     ezMutex m_FsMutex;
+
+    ezMutex m_AsyncReadMutex;
+    ezDynamicArray<AsyncReadRequest> m_PendingAsyncReads;
+    bool m_bAsyncReadTaskScheduled = false;
+    ezAtomicInteger32 m_iUnfinishedAsyncReads;
   };
 
+  /// \brief Executes all pending async reads, until no new ones come in. Runs on a file access thread.
+  static void ExecuteAsyncReads();
+
+  /// \brief Executes the callbacks of finished async reads.
+  static void FinishAsyncReads(const ezDynamicArray<AsyncReadRequest>& requests);
+
   /// \brief Returns a list of data directory categories that were embedded in the path.
   static const char* ExtractRootName(const char* szPath, ezString& rootName);
 
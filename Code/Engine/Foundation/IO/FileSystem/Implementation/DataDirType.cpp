@@ -38,6 +38,26 @@ void ezDataDirectoryReaderWriterBase::Close()
   m_pDataDirectory->OnReaderWriterClose(this);
 }
 
+ezUInt64 ezDataDirectoryReader::Skip(ezUInt64 uiBytes)
+{
+  ezUInt8 uiTempBuffer[1024];
+
+  ezUInt64 uiBytesSkipped = 0;
+
+  while (uiBytesSkipped < uiBytes)
+  {
+    const ezUInt64 uiBytesToRead = ezMath::Min<ezUInt64>(uiBytes - uiBytesSkipped, EZ_ARRAY_SIZE(uiTempBuffer));
+    const ezUInt64 uiBytesRead = Read(uiTempBuffer, uiBytesToRead);
+
+    uiBytesSkipped += uiBytesRead;
+
+    if (uiBytesRead < uiBytesToRead)
+      break;
+  }
+
+  return uiBytesSkipped;
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_DataDirType);
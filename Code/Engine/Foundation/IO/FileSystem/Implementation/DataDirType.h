@@ -163,6 +163,16 @@ public:
   }
 
   virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) = 0;
+
+  /// \brief Advances the read position by the given number of bytes. Returns how many bytes were actually skipped.
+  ///
+  /// The default implementation reads the data and discards it. Readers that can seek should override this.
+  virtual ezUInt64 Skip(ezUInt64 uiBytes);
+
+  /// \brief Returns the entire content of the file, if the data directory has it in memory already (e.g. in a memory mapped archive).
+  ///
+  /// The memory stays valid until the reader is closed. Returns an empty array, if the data cannot be accessed directly.
+  virtual ezArrayPtr<const ezUInt8> GetDirectView() const { return ezArrayPtr<const ezUInt8>(); }
 };
 
 /// \brief A base class for writers that handle writing to a (virtual) file inside a data directory.
@@ -36,6 +36,17 @@ namespace ezDataDirectory
 
   ezUInt64 FolderReader::Read(void* pBuffer, ezUInt64 uiBytes) { return m_File.Read(pBuffer, uiBytes); }
 
+  ezUInt64 FolderReader::Skip(ezUInt64 uiBytes)
+  {
+    // seek instead of reading, but never past the end of the file
+    const ezUInt64 uiFileSize = m_File.GetFileSize();
+    const ezUInt64 uiPosition = ezMath::Min(m_File.GetFilePosition(), uiFileSize);
+    const ezUInt64 uiSkip = ezMath::Min(uiBytes, uiFileSize - uiPosition);
+
+    m_File.SetFilePosition(static_cast<ezInt64>(uiSkip), ezFileSeekMode::FromCurrent);
+    return uiSkip;
+  }
+
   ezUInt64 FolderReader::GetFileSize() const { return m_File.GetFileSize(); }
 
   ezResult FolderWriter::InternalOpen(ezFileShareMode::Enum FileShareMode)
@@ -15,9 +15,10 @@ ezResult ezFileReader::Open(const char* szFile, ezUInt32 uiCacheSize /*= 1024 *
 
   m_Cache.SetCountUninitialized(uiCacheSize);
 
+  // the cache is filled by the first read, so files that are only accessed through GetDirectView() are never copied
   m_uiCacheReadPosition = 0;
-  m_uiBytesCached = m_pDataDirReader->Read(&m_Cache[0], m_Cache.GetCount());
-  m_bEOF = m_uiBytesCached > 0 ? false : true;
+  m_uiBytesCached = 0;
+  m_bEOF = false;
 
   return EZ_SUCCESS;
 }
@@ -82,6 +83,38 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
   return uiBufferPosition;
 }
 
+ezUInt64 ezFileReader::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  EZ_ASSERT_DEV(m_pDataDirReader != nullptr, "The file has not been opened (successfully).");
+  if (m_bEOF)
+    return 0;
+
+  const ezUInt64 uiCachedBytesLeft = m_uiBytesCached - m_uiCacheReadPosition;
+
+  // if the cache is not depleted by the skip, there is nothing else to do
+  if (uiBytesToSkip < uiCachedBytesLeft)
+  {
+    m_uiCacheReadPosition += uiBytesToSkip;
+    return uiBytesToSkip;
+  }
+
+  // otherwise skip the rest of the cache, let the data directory reader skip the remainder and refill the cache
+  const ezUInt64 uiBytesSkipped = uiCachedBytesLeft + m_pDataDirReader->Skip(uiBytesToSkip - uiCachedBytesLeft);
+
+  m_uiBytesCached = m_pDataDirReader->Read(&m_Cache[0], m_Cache.GetCount());
+  m_uiCacheReadPosition = 0;
+  m_bEOF = m_uiBytesCached == 0;
+
+  return uiBytesSkipped;
+}
+
+ezArrayPtr<const ezUInt8> ezFileReader::GetDirectView() const
+{
+  EZ_ASSERT_DEV(m_pDataDirReader != nullptr, "The file has not been opened (successfully).");
+
+  return m_pDataDirReader->GetDirectView();
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_FileReader);
@@ -4,10 +4,16 @@
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FileSystem)
 
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "TaskSystem"
+  END_SUBSYSTEM_DEPENDENCIES
+
   ON_CORESYSTEMS_STARTUP
   {
     ezFileSystem::Startup();
@@ -753,6 +759,9 @@ void ezFileSystem::Startup()
 
 void ezFileSystem::Shutdown()
 {
+  // the buffers of outstanding reads may belong to systems that are shut down afterwards
+  WaitForAsyncReads();
+
   {
     EZ_LOCK(s_Data->m_FsMutex);
 
@@ -895,5 +904,136 @@ ezResult ezFileSystem::CreateDirectoryStructure(const char* szPath)
 
   return ezOSFile::CreateDirectoryStructure(sRedir);
 }
+void ezFileSystem::ReadAsync(const char* szFile, ezUInt64 uiOffset, ezUInt64 uiBytes, void* pBuffer, AsyncReadCallback callback,
+  ezTaskPriority::Enum completionPriority /*= ezTaskPriority::ThisFrame*/)
+{
+  EZ_ASSERT_DEV(callback.IsValid(), "Async reads require a callback");
+
+  s_Data->m_iUnfinishedAsyncReads.Increment();
+
+  EZ_LOCK(s_Data->m_AsyncReadMutex);
+
+  AsyncReadRequest& request = s_Data->m_PendingAsyncReads.ExpandAndGetRef();
+  request.m_sFile = szFile;
+  request.m_uiOffset = uiOffset;
+  request.m_uiBytes = uiBytes;
+  request.m_pBuffer = pBuffer;
+  request.m_Callback = callback;
+  request.m_CompletionPriority = completionPriority;
+
+  // the running task picks up all requests that come in until it runs out of work
+  if (!s_Data->m_bAsyncReadTaskScheduled)
+  {
+    s_Data->m_bAsyncReadTaskScheduled = true;
+
+    ezDelegateTask<void>* pTask = EZ_DEFAULT_NEW(ezDelegateTask<void>, "Async File Reads", ezMakeDelegate(&ezFileSystem::ExecuteAsyncReads));
+    // data directory readers may wait for tasks of their own, e.g. archive readers decompress several chunks in parallel
+    pTask->ConfigureTask("Async File Reads", ezTaskNesting::Maybe, [](ezTask* pTask) { EZ_DEFAULT_DELETE(pTask); });
+
+    ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::FileAccess);
+  }
+}
+
+void ezFileSystem::WaitForAsyncReads()
+{
+  ezTaskSystem::WaitForCondition([]() { return s_Data->m_iUnfinishedAsyncReads == 0; });
+}
+
+void ezFileSystem::ExecuteAsyncReads()
+{
+  ezDynamicArray<AsyncReadRequest> batch;
+
+  while (true)
+  {
+    {
+      EZ_LOCK(s_Data->m_AsyncReadMutex);
+
+      batch.Swap(s_Data->m_PendingAsyncReads);
+
+      if (batch.IsEmpty())
+      {
+        s_Data->m_bAsyncReadTaskScheduled = false;
+        return;
+      }
+    }
+
+    batch.Sort([](const AsyncReadRequest& lhs, const AsyncReadRequest& rhs) -> bool {
+      const ezInt32 iCmp = lhs.m_sFile.Compare(rhs.m_sFile);
+      return iCmp != 0 ? iCmp < 0 : lhs.m_uiOffset < rhs.m_uiOffset;
+    });
+
+    ezDataDirectoryReader* pReader = nullptr;
+    ezUInt64 uiReadPosition = 0;
+
+    for (ezUInt32 i = 0; i < batch.GetCount(); ++i)
+    {
+      AsyncReadRequest& request = batch[i];
+
+      const bool bSameFile = i > 0 && batch[i - 1].m_sFile == request.m_sFile;
+
+      // overlapping requests have to start over, readers cannot seek backwards
+      if (!bSameFile || (pReader != nullptr && uiReadPosition > request.m_uiOffset))
+      {
+        if (pReader != nullptr)
+        {
+          pReader->Close();
+        }
+
+        pReader = GetFileReader(request.m_sFile, ezFileShareMode::SharedReads, true);
+        uiReadPosition = 0;
+      }
+
+      if (pReader == nullptr)
+        continue;
+
+      uiReadPosition += pReader->Skip(request.m_uiOffset - uiReadPosition);
+
+      if (uiReadPosition == request.m_uiOffset)
+      {
+        request.m_uiBytesRead = pReader->Read(request.m_pBuffer, request.m_uiBytes);
+        request.m_Result = EZ_SUCCESS;
+        uiReadPosition += request.m_uiBytesRead;
+      }
+    }
+
+    if (pReader != nullptr)
+    {
+      pReader->Close();
+    }
+
+    // post one completion task per priority
+    while (!batch.IsEmpty())
+    {
+      const ezTaskPriority::Enum priority = batch.PeekBack().m_CompletionPriority;
+
+      ezDynamicArray<AsyncReadRequest> finished;
+
+      for (ezUInt32 i = batch.GetCount(); i > 0; --i)
+      {
+        if (batch[i - 1].m_CompletionPriority == priority)
+        {
+          finished.PushBack(std::move(batch[i - 1]));
+          batch.RemoveAtAndSwap(i - 1);
+        }
+      }
+
+      using CompletionTask = ezDelegateTask<ezDynamicArray<AsyncReadRequest>>;
+      CompletionTask* pTask = EZ_DEFAULT_NEW(CompletionTask, "Async File Read Callbacks", ezMakeDelegate(&ezFileSystem::FinishAsyncReads), finished);
+      pTask->ConfigureTask("Async File Read Callbacks", ezTaskNesting::Never, [](ezTask* pTask) { EZ_DEFAULT_DELETE(pTask); });
+
+      ezTaskSystem::StartSingleTask(pTask, priority);
+    }
+  }
+}
+
+void ezFileSystem::FinishAsyncReads(const ezDynamicArray<AsyncReadRequest>& requests)
+{
+  for (const AsyncReadRequest& request : requests)
+  {
+    request.m_Callback(request.m_Result, request.m_uiBytesRead);
+  }
+
+  s_Data->m_iUnfinishedAsyncReads.Subtract(static_cast<ezInt32>(requests.GetCount()));
+}
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_FileSystem);
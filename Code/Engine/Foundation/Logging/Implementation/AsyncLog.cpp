@@ -0,0 +1,358 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, AsyncLog)
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezGlobalLog::DisableAsyncMode();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+namespace
+{
+  /// A copy of an ezLoggingEventData, that owns its strings.
+  struct AsyncLogEntry
+  {
+    ezUInt64 m_uiSequence = 0;
+    ezLogMsgType::Enum m_EventType = ezLogMsgType::None;
+    ezUInt8 m_uiIndentation = 0;
+    double m_fSeconds = 0;
+    ezTime m_Time;
+    ezUInt64 m_uiThreadId = 0;
+    ezHybridString<128, ezStaticAllocatorWrapper> m_sText;
+    ezHybridString<32, ezStaticAllocatorWrapper> m_sTag;
+  };
+
+  /// The queue of one thread. Only that thread writes to it and only the thread that holds s_WriteMutex reads from it.
+  struct AsyncLogQueue
+  {
+    AsyncLogQueue(ezUInt32 uiSize, ezUInt32 uiGeneration)
+      : m_uiGeneration(uiGeneration)
+    {
+      m_Entries.SetCount(uiSize);
+    }
+
+    bool IsEmpty() const { return m_iReadCount == m_iWriteCount; }
+
+    ezDynamicArray<AsyncLogEntry, ezStaticAllocatorWrapper> m_Entries;
+    ezAtomicInteger64 m_iWriteCount;
+    ezAtomicInteger64 m_iReadCount;
+
+    /// The value of s_uiGeneration when the queue was created, queues from earlier EnableAsyncMode() calls are replaced.
+    ezUInt32 m_uiGeneration;
+
+    /// Set when the thread does not use the queue anymore, it is deallocated once it is empty.
+    volatile bool m_bAbandoned = false;
+  };
+
+  static volatile bool s_bAsyncMode = false;
+  static ezGlobalLog::AsyncSettings s_AsyncSettings;
+
+  /// Incremented by every EnableAsyncMode() call, such that the threads pick up the new queue size.
+  static ezUInt32 s_uiGeneration = 0;
+
+  static ezMutex s_QueuesMutex;
+  static ezDynamicArray<AsyncLogQueue*, ezStaticAllocatorWrapper> s_Queues;
+  static thread_local AsyncLogQueue* s_pThreadQueue = nullptr;
+
+  /// Defines the order of the messages across all threads.
+  static ezAtomicInteger64 s_iNextSequence;
+
+  /// Held while the queued messages are passed on to the writers, so that they are never written twice or out of order.
+  static ezMutex s_WriteMutex;
+
+  /// Set while a thread passes queued messages on to the writers. Messages that the writers log themselves are handled immediately.
+  static thread_local bool s_bWritingQueuedMessages = false;
+
+  /// Not a member of the writer thread, so that logging threads may raise it while the thread is being stopped.
+  static ezThreadSignal s_WriterWakeUp;
+
+  static ezAtomicInteger32 s_iNumDroppedMessages;
+  static ezInt32 s_iNumReportedDroppedMessages = 0;
+
+  AsyncLogQueue* GetThreadQueue()
+  {
+    // messages that are still queued from an earlier time have to be written first
+    if (s_pThreadQueue != nullptr && s_pThreadQueue->m_uiGeneration != s_uiGeneration && s_pThreadQueue->IsEmpty())
+    {
+      s_pThreadQueue->m_bAbandoned = true;
+      s_pThreadQueue = nullptr;
+    }
+
+    if (s_pThreadQueue == nullptr)
+    {
+      s_pThreadQueue = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), AsyncLogQueue, s_AsyncSettings.m_uiQueueSize, s_uiGeneration);
+
+      EZ_LOCK(s_QueuesMutex);
+      s_Queues.PushBack(s_pThreadQueue);
+    }
+
+    return s_pThreadQueue;
+  }
+} // namespace
+
+/// \brief Periodically passes the queued messages to the log writers.
+class ezAsyncLogWriterThread : public ezThread
+{
+public:
+  ezAsyncLogWriterThread()
+    : ezThread("Log Writer")
+  {
+  }
+
+  volatile bool m_bKeepRunning = true;
+
+private:
+  virtual ezUInt32 Run() override
+  {
+    while (m_bKeepRunning)
+    {
+      s_WriterWakeUp.WaitForSignal(s_AsyncSettings.m_WriteInterval);
+
+      EZ_LOCK(s_WriteMutex);
+      ezGlobalLog::WriteQueuedMessages();
+    }
+
+    return 0;
+  }
+};
+
+static ezAsyncLogWriterThread* s_pWriterThread = nullptr;
+
+ezResult ezGlobalLog::EnableAsyncMode(const AsyncSettings& settings)
+{
+  if (s_pWriterThread != nullptr)
+  {
+    ezLog::Error("The asynchronous log mode is already enabled");
+    return EZ_FAILURE;
+  }
+
+  EZ_ASSERT_DEV(settings.m_uiQueueSize > 0, "The queue size must not be zero");
+  s_AsyncSettings = settings;
+  ++s_uiGeneration;
+
+  s_pWriterThread = EZ_DEFAULT_NEW(ezAsyncLogWriterThread);
+  s_pWriterThread->Start();
+
+  s_bAsyncMode = true;
+  return EZ_SUCCESS;
+}
+
+void ezGlobalLog::DisableAsyncMode()
+{
+  if (s_pWriterThread == nullptr)
+    return;
+
+  s_bAsyncMode = false;
+
+  s_pWriterThread->m_bKeepRunning = false;
+  s_WriterWakeUp.RaiseSignal();
+  s_pWriterThread->Join();
+
+  EZ_DEFAULT_DELETE(s_pWriterThread);
+
+  FlushAsyncQueue();
+}
+
+bool ezGlobalLog::IsAsyncModeEnabled()
+{
+  return s_bAsyncMode;
+}
+
+void ezGlobalLog::FlushAsyncQueue()
+{
+  EZ_LOCK(s_WriteMutex);
+  WriteQueuedMessages();
+}
+
+ezUInt32 ezGlobalLog::GetNumDroppedAsyncMessages()
+{
+  return static_cast<ezUInt32>(s_iNumDroppedMessages);
+}
+
+void ezGlobalLog::FlushAsyncQueueOnCrash()
+{
+  if (s_pWriterThread == nullptr)
+    return;
+
+  // everything that is logged from now on, especially by the crash handler, is written immediately
+  s_bAsyncMode = false;
+
+  // the writer thread may be in the middle of writing, or even be the thread that crashed, so waiting for it is not an option
+  for (ezUInt32 uiAttempt = 0; uiAttempt < 10; ++uiAttempt)
+  {
+    if (s_WriteMutex.TryLock())
+    {
+      WriteQueuedMessages();
+      s_WriteMutex.Unlock();
+      return;
+    }
+
+    ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+  }
+}
+
+void ezGlobalLog::RemoveThread()
+{
+  if (s_pThreadQueue == nullptr)
+    return;
+
+  s_pThreadQueue->m_bAbandoned = true;
+  s_pThreadQueue = nullptr;
+}
+
+bool ezGlobalLog::EnqueueAsync(const ezLoggingEventData& le)
+{
+  if (!s_bAsyncMode || s_bWritingQueuedMessages)
+    return false;
+
+  AsyncLogQueue* pQueue = GetThreadQueue();
+  const ezUInt32 uiSize = pQueue->m_Entries.GetCount();
+  const ezInt64 iWriteCount = pQueue->m_iWriteCount;
+
+  while (iWriteCount - pQueue->m_iReadCount >= uiSize)
+  {
+    if (s_AsyncSettings.m_OverflowPolicy == AsyncOverflowPolicy::Drop)
+    {
+      s_iNumDroppedMessages.Increment();
+      return true;
+    }
+
+    // the writer thread has been stopped in the meantime
+    if (!s_bAsyncMode)
+      return false;
+
+    s_WriterWakeUp.RaiseSignal();
+    ezThreadUtils::YieldTimeSlice();
+  }
+
+  AsyncLogEntry& entry = pQueue->m_Entries[static_cast<ezUInt32>(iWriteCount % uiSize)];
+  entry.m_uiSequence = static_cast<ezUInt64>(s_iNextSequence.Increment());
+  entry.m_EventType = le.m_EventType;
+  entry.m_uiIndentation = le.m_uiIndentation;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  entry.m_fSeconds = le.m_fSeconds;
+#endif
+  entry.m_Time = le.m_Time;
+  entry.m_uiThreadId = le.m_uiThreadId;
+  entry.m_sText = le.m_szText != nullptr ? le.m_szText : "";
+  entry.m_sTag = le.m_szTag != nullptr ? le.m_szTag : "";
+
+  // publishes the entry to the writer thread
+  pQueue->m_iWriteCount.Increment();
+
+  // don't let errors wait in the queue and don't let the queue run full without need
+  if (le.m_EventType == ezLogMsgType::ErrorMsg || le.m_EventType == ezLogMsgType::Flush || (iWriteCount + 1 - pQueue->m_iReadCount) * 2 >= uiSize)
+  {
+    s_WriterWakeUp.RaiseSignal();
+  }
+
+  return true;
+}
+
+void ezGlobalLog::WriteQueuedMessages()
+{
+  s_bWritingQueuedMessages = true;
+
+  ezHybridArray<AsyncLogQueue*, 32> queues;
+  {
+    EZ_LOCK(s_QueuesMutex);
+    queues = s_Queues;
+  }
+
+  // only the messages that are in the queues now are written, otherwise a thread that logs continuously could keep this going forever
+  ezHybridArray<ezInt64, 32> endCounts;
+  endCounts.SetCountUninitialized(queues.GetCount());
+  for (ezUInt32 i = 0; i < queues.GetCount(); ++i)
+  {
+    endCounts[i] = queues[i]->m_iWriteCount;
+  }
+
+  while (true)
+  {
+    // merge the queues by picking the oldest message of all of them
+    AsyncLogQueue* pOldestQueue = nullptr;
+    const AsyncLogEntry* pOldestEntry = nullptr;
+
+    for (ezUInt32 i = 0; i < queues.GetCount(); ++i)
+    {
+      AsyncLogQueue* pQueue = queues[i];
+      const ezInt64 iReadCount = pQueue->m_iReadCount;
+
+      if (iReadCount == endCounts[i])
+        continue;
+
+      const AsyncLogEntry& entry = pQueue->m_Entries[static_cast<ezUInt32>(iReadCount % pQueue->m_Entries.GetCount())];
+      if (pOldestEntry == nullptr || entry.m_uiSequence < pOldestEntry->m_uiSequence)
+      {
+        pOldestQueue = pQueue;
+        pOldestEntry = &entry;
+      }
+    }
+
+    if (pOldestEntry == nullptr)
+      break;
+
+    ezLoggingEventData le;
+    le.m_EventType = pOldestEntry->m_EventType;
+    le.m_uiIndentation = pOldestEntry->m_uiIndentation;
+    le.m_szText = pOldestEntry->m_sText;
+    le.m_szTag = pOldestEntry->m_sTag;
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    le.m_fSeconds = pOldestEntry->m_fSeconds;
+#endif
+    le.m_Time = pOldestEntry->m_Time;
+    le.m_uiThreadId = pOldestEntry->m_uiThreadId;
+
+    s_LoggingEvent.Broadcast(le);
+
+    // hands the entry back to the logging thread
+    pOldestQueue->m_iReadCount.Increment();
+  }
+
+  const ezInt32 iNumDroppedMessages = s_iNumDroppedMessages;
+  if (iNumDroppedMessages != s_iNumReportedDroppedMessages)
+  {
+    ezStringBuilder sText;
+    sText.Format("{} log messages were dropped, because the log queue of their thread was full", iNumDroppedMessages - s_iNumReportedDroppedMessages);
+    s_iNumReportedDroppedMessages = iNumDroppedMessages;
+
+    ezLoggingEventData le;
+    le.m_EventType = ezLogMsgType::WarningMsg;
+    le.m_szText = sText;
+    le.m_Time = ezTime::Now();
+    le.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
+
+    s_LoggingEvent.Broadcast(le);
+  }
+
+  // deallocate the queues that are not used anymore
+  {
+    EZ_LOCK(s_QueuesMutex);
+
+    for (ezUInt32 i = s_Queues.GetCount(); i > 0; --i)
+    {
+      AsyncLogQueue* pQueue = s_Queues[i - 1];
+
+      if (pQueue->m_bAbandoned && pQueue->IsEmpty())
+      {
+        s_Queues.RemoveAtAndSwap(i - 1);
+        EZ_DELETE(ezStaticAllocatorWrapper::GetAllocator(), pQueue);
+      }
+    }
+  }
+
+  s_bWritingQueuedMessages = false;
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Logging_Implementation_AsyncLog);
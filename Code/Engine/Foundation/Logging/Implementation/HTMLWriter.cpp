@@ -90,7 +90,7 @@ void ezLogWriter::HTML::LogMessageHandler(const ezLoggingEventData& eventData)
   sTag.ReplaceAll(">", "&gt;");
 
   ezStringBuilder sTimestamp;
-  ezLog::GenerateFormattedTimestamp(m_TimestampMode, sTimestamp);
+  ezLog::GenerateFormattedTimestamp(m_TimestampMode, eventData.m_Time, sTimestamp);
 
   bool bFlushWriteCache = false;
 
@@ -5,6 +5,7 @@
 #include <Foundation/Time/Time.h>
 #include <Foundation/Time/Timestamp.h>
 #include <Foundation/Strings/StringConversion.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS)
 #  include <Foundation/Logging/Implementation/Win/ETWProvider_win.h>
@@ -76,6 +77,9 @@ void ezGlobalLog::HandleLogMessage(const ezLoggingEventData& le)
     if ((ThisType > ezLogMsgType::None) && (ThisType < ezLogMsgType::All))
       s_uiMessageCount[ThisType].Increment();
 
+    if (EnqueueAsync(le))
+      return;
+
     s_LoggingEvent.Broadcast(le);
   }
 }
@@ -150,6 +154,8 @@ void ezLog::EndLogBlock(ezLogInterface* pInterface, ezLogBlock* pBlock)
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
     le.m_fSeconds = pBlock->m_fSeconds;
 #endif
+    le.m_Time = ezTime::Now();
+    le.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
 
     pInterface->HandleLogMessage(le);
   }
@@ -169,6 +175,8 @@ void ezLog::WriteBlockHeader(ezLogInterface* pInterface, ezLogBlock* pBlock)
   le.m_szText = pBlock->m_szName;
   le.m_uiIndentation = pBlock->m_uiBlockDepth;
   le.m_szTag = pBlock->m_szContextInfo;
+  le.m_Time = ezTime::Now();
+  le.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
 
   pInterface->HandleLogMessage(le);
 }
@@ -211,6 +219,8 @@ void ezLog::BroadcastLoggingEvent(ezLogInterface* pInterface, ezLogMsgType::Enum
   le.m_szText = szString;
   le.m_uiIndentation = uiIndentation;
   le.m_szTag = szTag;
+  le.m_Time = ezTime::Now();
+  le.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
 
   pInterface->HandleLogMessage(le);
   pInterface->m_uiLoggedMsgsSinceFlush++;
@@ -248,6 +258,11 @@ void ezLog::Printf(const char* szFormat, ...)
 }
 
 void ezLog::GenerateFormattedTimestamp(TimestampMode mode, ezStringBuilder& sTimestampOut)
+{
+  GenerateFormattedTimestamp(mode, ezTime::Zero(), sTimestampOut);
+}
+
+void ezLog::GenerateFormattedTimestamp(TimestampMode mode, ezTime eventTime, ezStringBuilder& sTimestampOut)
 {
   // if mode is 'None', early out to not even retrieve a timestamp
   if (mode == TimestampMode::None)
@@ -255,7 +270,15 @@ void ezLog::GenerateFormattedTimestamp(TimestampMode mode, ezStringBuilder& sTim
     return;
   }
 
-  const ezDateTime dateTime(ezTimestamp::CurrentTimestamp());
+  ezTimestamp timestamp = ezTimestamp::CurrentTimestamp();
+
+  // the event time is not a calendar time, but it can be related to one through the current time
+  if (!eventTime.IsZero())
+  {
+    timestamp -= ezTime::Now() - eventTime;
+  }
+
+  const ezDateTime dateTime(timestamp);
 
   switch (mode)
   {
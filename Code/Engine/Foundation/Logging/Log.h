@@ -58,6 +58,14 @@ struct EZ_FOUNDATION_DLL ezLoggingEventData
   /// \brief Used by log-blocks for profiling the duration of the block
   double m_fSeconds = 0;
 #endif
+
+  /// \brief The ezTime::Now() value when the event was created. Zero if the event was not created by ezLog.
+  ///
+  /// With the asynchronous mode of ezGlobalLog, writers may handle an event noticeably later than it was created.
+  ezTime m_Time;
+
+  /// \brief The ID of the thread on which the event was created, see ezThreadUtils::GetCurrentThreadID().
+  ezUInt64 m_uiThreadId = 0;
 };
 
 typedef ezEvent<const ezLoggingEventData&, ezMutex> ezLoggingEvent;
@@ -117,6 +125,57 @@ public:
   /// override is set at the moment.
   static void SetGlobalLogOverride(ezLogInterface* pInterface);
 
+  /// \brief What happens when a thread logs more messages than fit into its queue, in the asynchronous mode.
+  enum class AsyncOverflowPolicy
+  {
+    Block, ///< The thread waits until the writer thread has made room. No message is lost.
+    Drop,  ///< The message is discarded. The writers receive a warning with the number of dropped messages.
+  };
+
+  /// \brief Settings for EnableAsyncMode().
+  struct AsyncSettings
+  {
+    /// \brief How many messages each thread can queue up.
+    ezUInt32 m_uiQueueSize = 256;
+
+    AsyncOverflowPolicy m_OverflowPolicy = AsyncOverflowPolicy::Block;
+
+    /// \brief How often the writer thread wakes up. It also wakes up for errors and when a queue is half full.
+    ezTime m_WriteInterval = ezTime::Milliseconds(20);
+  };
+
+  /// \brief Decouples the log writers from the threads that log messages.
+  ///
+  /// In the asynchronous mode every thread puts its messages into its own lock-free queue and a dedicated thread passes them on to the
+  /// log writers, in the order in which they were logged. Threads therefore never wait for each other, or for slow writers, when they
+  /// log. Log writers are called from the writer thread and may see a message some time after it was logged, see
+  /// ezLoggingEventData::m_Time. The global log override is not affected, it still handles all messages immediately.
+  ///
+  /// Fails if the asynchronous mode is already enabled.
+  static ezResult EnableAsyncMode(const AsyncSettings& settings);
+
+  /// \brief Writes all queued messages and stops the writer thread. Afterwards the log writers are called directly again.
+  ///
+  /// Messages that other threads log while this function runs may still be queued afterwards. They are written once the asynchronous
+  /// mode is enabled again, or when FlushAsyncQueue() is called.
+  static void DisableAsyncMode();
+
+  /// \brief Returns whether EnableAsyncMode() was called without a matching DisableAsyncMode().
+  static bool IsAsyncModeEnabled();
+
+  /// \brief Passes all queued messages to the log writers on the calling thread, without waiting for the writer thread to wake up.
+  static void FlushAsyncQueue();
+
+  /// \brief Returns how many messages were discarded due to AsyncOverflowPolicy::Drop, since the application started.
+  static ezUInt32 GetNumDroppedAsyncMessages();
+
+  /// \brief Called by ezCrashHandler before the crash is handled. Writes all queued messages and disables the asynchronous mode,
+  /// such that the messages of the crash handler are written immediately.
+  static void FlushAsyncQueueOnCrash();
+
+  /// \brief Called by ezThread when a thread finishes, such that the queue of the thread can be deallocated.
+  static void RemoveThread();
+
 private:
   /// \brief Counts the number of messages of each type.
   static ezAtomicInteger32 s_uiMessageCount[ezLogMsgType::ENUM_COUNT];
@@ -126,6 +185,14 @@ private:
 
   static ezLogInterface* s_pOverrideLog;
 
+  /// \brief Puts the event into the queue of the calling thread. Returns false, if the event has to be handled immediately.
+  static bool EnqueueAsync(const ezLoggingEventData& le);
+
+  /// \brief Passes all events that are currently queued to the log writers, in the order in which they were logged.
+  static void WriteQueuedMessages();
+
+  friend class ezAsyncLogWriterThread;
+
 private:
   EZ_DISALLOW_COPY_AND_ASSIGN(ezGlobalLog);
 
@@ -331,6 +398,11 @@ public:
 
   static void GenerateFormattedTimestamp(TimestampMode mode, ezStringBuilder& sTimestampOut);
 
+  /// \brief Same as above, but formats the time at which an event was logged, see ezLoggingEventData::m_Time, instead of the current time.
+  ///
+  /// If \a eventTime is zero, the current time is used.
+  static void GenerateFormattedTimestamp(TimestampMode mode, ezTime eventTime, ezStringBuilder& sTimestampOut);
+
 private:
   // Needed to call 'EndLogBlock'
   friend class ezLogBlock;
@@ -8,6 +8,7 @@
 #include <Foundation/Memory/Policies/AlignedHeapAllocation.h>
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
+#include <Foundation/Memory/Policies/PoolAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
 
 
@@ -17,6 +18,9 @@ typedef ezAllocator<ezMemoryPolicies::ezAlignedHeapAllocation> ezAlignedHeapAllo
 /// \brief Default heap allocator
 typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation> ezHeapAllocator;
 
+/// \brief Thread-local small object pool allocator
+typedef ezAllocator<ezMemoryPolicies::ezPoolAllocation> ezPoolAllocator;
+
 /// \brief Guarded allocator
 typedef ezAllocator<ezMemoryPolicies::ezGuardedAllocation> ezGuardedAllocator;
 
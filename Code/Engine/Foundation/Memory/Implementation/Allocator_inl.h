@@ -46,7 +46,7 @@ EZ_FORCE_INLINE ezInternal::ezAllocatorImpl<A, TrackingFlags>::ezAllocatorImpl(c
 {
   if ((TrackingFlags & ezMemoryTrackingFlags::RegisterAllocator) != 0)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ~ezMemoryTrackingFlags::All) == 0, "Invalid tracking flags");
+    EZ_CHECK_AT_COMPILETIME_MSG((TrackingFlags & ~(ezMemoryTrackingFlags::All | ezMemoryTrackingFlags::SampleAllocations)) == 0, "Invalid tracking flags");
     const ezUInt32 uiTrackingFlags = TrackingFlags;
     ezBitflags<ezMemoryTrackingFlags> flags = *reinterpret_cast<const ezBitflags<ezMemoryTrackingFlags>*>(&uiTrackingFlags);
     this->m_Id = ezMemoryTracker::RegisterAllocator(szName, flags, pParent != nullptr ? pParent->GetId() : ezAllocatorId());
@@ -86,6 +86,11 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
     ezMemoryTracker::AddAllocation(this->m_Id, flags, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
 
+  if ((TrackingFlags & ezMemoryTrackingFlags::SampleAllocations) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, ptr, uiSize);
+  }
+
   return ptr;
 }
 
@@ -97,6 +102,11 @@ void ezInternal::ezAllocatorImpl<A, TrackingFlags>::Deallocate(void* ptr)
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
 
+  if ((TrackingFlags & ezMemoryTrackingFlags::SampleAllocations) != 0)
+  {
+    ezMemoryTracker::SampleDeallocation(this->m_Id, ptr);
+  }
+
   m_allocator.Deallocate(ptr);
 }
 
@@ -154,6 +164,11 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
     ezMemoryTracker::RemoveAllocation(this->m_Id, ptr);
   }
 
+  if ((TrackingFlags & ezMemoryTrackingFlags::SampleAllocations) != 0)
+  {
+    ezMemoryTracker::SampleDeallocation(this->m_Id, ptr);
+  }
+
   ezTime fAllocationTime = ezTime::Now();
 
   void* pNewMem = this->m_allocator.Reallocate(ptr, uiCurrentSize, uiNewSize, uiAlign);
@@ -165,6 +180,12 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
 
     ezMemoryTracker::AddAllocation(this->m_Id, flags, pNewMem, uiNewSize, uiAlign, ezTime::Now() - fAllocationTime);
   }
+
+  if ((TrackingFlags & ezMemoryTrackingFlags::SampleAllocations) != 0)
+  {
+    ezMemoryTracker::SampleAllocation(this->m_Id, pNewMem, uiNewSize);
+  }
+
   return pNewMem;
 }
 
@@ -1,5 +1,7 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Logging/Log.h>
@@ -7,6 +9,7 @@
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -41,6 +44,59 @@ namespace
     ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
   };
 
+  enum
+  {
+    SampleBufferCapacity = 64,
+    MaxSampledStackTraceLength = 32,
+    SampleFilterSize = 1 << 16,
+  };
+
+  struct SampleKey
+  {
+    const void* m_pPtr;
+    ezAllocatorId m_AllocatorId;
+
+    EZ_ALWAYS_INLINE bool operator==(const SampleKey& other) const { return m_pPtr == other.m_pPtr && m_AllocatorId == other.m_AllocatorId; }
+  };
+
+  struct SampleKeyHashHelper
+  {
+    EZ_ALWAYS_INLINE static ezUInt32 Hash(const SampleKey& key) { return ezHashHelper<const void*>::Hash(key.m_pPtr) ^ key.m_AllocatorId.m_Data; }
+    EZ_ALWAYS_INLINE static bool Equal(const SampleKey& a, const SampleKey& b) { return a == b; }
+  };
+
+  struct SampledAllocation
+  {
+    ezUInt64 m_uiStackTraceHash = 0;
+    double m_fEstimatedSize = 0.0;
+    double m_fEstimatedCount = 0.0;
+  };
+
+  struct SampledStackTrace
+  {
+    ezArrayPtr<void*> m_StackTrace;
+    ezUInt32 m_uiRefCount = 0;
+  };
+
+  struct SampleEvent
+  {
+    ezInt64 m_iSequence;
+    bool m_bDeallocation;
+    SampleKey m_Key;
+    SampledAllocation m_Allocation;
+    ezUInt32 m_uiStackTraceLength;
+    void* m_StackTrace[MaxSampledStackTraceLength];
+  };
+
+  /// Written without a lock by the owning thread, read by any thread that holds the tracker lock.
+  struct SampleBuffer
+  {
+    ezAtomicInteger64 m_iWritePos;
+    ezAtomicInteger64 m_iReadPos;
+    SampleBuffer* m_pNext = nullptr;
+    SampleEvent m_Events[SampleBufferCapacity];
+  };
+
   struct TrackerData
   {
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
@@ -52,6 +108,11 @@ namespace
     AllocatorTable m_AllocatorData;
 
     ezAllocatorId m_StaticAllocatorId;
+
+    ezHashTable<SampleKey, SampledAllocation, SampleKeyHashHelper, TrackerDataAllocatorWrapper> m_SampledAllocations;
+    ezHashTable<ezUInt64, SampledStackTrace, ezHashHelper<ezUInt64>, TrackerDataAllocatorWrapper> m_SampledStackTraces;
+    SampleBuffer* m_pSampleBuffers = nullptr;
+    ezInt64 m_iNextSequenceToProcess = 0;
   };
 
   static TrackerData* s_pTrackerData;
@@ -99,6 +160,235 @@ namespace
 
     ezLog::Print("--------------------------------------------------------------------\n\n");
   }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Allocation Sampling
+
+  static volatile ezInt32 s_iSamplingInterval = 512 * 1024;
+
+  // Counts the live samples per hash of their address. Deallocations of addresses that were never sampled can be rejected by
+  // looking at this, without taking the lock. Plain zero-initialized data, since allocations may be sampled before any constructor ran.
+  static volatile ezInt32 s_SampleFilter[SampleFilterSize];
+
+  // Orders the sample events of all threads, so that a deallocation is never applied before the allocation it belongs to.
+  static volatile ezInt64 s_iNextSampleSequence;
+
+  EZ_ALWAYS_INLINE ezUInt32 GetSampleFilterIndex(const void* ptr)
+  {
+    const ezUInt64 uiHash = (static_cast<ezUInt64>(reinterpret_cast<size_t>(ptr)) >> 3) * 0x9E3779B97F4A7C15ull;
+    return static_cast<ezUInt32>(uiHash >> 48);
+  }
+
+  struct SamplingThreadState
+  {
+    ezInt64 m_iBytesUntilNextSample;
+    ezInt32 m_iSamplingInterval; // the interval that m_iBytesUntilNextSample was computed with
+    ezUInt64 m_uiRandomState;
+    SampleBuffer* m_pBuffer;
+    bool m_bThreadExited;
+  };
+
+  // trivial, so that accessing it on every allocation doesn't need any initialization checks
+  static thread_local SamplingThreadState tl_SamplingState;
+
+  /// Needs the tracker lock.
+  void ReleaseSample(const SampleKey& key, const SampledAllocation& allocation)
+  {
+    ezAtomicUtils::Decrement(s_SampleFilter[GetSampleFilterIndex(key.m_pPtr)]);
+
+    SampledStackTrace* pStackTrace = nullptr;
+    if (s_pTrackerData->m_SampledStackTraces.TryGetValue(allocation.m_uiStackTraceHash, pStackTrace) && --pStackTrace->m_uiRefCount == 0)
+    {
+      EZ_DELETE_ARRAY(s_pTrackerDataAllocator, pStackTrace->m_StackTrace);
+      s_pTrackerData->m_SampledStackTraces.Remove(allocation.m_uiStackTraceHash);
+    }
+  }
+
+  /// Needs the tracker lock.
+  void AddSample(const SampleEvent& event)
+  {
+    const ezArrayPtr<void* const> stackTrace(event.m_StackTrace, event.m_uiStackTraceLength);
+    const ezUInt64 uiStackTraceHash = ezHashingUtils::xxHash64(stackTrace.GetPtr(), stackTrace.GetCount() * sizeof(void*));
+
+    SampledStackTrace& sampledStackTrace = s_pTrackerData->m_SampledStackTraces[uiStackTraceHash];
+    if (sampledStackTrace.m_uiRefCount++ == 0)
+    {
+      sampledStackTrace.m_StackTrace = EZ_NEW_ARRAY(s_pTrackerDataAllocator, void*, stackTrace.GetCount());
+      sampledStackTrace.m_StackTrace.CopyFrom(stackTrace);
+    }
+
+    SampledAllocation allocation = event.m_Allocation;
+    allocation.m_uiStackTraceHash = uiStackTraceHash;
+
+    SampledAllocation oldAllocation;
+    if (s_pTrackerData->m_SampledAllocations.Insert(event.m_Key, allocation, &oldAllocation))
+    {
+      // the deallocation of the previous allocation at this address was not reported
+      ReleaseSample(event.m_Key, oldAllocation);
+    }
+  }
+
+  /// Needs the tracker lock.
+  void RemoveSample(const SampleKey& key)
+  {
+    SampledAllocation allocation;
+    if (s_pTrackerData->m_SampledAllocations.Remove(key, &allocation))
+    {
+      ReleaseSample(key, allocation);
+    }
+  }
+
+  /// Needs the tracker lock. Applies the buffered events of all threads in the order in which they happened.
+  /// Stops at an event that another thread is still writing, since the events after it may depend on it.
+  void ProcessSampleBuffers()
+  {
+    while (true)
+    {
+      SampleBuffer* pNextBuffer = nullptr;
+
+      for (SampleBuffer* pBuffer = s_pTrackerData->m_pSampleBuffers; pBuffer != nullptr; pBuffer = pBuffer->m_pNext)
+      {
+        const ezInt64 iReadPos = pBuffer->m_iReadPos;
+
+        if (iReadPos < pBuffer->m_iWritePos && pBuffer->m_Events[iReadPos % SampleBufferCapacity].m_iSequence == s_pTrackerData->m_iNextSequenceToProcess)
+        {
+          pNextBuffer = pBuffer;
+          break;
+        }
+      }
+
+      if (pNextBuffer == nullptr)
+        return;
+
+      const ezInt64 iReadPos = pNextBuffer->m_iReadPos;
+      const SampleEvent& event = pNextBuffer->m_Events[iReadPos % SampleBufferCapacity];
+
+      if (event.m_bDeallocation)
+        RemoveSample(event.m_Key);
+      else
+        AddSample(event);
+
+      pNextBuffer->m_iReadPos.Set(iReadPos + 1);
+      ++s_pTrackerData->m_iNextSequenceToProcess;
+    }
+  }
+
+  /// Needs the tracker lock. Returns once all events up to the given sequence number are applied.
+  void ProcessSampleBuffersUntil(ezInt64 iSequence)
+  {
+    while (true)
+    {
+      ProcessSampleBuffers();
+
+      if (s_pTrackerData->m_iNextSequenceToProcess >= iSequence)
+        return;
+
+      // another thread is in the middle of writing an event, that never takes long
+      ezThreadUtils::YieldTimeSlice();
+    }
+  }
+
+  /// Blocks until the buffer has room for another event.
+  void ReserveSampleEvent(SampleBuffer* pBuffer)
+  {
+    while (pBuffer->m_iWritePos - pBuffer->m_iReadPos >= SampleBufferCapacity)
+    {
+      {
+        EZ_LOCK(*s_pTrackerData);
+        ProcessSampleBuffers();
+      }
+
+      if (pBuffer->m_iWritePos - pBuffer->m_iReadPos >= SampleBufferCapacity)
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+    }
+  }
+
+  /// Needs the tracker lock.
+  void RemoveAllSamples(ezAllocatorId allocatorId)
+  {
+    ProcessSampleBuffersUntil(s_iNextSampleSequence);
+
+    for (auto it = s_pTrackerData->m_SampledAllocations.GetIterator(); it.IsValid();)
+    {
+      if (it.Key().m_AllocatorId == allocatorId)
+      {
+        ReleaseSample(it.Key(), it.Value());
+        it = s_pTrackerData->m_SampledAllocations.Remove(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  // Only touched when a thread samples for the first time, the destructor hands the buffer back when the thread exits.
+  struct SampleBufferHolder
+  {
+    SampleBuffer* m_pBuffer = nullptr;
+
+    ~SampleBufferHolder()
+    {
+      tl_SamplingState.m_pBuffer = nullptr;
+      tl_SamplingState.m_bThreadExited = true;
+
+      if (m_pBuffer == nullptr)
+        return;
+
+      EZ_LOCK(*s_pTrackerData);
+
+      ProcessSampleBuffersUntil(s_iNextSampleSequence);
+
+      for (SampleBuffer** ppBuffer = &s_pTrackerData->m_pSampleBuffers; *ppBuffer != nullptr; ppBuffer = &(*ppBuffer)->m_pNext)
+      {
+        if (*ppBuffer == m_pBuffer)
+        {
+          *ppBuffer = m_pBuffer->m_pNext;
+          break;
+        }
+      }
+
+      EZ_DELETE(s_pTrackerDataAllocator, m_pBuffer);
+    }
+  };
+
+  static thread_local SampleBufferHolder tl_SampleBufferHolder;
+
+  SampleBuffer* GetSampleBuffer(SamplingThreadState& state)
+  {
+    if (state.m_pBuffer == nullptr)
+    {
+      SampleBuffer* pBuffer = EZ_NEW(s_pTrackerDataAllocator, SampleBuffer);
+
+      {
+        EZ_LOCK(*s_pTrackerData);
+        pBuffer->m_pNext = s_pTrackerData->m_pSampleBuffers;
+        s_pTrackerData->m_pSampleBuffers = pBuffer;
+      }
+
+      tl_SampleBufferHolder.m_pBuffer = pBuffer;
+      state.m_pBuffer = pBuffer;
+    }
+
+    return state.m_pBuffer;
+  }
+
+  /// Returns the number of bytes until the next sample, exponentially distributed with the sampling interval as the mean.
+  /// This makes the samples a Poisson process over the allocated bytes, so the chance to be sampled doesn't depend on the allocation pattern.
+  ezInt64 GetNextSampleDistance(SamplingThreadState& state, ezInt32 iSamplingInterval)
+  {
+    // xorshift64*
+    ezUInt64 x = state.m_uiRandomState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    state.m_uiRandomState = x;
+
+    const float fUniform = static_cast<float>(((x * 0x2545F4914F6CDD1Dull) >> 40) + 1) / static_cast<float>(1 << 24);
+    return static_cast<ezInt64>(-ezMath::Ln(fUniform) * iSamplingInterval);
+  }
 } // namespace
 
 // Iterator
@@ -169,6 +459,8 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
+  RemoveAllSamples(allocatorId);
+
   const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
 
   ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
@@ -431,4 +723,243 @@ ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 }
 
 
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt32 uiBytes)
+{
+  ezAtomicUtils::Set(s_iSamplingInterval, static_cast<ezInt32>(ezMath::Min<ezUInt32>(uiBytes, 0x7FFFFFFF)));
+}
+
+// static
+ezUInt32 ezMemoryTracker::GetSamplingInterval()
+{
+  return static_cast<ezUInt32>(s_iSamplingInterval);
+}
+
+// static
+void ezMemoryTracker::SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize)
+{
+  SamplingThreadState& state = tl_SamplingState;
+
+  const ezInt32 iSamplingInterval = s_iSamplingInterval;
+
+  state.m_iBytesUntilNextSample -= static_cast<ezInt64>(uiSize);
+  if (state.m_iBytesUntilNextSample >= 0 && state.m_iSamplingInterval == iSamplingInterval)
+    return;
+
+  if (iSamplingInterval == 0 || state.m_bThreadExited || allocatorId.IsInvalidated())
+  {
+    state.m_iSamplingInterval = iSamplingInterval;
+    state.m_iBytesUntilNextSample = ezMath::MaxValue<ezInt64>();
+    return;
+  }
+
+  if (state.m_iSamplingInterval != iSamplingInterval)
+  {
+    // first allocation on this thread or the interval was changed
+    if (state.m_uiRandomState == 0)
+    {
+      state.m_uiRandomState = (static_cast<ezUInt64>(reinterpret_cast<size_t>(&state)) ^ static_cast<ezUInt64>(ezTime::Now().GetNanoseconds())) | 1;
+    }
+
+    state.m_iSamplingInterval = iSamplingInterval;
+    state.m_iBytesUntilNextSample = GetNextSampleDistance(state, iSamplingInterval) - static_cast<ezInt64>(uiSize);
+
+    if (state.m_iBytesUntilNextSample >= 0)
+      return;
+  }
+
+  state.m_iBytesUntilNextSample = GetNextSampleDistance(state, iSamplingInterval);
+
+  SampleBuffer* pBuffer = GetSampleBuffer(state);
+  ReserveSampleEvent(pBuffer);
+
+  const ezInt64 iWritePos = pBuffer->m_iWritePos;
+
+  // the probability that an allocation of this size contains at least one sample point, each sample stands for 1 / probability allocations
+  const double fProbability = 1.0 - ezMath::Exp(-static_cast<float>(uiSize) / iSamplingInterval);
+
+  SampleEvent& event = pBuffer->m_Events[iWritePos % SampleBufferCapacity];
+  event.m_Key.m_pPtr = ptr;
+  event.m_Key.m_AllocatorId = allocatorId;
+  event.m_Allocation.m_fEstimatedSize = uiSize / fProbability;
+  event.m_Allocation.m_fEstimatedCount = 1.0 / fProbability;
+
+  ezArrayPtr<void*> stackTrace(event.m_StackTrace);
+  event.m_uiStackTraceLength = ezStackTracer::GetStackTrace(stackTrace);
+
+  // nothing between taking the sequence number and publishing the event may block, the processing of all threads waits for it
+  event.m_bDeallocation = false;
+  event.m_iSequence = ezAtomicUtils::PostIncrement(s_iNextSampleSequence);
+
+  // the filter has to know about the sample before the allocation is handed out, otherwise another thread could miss its deallocation
+  ezAtomicUtils::Increment(s_SampleFilter[GetSampleFilterIndex(ptr)]);
+
+  pBuffer->m_iWritePos.Set(iWritePos + 1);
+}
+
+// static
+void ezMemoryTracker::SampleDeallocation(ezAllocatorId allocatorId, const void* ptr)
+{
+  if (s_SampleFilter[GetSampleFilterIndex(ptr)] == 0)
+    return;
+
+  SampleKey key;
+  key.m_pPtr = ptr;
+  key.m_AllocatorId = allocatorId;
+
+  SamplingThreadState& state = tl_SamplingState;
+
+  if (state.m_bThreadExited)
+  {
+    EZ_LOCK(*s_pTrackerData);
+
+    // the allocation may still sit in the buffer of another thread
+    const ezInt64 iSequence = ezAtomicUtils::PostIncrement(s_iNextSampleSequence);
+    ProcessSampleBuffersUntil(iSequence);
+
+    RemoveSample(key);
+    ++s_pTrackerData->m_iNextSequenceToProcess;
+    return;
+  }
+
+  // deallocations are buffered just like allocations, so that they don't need the lock either
+  SampleBuffer* pBuffer = GetSampleBuffer(state);
+  ReserveSampleEvent(pBuffer);
+
+  const ezInt64 iWritePos = pBuffer->m_iWritePos;
+
+  SampleEvent& event = pBuffer->m_Events[iWritePos % SampleBufferCapacity];
+  event.m_Key = key;
+  event.m_bDeallocation = true;
+  event.m_iSequence = ezAtomicUtils::PostIncrement(s_iNextSampleSequence);
+
+  pBuffer->m_iWritePos.Set(iWritePos + 1);
+}
+
+// static
+void ezMemoryTracker::EnumerateSampledAllocations(SampledAllocationGroupFunc func, void* pPassThrough)
+{
+  if (s_pTrackerData == nullptr)
+    return;
+
+  struct Group
+  {
+    ezAllocatorId m_AllocatorId;
+    ezUInt64 m_uiStackTraceHash;
+    double m_fEstimatedSize;
+    double m_fEstimatedCount;
+    ezUInt32 m_uiNumSamples;
+    ezUInt32 m_uiFirstFrame;
+    ezUInt32 m_uiNumFrames;
+  };
+
+  ezDynamicArray<Group, TrackerDataAllocatorWrapper> groups;
+  ezDynamicArray<void*, TrackerDataAllocatorWrapper> frames;
+
+  {
+    EZ_LOCK(*s_pTrackerData);
+    ProcessSampleBuffersUntil(s_iNextSampleSequence);
+
+    groups.Reserve(s_pTrackerData->m_SampledAllocations.GetCount());
+
+    for (auto it = s_pTrackerData->m_SampledAllocations.GetIterator(); it.IsValid(); ++it)
+    {
+      Group& group = groups.ExpandAndGetRef();
+      group.m_AllocatorId = it.Key().m_AllocatorId;
+      group.m_uiStackTraceHash = it.Value().m_uiStackTraceHash;
+      group.m_fEstimatedSize = it.Value().m_fEstimatedSize;
+      group.m_fEstimatedCount = it.Value().m_fEstimatedCount;
+      group.m_uiNumSamples = 1;
+    }
+
+    // merge all samples of the same allocator and callstack
+    groups.Sort([](const Group& a, const Group& b) -> bool {
+      if (a.m_AllocatorId.m_Data != b.m_AllocatorId.m_Data)
+        return a.m_AllocatorId.m_Data < b.m_AllocatorId.m_Data;
+      return a.m_uiStackTraceHash < b.m_uiStackTraceHash;
+    });
+
+    ezUInt32 uiNumGroups = 0;
+    for (ezUInt32 i = 0; i < groups.GetCount(); ++i)
+    {
+      if (uiNumGroups > 0 && groups[uiNumGroups - 1].m_AllocatorId == groups[i].m_AllocatorId &&
+          groups[uiNumGroups - 1].m_uiStackTraceHash == groups[i].m_uiStackTraceHash)
+      {
+        Group& group = groups[uiNumGroups - 1];
+        group.m_fEstimatedSize += groups[i].m_fEstimatedSize;
+        group.m_fEstimatedCount += groups[i].m_fEstimatedCount;
+        group.m_uiNumSamples++;
+      }
+      else
+      {
+        groups[uiNumGroups++] = groups[i];
+      }
+    }
+
+    groups.SetCount(uiNumGroups);
+
+    // copy the callstacks, since they may be gone as soon as the lock is released
+    for (Group& group : groups)
+    {
+      const SampledStackTrace& stackTrace = s_pTrackerData->m_SampledStackTraces[group.m_uiStackTraceHash];
+
+      group.m_uiFirstFrame = frames.GetCount();
+      group.m_uiNumFrames = stackTrace.m_StackTrace.GetCount();
+      frames.PushBackRange(stackTrace.m_StackTrace);
+    }
+  }
+
+  groups.Sort([](const Group& a, const Group& b) -> bool { return a.m_fEstimatedSize > b.m_fEstimatedSize; });
+
+  for (const Group& group : groups)
+  {
+    SampledAllocationGroup result;
+    result.m_AllocatorId = group.m_AllocatorId;
+    result.m_uiEstimatedSize = static_cast<ezUInt64>(group.m_fEstimatedSize + 0.5);
+    result.m_uiEstimatedCount = static_cast<ezUInt64>(group.m_fEstimatedCount + 0.5);
+    result.m_uiNumSamples = group.m_uiNumSamples;
+    result.m_StackTrace = frames.GetArrayPtr().GetSubArray(group.m_uiFirstFrame, group.m_uiNumFrames);
+
+    func(result, pPassThrough);
+  }
+}
+
+// static
+void ezMemoryTracker::DumpSampledAllocations(ezUInt32 uiMaxGroups)
+{
+  struct DumpState
+  {
+    ezUInt32 m_uiMaxGroups;
+    ezUInt32 m_uiNumGroups;
+    ezUInt64 m_uiTotalSize;
+  };
+
+  DumpState state = {uiMaxGroups, 0, 0};
+
+  ezLog::Printf("\n\n--------------------------------------------------------------------\n"
+                "Sampled Allocations Report (sampling interval: %u bytes):"
+                "\n--------------------------------------------------------------------\n\n",
+    GetSamplingInterval());
+
+  EnumerateSampledAllocations(
+    [](const SampledAllocationGroup& group, void* pPassThrough) {
+      DumpState& state = *static_cast<DumpState*>(pPassThrough);
+      state.m_uiTotalSize += group.m_uiEstimatedSize;
+
+      if (state.m_uiNumGroups++ >= state.m_uiMaxGroups)
+        return;
+
+      ezLog::Printf("~%llu bytes in ~%llu allocations (%u samples) by '%s'\n", group.m_uiEstimatedSize, group.m_uiEstimatedCount,
+        group.m_uiNumSamples, GetAllocatorName(group.m_AllocatorId));
+
+      ezStackTracer::ResolveStackTrace(group.m_StackTrace, &ezLog::Print);
+
+      ezLog::Print("--------------------------------------------------------------------\n\n");
+    },
+    &state);
+
+  ezLog::Printf("Estimated %llu bytes in %u callstacks.\n\n", state.m_uiTotalSize, state.m_uiNumGroups);
+}
+
+
 EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Implementation_MemoryTracker);
@@ -14,6 +14,7 @@ struct ezMemoryTrackingFlags
     RegisterAllocator = EZ_BIT(0), ///< Register the allocator with the memory tracker. If EnableAllocationTracking is not set as well it is up to the allocator implementation whether it collects usable stats or not.
     EnableAllocationTracking = EZ_BIT(1), ///< Enable tracking of individual allocations
     EnableStackTrace = EZ_BIT(2), ///< Enable stack traces for each allocation
+    SampleAllocations = EZ_BIT(3), ///< Only track a random sample of all allocations, see ezMemoryTracker::SetSamplingInterval(). Much cheaper than EnableAllocationTracking.
 
     All = RegisterAllocator | EnableAllocationTracking | EnableStackTrace,
 
@@ -23,6 +24,9 @@ struct ezMemoryTrackingFlags
 #endif
 #if EZ_ENABLED(EZ_USE_ALLOCATION_STACK_TRACING)
               | EnableStackTrace
+#endif
+#if EZ_ENABLED(EZ_USE_ALLOCATION_SAMPLING)
+              | RegisterAllocator | SampleAllocations
 #endif
   };
 
@@ -31,6 +35,7 @@ struct ezMemoryTrackingFlags
     StorageType RegisterAllocator : 1;
     StorageType EnableAllocationTracking : 1;
     StorageType EnableStackTrace : 1;
+    StorageType SampleAllocations : 1;
   };
 };
 
@@ -74,6 +79,18 @@ public:
     }
   };
 
+  /// \brief Aggregated data of all live sampled allocations that were made by the same allocator from the same callstack.
+  struct SampledAllocationGroup
+  {
+    ezAllocatorId m_AllocatorId;
+    ezUInt64 m_uiEstimatedSize = 0;  ///< The estimated number of bytes that are currently allocated from this callstack.
+    ezUInt64 m_uiEstimatedCount = 0; ///< The estimated number of live allocations from this callstack.
+    ezUInt32 m_uiNumSamples = 0;     ///< The number of live allocations that were actually sampled.
+    ezArrayPtr<void*> m_StackTrace;  ///< Only valid during the callback of EnumerateSampledAllocations().
+  };
+
+  using SampledAllocationGroupFunc = void(const SampledAllocationGroup& group, void* pPassThrough);
+
   class EZ_FOUNDATION_DLL Iterator
   {
   public:
@@ -118,6 +135,37 @@ public:
 
   static void DumpMemoryLeaks();
 
+  /// \name Allocation Sampling
+  ///
+  /// Allocators with the ezMemoryTrackingFlags::SampleAllocations flag only report a random sample of their allocations,
+  /// on average one allocation every 'sampling interval' bytes. Larger allocations are therefore more likely to be sampled.
+  /// Each sample is weighted with the inverse of its probability, so the sums over many samples are unbiased estimates of the real memory usage.
+  /// Deciding whether to sample an allocation is thread-local and lock-free, the samples and the deallocations of sampled addresses are first
+  /// collected in per-thread buffers and only aggregated when a report is requested or a buffer is full.
+  ///@{
+
+  /// \brief Sets the average number of bytes between two sampled allocations. 0 disables sampling.
+  static void SetSamplingInterval(ezUInt32 uiBytes);
+
+  /// \brief Returns the average number of bytes between two sampled allocations. The default is 512 KB.
+  static ezUInt32 GetSamplingInterval();
+
+  /// \brief Called by allocators with the ezMemoryTrackingFlags::SampleAllocations flag for every allocation.
+  static void SampleAllocation(ezAllocatorId allocatorId, const void* ptr, size_t uiSize);
+
+  /// \brief Called by allocators with the ezMemoryTrackingFlags::SampleAllocations flag for every deallocation.
+  static void SampleDeallocation(ezAllocatorId allocatorId, const void* ptr);
+
+  /// \brief Calls \a func for each group of live sampled allocations, sorted by the estimated size in descending order.
+  ///
+  /// The callback is not called while holding any lock, so it may allocate memory.
+  static void EnumerateSampledAllocations(SampledAllocationGroupFunc func, void* pPassThrough = nullptr);
+
+  /// \brief Prints the \a uiMaxGroups callstacks that currently hold the most sampled memory, in the same way as DumpMemoryLeaks().
+  static void DumpSampledAllocations(ezUInt32 uiMaxGroups = 32);
+
+  ///@}
+
   static Iterator GetIterator();
 };
 
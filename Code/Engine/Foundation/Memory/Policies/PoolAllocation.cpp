@@ -0,0 +1,508 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/PoolAllocation.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+namespace
+{
+  struct ThreadCache;
+
+  enum
+  {
+    // 16 to 128 bytes in steps of 16, then four classes per power of two up to 1024 bytes
+    NumSizeClasses = 20,
+
+    // how many full slabs the slow path checks for blocks that other threads have freed, before it takes a new slab
+    MaxScannedFullSlabs = 4,
+
+    // every block is prefixed with a pointer to its slab, blocks that come from the CRT heap store nullptr instead
+    BlockHeaderSize = 8,
+  };
+
+  static_assert(sizeof(void*) <= BlockHeaderSize, "The block header must be able to hold a pointer");
+
+  struct Slab
+  {
+    // Only the owning thread changes this, but other threads read it to decide whether they may free into m_pFreeList.
+    // A thread can only ever see its own cache here if it is the owner, so a stale value always leads to the (safe) remote path.
+    ThreadCache* volatile m_pOwner;
+
+    // links in the owner's list of slabs of this size class, or in the list of abandoned slabs
+    Slab* m_pPrev;
+    Slab* m_pNext;
+
+    // only accessed by the owner
+    void* m_pFreeList;
+    ezUInt32 m_uiSizeClass;
+    ezUInt32 m_uiBlockStride;
+    ezUInt32 m_uiNumBlocks;
+    ezUInt32 m_uiNumCarvedBlocks;
+    ezUInt32 m_uiNumUsedBlocks;
+    bool m_bFull;
+
+    // blocks freed by other threads, as a lock-free stack of user pointers
+    ezAtomicInteger64 m_RemoteFreeList;
+  };
+
+  enum
+  {
+    SlabHeaderSize = (sizeof(Slab) + 15) & ~15,
+  };
+
+  struct SizeClass
+  {
+    Slab* m_pCurrent;
+
+    // the current slab and all slabs that have free blocks
+    Slab* m_pSlabs;
+
+    // slabs that ran out of blocks, they can only get blocks back through remote frees or by moving to m_pSlabs on a local free
+    Slab* m_pFullSlabs;
+    Slab* m_pNextFullSlabToScan;
+  };
+
+  struct ThreadCache
+  {
+    SizeClass m_SizeClasses[NumSizeClasses];
+  };
+
+  EZ_FORCE_INLINE ezUInt32 GetSizeClass(size_t uiSize)
+  {
+    if (uiSize <= 128)
+      return static_cast<ezUInt32>((uiSize + 15) / 16) - 1;
+
+    const ezUInt32 uiValue = static_cast<ezUInt32>(uiSize - 1);
+    const ezUInt32 uiHighBit = ezMath::FirstBitHigh(uiValue);
+    return 8 + (uiHighBit - 7) * 4 + (uiValue >> (uiHighBit - 2)) - 4;
+  }
+
+  EZ_FORCE_INLINE ezUInt32 GetSizeClassSize(ezUInt32 uiSizeClass)
+  {
+    if (uiSizeClass < 8)
+      return (uiSizeClass + 1) * 16;
+
+    const ezUInt32 k = uiSizeClass - 8;
+    return ((k % 4) + 5) << (k / 4 + 5);
+  }
+
+  EZ_ALWAYS_INLINE Slab*& GetBlockHeader(void* ptr)
+  {
+    return *static_cast<Slab**>(ezMemoryUtils::AddByteOffset(ptr, -BlockHeaderSize));
+  }
+
+  EZ_ALWAYS_INLINE void*& GetNextFree(void* ptr)
+  {
+    return *static_cast<void**>(ptr);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Slabs
+
+  Slab* CreateSlab(ThreadCache* pOwner, ezUInt32 uiSizeClass)
+  {
+    Slab* pSlab = new (ezPageAllocator::AllocatePage(ezMemoryPolicies::ezPoolAllocation::SlabSize)) Slab();
+    pSlab->m_pOwner = pOwner;
+    pSlab->m_pPrev = nullptr;
+    pSlab->m_pNext = nullptr;
+    pSlab->m_pFreeList = nullptr;
+    pSlab->m_uiSizeClass = uiSizeClass;
+    pSlab->m_uiBlockStride = GetSizeClassSize(uiSizeClass) + BlockHeaderSize;
+    pSlab->m_uiNumBlocks = (ezMemoryPolicies::ezPoolAllocation::SlabSize - SlabHeaderSize) / pSlab->m_uiBlockStride;
+    pSlab->m_uiNumCarvedBlocks = 0;
+    pSlab->m_uiNumUsedBlocks = 0;
+    pSlab->m_bFull = false;
+
+    return pSlab;
+  }
+
+  void DestroySlab(Slab* pSlab)
+  {
+    EZ_ASSERT_DEBUG(pSlab->m_uiNumUsedBlocks == 0, "Slab is still in use");
+
+    pSlab->~Slab();
+    ezPageAllocator::DeallocatePage(pSlab);
+  }
+
+  EZ_FORCE_INLINE void* TakeBlock(Slab* pSlab)
+  {
+    void* ptr = pSlab->m_pFreeList;
+
+    if (ptr != nullptr)
+    {
+      pSlab->m_pFreeList = GetNextFree(ptr);
+    }
+    else if (pSlab->m_uiNumCarvedBlocks < pSlab->m_uiNumBlocks)
+    {
+      // blocks that were never used before are carved out lazily, so that a new slab doesn't touch all of its memory at once
+      void* pBlock = ezMemoryUtils::AddByteOffset(pSlab, SlabHeaderSize + pSlab->m_uiNumCarvedBlocks * pSlab->m_uiBlockStride);
+      ++pSlab->m_uiNumCarvedBlocks;
+
+      ptr = ezMemoryUtils::AddByteOffset(pBlock, BlockHeaderSize);
+      GetBlockHeader(ptr) = pSlab;
+    }
+    else
+    {
+      return nullptr;
+    }
+
+    ++pSlab->m_uiNumUsedBlocks;
+    return ptr;
+  }
+
+  EZ_FORCE_INLINE bool HasFreeBlocks(const Slab* pSlab)
+  {
+    return pSlab->m_pFreeList != nullptr || pSlab->m_uiNumCarvedBlocks < pSlab->m_uiNumBlocks;
+  }
+
+  void PushRemoteFree(Slab* pSlab, void* ptr)
+  {
+    while (true)
+    {
+      const ezInt64 iHead = pSlab->m_RemoteFreeList;
+      GetNextFree(ptr) = reinterpret_cast<void*>(static_cast<size_t>(iHead));
+
+      if (pSlab->m_RemoteFreeList.TestAndSet(iHead, static_cast<ezInt64>(reinterpret_cast<size_t>(ptr))))
+        return;
+    }
+  }
+
+  /// Moves all blocks that other threads have freed into the slab's own free list. May only be called by the owner.
+  void CollectRemoteFrees(Slab* pSlab)
+  {
+    // the owner takes the whole list at once, so there is no ABA problem with the other threads only pushing
+    void* ptr = reinterpret_cast<void*>(static_cast<size_t>(pSlab->m_RemoteFreeList.Set(0)));
+
+    while (ptr != nullptr)
+    {
+      void* pNext = GetNextFree(ptr);
+
+      GetNextFree(ptr) = pSlab->m_pFreeList;
+      pSlab->m_pFreeList = ptr;
+      --pSlab->m_uiNumUsedBlocks;
+
+      ptr = pNext;
+    }
+  }
+
+  void LinkSlab(Slab*& pHead, Slab* pSlab)
+  {
+    pSlab->m_pPrev = nullptr;
+    pSlab->m_pNext = pHead;
+
+    if (pHead != nullptr)
+      pHead->m_pPrev = pSlab;
+
+    pHead = pSlab;
+  }
+
+  void UnlinkSlab(Slab*& pHead, Slab* pSlab)
+  {
+    if (pSlab->m_pPrev != nullptr)
+      pSlab->m_pPrev->m_pNext = pSlab->m_pNext;
+    else
+      pHead = pSlab->m_pNext;
+
+    if (pSlab->m_pNext != nullptr)
+      pSlab->m_pNext->m_pPrev = pSlab->m_pPrev;
+
+    pSlab->m_pPrev = nullptr;
+    pSlab->m_pNext = nullptr;
+  }
+
+  void MoveToFullSlabs(SizeClass& sizeClass, Slab* pSlab)
+  {
+    UnlinkSlab(sizeClass.m_pSlabs, pSlab);
+    LinkSlab(sizeClass.m_pFullSlabs, pSlab);
+    pSlab->m_bFull = true;
+  }
+
+  void MoveFromFullSlabs(SizeClass& sizeClass, Slab* pSlab)
+  {
+    if (sizeClass.m_pNextFullSlabToScan == pSlab)
+    {
+      sizeClass.m_pNextFullSlabToScan = pSlab->m_pNext;
+    }
+
+    UnlinkSlab(sizeClass.m_pFullSlabs, pSlab);
+    LinkSlab(sizeClass.m_pSlabs, pSlab);
+    pSlab->m_bFull = false;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Abandoned slabs
+
+  // Slabs that still contain used blocks when their thread exits. They are adopted by the next thread that needs a slab of that size class.
+  // This is only a spin lock, since it is rarely taken and must not depend on anything that might allocate or need initialization.
+  static ezAtomicInteger32 s_AbandonedSlabsLock;
+  static Slab* s_AbandonedSlabs[NumSizeClasses];
+
+  struct AbandonedSlabsLock
+  {
+    AbandonedSlabsLock()
+    {
+      while (!s_AbandonedSlabsLock.TestAndSet(0, 1))
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+    }
+
+    ~AbandonedSlabsLock() { s_AbandonedSlabsLock.Set(0); }
+  };
+
+  void AbandonThreadCache(ThreadCache& cache)
+  {
+    for (ezUInt32 uiSizeClass = 0; uiSizeClass < NumSizeClasses; ++uiSizeClass)
+    {
+      SizeClass& sizeClass = cache.m_SizeClasses[uiSizeClass];
+
+      while (sizeClass.m_pFullSlabs != nullptr)
+      {
+        MoveFromFullSlabs(sizeClass, sizeClass.m_pFullSlabs);
+      }
+
+      while (Slab* pSlab = sizeClass.m_pSlabs)
+      {
+        UnlinkSlab(sizeClass.m_pSlabs, pSlab);
+        CollectRemoteFrees(pSlab);
+
+        if (pSlab->m_uiNumUsedBlocks == 0)
+        {
+          DestroySlab(pSlab);
+        }
+        else
+        {
+          pSlab->m_pOwner = nullptr;
+
+          AbandonedSlabsLock lock;
+          LinkSlab(s_AbandonedSlabs[uiSizeClass], pSlab);
+        }
+      }
+
+      sizeClass.m_pCurrent = nullptr;
+    }
+  }
+
+  Slab* AdoptAbandonedSlab(ThreadCache* pCache, ezUInt32 uiSizeClass)
+  {
+    Slab* pSlab = nullptr;
+
+    {
+      AbandonedSlabsLock lock;
+
+      pSlab = s_AbandonedSlabs[uiSizeClass];
+      if (pSlab == nullptr)
+        return nullptr;
+
+      UnlinkSlab(s_AbandonedSlabs[uiSizeClass], pSlab);
+    }
+
+    pSlab->m_pOwner = pCache;
+    CollectRemoteFrees(pSlab);
+    return pSlab;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Thread caches
+
+  static thread_local ThreadCache* tl_pThreadCache = nullptr;
+  static thread_local bool tl_bThreadCacheDestroyed = false;
+
+  // Only touched when a thread allocates for the first time, so that the fast path doesn't pay for the thread_local destructor registration.
+  struct ThreadCacheHolder
+  {
+    ThreadCache m_Cache = {};
+
+    ~ThreadCacheHolder()
+    {
+      AbandonThreadCache(m_Cache);
+
+      tl_pThreadCache = nullptr;
+      tl_bThreadCacheDestroyed = true;
+    }
+  };
+
+  static thread_local ThreadCacheHolder tl_ThreadCacheHolder;
+
+  EZ_FORCE_INLINE ThreadCache* GetThreadCache()
+  {
+    if (tl_pThreadCache == nullptr && !tl_bThreadCacheDestroyed)
+    {
+      tl_pThreadCache = &tl_ThreadCacheHolder.m_Cache;
+    }
+
+    return tl_pThreadCache;
+  }
+
+  void* AllocateSlow(ThreadCache* pCache, ezUInt32 uiSizeClass)
+  {
+    SizeClass& sizeClass = pCache->m_SizeClasses[uiSizeClass];
+
+    if (Slab* pCurrent = sizeClass.m_pCurrent)
+    {
+      sizeClass.m_pCurrent = nullptr;
+
+      if (pCurrent->m_RemoteFreeList != 0)
+      {
+        CollectRemoteFrees(pCurrent);
+      }
+
+      if (!HasFreeBlocks(pCurrent))
+      {
+        MoveToFullSlabs(sizeClass, pCurrent);
+      }
+    }
+
+    // all slabs in this list have free blocks
+    Slab* pFound = sizeClass.m_pSlabs;
+
+    // Otherwise look for full slabs that other threads have given blocks back to. Only a few of them are checked per call, continuing where
+    // the last call stopped, so that the cost doesn't grow with the number of slabs, but every slab is looked at eventually.
+    for (ezUInt32 i = 0; i < MaxScannedFullSlabs && pFound == nullptr && sizeClass.m_pFullSlabs != nullptr; ++i)
+    {
+      Slab* pSlab = sizeClass.m_pNextFullSlabToScan != nullptr ? sizeClass.m_pNextFullSlabToScan : sizeClass.m_pFullSlabs;
+      sizeClass.m_pNextFullSlabToScan = pSlab->m_pNext;
+
+      if (pSlab->m_RemoteFreeList != 0)
+      {
+        CollectRemoteFrees(pSlab);
+        MoveFromFullSlabs(sizeClass, pSlab);
+        pFound = pSlab;
+      }
+    }
+
+    while (pFound == nullptr)
+    {
+      Slab* pSlab = AdoptAbandonedSlab(pCache, uiSizeClass);
+
+      if (pSlab == nullptr)
+      {
+        pSlab = CreateSlab(pCache, uiSizeClass);
+      }
+
+      if (HasFreeBlocks(pSlab))
+      {
+        LinkSlab(sizeClass.m_pSlabs, pSlab);
+        pFound = pSlab;
+      }
+      else
+      {
+        LinkSlab(sizeClass.m_pFullSlabs, pSlab);
+        pSlab->m_bFull = true;
+      }
+    }
+
+    sizeClass.m_pCurrent = pFound;
+    return TakeBlock(pFound);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Heap fallback
+
+  void* AllocateFromHeap(size_t uiSize)
+  {
+    void* pBlock = malloc(uiSize + BlockHeaderSize);
+    if (pBlock == nullptr)
+      return nullptr;
+
+    void* ptr = ezMemoryUtils::AddByteOffset(pBlock, BlockHeaderSize);
+    GetBlockHeader(ptr) = nullptr;
+    return ptr;
+  }
+} // namespace
+
+namespace ezMemoryPolicies
+{
+  void* ezPoolAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    // see ezHeapAllocation::Allocate
+    EZ_ASSERT_DEBUG(
+      uiAlign <= 8, "This allocator does not guarantee alignments larger than 8. Use an aligned allocator to allocate the desired data type.");
+
+    ThreadCache* pCache = GetThreadCache();
+
+    if (uiSize > MaxPooledSize || pCache == nullptr)
+    {
+      return AllocateFromHeap(uiSize);
+    }
+
+    const ezUInt32 uiSizeClass = GetSizeClass(uiSize);
+    Slab* pCurrent = pCache->m_SizeClasses[uiSizeClass].m_pCurrent;
+
+    if (pCurrent != nullptr)
+    {
+      if (void* ptr = TakeBlock(pCurrent))
+        return ptr;
+    }
+
+    return AllocateSlow(pCache, uiSizeClass);
+  }
+
+  void* ezPoolAllocation::Reallocate(void* currentPtr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign)
+  {
+    Slab* pSlab = GetBlockHeader(currentPtr);
+
+    if (pSlab == nullptr)
+    {
+      void* pBlock = realloc(ezMemoryUtils::AddByteOffset(currentPtr, -BlockHeaderSize), uiNewSize + BlockHeaderSize);
+      return pBlock != nullptr ? ezMemoryUtils::AddByteOffset(pBlock, BlockHeaderSize) : nullptr;
+    }
+
+    if (uiNewSize <= GetSizeClassSize(pSlab->m_uiSizeClass))
+    {
+      return currentPtr;
+    }
+
+    void* pNewPtr = Allocate(uiNewSize, uiAlign);
+    ezMemoryUtils::RawByteCopy(pNewPtr, currentPtr, ezMath::Min(uiCurrentSize, uiNewSize));
+    Deallocate(currentPtr);
+
+    return pNewPtr;
+  }
+
+  void ezPoolAllocation::Deallocate(void* ptr)
+  {
+    if (ptr == nullptr)
+      return;
+
+    Slab* pSlab = GetBlockHeader(ptr);
+
+    if (pSlab == nullptr)
+    {
+      free(ezMemoryUtils::AddByteOffset(ptr, -BlockHeaderSize));
+      return;
+    }
+
+    ThreadCache* pCache = tl_pThreadCache;
+
+    if (pCache == nullptr || pSlab->m_pOwner != pCache)
+    {
+      PushRemoteFree(pSlab, ptr);
+      return;
+    }
+
+    GetNextFree(ptr) = pSlab->m_pFreeList;
+    pSlab->m_pFreeList = ptr;
+    --pSlab->m_uiNumUsedBlocks;
+
+    SizeClass& sizeClass = pCache->m_SizeClasses[pSlab->m_uiSizeClass];
+
+    if (pSlab->m_bFull)
+    {
+      MoveFromFullSlabs(sizeClass, pSlab);
+    }
+
+    // keep the slab that is currently allocated from, to not release and request a page over and over again
+    if (pSlab->m_uiNumUsedBlocks == 0)
+    {
+      if (sizeClass.m_pCurrent != pSlab)
+      {
+        UnlinkSlab(sizeClass.m_pSlabs, pSlab);
+        DestroySlab(pSlab);
+      }
+    }
+  }
+} // namespace ezMemoryPolicies
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_PoolAllocation);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Small object pool allocation policy.
+  ///
+  /// Allocations of up to MaxPooledSize bytes are rounded up to one of a few size classes and served from thread-local free lists.
+  /// Each thread carves its blocks out of its own slabs of SlabSize bytes, which are requested from ezPageAllocator.
+  /// Allocating and freeing on the same thread therefore never takes a lock.
+  /// Blocks that are freed on another thread are pushed onto a lock-free list of their slab and handed back to the owning thread
+  /// the next time that thread runs out of blocks. Slabs of threads that exit are adopted by the next thread that needs one.
+  ///
+  /// Larger allocations are passed through to the CRT heap. All instances of this policy share the same pools,
+  /// just like all instances of ezHeapAllocation share the CRT heap.
+  /// Like ezHeapAllocation, this allocator does not guarantee alignments larger than 8.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezPoolAllocation
+  {
+  public:
+    enum
+    {
+      MaxPooledSize = 1024,
+      SlabSize = 64 * 1024,
+    };
+
+    EZ_ALWAYS_INLINE ezPoolAllocation(ezAllocatorBase* pParent) {}
+    EZ_ALWAYS_INLINE ~ezPoolAllocation() {}
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void* Reallocate(void* currentPtr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+  };
+} // namespace ezMemoryPolicies
@@ -3,15 +3,29 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
+#include <Foundation/IO/CompressedStreamZstd.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/JSONWriter.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
 #if EZ_ENABLED(EZ_USE_PROFILING)
 
+#  if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+#    if EZ_ENABLED(EZ_COMPILER_MSVC)
+#      include <intrin.h>
+#    else
+#      include <x86intrin.h>
+#    endif
+#  endif
+
 class ezProfileCaptureDataTransfer : public ezDataTransfer
 {
 private:
@@ -32,7 +46,9 @@ static ezProfileCaptureDataTransfer s_ProfileCaptureDataTransfer;
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
 
-  // no dependencies
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "FileSystem"
+  END_SUBSYSTEM_DEPENDENCIES
 
   ON_BASESYSTEMS_STARTUP
   {
@@ -42,6 +58,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
   ON_CORESYSTEMS_SHUTDOWN
   {
     s_ProfileCaptureDataTransfer.DisableDataTransfer();
+    ezProfilingSystem::StopStreaming();
     ezProfilingSystem::Reset();
   }
 
@@ -59,73 +76,172 @@ namespace
   enum
   {
     BUFFER_SIZE_FRAMES = 120 * 60,
+    BUFFER_SIZE_FLOW_EVENTS = 16 * 1024,
   };
 
   typedef ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)> GPUScopesBuffer;
 
-  static ezUInt64 s_MainThreadId = 0;
-
-  struct CpuScopesBufferBase
+  /// Ring buffer of CPU scopes that is only written by its own thread, but can be read from any other thread at the same time.
+  ///
+  /// The events are addressed by the number of events that were written before them. Readers copy a range of events and afterwards
+  /// check which of them could have been overwritten in the mean time, so no locking is necessary on the writing side.
+  struct CpuScopesBuffer
   {
-    virtual ~CpuScopesBufferBase() = default;
+    CpuScopesBuffer(ezUInt32 uiSizeInBytes)
+    {
+      m_Data.SetCountUninitialized(uiSizeInBytes / sizeof(ezProfilingSystem::CPUScope));
+    }
 
-    ezUInt64 m_uiThreadId = 0;
-    bool IsMainThread() const
+    void PushBack(const ezProfilingSystem::CPUScope& scope)
     {
-      return m_uiThreadId == s_MainThreadId;
+      m_Data[static_cast<ezUInt32>(m_uiOwnerWriteCount % m_Data.GetCount())] = scope;
+      ++m_uiOwnerWriteCount;
+
+      // publishes the event to the readers
+      m_iWriteCount.Increment();
     }
-  };
 
-  template <ezUInt32 SizeInBytes>
-  struct CpuScopesBuffer : public CpuScopesBufferBase
-  {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
-  };
+    /// Returns the index of the oldest event that is still available.
+    ezUInt64 GetFirstAvailableEvent() const
+    {
+      const ezUInt64 uiWriteCount = static_cast<ezUInt64>(m_iWriteCount);
+      const ezUInt64 uiFirst = uiWriteCount > m_Data.GetCount() ? uiWriteCount - m_Data.GetCount() : 0;
+      return ezMath::Max(uiFirst, static_cast<ezUInt64>(m_iClearedCount));
+    }
 
-  CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>*>(pEventBuffer);
-  }
+    /// Appends all events from uiFirstEvent on that are still valid and returns the index of the next event that hasn't been copied.
+    ezUInt64 CopyEvents(ezUInt64 uiFirstEvent, ezDynamicArray<ezProfilingSystem::CPUScope>& out_events) const
+    {
+      uiFirstEvent = ezMath::Max(uiFirstEvent, GetFirstAvailableEvent());
+      const ezUInt64 uiEndEvent = static_cast<ezUInt64>(m_iWriteCount);
 
-  CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>* CastToOtherThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(!pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>*>(pEventBuffer);
-  }
+      const ezUInt32 uiPrevCount = out_events.GetCount();
+      for (ezUInt64 i = uiFirstEvent; i < uiEndEvent; ++i)
+      {
+        out_events.PushBack(m_Data[static_cast<ezUInt32>(i % m_Data.GetCount())]);
+      }
+
+      // the writer may have overwritten the oldest events while they were copied, those are removed again
+      const ezUInt64 uiWriteCount = static_cast<ezUInt64>(m_iWriteCount);
+      if (uiWriteCount >= uiFirstEvent + m_Data.GetCount())
+      {
+        const ezUInt64 uiNumOverwritten = ezMath::Min(uiWriteCount - m_Data.GetCount() + 1 - uiFirstEvent, uiEndEvent - uiFirstEvent);
+        out_events.RemoveAtAndCopy(uiPrevCount, static_cast<ezUInt32>(uiNumOverwritten));
+      }
+
+      return uiEndEvent;
+    }
+
+    ezUInt64 m_uiThreadId = 0;
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_Data;
+    ezUInt64 m_uiOwnerWriteCount = 0;   ///< Only accessed by the owning thread.
+    ezAtomicInteger64 m_iWriteCount;    ///< The number of events that were ever written.
+    ezAtomicInteger64 m_iClearedCount;  ///< All events in front of this index were removed by Clear().
+    ezUInt64 m_uiStreamedCount = 0;     ///< Only accessed by the streaming thread, while holding s_AllCpuScopesMutex.
+  };
 
   ezCVarFloat CVarDiscardThresholdMs("g_ProfilingDiscardThresholdMs", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than the specified threshold.");
 
   ezStaticRingBuffer<ezTime, BUFFER_SIZE_FRAMES> s_FrameStartTimes;
   ezUInt64 s_uiFrameCount = 0;
+  static ezMutex s_FrameStartTimesMutex;
 
   static ezHybridArray<ezProfilingSystem::ThreadInfo, 16> s_ThreadInfos;
   static ezHybridArray<ezUInt64, 16> s_DeadThreadIDs;
   static ezMutex s_ThreadInfosMutex;
 
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 16);
 #  if EZ_ENABLED(EZ_PLATFORM_64BIT)
-  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 64);
   EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::GPUScope) == 64);
 #  endif
 
-  static thread_local CpuScopesBufferBase* s_CpuScopes = nullptr;
-  static ezDynamicArray<CpuScopesBufferBase*> s_AllCpuScopes;
+  static thread_local CpuScopesBuffer* s_CpuScopes = nullptr;
+  static ezDynamicArray<CpuScopesBuffer*> s_AllCpuScopes;
   static ezMutex s_AllCpuScopesMutex;
 
   static GPUScopesBuffer* s_GPUScopes;
+  static ezUInt64 s_uiGPUScopeCount = 0;
+  static ezMutex s_GPUScopesMutex;
+
+  static ezStaticRingBuffer<ezProfilingSystem::FlowEvent, BUFFER_SIZE_FLOW_EVENTS> s_FlowEvents;
+  static ezUInt64 s_uiFlowEventCount = 0;
+  static ezMutex s_FlowEventsMutex;
+  static ezAtomicInteger64 s_iNextFlowId;
+
+  // Tick calibration. The initial estimate is only used for the discard threshold, Capture() measures the tick rate
+  // over the entire time since startup.
+  static ezUInt64 s_uiBaseTicks = 0;
+  static ezTime s_BaseTime;
+  static double s_fTicksPerSecond = 1000000000.0;
+
+  // Interned scope names. The deque keeps the strings at stable addresses, so the per-thread caches can point to them.
+  static ezDeque<ezProfilingSystem::ScopeName> s_ScopeNames;
+  static ezHashTable<ezUInt64, ezUInt32> s_ScopeNameIds;
+  static ezMutex s_ScopeNamesMutex;
+
+  enum
+  {
+    SCOPE_NAME_CACHE_SIZE = 256
+  };
+
+  struct ScopeNameCacheEntry
+  {
+    ezUInt64 m_uiHash = 0;
+    ezUInt32 m_uiNameId = ezInvalidIndex;
+  };
+
+  static thread_local ScopeNameCacheEntry s_ScopeNameCache[SCOPE_NAME_CACHE_SIZE];
+
+  static ezAtomicBool s_bStreamFlushRequested;
+  static ezTime s_StreamHitchThreshold;
+
+  ezUInt64 TimeToTicks(ezTime time)
+  {
+    const double fTicks = (time - s_BaseTime).GetSeconds() * s_fTicksPerSecond;
+    return fTicks > 0.0 ? s_uiBaseTicks + static_cast<ezUInt64>(fTicks) : 0;
+  }
+
+  double MeasureTicksPerSecond()
+  {
+    const ezUInt64 uiTicks = ezProfilingSystem::GetTicks();
+    const ezTime time = ezTime::Now();
+
+    // calibrate the ticks over the entire time since startup, this is a lot more precise than the initial estimate
+    if (uiTicks > s_uiBaseTicks && time - s_BaseTime > ezTime::Milliseconds(10))
+    {
+      return (uiTicks - s_uiBaseTicks) / (time - s_BaseTime).GetSeconds();
+    }
+
+    return s_fTicksPerSecond;
+  }
 
-  static ezEventSubscriptionID s_PluginEventSubscription = 0;
-  void PluginEvent(const ezPluginEvent& e)
+  void CalibrateTicks()
   {
-    if (e.m_EventType == ezPluginEvent::AfterUnloading)
+    s_uiBaseTicks = ezProfilingSystem::GetTicks();
+    s_BaseTime = ezTime::Now();
+
+    // a short busy wait is enough to get the tick rate within a fraction of a percent
+    ezUInt64 uiTicks = 0;
+    ezTime time;
+    do
+    {
+      uiTicks = ezProfilingSystem::GetTicks();
+      time = ezTime::Now();
+    } while (time - s_BaseTime < ezTime::Milliseconds(1));
+
+    if (uiTicks > s_uiBaseTicks)
     {
-      // When a plugin is unloaded we need to clear all profiling data
-      // since they can contain pointers to function names that don't exist anymore.
-      ezProfilingSystem::Clear();
+      s_fTicksPerSecond = (uiTicks - s_uiBaseTicks) / (time - s_BaseTime).GetSeconds();
     }
   }
 } // namespace
 
+ezTime ezProfilingSystem::ProfilingData::TicksToTime(ezUInt64 uiTicks) const
+{
+  const double fTicks = uiTicks >= m_uiBaseTicks ? static_cast<double>(uiTicks - m_uiBaseTicks) : -static_cast<double>(m_uiBaseTicks - uiTicks);
+  return m_BaseTime + ezTime::Seconds(fTicks / m_fTicksPerSecond);
+}
+
 ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) const
 {
   ezStandardJSONWriter writer;
@@ -239,37 +355,36 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
       // So we sort by duration to make sure that parent scopes are written first in the json file.
       sortedScopes = eventBuffer.m_Data;
       sortedScopes.Sort([](const CPUScope& a, const CPUScope& b) {
-        return (a.m_EndTime - a.m_BeginTime) > (b.m_EndTime - b.m_BeginTime);
+        return a.GetDurationTicks() > b.GetDurationTicks();
       });
 
       for (const CPUScope& e : sortedScopes)
       {
+        const ScopeName& name = m_ScopeNames[e.GetNameId()];
+
         writer.BeginObject();
-        writer.AddVariableString("name", e.m_szName);
+        writer.AddVariableString("name", name.m_sName);
         writer.AddVariableUInt32("pid", m_uiProcessID);
         writer.AddVariableUInt64("tid", uiThreadId);
-        writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_BeginTime.GetMicroseconds()));
+        writer.AddVariableUInt64("ts", static_cast<ezUInt64>(TicksToTime(e.m_uiBeginTicks).GetMicroseconds()));
         writer.AddVariableString("ph", "B");
 
-        if (e.m_szFunctionName != nullptr)
+        if (!name.m_sFunctionName.IsEmpty())
         {
           writer.BeginObject("args");
-          writer.AddVariableString("function", e.m_szFunctionName);
+          writer.AddVariableString("function", name.m_sFunctionName);
           writer.EndObject();
         }
 
         writer.EndObject();
 
-        if (e.m_EndTime.IsPositive())
-        {
-          writer.BeginObject();
-          writer.AddVariableString("name", e.m_szName);
-          writer.AddVariableUInt32("pid", m_uiProcessID);
-          writer.AddVariableUInt64("tid", uiThreadId);
-          writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_EndTime.GetMicroseconds()));
-          writer.AddVariableString("ph", "E");
-          writer.EndObject();
-        }
+        writer.BeginObject();
+        writer.AddVariableString("name", name.m_sName);
+        writer.AddVariableUInt32("pid", m_uiProcessID);
+        writer.AddVariableUInt64("tid", uiThreadId);
+        writer.AddVariableUInt64("ts", static_cast<ezUInt64>(TicksToTime(e.GetEndTicks()).GetMicroseconds()));
+        writer.AddVariableString("ph", "E");
+        writer.EndObject();
 
         if (writer.HadWriteError())
         {
@@ -288,6 +403,10 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
         const ezTime t0 = m_FrameStartTimes[i - 1];
         const ezTime t1 = m_FrameStartTimes[i];
 
+        // frames that are missing in a streamed capture are zero
+        if (t0.IsZero() || t1.IsZero())
+          continue;
+
         const ezUInt64 localFrameID = uiNumFrames - i - 1;
         sFrameName.Format("Frame {}", m_uiFrameCount - localFrameID);
 
@@ -341,6 +460,33 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) c
       }
     }
 
+    // flow arrows
+    {
+      for (const FlowEvent& e : m_FlowEvents)
+      {
+        writer.BeginObject();
+        writer.AddVariableString("name", "Flow");
+        writer.AddVariableString("cat", "Flow");
+        writer.AddVariableUInt64("id", e.m_uiFlowId);
+        writer.AddVariableUInt32("pid", m_uiProcessID);
+        writer.AddVariableUInt64("tid", e.m_uiThreadId + 2);
+        writer.AddVariableUInt64("ts", static_cast<ezUInt64>(TicksToTime(e.m_uiTicks).GetMicroseconds()));
+        writer.AddVariableString("ph", e.m_bStart ? "s" : "f");
+
+        if (!e.m_bStart)
+        {
+          // bind to the enclosing scope instead of the next one
+          writer.AddVariableString("bp", "e");
+        }
+
+        writer.EndObject();
+        if (writer.HadWriteError())
+        {
+          return EZ_FAILURE;
+        }
+      }
+    }
+
     writer.EndArray();
   }
 
@@ -356,22 +502,26 @@ void ezProfilingSystem::Clear()
     EZ_LOCK(s_AllCpuScopesMutex);
     for (auto pEventBuffer : s_AllCpuScopes)
     {
-      if (pEventBuffer->IsMainThread())
-      {
-        CastToMainThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
-      else
-      {
-        CastToOtherThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
+      pEventBuffer->m_iClearedCount = static_cast<ezInt64>(pEventBuffer->m_iWriteCount);
     }
   }
 
-  s_FrameStartTimes.Clear();
+  {
+    EZ_LOCK(s_FrameStartTimesMutex);
+    s_FrameStartTimes.Clear();
+  }
+
+  {
+    EZ_LOCK(s_GPUScopesMutex);
+    if (s_GPUScopes != nullptr)
+    {
+      s_GPUScopes->Clear();
+    }
+  }
 
-  if (s_GPUScopes != nullptr)
   {
-    s_GPUScopes->Clear();
+    EZ_LOCK(s_FlowEventsMutex);
+    s_FlowEvents.Clear();
   }
 }
 
@@ -399,38 +549,54 @@ ezProfilingSystem::ProfilingData ezProfilingSystem::Capture()
     profilingData.m_AllEventBuffers.Reserve(s_AllCpuScopes.GetCount());
     for (ezUInt32 i = 0; i < s_AllCpuScopes.GetCount(); ++i)
     {
-      auto& sourceEventBuffer = s_AllCpuScopes[i];
+      const CpuScopesBuffer* pSourceEventBuffer = s_AllCpuScopes[i];
       CPUScopesBufferFlat targetEventBuffer;
 
-      targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
+      targetEventBuffer.m_uiThreadId = pSourceEventBuffer->m_uiThreadId;
+      targetEventBuffer.m_Data.Reserve(pSourceEventBuffer->m_Data.GetCount());
+      pSourceEventBuffer->CopyEvents(0, targetEventBuffer.m_Data);
 
-      ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
-      targetEventBuffer.m_Data.Reserve(uiSourceCount);
-      for (ezUInt32 j = 0; j < uiSourceCount; ++j)
-      {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
-
-        CPUScope copiedEvent;
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+      profilingData.m_AllEventBuffers.PushBack(std::move(targetEventBuffer));
+    }
+  }
 
-        targetEventBuffer.m_Data.PushBack(std::move(copiedEvent));
-      }
+  {
+    EZ_LOCK(s_ScopeNamesMutex);
 
-      profilingData.m_AllEventBuffers.PushBack(std::move(targetEventBuffer));
+    profilingData.m_ScopeNames.Reserve(s_ScopeNames.GetCount());
+    for (const ScopeName& name : s_ScopeNames)
+    {
+      profilingData.m_ScopeNames.PushBack(name);
     }
   }
 
-  profilingData.m_uiFrameCount = s_uiFrameCount;
+  profilingData.m_uiBaseTicks = s_uiBaseTicks;
+  profilingData.m_BaseTime = s_BaseTime;
+  profilingData.m_fTicksPerSecond = MeasureTicksPerSecond();
+
+  {
+    EZ_LOCK(s_FrameStartTimesMutex);
+
+    profilingData.m_uiFrameCount = s_uiFrameCount;
+
+    profilingData.m_FrameStartTimes.Reserve(s_FrameStartTimes.GetCount());
+    for (ezUInt32 i = 0; i < s_FrameStartTimes.GetCount(); ++i)
+    {
+      profilingData.m_FrameStartTimes.PushBack(s_FrameStartTimes[i]);
+    }
+  }
 
-  profilingData.m_FrameStartTimes.Reserve(profilingData.m_FrameStartTimes.GetCount());
-  for (ezUInt32 i = 0; i < s_FrameStartTimes.GetCount(); ++i)
   {
-    profilingData.m_FrameStartTimes.PushBack(s_FrameStartTimes[i]);
+    EZ_LOCK(s_FlowEventsMutex);
+
+    profilingData.m_FlowEvents.Reserve(s_FlowEvents.GetCount());
+    for (ezUInt32 i = 0; i < s_FlowEvents.GetCount(); ++i)
+    {
+      profilingData.m_FlowEvents.PushBack(s_FlowEvents[i]);
+    }
   }
 
+  EZ_LOCK(s_GPUScopesMutex);
   if (s_GPUScopes != nullptr)
   {
     profilingData.m_GPUScopes.Reserve(s_GPUScopes->GetCount());
@@ -459,35 +625,65 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold)
 // static
 void ezProfilingSystem::StartNewFrame()
 {
-  ++s_uiFrameCount;
+  const ezTime now = ezTime::Now();
+  ezTime lastFrameStart;
 
-  if (!s_FrameStartTimes.CanAppend())
   {
-    s_FrameStartTimes.PopFront();
+    EZ_LOCK(s_FrameStartTimesMutex);
+
+    ++s_uiFrameCount;
+
+    if (!s_FrameStartTimes.IsEmpty())
+    {
+      lastFrameStart = s_FrameStartTimes.PeekBack();
+    }
+
+    if (!s_FrameStartTimes.CanAppend())
+    {
+      s_FrameStartTimes.PopFront();
+    }
+
+    s_FrameStartTimes.PushBack(now);
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  if (s_StreamHitchThreshold.IsPositive() && lastFrameStart.IsPositive() && now - lastFrameStart > s_StreamHitchThreshold)
+  {
+    TriggerStreamFlush();
+  }
 }
 
 // static
 void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime)
 {
+  AddCPUScopeTicks(szName, szFunctionName, TimeToTicks(beginTime), TimeToTicks(endTime));
+}
+
+// static
+void ezProfilingSystem::AddCPUScopeTicks(const char* szName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks)
+{
+  const ezUInt64 uiDurationTicks = uiEndTicks > uiBeginTicks ? uiEndTicks - uiBeginTicks : 0;
+
+  // discard? checked before the name is registered, most scopes end here
+  if (uiDurationTicks < CVarDiscardThresholdMs * 0.001 * s_fTicksPerSecond)
+    return;
+
+  AddCPUScopeTicks(RegisterScopeName(szName, szFunctionName), uiBeginTicks, uiEndTicks);
+}
+
+// static
+void ezProfilingSystem::AddCPUScopeTicks(ezUInt32 uiNameId, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks)
+{
+  const ezUInt64 uiDurationTicks = uiEndTicks > uiBeginTicks ? uiEndTicks - uiBeginTicks : 0;
+
   // discard?
-  if (endTime - beginTime < ezTime::Milliseconds(CVarDiscardThresholdMs))
+  if (uiDurationTicks < CVarDiscardThresholdMs * 0.001 * s_fTicksPerSecond)
     return;
 
-  ::CpuScopesBufferBase* pScopes = s_CpuScopes;
+  ::CpuScopesBuffer* pScopes = s_CpuScopes;
 
   if (pScopes == nullptr)
   {
-    if (ezThreadUtils::IsMainThread())
-    {
-      pScopes = EZ_DEFAULT_NEW(::CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>);
-    }
-    else
-    {
-      pScopes = EZ_DEFAULT_NEW(::CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>);
-    }
+    pScopes = EZ_DEFAULT_NEW(::CpuScopesBuffer, ezThreadUtils::IsMainThread() ? BUFFER_SIZE_MAIN_THREAD : BUFFER_SIZE_OTHER_THREAD);
 
     pScopes->m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
     s_CpuScopes = pScopes;
@@ -499,31 +695,122 @@ void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionNa
   }
 
   CPUScope scope;
-  scope.m_szFunctionName = szFunctionName;
-  scope.m_BeginTime = beginTime;
-  scope.m_EndTime = endTime;
-  ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), szName);
+  scope.m_uiBeginTicks = uiBeginTicks;
+  scope.m_uiDurationAndNameId = ezMath::Min(uiDurationTicks, CPUScope::MAX_DURATION_TICKS) | (static_cast<ezUInt64>(uiNameId) << CPUScope::DURATION_BITS);
+
+  pScopes->PushBack(scope);
+}
+
+// static
+ezUInt64 ezProfilingSystem::GetTicks()
+{
+#  if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
+  return __rdtsc();
+#  else
+  return static_cast<ezUInt64>(ezTime::Now().GetNanoseconds());
+#  endif
+}
+
+// static
+double ezProfilingSystem::GetTicksPerSecond()
+{
+  return MeasureTicksPerSecond();
+}
+
+// static
+ezUInt64 ezProfilingSystem::CreateFlowId()
+{
+  return static_cast<ezUInt64>(s_iNextFlowId.Increment());
+}
+
+// static
+void ezProfilingSystem::AddFlowEvent(ezUInt64 uiFlowId, bool bStart)
+{
+  FlowEvent e;
+  e.m_uiTicks = GetTicks();
+  e.m_uiThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
+  e.m_uiFlowId = uiFlowId;
+  e.m_bStart = bStart;
 
-  if (ezThreadUtils::IsMainThread())
+  EZ_LOCK(s_FlowEventsMutex);
+
+  ++s_uiFlowEventCount;
+
+  if (!s_FlowEvents.CanAppend())
   {
-    auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
-    if (!pMainThreadBuffer->m_Data.CanAppend())
-    {
-      pMainThreadBuffer->m_Data.PopFront();
-    }
+    s_FlowEvents.PopFront();
+  }
+
+  s_FlowEvents.PushBack(e);
+}
+
+// static
+ezUInt32 ezProfilingSystem::RegisterScopeName(const char* szName, const char* szFunctionName)
+{
+  if (szName == nullptr)
+    szName = "";
+  if (szFunctionName == nullptr)
+    szFunctionName = "";
+
+  const ezUInt32 uiNameLength = ezStringUtils::GetStringElementCount(szName);
+  const ezUInt32 uiFunctionNameLength = ezStringUtils::GetStringElementCount(szFunctionName);
+  const ezUInt64 uiHash = ezHashingUtils::xxHash64(szName, uiNameLength, ezHashingUtils::xxHash64(szFunctionName, uiFunctionNameLength));
+
+  // the cache only looks at the content, so names that are built on the fly hit it just like static strings.
+  // Two different names with the same 64 bit hash would share an ID here, which is unlikely enough to be ignored.
+  ScopeNameCacheEntry& cached = s_ScopeNameCache[uiHash % SCOPE_NAME_CACHE_SIZE];
 
-    pMainThreadBuffer->m_Data.PushBack(scope);
+  if (cached.m_uiHash == uiHash && cached.m_uiNameId != ezInvalidIndex)
+  {
+    return cached.m_uiNameId;
   }
-  else
+
+  ezUInt64 uiKey = uiHash;
+
+  EZ_LOCK(s_ScopeNamesMutex);
+
+  ezUInt32 uiNameId = 0;
+  while (true)
   {
-    auto pOtherThreadBuffer = CastToOtherThreadEventBuffer(pScopes);
-    if (!pOtherThreadBuffer->m_Data.CanAppend())
+    if (!s_ScopeNameIds.TryGetValue(uiKey, uiNameId))
     {
-      pOtherThreadBuffer->m_Data.PopFront();
+      if (s_ScopeNames.GetCount() < CPUScope::MAX_NAME_ID)
+      {
+        uiNameId = s_ScopeNames.GetCount();
+
+        ScopeName& name = s_ScopeNames.ExpandAndGetRef();
+        name.m_sName = szName;
+        name.m_sFunctionName = szFunctionName;
+      }
+      else
+      {
+        // all further names share the last ID
+        uiNameId = CPUScope::MAX_NAME_ID;
+
+        if (s_ScopeNames.GetCount() == CPUScope::MAX_NAME_ID)
+        {
+          s_ScopeNames.ExpandAndGetRef().m_sName = "<Too many scope names>";
+        }
+
+        break;
+      }
+
+      s_ScopeNameIds.Insert(uiKey, uiNameId);
+      break;
     }
 
-    pOtherThreadBuffer->m_Data.PushBack(scope);
+    const ScopeName& name = s_ScopeNames[uiNameId];
+    if (name.m_sName == szName && name.m_sFunctionName == szFunctionName)
+      break;
+
+    // hash collision, probe the next key
+    ++uiKey;
   }
+
+  cached.m_uiHash = uiHash;
+  cached.m_uiNameId = uiNameId;
+
+  return uiNameId;
 }
 
 // static
@@ -531,9 +818,7 @@ void ezProfilingSystem::Initialize()
 {
   SetThreadName("Main Thread");
 
-  s_MainThreadId = (ezUInt64)ezThreadUtils::GetCurrentThreadID();
-
-  s_PluginEventSubscription = ezPlugin::s_PluginEvents.AddEventHandler(&PluginEvent);
+  CalibrateTicks();
 }
 
 // static
@@ -557,7 +842,7 @@ void ezProfilingSystem::Reset()
     }
     for (ezUInt32 k = 0; k < s_AllCpuScopes.GetCount(); k++)
     {
-      CpuScopesBufferBase* pEventBuffer = s_AllCpuScopes[k];
+      CpuScopesBuffer* pEventBuffer = s_AllCpuScopes[k];
       if (pEventBuffer->m_uiThreadId == uiThreadId)
       {
         EZ_DEFAULT_DELETE(pEventBuffer);
@@ -567,8 +852,6 @@ void ezProfilingSystem::Reset()
     }
   }
   s_DeadThreadIDs.Clear();
-
-  ezPlugin::s_PluginEvents.RemoveEventHandler(s_PluginEventSubscription);
 }
 
 // static
@@ -592,6 +875,8 @@ void ezProfilingSystem::RemoveThread()
 // static
 void ezProfilingSystem::InitializeGPUData()
 {
+  EZ_LOCK(s_GPUScopesMutex);
+
   if (s_GPUScopes == nullptr)
   {
     s_GPUScopes = EZ_DEFAULT_NEW(GPUScopesBuffer);
@@ -604,6 +889,10 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
   if (endTime - beginTime < ezTime::Milliseconds(CVarDiscardThresholdMs))
     return;
 
+  EZ_LOCK(s_GPUScopesMutex);
+
+  ++s_uiGPUScopeCount;
+
   if (!s_GPUScopes->CanAppend())
   {
     s_GPUScopes->PopFront();
@@ -619,16 +908,676 @@ void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime
 
 //////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  constexpr ezUInt32 PROFILING_STREAM_MAGIC = 0x53504D45; // 'EMPS'
+  constexpr ezUInt8 PROFILING_STREAM_VERSION = 1;
+
+  /// The stream is a sequence of blocks, each one starts with this type.
+  enum class ProfilingStreamBlock : ezUInt8
+  {
+    End,
+    Calibration,
+    Threads,
+    ScopeNames,
+    CPUScopes,
+    Frames,
+    GPUScopes,
+    FlowEvents,
+  };
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+  /// Drains the per-thread buffers into a window in memory and writes that window to the file, either continuously or when a flush was triggered.
+  class ProfilingStreamThread : public ezThread
+  {
+  public:
+    ProfilingStreamThread()
+      : ezThread("Profiling Stream")
+    {
+    }
+
+    ezProfilingSystem::StreamingSettings m_Settings;
+    ezFileWriter m_File;
+    ezCompressedStreamWriterZstd m_Compressor;
+
+    volatile bool m_bKeepRunning = true;
+    ezThreadSignal m_WakeUp;
+
+    ezUInt64 m_uiStreamedFrameCount = 0;
+    ezUInt64 m_uiStreamedGPUScopeCount = 0;
+    ezUInt64 m_uiStreamedFlowEventCount = 0;
+
+  private:
+    struct ThreadWindow
+    {
+      ezUInt64 m_uiThreadId = 0;
+      ezDeque<ezProfilingSystem::CPUScope> m_Events;
+    };
+
+    virtual ezUInt32 Run() override
+    {
+      while (m_bKeepRunning)
+      {
+        m_WakeUp.WaitForSignal(m_Settings.m_DrainInterval);
+        Update(false);
+      }
+
+      Update(true);
+
+      m_Compressor << static_cast<ezUInt8>(ProfilingStreamBlock::End);
+      m_Compressor.FinishCompressedStream().IgnoreResult();
+      m_File.Close();
+
+      return 0;
+    }
+
+    void Update(bool bStopping)
+    {
+      Drain();
+
+      if (m_Settings.m_KeepDuration.IsZero())
+      {
+        WriteWindow();
+        return;
+      }
+
+      if (s_bStreamFlushRequested.Set(false) && !m_bFlushPending)
+      {
+        m_bFlushPending = true;
+        m_FlushTime = ezTime::Now() + m_Settings.m_FlushDelay;
+      }
+
+      if (m_bFlushPending && (bStopping || ezTime::Now() >= m_FlushTime))
+      {
+        m_bFlushPending = false;
+
+        WriteWindow();
+
+        // make sure the window ends up on disk, even if the process is killed later on
+        m_Compressor.Flush().IgnoreResult();
+        m_File.Flush().IgnoreResult();
+      }
+      else if (!m_bFlushPending)
+      {
+        // while a flush is pending, the window grows, so that it covers the time around the trigger
+        Prune();
+      }
+    }
+
+    void Drain()
+    {
+      {
+        EZ_LOCK(s_AllCpuScopesMutex);
+
+        for (CpuScopesBuffer* pEventBuffer : s_AllCpuScopes)
+        {
+          ThreadWindow* pWindow = nullptr;
+          for (ThreadWindow& window : m_CpuWindow)
+          {
+            if (window.m_uiThreadId == pEventBuffer->m_uiThreadId)
+            {
+              pWindow = &window;
+              break;
+            }
+          }
+
+          if (pWindow == nullptr)
+          {
+            pWindow = &m_CpuWindow.ExpandAndGetRef();
+            pWindow->m_uiThreadId = pEventBuffer->m_uiThreadId;
+          }
+
+          m_TempEvents.Clear();
+          pEventBuffer->m_uiStreamedCount = pEventBuffer->CopyEvents(pEventBuffer->m_uiStreamedCount, m_TempEvents);
+
+          for (const ezProfilingSystem::CPUScope& e : m_TempEvents)
+          {
+            pWindow->m_Events.PushBack(e);
+          }
+        }
+      }
+
+      {
+        EZ_LOCK(s_FrameStartTimesMutex);
+
+        if (m_FrameWindow.IsEmpty())
+        {
+          m_uiFirstWindowFrame = m_uiStreamedFrameCount + 1;
+        }
+
+        // frames that were already overwritten are stored as zero, so that the frame numbers stay correct
+        const ezUInt64 uiNumNewFrames = s_uiFrameCount - m_uiStreamedFrameCount;
+        const ezUInt32 uiNumAvailable = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiNumNewFrames, s_FrameStartTimes.GetCount()));
+
+        for (ezUInt64 i = uiNumAvailable; i < uiNumNewFrames; ++i)
+        {
+          m_FrameWindow.PushBack(ezTime::Zero());
+        }
+
+        for (ezUInt32 i = s_FrameStartTimes.GetCount() - uiNumAvailable; i < s_FrameStartTimes.GetCount(); ++i)
+        {
+          m_FrameWindow.PushBack(s_FrameStartTimes[i]);
+        }
+
+        m_uiStreamedFrameCount = s_uiFrameCount;
+      }
+
+      {
+        EZ_LOCK(s_GPUScopesMutex);
+
+        if (s_GPUScopes != nullptr)
+        {
+          const ezUInt32 uiNumAvailable = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(s_uiGPUScopeCount - m_uiStreamedGPUScopeCount, s_GPUScopes->GetCount()));
+
+          for (ezUInt32 i = s_GPUScopes->GetCount() - uiNumAvailable; i < s_GPUScopes->GetCount(); ++i)
+          {
+            m_GpuWindow.PushBack((*s_GPUScopes)[i]);
+          }
+        }
+
+        m_uiStreamedGPUScopeCount = s_uiGPUScopeCount;
+      }
+
+      {
+        EZ_LOCK(s_FlowEventsMutex);
+
+        const ezUInt32 uiNumAvailable = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(s_uiFlowEventCount - m_uiStreamedFlowEventCount, s_FlowEvents.GetCount()));
+
+        for (ezUInt32 i = s_FlowEvents.GetCount() - uiNumAvailable; i < s_FlowEvents.GetCount(); ++i)
+        {
+          m_FlowWindow.PushBack(s_FlowEvents[i]);
+        }
+
+        m_uiStreamedFlowEventCount = s_uiFlowEventCount;
+      }
+    }
+
+    void Prune()
+    {
+      const ezTime cutoff = ezTime::Now() - m_Settings.m_KeepDuration;
+      const ezUInt64 uiCutoffTicks = TimeToTicks(cutoff);
+
+      for (ThreadWindow& window : m_CpuWindow)
+      {
+        while (!window.m_Events.IsEmpty() && window.m_Events.PeekFront().GetEndTicks() < uiCutoffTicks)
+        {
+          window.m_Events.PopFront();
+        }
+      }
+
+      // a frame is removed once the next frame started before the cutoff
+      while (m_FrameWindow.GetCount() > 1 && m_FrameWindow[1] < cutoff)
+      {
+        m_FrameWindow.PopFront();
+        ++m_uiFirstWindowFrame;
+      }
+
+      while (!m_GpuWindow.IsEmpty() && m_GpuWindow.PeekFront().m_EndTime < cutoff)
+      {
+        m_GpuWindow.PopFront();
+      }
+
+      while (!m_FlowWindow.IsEmpty() && m_FlowWindow.PeekFront().m_uiTicks < uiCutoffTicks)
+      {
+        m_FlowWindow.PopFront();
+      }
+    }
+
+    void WriteWindow()
+    {
+      ezStreamWriter& stream = m_Compressor;
+
+      stream << static_cast<ezUInt8>(ProfilingStreamBlock::Calibration);
+      stream << s_uiBaseTicks;
+      stream << s_BaseTime;
+      stream << MeasureTicksPerSecond();
+
+      {
+        ezHybridArray<ezProfilingSystem::ThreadInfo, 16> threadInfos;
+        {
+          EZ_LOCK(s_ThreadInfosMutex);
+          threadInfos = s_ThreadInfos;
+        }
+
+        stream << static_cast<ezUInt8>(ProfilingStreamBlock::Threads);
+        stream << threadInfos.GetCount();
+        for (const ezProfilingSystem::ThreadInfo& info : threadInfos)
+        {
+          stream << info.m_uiThreadId;
+          stream << info.m_sName;
+        }
+      }
+
+      // names are registered before the scopes that use them are added, so all names of the written scopes are known at this point
+      {
+        ezDynamicArray<ezProfilingSystem::ScopeName> newNames;
+        {
+          EZ_LOCK(s_ScopeNamesMutex);
+          for (ezUInt32 i = m_uiWrittenScopeNames; i < s_ScopeNames.GetCount(); ++i)
+          {
+            newNames.PushBack(s_ScopeNames[i]);
+          }
+        }
+
+        if (!newNames.IsEmpty())
+        {
+          stream << static_cast<ezUInt8>(ProfilingStreamBlock::ScopeNames);
+          stream << m_uiWrittenScopeNames;
+          stream << newNames.GetCount();
+          for (const ezProfilingSystem::ScopeName& name : newNames)
+          {
+            stream << name.m_sName;
+            stream << name.m_sFunctionName;
+          }
+
+          m_uiWrittenScopeNames += newNames.GetCount();
+        }
+      }
+
+      for (ThreadWindow& window : m_CpuWindow)
+      {
+        if (window.m_Events.IsEmpty())
+          continue;
+
+        stream << static_cast<ezUInt8>(ProfilingStreamBlock::CPUScopes);
+        stream << window.m_uiThreadId;
+        stream << window.m_Events.GetCount();
+        for (const ezProfilingSystem::CPUScope& e : window.m_Events)
+        {
+          stream << e.m_uiBeginTicks;
+          stream << e.m_uiDurationAndNameId;
+        }
+
+        window.m_Events.Clear();
+      }
+
+      if (!m_FrameWindow.IsEmpty())
+      {
+        stream << static_cast<ezUInt8>(ProfilingStreamBlock::Frames);
+        stream << m_uiFirstWindowFrame;
+        stream << m_FrameWindow.GetCount();
+        for (ezTime frameStart : m_FrameWindow)
+        {
+          stream << frameStart;
+        }
+
+        m_FrameWindow.Clear();
+      }
+
+      if (!m_GpuWindow.IsEmpty())
+      {
+        stream << static_cast<ezUInt8>(ProfilingStreamBlock::GPUScopes);
+        stream << m_GpuWindow.GetCount();
+        for (const ezProfilingSystem::GPUScope& e : m_GpuWindow)
+        {
+          stream << e.m_BeginTime;
+          stream << e.m_EndTime;
+          stream.WriteString(e.m_szName).IgnoreResult();
+        }
+
+        m_GpuWindow.Clear();
+      }
+
+      if (!m_FlowWindow.IsEmpty())
+      {
+        stream << static_cast<ezUInt8>(ProfilingStreamBlock::FlowEvents);
+        stream << m_FlowWindow.GetCount();
+        for (const ezProfilingSystem::FlowEvent& e : m_FlowWindow)
+        {
+          stream << e.m_uiTicks;
+          stream << e.m_uiThreadId;
+          stream << e.m_uiFlowId;
+          stream << e.m_bStart;
+        }
+
+        m_FlowWindow.Clear();
+      }
+    }
+
+    ezHybridArray<ThreadWindow, 16> m_CpuWindow;
+    ezDynamicArray<ezProfilingSystem::CPUScope> m_TempEvents;
+    ezDeque<ezTime> m_FrameWindow;
+    ezUInt64 m_uiFirstWindowFrame = 1;
+    ezDeque<ezProfilingSystem::GPUScope> m_GpuWindow;
+    ezDeque<ezProfilingSystem::FlowEvent> m_FlowWindow;
+    ezUInt32 m_uiWrittenScopeNames = 0;
+
+    bool m_bFlushPending = false;
+    ezTime m_FlushTime;
+  };
+
+  static ProfilingStreamThread* s_pStreamThread = nullptr;
+
+#  endif
+} // namespace
+
+// static
+ezResult ezProfilingSystem::StartStreaming(const StreamingSettings& settings)
+{
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (s_pStreamThread != nullptr)
+  {
+    ezLog::Error("Profiling data is already being streamed to '{}'", s_pStreamThread->m_Settings.m_sOutputFile);
+    return EZ_FAILURE;
+  }
+
+  ProfilingStreamThread* pThread = EZ_DEFAULT_NEW(ProfilingStreamThread);
+
+  if (pThread->m_File.Open(settings.m_sOutputFile).Failed())
+  {
+    ezLog::Error("Failed to open '{}' for streaming profiling data", settings.m_sOutputFile);
+    EZ_DEFAULT_DELETE(pThread);
+    return EZ_FAILURE;
+  }
+
+  pThread->m_Settings = settings;
+  pThread->m_Compressor.SetOutputStream(&pThread->m_File);
+
+  pThread->m_Compressor << PROFILING_STREAM_MAGIC;
+  pThread->m_Compressor << PROFILING_STREAM_VERSION;
+#    if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+  pThread->m_Compressor << static_cast<ezUInt32>(ezProcess::GetCurrentProcessID());
+#    else
+  pThread->m_Compressor << static_cast<ezUInt32>(0);
+#    endif
+
+  // only what is recorded from now on is streamed
+  {
+    EZ_LOCK(s_AllCpuScopesMutex);
+    for (CpuScopesBuffer* pEventBuffer : s_AllCpuScopes)
+    {
+      pEventBuffer->m_uiStreamedCount = static_cast<ezUInt64>(pEventBuffer->m_iWriteCount);
+    }
+  }
+
+  {
+    EZ_LOCK(s_FrameStartTimesMutex);
+    pThread->m_uiStreamedFrameCount = s_uiFrameCount;
+  }
+
+  {
+    EZ_LOCK(s_GPUScopesMutex);
+    pThread->m_uiStreamedGPUScopeCount = s_uiGPUScopeCount;
+  }
+
+  {
+    EZ_LOCK(s_FlowEventsMutex);
+    pThread->m_uiStreamedFlowEventCount = s_uiFlowEventCount;
+  }
+
+  s_bStreamFlushRequested = false;
+  s_StreamHitchThreshold = settings.m_KeepDuration.IsPositive() ? settings.m_HitchThreshold : ezTime::Zero();
+
+  s_pStreamThread = pThread;
+  s_pStreamThread->Start();
+
+  return EZ_SUCCESS;
+#  else
+  ezLog::Error("Streaming profiling data requires zstd support");
+  return EZ_FAILURE;
+#  endif
+}
+
+// static
+void ezProfilingSystem::StopStreaming()
+{
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (s_pStreamThread == nullptr)
+    return;
+
+  s_StreamHitchThreshold = ezTime::Zero();
+
+  s_pStreamThread->m_bKeepRunning = false;
+  s_pStreamThread->m_WakeUp.RaiseSignal();
+  s_pStreamThread->Join();
+
+  EZ_DEFAULT_DELETE(s_pStreamThread);
+#  endif
+}
+
+// static
+bool ezProfilingSystem::IsStreaming()
+{
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  return s_pStreamThread != nullptr;
+#  else
+  return false;
+#  endif
+}
+
+// static
+void ezProfilingSystem::TriggerStreamFlush()
+{
+  s_bStreamFlushRequested = true;
+}
+
+// static
+ezResult ezProfilingSystem::ReadStream(ezStreamReader& inputStream, ProfilingData& out_profilingData)
+{
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  ezCompressedStreamReaderZstd stream(&inputStream);
+
+  ezUInt32 uiMagic = 0;
+  ezUInt8 uiVersion = 0;
+  stream >> uiMagic;
+  stream >> uiVersion;
+
+  if (uiMagic != PROFILING_STREAM_MAGIC || uiVersion != PROFILING_STREAM_VERSION)
+  {
+    ezLog::Error("Not a profiling stream or unsupported version {}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  out_profilingData = ProfilingData();
+  out_profilingData.m_uiFramesThreadID = 1;
+  out_profilingData.m_uiGPUThreadID = 0;
+  out_profilingData.m_uiFrameCount = 0;
+
+  ezUInt32 uiProcessID = 0;
+  stream >> uiProcessID;
+  out_profilingData.m_uiProcessID = static_cast<ezOsProcessID>(uiProcessID);
+
+  ezStringBuilder sTemp;
+
+  // a truncated stream, e.g. from a crashed process, is loaded as far as possible
+  ezUInt8 uiBlock = 0;
+  while (stream.ReadBytes(&uiBlock, sizeof(uiBlock)) == sizeof(uiBlock))
+  {
+    switch (static_cast<ProfilingStreamBlock>(uiBlock))
+    {
+      case ProfilingStreamBlock::End:
+        return EZ_SUCCESS;
+
+      case ProfilingStreamBlock::Calibration:
+      {
+        stream >> out_profilingData.m_uiBaseTicks;
+        stream >> out_profilingData.m_BaseTime;
+        stream >> out_profilingData.m_fTicksPerSecond;
+      }
+      break;
+
+      case ProfilingStreamBlock::Threads:
+      {
+        ezUInt32 uiCount = 0;
+        stream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ThreadInfo info;
+          stream >> info.m_uiThreadId;
+          stream >> info.m_sName;
+
+          bool bKnown = false;
+          for (ThreadInfo& existing : out_profilingData.m_ThreadInfos)
+          {
+            if (existing.m_uiThreadId == info.m_uiThreadId)
+            {
+              existing.m_sName = info.m_sName;
+              bKnown = true;
+            }
+          }
+
+          if (!bKnown)
+          {
+            out_profilingData.m_ThreadInfos.PushBack(info);
+          }
+        }
+      }
+      break;
+
+      case ProfilingStreamBlock::ScopeNames:
+      {
+        ezUInt32 uiFirstId = 0;
+        ezUInt32 uiCount = 0;
+        stream >> uiFirstId;
+        stream >> uiCount;
+
+        if (uiFirstId != out_profilingData.m_ScopeNames.GetCount())
+        {
+          ezLog::Error("Profiling stream is corrupted, scope names are missing");
+          return EZ_FAILURE;
+        }
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ScopeName& name = out_profilingData.m_ScopeNames.ExpandAndGetRef();
+          stream >> name.m_sName;
+          stream >> name.m_sFunctionName;
+        }
+      }
+      break;
+
+      case ProfilingStreamBlock::CPUScopes:
+      {
+        ezUInt64 uiThreadId = 0;
+        ezUInt32 uiCount = 0;
+        stream >> uiThreadId;
+        stream >> uiCount;
+
+        CPUScopesBufferFlat* pEventBuffer = nullptr;
+        for (CPUScopesBufferFlat& eventBuffer : out_profilingData.m_AllEventBuffers)
+        {
+          if (eventBuffer.m_uiThreadId == uiThreadId)
+          {
+            pEventBuffer = &eventBuffer;
+            break;
+          }
+        }
+
+        if (pEventBuffer == nullptr)
+        {
+          pEventBuffer = &out_profilingData.m_AllEventBuffers.ExpandAndGetRef();
+          pEventBuffer->m_uiThreadId = uiThreadId;
+        }
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          CPUScope& e = pEventBuffer->m_Data.ExpandAndGetRef();
+          stream >> e.m_uiBeginTicks;
+          stream >> e.m_uiDurationAndNameId;
+
+          if (e.GetNameId() >= out_profilingData.m_ScopeNames.GetCount())
+          {
+            ezLog::Error("Profiling stream is corrupted, scope name {} is unknown", e.GetNameId());
+            return EZ_FAILURE;
+          }
+        }
+      }
+      break;
+
+      case ProfilingStreamBlock::Frames:
+      {
+        ezUInt64 uiFirstFrame = 0;
+        ezUInt32 uiCount = 0;
+        stream >> uiFirstFrame;
+        stream >> uiCount;
+
+        auto& frames = out_profilingData.m_FrameStartTimes;
+
+        if (frames.IsEmpty())
+        {
+          out_profilingData.m_uiFrameCount = uiFirstFrame - 1;
+        }
+
+        // frames between the written windows are filled with zero, those are skipped by Write()
+        while (out_profilingData.m_uiFrameCount + 1 < uiFirstFrame)
+        {
+          frames.PushBack(ezTime::Zero());
+          ++out_profilingData.m_uiFrameCount;
+        }
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          ezTime frameStart;
+          stream >> frameStart;
+
+          if (uiFirstFrame + i > out_profilingData.m_uiFrameCount)
+          {
+            frames.PushBack(frameStart);
+            ++out_profilingData.m_uiFrameCount;
+          }
+        }
+      }
+      break;
+
+      case ProfilingStreamBlock::GPUScopes:
+      {
+        ezUInt32 uiCount = 0;
+        stream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          GPUScope& e = out_profilingData.m_GPUScopes.ExpandAndGetRef();
+          stream >> e.m_BeginTime;
+          stream >> e.m_EndTime;
+          stream.ReadString(sTemp).IgnoreResult();
+          ezStringUtils::Copy(e.m_szName, GPUScope::NAME_SIZE, sTemp);
+        }
+      }
+      break;
+
+      case ProfilingStreamBlock::FlowEvents:
+      {
+        ezUInt32 uiCount = 0;
+        stream >> uiCount;
+
+        for (ezUInt32 i = 0; i < uiCount; ++i)
+        {
+          FlowEvent& e = out_profilingData.m_FlowEvents.ExpandAndGetRef();
+          stream >> e.m_uiTicks;
+          stream >> e.m_uiThreadId;
+          stream >> e.m_uiFlowId;
+          stream >> e.m_bStart;
+        }
+      }
+      break;
+
+      default:
+        ezLog::Error("Profiling stream is corrupted, unknown block type {}", uiBlock);
+        return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+#  else
+  ezLog::Error("Reading profiling streams requires zstd support");
+  return EZ_FAILURE;
+#  endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 ezProfilingScope::ezProfilingScope(const char* szName, const char* szFunctionName)
   : m_szName(szName)
   , m_szFunction(szFunctionName)
-  , m_BeginTime(ezTime::Now())
+  , m_uiBeginTicks(ezProfilingSystem::GetTicks())
 {
 }
 
 ezProfilingScope::~ezProfilingScope()
 {
-  ezProfilingSystem::AddCPUScope(m_szName, m_szFunction, m_BeginTime, ezTime::Now());
+  ezProfilingSystem::AddCPUScopeTicks(m_szName, m_szFunction, m_uiBeginTicks, ezProfilingSystem::GetTicks());
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -638,9 +1587,9 @@ thread_local ezProfilingListScope* ezProfilingListScope::s_pCurrentList = nullpt
 ezProfilingListScope::ezProfilingListScope(const char* szListName, const char* szFirstSectionName, const char* szFunctionName)
   : m_szListName(szListName)
   , m_szListFunction(szFunctionName)
-  , m_ListBeginTime(ezTime::Now())
+  , m_uiListBeginTicks(ezProfilingSystem::GetTicks())
   , m_szCurSectionName(szFirstSectionName)
-  , m_CurSectionBeginTime(m_ListBeginTime)
+  , m_uiCurSectionBeginTicks(m_uiListBeginTicks)
 {
   m_pPreviousList = s_pCurrentList;
   s_pCurrentList = this;
@@ -648,9 +1597,9 @@ ezProfilingListScope::ezProfilingListScope(const char* szListName, const char* s
 
 ezProfilingListScope::~ezProfilingListScope()
 {
-  ezTime now = ezTime::Now();
-  ezProfilingSystem::AddCPUScope(m_szCurSectionName, nullptr, m_CurSectionBeginTime, now);
-  ezProfilingSystem::AddCPUScope(m_szListName, m_szListFunction, m_ListBeginTime, now);
+  const ezUInt64 uiNow = ezProfilingSystem::GetTicks();
+  ezProfilingSystem::AddCPUScopeTicks(m_szCurSectionName, nullptr, m_uiCurSectionBeginTicks, uiNow);
+  ezProfilingSystem::AddCPUScopeTicks(m_szListName, m_szListFunction, m_uiListBeginTicks, uiNow);
 
   s_pCurrentList = m_pPreviousList;
 }
@@ -660,15 +1609,20 @@ void ezProfilingListScope::StartNextSection(const char* szNextSectionName)
 {
   ezProfilingListScope* pCurScope = s_pCurrentList;
 
-  ezTime now = ezTime::Now();
-  ezProfilingSystem::AddCPUScope(pCurScope->m_szCurSectionName, nullptr, pCurScope->m_CurSectionBeginTime, now);
+  const ezUInt64 uiNow = ezProfilingSystem::GetTicks();
+  ezProfilingSystem::AddCPUScopeTicks(pCurScope->m_szCurSectionName, nullptr, pCurScope->m_uiCurSectionBeginTicks, uiNow);
 
   pCurScope->m_szCurSectionName = szNextSectionName;
-  pCurScope->m_CurSectionBeginTime = now;
+  pCurScope->m_uiCurSectionBeginTicks = uiNow;
 }
 
 #else
 
+ezTime ezProfilingSystem::ProfilingData::TicksToTime(ezUInt64 uiTicks) const
+{
+  return ezTime::Zero();
+}
+
 ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& outputStream) const
 {
   return EZ_FAILURE;
@@ -687,6 +1641,33 @@ void ezProfilingSystem::StartNewFrame() {}
 
 void ezProfilingSystem::AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime) {}
 
+void ezProfilingSystem::AddCPUScopeTicks(const char* szName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks) {}
+
+void ezProfilingSystem::AddCPUScopeTicks(ezUInt32 uiNameId, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks) {}
+
+ezUInt64 ezProfilingSystem::GetTicks()
+{
+  // still used for the task system statistics
+  return static_cast<ezUInt64>(ezTime::Now().GetNanoseconds());
+}
+
+double ezProfilingSystem::GetTicksPerSecond()
+{
+  return 1000000000.0;
+}
+
+ezUInt64 ezProfilingSystem::CreateFlowId()
+{
+  return 0;
+}
+
+void ezProfilingSystem::AddFlowEvent(ezUInt64 uiFlowId, bool bStart) {}
+
+ezUInt32 ezProfilingSystem::RegisterScopeName(const char* szName, const char* szFunctionName)
+{
+  return 0;
+}
+
 void ezProfilingSystem::Initialize() {}
 
 void ezProfilingSystem::Reset() {}
@@ -699,6 +1680,25 @@ void ezProfilingSystem::InitializeGPUData() {}
 
 void ezProfilingSystem::AddGPUScope(const char* szName, ezTime beginTime, ezTime endTime) {}
 
+ezResult ezProfilingSystem::StartStreaming(const StreamingSettings& settings)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopStreaming() {}
+
+bool ezProfilingSystem::IsStreaming()
+{
+  return false;
+}
+
+void ezProfilingSystem::TriggerStreamFlush() {}
+
+ezResult ezProfilingSystem::ReadStream(ezStreamReader& inputStream, ProfilingData& out_profilingData)
+{
+  return EZ_FAILURE;
+}
+
 #endif
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Profiling_Implementation_Profiling);
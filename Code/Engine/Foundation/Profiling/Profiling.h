@@ -6,6 +6,7 @@
 #include <Foundation/System/Process.h>
 #include <Foundation/Time/Time.h>
 
+class ezStreamReader;
 class ezStreamWriter;
 class ezThread;
 
@@ -22,7 +23,7 @@ public:
 protected:
   const char* m_szName;
   const char* m_szFunction;
-  ezTime m_BeginTime;
+  ezUInt64 m_uiBeginTicks;
 };
 
 /// \brief This class implements a profiling scope similar to ezProfilingScope, but with additional sub-scopes which can be added easily without introducing actual C++ scopes.
@@ -47,10 +48,10 @@ protected:
 
   const char* m_szListName;
   const char* m_szListFunction;
-  ezTime m_ListBeginTime;
+  ezUInt64 m_uiListBeginTicks;
 
   const char* m_szCurSectionName;
-  ezTime m_CurSectionBeginTime;
+  ezUInt64 m_uiCurSectionBeginTicks;
 };
 
 /// \brief Helper functionality of the profiling system.
@@ -63,16 +64,32 @@ public:
     ezString m_sName;
   };
 
+  /// \brief A finished CPU scope in the compact 16 byte encoding.
+  ///
+  /// The scope and function name are not stored in the event, but interned once through RegisterScopeName().
+  /// Timestamps are raw ticks of the cycle counter, see GetTicks(). They are only converted to ezTime when the data is written,
+  /// using the calibration that was measured at capture time.
   struct CPUScope
   {
     EZ_DECLARE_POD_TYPE();
 
-    static constexpr ezUInt32 NAME_SIZE = 40;
+    static constexpr ezUInt32 DURATION_BITS = 40;
+    static constexpr ezUInt64 MAX_DURATION_TICKS = (1ull << DURATION_BITS) - 1;
+    static constexpr ezUInt32 MAX_NAME_ID = (1u << (64 - DURATION_BITS)) - 1;
 
-    const char* m_szFunctionName;
-    ezTime m_BeginTime;
-    ezTime m_EndTime;
-    char m_szName[NAME_SIZE];
+    ezUInt64 m_uiBeginTicks;
+    ezUInt64 m_uiDurationAndNameId; ///< The lower 40 bits store the duration in ticks, the upper 24 bits the name ID.
+
+    ezUInt64 GetDurationTicks() const { return m_uiDurationAndNameId & MAX_DURATION_TICKS; }
+    ezUInt64 GetEndTicks() const { return m_uiBeginTicks + GetDurationTicks(); }
+    ezUInt32 GetNameId() const { return static_cast<ezUInt32>(m_uiDurationAndNameId >> DURATION_BITS); }
+  };
+
+  /// \brief The strings behind an interned scope name ID.
+  struct ScopeName
+  {
+    ezString m_sName;
+    ezString m_sFunctionName;
   };
 
   struct CPUScopesBufferFlat
@@ -93,6 +110,17 @@ public:
     char m_szName[NAME_SIZE];
   };
 
+  /// \brief One end of an arrow between two points in time, see AddFlowEvent().
+  struct FlowEvent
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiTicks;
+    ezUInt64 m_uiThreadId;
+    ezUInt64 m_uiFlowId;
+    bool m_bStart;
+  };
+
   struct EZ_FOUNDATION_DLL ProfilingData
   {
     ezUInt32 m_uiFramesThreadID = 0;
@@ -103,20 +131,82 @@ public:
 
     ezDynamicArray<CPUScopesBufferFlat> m_AllEventBuffers;
 
+    /// \brief All interned scope names, indexed by CPUScope::GetNameId().
+    ezDynamicArray<ScopeName> m_ScopeNames;
+
+    /// \brief Calibration of the CPU scope ticks, see TicksToTime().
+    ezUInt64 m_uiBaseTicks = 0;
+    ezTime m_BaseTime;
+    double m_fTicksPerSecond = 1.0;
+
     ezUInt64 m_uiFrameCount;
     ezDynamicArray<ezTime> m_FrameStartTimes;
 
     ezDynamicArray<GPUScope> m_GPUScopes;
 
+    ezDynamicArray<FlowEvent> m_FlowEvents;
+
+    /// \brief Converts a CPU scope timestamp into the same time base as ezTime::Now().
+    ezTime TicksToTime(ezUInt64 uiTicks) const;
+
     /// \brief Writes profiling data as JSON to the output stream.
+    ///
+    /// The compact CPU scopes are converted to the Chrome trace event format, flow events become flow arrows.
     ezResult Write(ezStreamWriter& outputStream) const;
   };
 
+  /// \brief Settings for StartStreaming().
+  struct StreamingSettings
+  {
+    /// \brief The file that the compressed trace is written to. This goes through ezFileSystem.
+    ezString m_sOutputFile;
+
+    /// \brief If zero, all profiling data is written to disk continuously.
+    ///
+    /// Otherwise only the data of the last m_KeepDuration is kept in memory and it is only written when TriggerStreamFlush() is called.
+    /// Each flush appends the window to the same file, so a single file can hold many windows.
+    ezTime m_KeepDuration;
+
+    /// \brief How long after TriggerStreamFlush() the window is written, so that it also contains what happened after the trigger.
+    ezTime m_FlushDelay = ezTime::Seconds(1);
+
+    /// \brief If positive, StartNewFrame() calls TriggerStreamFlush() whenever a frame took longer than this.
+    ezTime m_HitchThreshold;
+
+    /// \brief How often the per-thread buffers are drained. This must be short enough that the buffers don't overflow in between.
+    ezTime m_DrainInterval = ezTime::Milliseconds(100);
+  };
+
 public:
   static void Clear();
 
   static ProfilingData Capture();
 
+  /// \brief Starts a background thread that drains the profiling data into a zstd compressed file.
+  ///
+  /// Only the data that is recorded after this call is written. Use ReadStream() to load the file again.
+  /// Fails if streaming is already active, the file cannot be opened or zstd support is not compiled in.
+  static ezResult StartStreaming(const StreamingSettings& settings);
+
+  /// \brief Stops streaming and closes the file.
+  ///
+  /// In continuous mode all remaining data is written. In the keep mode, a pending flush is written immediately, everything else is discarded.
+  static void StopStreaming();
+
+  /// \brief Returns whether StartStreaming() was called without a matching StopStreaming().
+  static bool IsStreaming();
+
+  /// \brief In the keep mode of StartStreaming(), writes the profiling data that is kept in memory to the file after the flush delay.
+  ///
+  /// This is meant to be called by something like a hitch detector, to persist the data around a rare event.
+  /// Can be called from any thread. Triggers that happen while a flush is pending are merged into that flush.
+  static void TriggerStreamFlush();
+
+  /// \brief Loads a file that was written through StartStreaming() and converts it into a ProfilingData.
+  ///
+  /// The stream must be the file itself, the decompression is done internally.
+  static ezResult ReadStream(ezStreamReader& inputStream, ProfilingData& out_profilingData);
+
   /// \brief Scopes are discarded if their duration is shorter than the specified threshold. Default is 0.1ms.
   static void SetDiscardThreshold(ezTime threshold);
 
@@ -126,6 +216,37 @@ public:
   /// \brief Adds a new scoped event for the calling thread in the profiling system
   static void AddCPUScope(const char* szName, const char* szFunctionName, ezTime beginTime, ezTime endTime);
 
+  /// \brief Same as AddCPUScope() but takes the raw timestamps returned by GetTicks(). This is what the profiling scopes use.
+  static void AddCPUScopeTicks(const char* szName, const char* szFunctionName, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks);
+
+  /// \brief Same as AddCPUScopeTicks() but takes a name ID that was returned by RegisterScopeName(), for scopes that intern their name up front.
+  static void AddCPUScopeTicks(ezUInt32 uiNameId, ezUInt64 uiBeginTicks, ezUInt64 uiEndTicks);
+
+  /// \brief Returns the current value of the cycle counter that is used to timestamp CPU scopes.
+  ///
+  /// This is much cheaper to query than ezTime::Now(), but the tick rate is only known after calibration.
+  /// On platforms without a usable cycle counter and when profiling is disabled, this returns ezTime::Now() in nanoseconds.
+  static ezUInt64 GetTicks();
+
+  /// \brief Returns how many GetTicks() pass per second. This is calibrated over the entire time since startup.
+  static double GetTicksPerSecond();
+
+  /// \brief Returns a new, non-zero ID for AddFlowEvent(). Returns zero if profiling is disabled.
+  static ezUInt64 CreateFlowId();
+
+  /// \brief Adds the start or the end of a flow for the calling thread. A flow is shown as an arrow between two scopes in the trace.
+  ///
+  /// Both ends are attached to the scope that encloses them on their thread, so they should be added inside of a profiling scope.
+  /// This is used to visualize causality across threads, e.g. which finished task started the tasks that depended on it.
+  static void AddFlowEvent(ezUInt64 uiFlowId, bool bStart);
+
+  /// \brief Interns the given scope and function name and returns the ID under which they are stored in CPUScope.
+  ///
+  /// Registering the same strings again returns the same ID, the strings are copied and don't need to stay alive.
+  /// Each thread caches the IDs by a hash of the strings, so repeated names only pay for hashing them, not for the global lookup.
+  /// Since interned names are never released, scope names should not contain frequently changing data like frame numbers.
+  static ezUInt32 RegisterScopeName(const char* szName, const char* szFunctionName);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
@@ -126,3 +126,8 @@ EZ_ALWAYS_INLINE bool ezSimdVec4b::NoneSet() const
   return !AnySet<N>();
 }
 
+EZ_ALWAYS_INLINE ezUInt32 ezSimdVec4b::GetBitmask() const
+{
+  return (m_v.x ? 1 : 0) | (m_v.y ? 2 : 0) | (m_v.z ? 4 : 0) | (m_v.w ? 8 : 0);
+}
+
@@ -96,3 +96,8 @@ EZ_ALWAYS_INLINE bool ezSimdVec4b::NoneSet() const
   return (_mm_movemask_ps(m_v) & mask) == 0;
 }
 
+EZ_ALWAYS_INLINE ezUInt32 ezSimdVec4b::GetBitmask() const
+{
+  return static_cast<ezUInt32>(_mm_movemask_ps(m_v));
+}
+
@@ -13,6 +13,7 @@ static void ezCrashHandlerFunc() noexcept
 {
   if (ezCrashHandler::GetCrashHandler() != nullptr)
   {
+    ezGlobalLog::FlushAsyncQueueOnCrash();
     ezCrashHandler::GetCrashHandler()->HandleCrash(nullptr);
   }
 
@@ -51,6 +52,7 @@ static void ezSignalHandler(int signum)
 
   if (ezCrashHandler::GetCrashHandler() != nullptr)
   {
+    ezGlobalLog::FlushAsyncQueueOnCrash();
     ezCrashHandler::GetCrashHandler()->HandleCrash(nullptr);
   }
 
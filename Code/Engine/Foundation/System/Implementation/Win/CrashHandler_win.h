@@ -15,6 +15,7 @@ static LONG WINAPI ezCrashHandlerFunc(struct _EXCEPTION_POINTERS* pExceptionInfo
     if (ezCrashHandler::GetCrashHandler() != nullptr)
     {
       s_bAlreadyHandled = true;
+      ezGlobalLog::FlushAsyncQueueOnCrash();
       ezCrashHandler::GetCrashHandler()->HandleCrash(pExceptionInfo);
     }
   }
@@ -1,5 +1,7 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Memory/FrameAllocator.h>
+#include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 /// \brief This is a helper class that splits up task items via index ranges.
@@ -36,6 +38,113 @@ private:
   ezParallelForIndexedFunction m_TaskCallback;
 };
 
+/// \brief This is a helper class that distributes an index range adaptively between all its invocations.
+///
+/// Each invocation owns one slot that holds its remaining range, packed into a single 64 bit atomic as (end << 32) | begin.
+/// The owner takes pieces of uiGrainSize items from the front of its range. Once its slot is empty, it steals the back half
+/// of the largest remaining range from another slot and continues with that. Both operations are a single compare-and-swap.
+class AdaptiveIndexedTask final : public ezTask
+{
+public:
+  AdaptiveIndexedTask(ezArrayPtr<ezAtomicInteger64> slots, ezUInt32 uiGrainSize, const ezParallelForIndexedFunction& taskCallback)
+    : m_pSlots(slots.GetPtr())
+    , m_uiNumSlots(slots.GetCount())
+    , m_uiGrainSize(uiGrainSize)
+    , m_TaskCallback(taskCallback)
+  {
+  }
+
+  EZ_ALWAYS_INLINE static ezInt64 PackRange(ezUInt32 uiBegin, ezUInt32 uiEnd) { return static_cast<ezInt64>((static_cast<ezUInt64>(uiEnd) << 32) | uiBegin); }
+  EZ_ALWAYS_INLINE static ezUInt32 GetBegin(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) & 0xFFFFFFFFu); }
+  EZ_ALWAYS_INLINE static ezUInt32 GetEnd(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) >> 32); }
+
+  void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    ezAtomicInteger64& ownSlot = m_pSlots[uiInvocation];
+
+    do
+    {
+      ezUInt32 uiBegin, uiEnd;
+      while (TakePiece(ownSlot, uiBegin, uiEnd))
+      {
+        m_TaskCallback(uiBegin, uiEnd);
+      }
+
+    } while (StealRange(ownSlot));
+  }
+
+private:
+  bool TakePiece(ezAtomicInteger64& slot, ezUInt32& out_uiBegin, ezUInt32& out_uiEnd) const
+  {
+    while (true)
+    {
+      const ezInt64 iRange = slot;
+      const ezUInt32 uiBegin = GetBegin(iRange);
+      const ezUInt32 uiEnd = GetEnd(iRange);
+
+      if (uiBegin >= uiEnd)
+        return false;
+
+      const ezUInt32 uiPieceEnd = uiBegin + ezMath::Min(m_uiGrainSize, uiEnd - uiBegin);
+
+      if (slot.TestAndSet(iRange, PackRange(uiPieceEnd, uiEnd)))
+      {
+        out_uiBegin = uiBegin;
+        out_uiEnd = uiPieceEnd;
+        return true;
+      }
+    }
+  }
+
+  bool StealRange(ezAtomicInteger64& ownSlot) const
+  {
+    while (true)
+    {
+      // find the slot with the most remaining work
+      ezAtomicInteger64* pVictim = nullptr;
+      ezInt64 iVictimRange = 0;
+      ezUInt32 uiMaxRemaining = 0;
+
+      for (ezUInt32 i = 0; i < m_uiNumSlots; ++i)
+      {
+        ezAtomicInteger64& slot = m_pSlots[i];
+        const ezInt64 iRange = slot;
+        const ezUInt32 uiBegin = GetBegin(iRange);
+        const ezUInt32 uiEnd = GetEnd(iRange);
+
+        if (uiEnd > uiBegin && uiEnd - uiBegin > uiMaxRemaining)
+        {
+          pVictim = &slot;
+          iVictimRange = iRange;
+          uiMaxRemaining = uiEnd - uiBegin;
+        }
+      }
+
+      // everything is taken, the other invocations will finish what they have
+      if (pVictim == nullptr)
+        return false;
+
+      const ezUInt32 uiBegin = GetBegin(iVictimRange);
+      const ezUInt32 uiEnd = GetEnd(iVictimRange);
+
+      // take the back half, or everything if it can't be split anymore
+      const ezUInt32 uiSplit = (uiMaxRemaining > m_uiGrainSize) ? uiEnd - uiMaxRemaining / 2 : uiBegin;
+
+      if (pVictim->TestAndSet(iVictimRange, PackRange(uiBegin, uiSplit)))
+      {
+        // nobody else modifies our slot while it is empty, so no CAS necessary here
+        ownSlot.Set(PackRange(uiSplit, uiEnd));
+        return true;
+      }
+    }
+  }
+
+  ezAtomicInteger64* m_pSlots;
+  ezUInt32 m_uiNumSlots;
+  ezUInt32 m_uiGrainSize;
+  const ezParallelForIndexedFunction& m_TaskCallback;
+};
+
 ezUInt32 ezParallelForParams::DetermineMultiplicity(ezUInt32 uiNumTaskItems) const
 {
   // If we have not exceeded the threading threshold we will indicate to use serial execution.
@@ -84,6 +193,12 @@ ezUInt32 ezParallelForParams::DetermineItemsPerInvocation(ezUInt32 uiNumTaskItem
 
 void ezTaskSystem::ParallelForIndexed(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
 {
+  if (params.splitting == ezParallelForSplitting::Adaptive)
+  {
+    ParallelForAdaptive(uiStartIndex, uiNumItems, taskCallback, taskName ? taskName : "Generic Indexed Task", params);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = params.DetermineMultiplicity(uiNumItems);
   const ezUInt32 uiItemsPerInvocation = params.DetermineItemsPerInvocation(uiNumItems, uiMultiplicity);
 
@@ -103,5 +218,41 @@ void ezTaskSystem::ParallelForIndexed(ezUInt32 uiStartIndex, ezUInt32 uiNumItems
   }
 }
 
+void ezTaskSystem::ParallelForAdaptive(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, const ezParallelForIndexedFunction& taskCallback, const char* taskName, const ezParallelForParams& params)
+{
+  EZ_ASSERT_DEV(params.uiGrainSize > 0, "The grain size must not be zero");
+  EZ_ASSERT_DEV(static_cast<ezUInt64>(uiStartIndex) + uiNumItems <= 0xFFFFFFFFu, "Index range is too large");
+
+  const ezUInt32 uiNumPieces = (uiNumItems + params.uiGrainSize - 1) / params.uiGrainSize;
+
+  // one invocation per worker is enough, idle invocations steal work from the busy ones
+  const ezUInt32 uiMultiplicity = (uiNumItems < params.uiBinSize) ? 0 : ezMath::Min(uiNumPieces, ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks));
+
+  if (uiMultiplicity <= 1)
+  {
+    EZ_PROFILE_SCOPE(taskName);
+    taskCallback(uiStartIndex, uiStartIndex + uiNumItems);
+    return;
+  }
+
+  // every invocation starts with an equal share of the range
+  ezHybridArray<ezAtomicInteger64, 32> slots(ezFrameAllocator::GetCurrentAllocator());
+  slots.SetCountUninitialized(uiMultiplicity);
+
+  for (ezUInt32 i = 0; i < uiMultiplicity; ++i)
+  {
+    const ezUInt32 uiBegin = uiStartIndex + static_cast<ezUInt32>(static_cast<ezUInt64>(uiNumItems) * i / uiMultiplicity);
+    const ezUInt32 uiEnd = uiStartIndex + static_cast<ezUInt32>(static_cast<ezUInt64>(uiNumItems) * (i + 1) / uiMultiplicity);
+
+    slots[i] = AdaptiveIndexedTask::PackRange(uiBegin, uiEnd);
+  }
+
+  AdaptiveIndexedTask adaptiveTask(slots, params.uiGrainSize, taskCallback);
+  adaptiveTask.ConfigureTask(taskName, params.nestingMode);
+  adaptiveTask.SetMultiplicity(uiMultiplicity);
+
+  ezTaskGroupID taskGroupId = ezTaskSystem::StartSingleTask(&adaptiveTask, ezTaskPriority::EarlyThisFrame);
+  ezTaskSystem::WaitForGroup(taskGroupId);
+}
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_ParallelFor);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
 
@@ -44,6 +45,16 @@ private:
 template <typename ElemType>
 void ezTaskSystem::ParallelForInternal(ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config)
 {
+  if (config.splitting == ezParallelForSplitting::Adaptive)
+  {
+    auto indexedCallback = [taskItems, &taskCallback](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      taskCallback(uiStartIndex, taskItems.GetSubArray(uiStartIndex, uiEndIndex - uiStartIndex));
+    };
+
+    ParallelForAdaptive(0, taskItems.GetCount(), ezParallelForIndexedFunction(indexedCallback, ezFrameAllocator::GetCurrentAllocator()), taskName ? taskName : "Generic ArrayPtr Task", config);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = config.DetermineMultiplicity(taskItems.GetCount());
   const ezUInt32 uiItemsPerInvocation = config.DetermineItemsPerInvocation(taskItems.GetCount(), uiMultiplicity);
 
@@ -100,3 +111,128 @@ void ezTaskSystem::ParallelForSingleIndex(ezArrayPtr<ElemType> taskItems, Callba
 
   ParallelForInternal<ElemType>(taskItems, ezParallelForFunction<ElemType>(std::move(wrappedCallback), ezFrameAllocator::GetCurrentAllocator()), taskName, params);
 }
+
+template <typename ElemType, typename ResultType, typename FoldCallback, typename CombineCallback>
+ResultType ezTaskSystem::ParallelReduce(ezArrayPtr<ElemType> taskItems, const ResultType& identity, FoldCallback foldCallback, CombineCallback combineCallback, const char* taskName, const ezParallelForParams& params)
+{
+  // the slices are always determined the same way, independent of the splitting mode, which makes the result deterministic
+  const ezUInt32 uiNumSlices = ezMath::Max(1u, params.DetermineMultiplicity(taskItems.GetCount()));
+  const ezUInt32 uiItemsPerSlice = params.DetermineItemsPerInvocation(taskItems.GetCount(), uiNumSlices);
+
+  ezHybridArray<ResultType, 32> partialResults(ezFrameAllocator::GetCurrentAllocator());
+  partialResults.SetCount(uiNumSlices, identity);
+
+  ezParallelForParams sliceParams = params;
+  sliceParams.uiBinSize = 1;
+  sliceParams.uiGrainSize = 1;
+
+  auto reduceSlices = [&](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) {
+    for (ezUInt32 uiSlice = uiStartSlice; uiSlice < uiEndSlice; ++uiSlice)
+    {
+      const ezUInt32 uiFirstItem = ezMath::Min(uiSlice * uiItemsPerSlice, taskItems.GetCount());
+      const ezUInt32 uiLastItem = ezMath::Min(uiFirstItem + uiItemsPerSlice, taskItems.GetCount());
+
+      ResultType partialResult = identity;
+      for (ezUInt32 i = uiFirstItem; i < uiLastItem; ++i)
+      {
+        partialResult = foldCallback(partialResult, taskItems[i]);
+      }
+
+      partialResults[uiSlice] = std::move(partialResult);
+    }
+  };
+
+  ParallelForIndexed(0, uiNumSlices, ezParallelForIndexedFunction(reduceSlices, ezFrameAllocator::GetCurrentAllocator()), taskName ? taskName : "Generic Reduce Task", sliceParams);
+
+  ResultType result = identity;
+  for (const ResultType& partialResult : partialResults)
+  {
+    result = combineCallback(result, partialResult);
+  }
+
+  return result;
+}
+
+template <typename ElemType, typename ResultType, typename FoldCallback, typename CombineCallback>
+void ezTaskSystem::ParallelScan(ezArrayPtr<ElemType> taskItems, ezArrayPtr<ResultType> out_Results, const ResultType& identity, FoldCallback foldCallback, CombineCallback combineCallback, ezParallelScanMode mode, const char* taskName, const ezParallelForParams& params)
+{
+  EZ_ASSERT_DEV(out_Results.GetCount() == taskItems.GetCount(), "The result array must have the same size as the task items array ({} != {})", out_Results.GetCount(), taskItems.GetCount());
+
+  const ezUInt32 uiNumSlices = ezMath::Max(1u, params.DetermineMultiplicity(taskItems.GetCount()));
+  const ezUInt32 uiItemsPerSlice = params.DetermineItemsPerInvocation(taskItems.GetCount(), uiNumSlices);
+
+  ezHybridArray<ResultType, 32> sliceOffsets(ezFrameAllocator::GetCurrentAllocator());
+  sliceOffsets.SetCount(uiNumSlices, identity);
+
+  ezParallelForParams sliceParams = params;
+  sliceParams.uiBinSize = 1;
+  sliceParams.uiGrainSize = 1;
+
+  if (taskName == nullptr)
+  {
+    taskName = "Generic Scan Task";
+  }
+
+  // first pass: the combination of all items in each slice, the last slice is not needed
+  auto reduceSlices = [&](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) {
+    for (ezUInt32 uiSlice = uiStartSlice; uiSlice < uiEndSlice; ++uiSlice)
+    {
+      const ezUInt32 uiFirstItem = ezMath::Min(uiSlice * uiItemsPerSlice, taskItems.GetCount());
+      const ezUInt32 uiLastItem = ezMath::Min(uiFirstItem + uiItemsPerSlice, taskItems.GetCount());
+
+      ResultType partialResult = identity;
+      for (ezUInt32 i = uiFirstItem; i < uiLastItem; ++i)
+      {
+        partialResult = foldCallback(partialResult, taskItems[i]);
+      }
+
+      sliceOffsets[uiSlice] = std::move(partialResult);
+    }
+  };
+
+  if (uiNumSlices > 1)
+  {
+    ParallelForIndexed(0, uiNumSlices - 1, ezParallelForIndexedFunction(reduceSlices, ezFrameAllocator::GetCurrentAllocator()), taskName, sliceParams);
+  }
+
+  // turn the partial results into the offset at which each slice starts
+  {
+    ResultType offset = identity;
+    for (ResultType& sliceOffset : sliceOffsets)
+    {
+      ResultType partialResult = std::move(sliceOffset);
+      sliceOffset = offset;
+      offset = combineCallback(offset, partialResult);
+    }
+  }
+
+  // second pass: scan each slice, starting at its offset
+  auto scanSlices = [&](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) {
+    for (ezUInt32 uiSlice = uiStartSlice; uiSlice < uiEndSlice; ++uiSlice)
+    {
+      const ezUInt32 uiFirstItem = ezMath::Min(uiSlice * uiItemsPerSlice, taskItems.GetCount());
+      const ezUInt32 uiLastItem = ezMath::Min(uiFirstItem + uiItemsPerSlice, taskItems.GetCount());
+
+      ResultType result = sliceOffsets[uiSlice];
+
+      if (mode == ezParallelScanMode::Inclusive)
+      {
+        for (ezUInt32 i = uiFirstItem; i < uiLastItem; ++i)
+        {
+          result = foldCallback(result, taskItems[i]);
+          out_Results[i] = result;
+        }
+      }
+      else
+      {
+        for (ezUInt32 i = uiFirstItem; i < uiLastItem; ++i)
+        {
+          out_Results[i] = result;
+          result = foldCallback(result, taskItems[i]);
+        }
+      }
+    }
+  };
+
+  ParallelForIndexed(0, uiNumSlices, ezParallelForIndexedFunction(scanSlices, ezFrameAllocator::GetCurrentAllocator()), taskName, sliceParams);
+}
@@ -19,6 +19,7 @@ void ezTask::ConfigureTask(const char* szTaskName, ezTaskNesting nestingMode, ez
   EZ_ASSERT_DEV(IsTaskFinished(), "This function must be called before the task is started.");
 
   m_sTaskName = szTaskName;
+  m_uiProfilingNameId = ezProfilingSystem::RegisterScopeName(m_sTaskName, nullptr);
   m_NestingMode = nestingMode;
   m_OnTaskFinished = Callback;
 }
@@ -38,22 +39,14 @@ void ezTask::Run(ezUInt32 uiInvocation)
     return;
   }
 
+  // the profiling scope is added by ezTaskSystem::ExecuteTask()
+  if (m_bUsesMultiplicity)
   {
-    ezStringBuilder scopeName = m_sTaskName;
-
-    if (m_bUsesMultiplicity)
-      scopeName.AppendFormat("-{}", uiInvocation);
-
-    EZ_PROFILE_SCOPE(scopeName.GetData());
-
-    if (m_bUsesMultiplicity)
-    {
-      ExecuteWithMultiplicity(uiInvocation);
-    }
-    else
-    {
-      Execute();
-    }
+    ExecuteWithMultiplicity(uiInvocation);
+  }
+  else
+  {
+    Execute();
   }
 
   m_iRemainingRuns.Decrement();
@@ -108,4 +108,7 @@ private:
   ezTaskGroupID m_BelongsToGroup;
 
   ezString m_sTaskName;
+
+  /// \brief The task name interned by ezProfilingSystem::RegisterScopeName(), such that executing the task doesn't have to look it up.
+  ezUInt32 m_uiProfilingNameId = 0;
 };
@@ -29,6 +29,7 @@ void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCall
   m_OthersDependingOnMe.Clear();
   m_Priority = priority;
   m_OnFinishedCallback = callback;
+  m_iReleasingFlowId = 0;
 }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
@@ -37,5 +37,6 @@ private:
   ezAtomicInteger32 m_iNumRemainingTasks;
   ezOnTaskGroupFinishedCallback m_OnFinishedCallback;
   ezTaskPriority::Enum m_Priority = ezTaskPriority::ThisFrame;
+  ezAtomicInteger64 m_iReleasingFlowId; // the profiling flow that started at the dependency which released this group, ended by the first task that runs
   mutable ezConditionVariable m_CondVarGroupFinished;
 };
@@ -35,15 +35,19 @@ void ezTaskSystem::Startup()
 {
   s_ThreadState = EZ_DEFAULT_NEW(ezTaskSystemThreadState);
   s_State = EZ_DEFAULT_NEW(ezTaskSystemState);
+  s_State->m_iStatisticsResetTime = static_cast<ezInt64>(ezTime::Now().GetNanoseconds());
 
   tl_TaskWorkerInfo.m_WorkerType = ezWorkerThreadType::MainThread;
   tl_TaskWorkerInfo.m_iWorkerIndex = 0;
+  tl_TaskWorkerInfo.m_pLocalQueues = &s_ThreadState->m_MainThreadQueues;
 }
 
 void ezTaskSystem::Shutdown()
 {
   StopWorkerThreads();
 
+  tl_TaskWorkerInfo.m_pLocalQueues = nullptr;
+
   s_State.Clear();
   s_ThreadState.Clear();
 }
@@ -11,6 +11,7 @@ class ezTaskGroup;
 class ezTaskWorkerThread;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
+struct ezTaskThreadStatistics;
 class ezDGMLGraph;
 
 /// \brief Describes the priority with which to execute a task.
@@ -23,7 +24,8 @@ class ezDGMLGraph;
 /// Once 'ezTaskSystem::FinishFrameTasks' is called, all those tasks will be moved into the 'XYZThisFrame' categories.\n
 /// For tasks that run over a longer period (e.g. path searches, procedural data creation), use 'LongRunning'.
 /// Only use 'LongRunningHighPriority' for tasks that occur rarely, otherwise 'LongRunning' tasks might not get processed, at all.\n
-/// For tasks that need to access files, prefer to use 'FileAccess', this way all file accesses get executed sequentially.\n
+/// For tasks that need to access files, prefer to use 'FileAccess', this way all file accesses get executed sequentially (unless more file
+/// access threads are configured through ezTaskSystem::SetWorkerThreadCount()).\n
 /// Use 'FileAccessHighPriority' to get very important file accesses done sooner. For example writing out a save-game should finish
 /// quickly.\n For tasks that need to execute on the main thread (e.g. uploading GPU resources) use 'ThisFrameMainThread' or
 /// 'SomeFrameMainThread' depending on how urgent it is. 'SomeFrameMainThread' tasks might get delayed for quite a while, depending on the
@@ -56,10 +58,10 @@ struct ezTaskPriority
     LongRunningHighPriority,  ///< Tasks that might take a while, but should be preferred over 'LongRunning' tasks. Use this priority only
                               ///< rarely, otherwise 'LongRunning' tasks might never get executed.
     LongRunning,              ///< Use this priority for tasks that might run for a while.
-    FileAccessHighPriority,   ///< For tasks that require file access (e.g. resource loading). They run on one dedicated thread, such that
-                              ///< file accesses are done sequentially and never in parallel.
-    FileAccess,               ///< For tasks that require file access (e.g. resource loading). They run on one dedicated thread, such that file accesses
-                              ///< are done sequentially and never in parallel.
+    FileAccessHighPriority,   ///< For tasks that require file access (e.g. resource loading). They run on dedicated threads (one by default),
+                              ///< such that file accesses are done sequentially and never in parallel.
+    FileAccess,               ///< For tasks that require file access (e.g. resource loading). They run on dedicated threads (one by default), such
+                              ///< that file accesses are done sequentially and never in parallel.
     ThisFrameMainThread,      ///< Tasks that need to be executed this frame, but in the main thread. This is mostly intended for resource
                               ///< creation.
     SomeFrameMainThread,      ///< Tasks that have no hard deadline but need to be executed in the main thread. This is mostly intended for
@@ -147,6 +149,26 @@ enum class ezTaskNesting
   Never,
 };
 
+/// \brief Describes how ezTaskSystem::ParallelFor splits up the task items into pieces of work.
+enum class ezParallelForSplitting
+{
+  /// The items are split up front into a fixed number of equally sized slices (see ezParallelForParams::DetermineMultiplicity()).
+  /// Has the least overhead, but if some items take a lot longer than others, a few slices run long and the other workers sit idle.
+  Static,
+
+  /// Every task invocation starts with an equal share of the items, but processes it only ezParallelForParams::uiGrainSize items at a
+  /// time. Invocations that run out of work steal half of the largest remaining range from another invocation, so the range is split
+  /// recursively, but only where and when there are idle workers. Use this when the cost per item is very uneven.
+  Adaptive,
+};
+
+/// \brief Describes whether ezTaskSystem::ParallelScan includes the item itself in its result.
+enum class ezParallelScanMode
+{
+  Inclusive, ///< Result i contains the items 0 to i.
+  Exclusive, ///< Result i contains the items 0 to i - 1, ie. the first result is the identity.
+};
+
 /// \brief Settings for ezTaskSystem::ParallelFor invocations.
 struct EZ_FOUNDATION_DLL ezParallelForParams
 {
@@ -167,6 +189,13 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
 
   ezTaskNesting nestingMode = ezTaskNesting::Never;
 
+  /// How the task items are split up into pieces of work. See ezParallelForSplitting.
+  ezParallelForSplitting splitting = ezParallelForSplitting::Static;
+
+  /// Only used with ezParallelForSplitting::Adaptive. The number of task items that are handed to the callback at once.
+  /// Ranges are never split into pieces smaller than this. Choose it such that one piece takes at least a few microseconds.
+  ezUInt32 uiGrainSize = 1;
+
   /// Returns the multiplicity to use for the given task. If 0 is returned,
   /// serial execution is to be performed.
   ezUInt32 DetermineMultiplicity(ezUInt32 uiNumTaskItems) const;
@@ -187,3 +216,57 @@ enum class ezTaskWorkerState
   Idle = 1,
   Blocked = 2,
 };
+
+/// \brief Aggregated statistics of all tasks of one priority, see ezTaskSystem::GetStatistics().
+struct ezTaskPriorityStatistics
+{
+  ezUInt64 m_uiNumGroupsStarted = 0; ///< The number of task groups of this priority whose tasks were queued.
+  ezUInt64 m_uiNumTasksExecuted = 0; ///< The number of task invocations that were executed. A task with multiplicity N counts N times.
+  ezTime m_TotalQueueLatency;        ///< The sum of the time between queuing and starting each task invocation.
+  ezTime m_MaxQueueLatency;          ///< The longest time any task invocation was queued before it was started.
+  ezTime m_TotalExecutionTime;       ///< The sum of the time spent executing the task invocations.
+
+  /// \brief The average time a task invocation waited in the queue.
+  ezTime GetAverageQueueLatency() const { return m_uiNumTasksExecuted > 0 ? m_TotalQueueLatency / (double)m_uiNumTasksExecuted : ezTime::Zero(); }
+
+  /// \brief The average time it took to execute one task invocation. Very short tasks indicate that more work should be put into each task.
+  ezTime GetAverageExecutionTime() const { return m_uiNumTasksExecuted > 0 ? m_TotalExecutionTime / (double)m_uiNumTasksExecuted : ezTime::Zero(); }
+
+  /// \brief The average number of task invocations per group.
+  double GetAverageTasksPerGroup() const { return m_uiNumGroupsStarted > 0 ? (double)m_uiNumTasksExecuted / (double)m_uiNumGroupsStarted : 0.0; }
+};
+
+/// \brief How one worker thread spent its time, see ezTaskSystem::GetStatistics().
+struct ezTaskWorkerStatistics
+{
+  ezWorkerThreadType::Enum m_WorkerType = ezWorkerThreadType::Unknown;
+  ezUInt32 m_uiWorkerIndex = 0;
+  ezUInt64 m_uiNumTasksExecuted = 0; ///< Includes the tasks that the thread executed while it was waiting for other tasks.
+  ezTime m_ActiveTime;               ///< Time spent executing or looking for tasks.
+  ezTime m_IdleTime;                 ///< Time spent sleeping, because there was no work.
+  ezTime m_BlockedTime;              ///< Time spent waiting for a task group or condition, without being able to help with other tasks.
+
+  /// \brief Returns the fraction (0 - 1) of the time in which this thread was active.
+  double GetUtilization() const
+  {
+    const double fTotal = (m_ActiveTime + m_IdleTime + m_BlockedTime).GetSeconds();
+    return fTotal > 0.0 ? m_ActiveTime.GetSeconds() / fTotal : 0.0;
+  }
+};
+
+/// \brief Statistics about the task system since the last call to ezTaskSystem::ResetStatistics().
+///
+/// \see ezTaskSystem::GetStatistics()
+struct ezTaskSystemStatistics
+{
+  /// \brief The time that passed since the statistics were reset.
+  ezTime m_Duration;
+
+  /// \brief The number of task groups that were started because their last dependency finished.
+  ezUInt64 m_uiNumDependencyReleases = 0;
+
+  ezTaskPriorityStatistics m_Priorities[ezTaskPriority::ENUM_COUNT];
+
+  /// \brief One entry for each allocated worker thread.
+  ezHybridArray<ezTaskWorkerStatistics, 32> m_Workers;
+};
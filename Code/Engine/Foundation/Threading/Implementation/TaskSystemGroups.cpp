@@ -161,6 +161,14 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
     pGroup->m_iNumRemainingTasks = iRemainingTasks;
 
+    const ezUInt64 uiEnqueueTicks = ezProfilingSystem::GetTicks();
+
+    // with work stealing, tasks that never wait go into the queues of this thread (if it has any) and other threads steal them from there
+    ezTaskWorkStealingQueue* pLocalQueue = nullptr;
+    if (s_State->m_bWorkStealing && tl_TaskWorkerInfo.m_pLocalQueues != nullptr && ezTaskWorkStealingQueues::IsStealablePriority(pGroup->m_Priority))
+    {
+      pLocalQueue = &tl_TaskWorkerInfo.m_pLocalQueues->m_Queues[pGroup->m_Priority - ezTaskWorkStealingQueues::FirstPriority];
+    }
 
     for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
     {
@@ -173,6 +181,11 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
         td.m_pTask = pTask;
         td.m_pTask->m_bTaskIsScheduled = true;
         td.m_uiInvocation = mult;
+        td.m_uiEnqueueTicks = uiEnqueueTicks;
+
+        // if the local queue is full, fall back to the global list
+        if (pLocalQueue != nullptr && pTask->m_NestingMode == ezTaskNesting::Never && pLocalQueue->Push(td))
+          continue;
 
         if (bHighPriority)
           s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
@@ -181,6 +194,10 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
       }
     }
 
+    // must happen after the tasks are queued and before waking up the workers, see GetNextTask()
+    s_State->m_iNumQueuedTasks[pGroup->m_Priority].Add(iRemainingTasks);
+    GetThreadStatistics().m_iNumGroupsStarted[pGroup->m_Priority].Increment();
+
     // send the proper thread signal, to make sure one of the correct worker threads is awake
     switch (pGroup->m_Priority)
     {
@@ -231,6 +248,19 @@ void ezTaskSystem::DependencyHasFinished(ezTaskGroup* pGroup)
   // remove one dependency from the group
   if (pGroup->m_iNumActiveDependencies.Decrement() == 0)
   {
+    s_State->m_iNumDependencyReleases.Increment();
+
+    // in the profiling trace, draw an arrow from the task that finished the dependency to the first task of this group that runs
+    if (!pGroup->m_Tasks.IsEmpty())
+    {
+      const ezUInt64 uiFlowId = ezProfilingSystem::CreateFlowId();
+      if (uiFlowId != 0)
+      {
+        ezProfilingSystem::AddFlowEvent(uiFlowId, true);
+        pGroup->m_iReleasingFlowId = static_cast<ezInt64>(uiFlowId);
+      }
+    }
+
     // if there are no remaining dependencies, kick off all tasks in this group
     ScheduleGroupTasks(pGroup, true);
   }
@@ -292,6 +322,7 @@ void ezTaskSystem::WaitForGroup(ezTaskGroupID Group)
         if (tl_TaskWorkerInfo.m_pWorkerState)
         {
           EZ_VERIFY(tl_TaskWorkerInfo.m_pWorkerState->Set((int)ezTaskWorkerState::Blocked) == (int)ezTaskWorkerState::Active, "Corrupt worker state");
+          tl_TaskWorkerInfo.m_pWorkerThread->BeginBlocked();
         }
 
         WakeUpThreads(typeToWakeUp, 1);
@@ -300,6 +331,7 @@ void ezTaskSystem::WaitForGroup(ezTaskGroupID Group)
 
         if (tl_TaskWorkerInfo.m_pWorkerState)
         {
+          tl_TaskWorkerInfo.m_pWorkerThread->EndBlocked();
           EZ_VERIFY(tl_TaskWorkerInfo.m_pWorkerState->Set((int)ezTaskWorkerState::Active) == (int)ezTaskWorkerState::Blocked, "Corrupt worker state");
         }
 
@@ -333,6 +365,7 @@ void ezTaskSystem::WaitForCondition(ezDelegate<bool()> condition)
         if (tl_TaskWorkerInfo.m_pWorkerState)
         {
           EZ_VERIFY(tl_TaskWorkerInfo.m_pWorkerState->Set((int)ezTaskWorkerState::Blocked) == (int)ezTaskWorkerState::Active, "Corrupt worker state");
+          tl_TaskWorkerInfo.m_pWorkerThread->BeginBlocked();
         }
 
         WakeUpThreads(typeToWakeUp, 1);
@@ -345,6 +378,7 @@ void ezTaskSystem::WaitForCondition(ezDelegate<bool()> condition)
 
         if (tl_TaskWorkerInfo.m_pWorkerState)
         {
+          tl_TaskWorkerInfo.m_pWorkerThread->EndBlocked();
           EZ_VERIFY(tl_TaskWorkerInfo.m_pWorkerState->Set((int)ezTaskWorkerState::Active) == (int)ezTaskWorkerState::Blocked, "Corrupt worker state");
         }
 
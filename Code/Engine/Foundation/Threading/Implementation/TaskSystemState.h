@@ -1,6 +1,9 @@
 #pragma once
 
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
+#include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Metrics.h>
 
 class ezTaskSystemThreadState
 {
@@ -16,12 +19,16 @@ private:
 
   // the maximum number of worker threads that should be non-idle (and not blocked) at any time
   ezUInt32 m_uiMaxWorkersToUse[ezWorkerThreadType::ENUM_COUNT] = {};
+
+  // the work-stealing queues of the main thread, the short task workers own theirs
+  ezTaskWorkStealingQueues m_MainThreadQueues;
 };
 
 class ezTaskSystemState
 {
 private:
   friend class ezTaskSystem;
+  friend class ezTaskWorkerThread;
 
   // The target frame time used by FinishFrameTasks()
   ezTime m_TargetFrameTime = ezTime::Seconds(1.0 / 40.0); // => 25 ms
@@ -31,4 +38,32 @@ private:
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // The number of scheduled tasks for each priority, both in m_Tasks and in all work-stealing queues.
+  // Allows to skip empty priorities without taking the lock and to detect work that was queued while a worker went idle.
+  ezAtomicInteger32 m_iNumQueuedTasks[ezTaskPriority::ENUM_COUNT];
+
+  // Whether new 'this frame' tasks are put into the work-stealing queues of the scheduling thread, see ezTaskSystem::SetWorkStealingEnabled().
+  // Read by all threads that schedule tasks, while any thread may toggle it.
+  ezAtomicBool m_bWorkStealing = false;
+
+  // Statistics for ezTaskSystem::GetStatistics().
+  // m_iStatisticsResetTime is the ezTime::Now() value in nanoseconds at which the statistics were last reset.
+  ezAtomicInteger64 m_iStatisticsResetTime;
+  ezAtomicInteger64 m_iNumDependencyReleases;
+
+  // The per priority statistics of all threads that are not workers, and of the workers that were already shut down.
+  // Each worker accumulates its own, see ezTaskWorkerThread::GetTaskStatistics().
+  ezTaskThreadStatistics m_OtherThreadsStatistics;
+
+  // The metrics that FinishFrameTasks() updates from the statistics, see ezTaskSystem::UpdateMetrics().
+  // The m_uiLast/m_Last values are the statistics at the previous update, the metrics receive the difference.
+  ezMetricCounter m_TasksExecutedMetric;
+  ezMetricCounter m_GroupsStartedMetric;
+  ezMetricCounter m_DependencyReleasesMetric;
+  ezMetricHistogram m_QueueLatencyMetric;
+  ezUInt64 m_uiLastTasksExecuted = 0;
+  ezUInt64 m_uiLastGroupsStarted = 0;
+  ezUInt64 m_uiLastDependencyReleases = 0;
+  ezTime m_LastTotalQueueLatency;
 };
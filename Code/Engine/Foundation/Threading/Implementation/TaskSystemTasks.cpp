@@ -69,35 +69,99 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
   }
 }
 
+bool ezTaskSystem::TakeStealableTask(ezUInt32 uiPriority, TaskData& out_td)
+{
+  const ezUInt32 uiQueue = uiPriority - ezTaskWorkStealingQueues::FirstPriority;
+  ezTaskWorkStealingQueues* pOwnQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  // prefer the tasks that this thread queued itself, they are the most recent ones and their data is likely still in the cache
+  if (pOwnQueues != nullptr && pOwnQueues->m_Queues[uiQueue].Pop(out_td))
+    return true;
+
+  // otherwise try to steal from the other threads
+  // start with a different victim every time, so that the thieves spread out instead of all hammering the same queue
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiNumVictims = uiNumWorkers + 1; // the main thread is the last one
+  const ezUInt32 uiFirstVictim = tl_TaskWorkerInfo.m_uiNextStealVictim++;
+
+  for (ezUInt32 i = 0; i < uiNumVictims; ++i)
+  {
+    const ezUInt32 uiVictim = (uiFirstVictim + i) % uiNumVictims;
+
+    ezTaskWorkStealingQueues* pVictimQueues = (uiVictim == uiNumWorkers) ? &s_ThreadState->m_MainThreadQueues : s_ThreadState->m_Workers[ezWorkerThreadType::ShortTasks][uiVictim]->GetLocalQueues();
+
+    if (pVictimQueues == pOwnQueues)
+      continue;
+
+    if (pVictimQueues->m_Queues[uiQueue].Steal(out_td))
+      return true;
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  {
+    if (s_State->m_iNumQueuedTasks[prio] > 0)
+      return true;
+  }
+
+  return false;
+}
+
 ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
 {
   // this is the central function that selects tasks for the worker threads to work on
 
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
 
-  EZ_LOCK(s_TaskSystemMutex);
-
-  // go through all the task lists that this thread is willing to work on
-  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  while (true)
   {
-    for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+    // go through all the task queues that this thread is willing to work on
+    for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
     {
-      if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
-      {
-        TaskData td = *it;
+      // nothing to do for this priority, don't bother locking anything
+      if (s_State->m_iNumQueuedTasks[prio] <= 0)
+        continue;
+
+      TaskData td;
 
-        s_State->m_Tasks[prio].Remove(it);
+      // the work-stealing queues only contain tasks that never wait, so they are always allowed to be executed here
+      if (ezTaskWorkStealingQueues::IsStealablePriority(prio) && TakeStealableTask(prio, td))
+      {
+        s_State->m_iNumQueuedTasks[prio].Decrement();
         return td;
       }
+
+      EZ_LOCK(s_TaskSystemMutex);
+
+      for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+      {
+        if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+        {
+          td = *it;
+
+          s_State->m_Tasks[prio].Remove(it);
+          s_State->m_iNumQueuedTasks[prio].Decrement();
+          return td;
+        }
+      }
     }
-  }
 
-  if (pWorkerState)
-  {
+    if (pWorkerState == nullptr)
+      return TaskData();
+
     EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
-  }
 
-  return TaskData();
+    // Some task may have been queued after we looked at its queue, but before we marked ourselves as idle.
+    // The thread that queued it may then have decided not to wake us up, so we have to check again.
+    // If someone did wake us up in the mean time, the state is 'active' again and the wake up signal is set,
+    // so the worker will not go to sleep anyway.
+    if (!HasQueuedTasks(FirstPriority, LastPriority) || pWorkerState->CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) != (int)ezTaskWorkerState::Idle)
+      return TaskData();
+  }
 }
 
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
@@ -114,14 +178,46 @@ bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriorit
     EZ_ASSERT_DEV(td.m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup, "");
   }
 
-  tl_TaskWorkerInfo.m_bAllowNestedTasks = td.m_pTask->m_NestingMode != ezTaskNesting::Never;
-  tl_TaskWorkerInfo.m_szTaskName = td.m_pTask->m_sTaskName;
-  td.m_pTask->Run(td.m_uiInvocation);
-  tl_TaskWorkerInfo.m_bAllowNestedTasks = true;
-  tl_TaskWorkerInfo.m_szTaskName = nullptr;
+  const ezTaskPriority::Enum priority = td.m_pBelongsToGroup->m_Priority;
+
+  // the task may be deleted once it is finished, the name was already interned by ConfigureTask()
+  const ezUInt32 uiProfilingNameId = td.m_pTask->m_uiProfilingNameId;
+  const ezUInt64 uiStartTicks = ezProfilingSystem::GetTicks();
+
+  {
+    // the first task of a group that was started by a finished dependency ends the flow that was started there
+    if (td.m_pBelongsToGroup->m_iReleasingFlowId != 0)
+    {
+      const ezInt64 iFlowId = td.m_pBelongsToGroup->m_iReleasingFlowId.Set(0);
+      if (iFlowId != 0)
+      {
+        ezProfilingSystem::AddFlowEvent(static_cast<ezUInt64>(iFlowId), false);
+      }
+    }
+
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = td.m_pTask->m_NestingMode != ezTaskNesting::Never;
+    tl_TaskWorkerInfo.m_szTaskName = td.m_pTask->m_sTaskName;
+    td.m_pTask->Run(td.m_uiInvocation);
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = true;
+    tl_TaskWorkerInfo.m_szTaskName = nullptr;
+
+    const ezUInt64 uiEndTicks = ezProfilingSystem::GetTicks();
+
+    // record the statistics before the task is marked as finished, such that anyone waiting for it sees them
+    const ezInt64 iQueueLatency = uiStartTicks > td.m_uiEnqueueTicks ? static_cast<ezInt64>(uiStartTicks - td.m_uiEnqueueTicks) : 0;
+    GetThreadStatistics().TaskExecuted(priority, iQueueLatency, static_cast<ezInt64>(uiEndTicks - uiStartTicks));
+
+    if (tl_TaskWorkerInfo.m_pWorkerThread != nullptr)
+    {
+      tl_TaskWorkerInfo.m_pWorkerThread->TaskExecuted();
+    }
+
+    // notify the group, that a task is finished, which might trigger other tasks to be executed
+    TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+  }
 
-  // notify the group, that a task is finished, which might trigger other tasks to be executed
-  TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+  // the profiling scope also covers finishing the task, such that the flow events of the groups that it starts are attached to it
+  ezProfilingSystem::AddCPUScopeTicks(uiProfilingNameId, uiStartTicks, ezProfilingSystem::GetTicks());
 
   return true;
 }
@@ -164,6 +260,7 @@ ezResult ezTaskSystem::CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRun
           if (it->m_pTask == pTask)
           {
             s_State->m_Tasks[i].Remove(it);
+            s_State->m_iNumQueuedTasks[i].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
@@ -219,6 +316,10 @@ void ezTaskSystem::ReprioritizeFrameTasks()
       ++it;
     }
 
+    const ezInt32 iNumMoved = s_State->m_Tasks[i].GetCount();
+    s_State->m_iNumQueuedTasks[ezTaskPriority::EarlyThisFrame].Add(iNumMoved);
+    s_State->m_iNumQueuedTasks[i].Subtract(iNumMoved);
+
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
@@ -235,6 +336,10 @@ void ezTaskSystem::ReprioritizeFrameTasks()
       ++it;
     }
 
+    const ezInt32 iNumMoved = s_State->m_Tasks[i].GetCount();
+    s_State->m_iNumQueuedTasks[i - 3].Add(iNumMoved);
+    s_State->m_iNumQueuedTasks[i].Subtract(iNumMoved);
+
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
@@ -252,6 +357,10 @@ void ezTaskSystem::ReprioritizeFrameTasks()
       ++it;
     }
 
+    const ezInt32 iNumMoved = s_State->m_Tasks[i].GetCount();
+    s_State->m_iNumQueuedTasks[i - 1].Add(iNumMoved);
+    s_State->m_iNumQueuedTasks[i].Subtract(iNumMoved);
+
     // remove the tasks from their current queue
     s_State->m_Tasks[i].Clear();
   }
@@ -392,6 +501,8 @@ void ezTaskSystem::FinishFrameTasks()
       }
     }
   }
+
+  UpdateMetrics();
 }
 
 
@@ -1,11 +1,35 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Configuration/Startup.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/Profiling.h>
 #include <Foundation/System/SystemInformation.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
 
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, TaskSystemMetrics)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "TaskSystem",
+    "Metrics"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_CORESYSTEMS_STARTUP
+  {
+    ezTaskSystem::RegisterMetrics();
+  }
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezTaskSystem::UnregisterMetrics();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
 ezUInt32 ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::Enum type)
 {
   return s_ThreadState->m_uiMaxWorkersToUse[type];
@@ -16,7 +40,7 @@ ezUInt32 ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::Enum typ
   return s_ThreadState->m_iAllocatedWorkers[type];
 }
 
-void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
+void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks, ezInt8 iFileAccessTasks)
 {
   ezSystemInformation info = ezSystemInformation::Get();
 
@@ -33,15 +57,19 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
   if (iLongTasks <= 0)
     iLongTasks = ezMath::Clamp<ezInt8>(iCpuCores - 2, 2, 8);
 
-  // plus there is always one additional 'file access' thread
-  // and the main thread, of course
+  // a single 'file access' thread, so that file accesses are sequential by default
+  if (iFileAccessTasks <= 0)
+    iFileAccessTasks = 1;
+
+  // plus the main thread, of course
 
   iShortTasks = ezMath::Max<ezInt8>(iShortTasks, 1);
   iLongTasks = ezMath::Max<ezInt8>(iLongTasks, 1);
 
   // if nothing has changed, do nothing
   if (s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] == iShortTasks &&
-      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == iLongTasks)
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == iLongTasks &&
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] == iFileAccessTasks)
     return;
 
   StopWorkerThreads();
@@ -53,7 +81,7 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
 
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] = iShortTasks;
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] = iLongTasks;
-  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = 1;
+  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = iFileAccessTasks;
 
   AllocateThreads(ezWorkerThreadType::ShortTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks]);
   AllocateThreads(ezWorkerThreadType::LongTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks]);
@@ -93,6 +121,25 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+
+      // tasks that are still in the work-stealing queues of this thread must not get lost
+      if (ezTaskWorkStealingQueues* pQueues = s_ThreadState->m_Workers[type][i]->GetLocalQueues())
+      {
+        EZ_LOCK(s_TaskSystemMutex);
+
+        for (ezUInt32 q = 0; q < ezTaskWorkStealingQueues::NumPriorities; ++q)
+        {
+          TaskData td;
+          while (pQueues->m_Queues[q].Steal(td))
+          {
+            s_State->m_Tasks[ezTaskWorkStealingQueues::FirstPriority + q].PushBack(td);
+          }
+        }
+      }
+
+      // keep the task statistics of this thread, GetStatistics() only looks at the allocated workers
+      s_State->m_OtherThreadsStatistics.Accumulate(s_ThreadState->m_Workers[type][i]->GetTaskStatistics());
+
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -175,6 +222,16 @@ void ezTaskSystem::WakeUpThreads(ezWorkerThreadType::Enum type, ezUInt32 uiNumTh
   }
 }
 
+void ezTaskSystem::SetWorkStealingEnabled(bool bEnable)
+{
+  s_State->m_bWorkStealing = bEnable;
+}
+
+bool ezTaskSystem::IsWorkStealingEnabled()
+{
+  return s_State->m_bWorkStealing;
+}
+
 ezWorkerThreadType::Enum ezTaskSystem::GetCurrentThreadWorkerType()
 {
   return tl_TaskWorkerInfo.m_WorkerType;
@@ -185,6 +242,120 @@ double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt3
   return s_ThreadState->m_Workers[Type][uiThreadIndex]->GetThreadUtilization(pNumTasksExecuted);
 }
 
+void ezTaskSystem::GetStatistics(ezTaskSystemStatistics& out_Statistics)
+{
+  const ezInt64 iNow = static_cast<ezInt64>(ezTime::Now().GetNanoseconds());
+  const ezInt64 iResetTime = s_State->m_iStatisticsResetTime;
+
+  out_Statistics.m_Duration = ezTime::Nanoseconds(static_cast<double>(iNow - iResetTime));
+  out_Statistics.m_uiNumDependencyReleases = static_cast<ezUInt64>(s_State->m_iNumDependencyReleases);
+  out_Statistics.m_Workers.Clear();
+
+  ezTaskThreadStatistics total;
+  total.Accumulate(s_State->m_OtherThreadsStatistics);
+
+  for (ezUInt32 type = 0; type < ezWorkerThreadType::ENUM_COUNT; ++type)
+  {
+    const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[type];
+
+    for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+    {
+      const ezTaskWorkerThread* pWorker = s_ThreadState->m_Workers[type][i];
+      pWorker->GetStatistics(out_Statistics.m_Workers.ExpandAndGetRef(), iNow, iResetTime);
+      total.Accumulate(pWorker->GetTaskStatistics());
+    }
+  }
+
+  const double fTicksToSeconds = 1.0 / ezProfilingSystem::GetTicksPerSecond();
+
+  for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+  {
+    ezTaskPriorityStatistics& stats = out_Statistics.m_Priorities[prio];
+    stats.m_uiNumGroupsStarted = static_cast<ezUInt64>(total.m_iNumGroupsStarted[prio]);
+    stats.m_uiNumTasksExecuted = static_cast<ezUInt64>(total.m_iNumTasksExecuted[prio]);
+    stats.m_TotalQueueLatency = ezTime::Seconds(static_cast<double>(total.m_iTotalQueueLatency[prio]) * fTicksToSeconds);
+    stats.m_MaxQueueLatency = ezTime::Seconds(static_cast<double>(total.m_iMaxQueueLatency[prio]) * fTicksToSeconds);
+    stats.m_TotalExecutionTime = ezTime::Seconds(static_cast<double>(total.m_iTotalExecutionTime[prio]) * fTicksToSeconds);
+  }
+}
+
+void ezTaskSystem::ResetStatistics()
+{
+  s_State->m_iStatisticsResetTime = static_cast<ezInt64>(ezTime::Now().GetNanoseconds());
+  s_State->m_iNumDependencyReleases = 0;
+  s_State->m_OtherThreadsStatistics.Reset();
+
+  for (ezUInt32 type = 0; type < ezWorkerThreadType::ENUM_COUNT; ++type)
+  {
+    const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[type];
+
+    for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+    {
+      s_ThreadState->m_Workers[type][i]->ResetStatistics();
+    }
+  }
+}
+
+void ezTaskSystem::RegisterMetrics()
+{
+  s_State->m_TasksExecutedMetric = ezMetrics::RegisterCounter("TaskSystem/TasksExecuted");
+  s_State->m_GroupsStartedMetric = ezMetrics::RegisterCounter("TaskSystem/GroupsStarted");
+  s_State->m_DependencyReleasesMetric = ezMetrics::RegisterCounter("TaskSystem/DependencyReleases");
+  s_State->m_QueueLatencyMetric = ezMetrics::RegisterHistogram("TaskSystem/AverageQueueLatency");
+}
+
+void ezTaskSystem::UnregisterMetrics()
+{
+  s_State->m_TasksExecutedMetric = ezMetricCounter();
+  s_State->m_GroupsStartedMetric = ezMetricCounter();
+  s_State->m_DependencyReleasesMetric = ezMetricCounter();
+  s_State->m_QueueLatencyMetric = ezMetricHistogram();
+}
+
+void ezTaskSystem::UpdateMetrics()
+{
+  if (!s_State->m_TasksExecutedMetric.IsValid())
+    return;
+
+  ezTaskSystemStatistics stats;
+  GetStatistics(stats);
+
+  ezUInt64 uiTasksExecuted = 0;
+  ezUInt64 uiGroupsStarted = 0;
+  ezTime totalQueueLatency;
+
+  for (const ezTaskPriorityStatistics& prio : stats.m_Priorities)
+  {
+    uiTasksExecuted += prio.m_uiNumTasksExecuted;
+    uiGroupsStarted += prio.m_uiNumGroupsStarted;
+    totalQueueLatency += prio.m_TotalQueueLatency;
+  }
+
+  // after ResetStatistics() everything counts as new
+  auto GetNew = [](ezUInt64 uiValue, ezUInt64 uiLastValue) { return uiValue >= uiLastValue ? uiValue - uiLastValue : uiValue; };
+
+  const ezUInt64 uiNewTasks = GetNew(uiTasksExecuted, s_State->m_uiLastTasksExecuted);
+  s_State->m_TasksExecutedMetric.Add(static_cast<ezInt64>(uiNewTasks));
+  s_State->m_GroupsStartedMetric.Add(static_cast<ezInt64>(GetNew(uiGroupsStarted, s_State->m_uiLastGroupsStarted)));
+  s_State->m_DependencyReleasesMetric.Add(static_cast<ezInt64>(GetNew(stats.m_uiNumDependencyReleases, s_State->m_uiLastDependencyReleases)));
+
+  if (uiNewTasks > 0)
+  {
+    const ezTime newQueueLatency = uiTasksExecuted >= s_State->m_uiLastTasksExecuted ? totalQueueLatency - s_State->m_LastTotalQueueLatency : totalQueueLatency;
+    s_State->m_QueueLatencyMetric.RecordTime(newQueueLatency / (double)uiNewTasks);
+  }
+
+  s_State->m_uiLastTasksExecuted = uiTasksExecuted;
+  s_State->m_uiLastGroupsStarted = uiGroupsStarted;
+  s_State->m_uiLastDependencyReleases = stats.m_uiNumDependencyReleases;
+  s_State->m_LastTotalQueueLatency = totalQueueLatency;
+}
+
+ezTaskThreadStatistics& ezTaskSystem::GetThreadStatistics()
+{
+  return tl_TaskWorkerInfo.m_pStatistics != nullptr ? *tl_TaskWorkerInfo.m_pStatistics : s_State->m_OtherThreadsStatistics;
+}
+
 void ezTaskSystem::DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority)
 {
   switch (tl_TaskWorkerInfo.m_WorkerType)
@@ -0,0 +1,82 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
+
+// All reads and writes of m_iTop and m_iBottom go through ezAtomicUtils and are therefore full memory barriers,
+// which is what the Chase-Lev algorithm requires between publishing the new bottom and reading top (and vice versa).
+
+ezTaskWorkStealingQueue::ezTaskWorkStealingQueue()
+{
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+}
+
+bool ezTaskWorkStealingQueue::Push(const ezTaskSystem::TaskData& td)
+{
+  const ezInt64 b = m_iBottom;
+  const ezInt64 t = m_iTop;
+
+  if (b - t >= Capacity)
+    return false;
+
+  m_Tasks[b & (Capacity - 1)] = td;
+
+  // publish the task only after it was written completely
+  m_iBottom.Set(b + 1);
+  return true;
+}
+
+bool ezTaskWorkStealingQueue::Pop(ezTaskSystem::TaskData& out_td)
+{
+  const ezInt64 b = m_iBottom - 1;
+
+  // reserve the bottom item before looking at top, so that thieves can't take it anymore without noticing us
+  m_iBottom.Set(b);
+
+  const ezInt64 t = m_iTop;
+
+  if (t > b)
+  {
+    // queue was empty
+    m_iBottom.Set(b + 1);
+    return false;
+  }
+
+  out_td = m_Tasks[b & (Capacity - 1)];
+
+  if (t != b)
+  {
+    // there were more items in the queue, thieves can't get to this one
+    return true;
+  }
+
+  // this was the last item, we have to race the thieves for it
+  const bool bWon = m_iTop.TestAndSet(t, t + 1);
+  m_iBottom.Set(b + 1);
+  return bWon;
+}
+
+bool ezTaskWorkStealingQueue::Steal(ezTaskSystem::TaskData& out_td)
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+
+  if (t >= b)
+    return false;
+
+  // The slot may get overwritten by the owner right after we read it, but only if another thief took this item in the meantime.
+  // In that case the CAS below fails and the copy is discarded.
+  out_td = m_Tasks[t & (Capacity - 1)];
+
+  return m_iTop.TestAndSet(t, t + 1);
+}
+
+ezUInt32 ezTaskWorkStealingQueue::GetCount() const
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+
+  return b > t ? static_cast<ezUInt32>(b - t) : 0;
+}
+
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkStealingQueue);
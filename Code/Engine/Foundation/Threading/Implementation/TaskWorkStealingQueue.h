@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \internal A fixed-size, lock-free work-stealing deque (Chase-Lev) for ezTaskSystem::TaskData.
+///
+/// Only the owning thread may call Push() and Pop(), which operate on the 'bottom' end of the queue.
+/// Any other thread may call Steal(), which takes items from the 'top' end.
+/// The queue does not grow. If it is full, Push() fails and the caller has to put the task into the global queue instead.
+class ezTaskWorkStealingQueue
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingQueue);
+
+public:
+  enum
+  {
+    Capacity = 512, // must be a power of two
+  };
+
+  ezTaskWorkStealingQueue();
+
+  /// \brief Adds a task at the bottom of the queue. Returns false if the queue is full. May only be called by the owning thread.
+  bool Push(const ezTaskSystem::TaskData& td);
+
+  /// \brief Takes the most recently pushed task from the bottom of the queue. May only be called by the owning thread.
+  bool Pop(ezTaskSystem::TaskData& out_td);
+
+  /// \brief Takes the oldest task from the top of the queue. May be called from any thread.
+  ///
+  /// Returns false when the queue is empty or another thread took the task first.
+  bool Steal(ezTaskSystem::TaskData& out_td);
+
+  /// \brief Returns a snapshot of the number of tasks in the queue. Only a hint, unless the owning thread is stopped.
+  ezUInt32 GetCount() const;
+
+private:
+  // read by thieves, written by thieves and the owner (only when taking the last item)
+  ezAtomicInteger64 m_iTop;
+  ezUInt8 m_Padding0[64 - sizeof(ezAtomicInteger64)];
+
+  // written only by the owner
+  ezAtomicInteger64 m_iBottom;
+  ezUInt8 m_Padding1[64 - sizeof(ezAtomicInteger64)];
+
+  ezTaskSystem::TaskData m_Tasks[Capacity];
+};
+
+/// \internal The set of work-stealing queues that one thread owns, one queue for each 'this frame' priority.
+struct ezTaskWorkStealingQueues
+{
+  enum
+  {
+    FirstPriority = ezTaskPriority::EarlyThisFrame,
+    LastPriority = ezTaskPriority::LateThisFrame,
+    NumPriorities = LastPriority - FirstPriority + 1,
+  };
+
+  /// \brief Whether tasks of the given priority may be put into work-stealing queues.
+  EZ_ALWAYS_INLINE static bool IsStealablePriority(ezUInt32 uiPriority) { return uiPriority <= LastPriority; }
+
+  ezTaskWorkStealingQueue m_Queues[NumPriorities];
+};
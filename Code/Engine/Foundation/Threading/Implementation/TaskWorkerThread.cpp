@@ -6,6 +6,17 @@
 
 thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
 
+static ezInt64 GetStatisticsTime()
+{
+  return static_cast<ezInt64>(ezTime::Now().GetNanoseconds());
+}
+
+// the part of the interval that lies after the last reset of the statistics
+static ezInt64 GetStatisticsInterval(ezInt64 iBegin, ezInt64 iEnd, ezInt64 iResetTime)
+{
+  return ezMath::Max<ezInt64>(0, iEnd - ezMath::Max(iBegin, iResetTime));
+}
+
 static const char* GenerateThreadName(ezWorkerThreadType::Enum ThreadType, ezUInt32 uiThreadNumber)
 {
   static ezStringBuilder sTemp;
@@ -18,6 +29,12 @@ ezTaskWorkerThread::ezTaskWorkerThread(ezWorkerThreadType::Enum ThreadType, ezUI
 {
   m_WorkerType = ThreadType;
   m_uiWorkerThreadNumber = uiThreadNumber & 0xFFFF;
+  m_iStartTime = GetStatisticsTime();
+
+  if (m_WorkerType == ezWorkerThreadType::ShortTasks)
+  {
+    m_pLocalQueues = EZ_DEFAULT_NEW(ezTaskWorkStealingQueues);
+  }
 }
 
 ezTaskWorkerThread::~ezTaskWorkerThread() = default;
@@ -47,6 +64,10 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
+  tl_TaskWorkerInfo.m_pWorkerThread = this;
+  tl_TaskWorkerInfo.m_pStatistics = &m_TaskStatistics;
+  tl_TaskWorkerInfo.m_pLocalQueues = m_pLocalQueues.Borrow();
+  tl_TaskWorkerInfo.m_uiNextStealVictim = m_uiWorkerThreadNumber + 1;
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
@@ -98,7 +119,15 @@ void ezTaskWorkerThread::WaitForWork()
 
   m_ThreadActiveTime += ezTime::Now() - m_StartedWorkingTime;
   m_bExecutingTask = false;
+
+  const ezInt64 iIdleSince = GetStatisticsTime();
+  m_iIdleSince = iIdleSince;
+
   m_WakeUpSignal.WaitForSignal();
+
+  m_iIdleSince = 0;
+  m_iIdleTime.Add(GetStatisticsInterval(iIdleSince, GetStatisticsTime(), ezTaskSystem::s_State->m_iStatisticsResetTime));
+
   EZ_ASSERT_DEBUG(m_WorkerState == (int)ezTaskWorkerState::Active, "Worker state should have been reset to 'active'");
 }
 
@@ -145,5 +174,83 @@ double ezTaskWorkerThread::GetThreadUtilization(ezUInt32* pNumTasksExecuted /*=
   return m_fLastThreadUtilization;
 }
 
+void ezTaskWorkerThread::GetStatistics(ezTaskWorkerStatistics& out_Statistics, ezInt64 iNow, ezInt64 iResetTime) const
+{
+  // an interval that is still in progress counts up to now
+  ezInt64 iIdle = m_iIdleTime;
+  if (const ezInt64 iIdleSince = m_iIdleSince; iIdleSince != 0)
+  {
+    iIdle += GetStatisticsInterval(iIdleSince, iNow, iResetTime);
+  }
+
+  ezInt64 iBlocked = m_iBlockedTime;
+  if (const ezInt64 iBlockedSince = m_iBlockedSince; iBlockedSince != 0)
+  {
+    iBlocked += GetStatisticsInterval(iBlockedSince, iNow, iResetTime);
+  }
+
+  // whatever time was not spent idle or blocked, the thread was active
+  const ezInt64 iTotal = GetStatisticsInterval(m_iStartTime, iNow, iResetTime);
+  const ezInt64 iActive = ezMath::Max<ezInt64>(0, iTotal - iIdle - iBlocked);
+
+  out_Statistics.m_WorkerType = m_WorkerType;
+  out_Statistics.m_uiWorkerIndex = m_uiWorkerThreadNumber;
+  out_Statistics.m_uiNumTasksExecuted = static_cast<ezUInt64>(m_iTotalTasksExecuted);
+  out_Statistics.m_ActiveTime = ezTime::Nanoseconds(static_cast<double>(iActive));
+  out_Statistics.m_IdleTime = ezTime::Nanoseconds(static_cast<double>(iIdle));
+  out_Statistics.m_BlockedTime = ezTime::Nanoseconds(static_cast<double>(iBlocked));
+}
+
+void ezTaskWorkerThread::ResetStatistics()
+{
+  // intervals that are in progress are clamped to the reset time, so only the accumulated values need to be reset
+  m_iIdleTime = 0;
+  m_iBlockedTime = 0;
+  m_iTotalTasksExecuted = 0;
+  m_TaskStatistics.Reset();
+}
+
+void ezTaskWorkerThread::BeginBlocked()
+{
+  m_iBlockedSince = GetStatisticsTime();
+}
+
+void ezTaskWorkerThread::EndBlocked()
+{
+  const ezInt64 iBlockedSince = m_iBlockedSince.Set(0);
+  m_iBlockedTime.Add(GetStatisticsInterval(iBlockedSince, GetStatisticsTime(), ezTaskSystem::s_State->m_iStatisticsResetTime));
+}
+
+void ezTaskThreadStatistics::TaskExecuted(ezTaskPriority::Enum priority, ezInt64 iQueueLatencyTicks, ezInt64 iExecutionTicks)
+{
+  m_iNumTasksExecuted[priority].Increment();
+  m_iTotalQueueLatency[priority].Add(iQueueLatencyTicks);
+  m_iMaxQueueLatency[priority].Max(iQueueLatencyTicks);
+  m_iTotalExecutionTime[priority].Add(iExecutionTicks);
+}
+
+void ezTaskThreadStatistics::Accumulate(const ezTaskThreadStatistics& other)
+{
+  for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+  {
+    m_iNumGroupsStarted[prio].Add(other.m_iNumGroupsStarted[prio]);
+    m_iNumTasksExecuted[prio].Add(other.m_iNumTasksExecuted[prio]);
+    m_iTotalQueueLatency[prio].Add(other.m_iTotalQueueLatency[prio]);
+    m_iMaxQueueLatency[prio].Max(other.m_iMaxQueueLatency[prio]);
+    m_iTotalExecutionTime[prio].Add(other.m_iTotalExecutionTime[prio]);
+  }
+}
+
+void ezTaskThreadStatistics::Reset()
+{
+  for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+  {
+    m_iNumGroupsStarted[prio] = 0;
+    m_iNumTasksExecuted[prio] = 0;
+    m_iTotalQueueLatency[prio] = 0;
+    m_iMaxQueueLatency[prio] = 0;
+    m_iTotalExecutionTime[prio] = 0;
+  }
+}
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkerThread);
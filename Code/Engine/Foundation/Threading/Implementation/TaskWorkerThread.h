@@ -5,6 +5,28 @@
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
 
+struct ezTaskWorkStealingQueues;
+
+/// \internal The per priority task statistics that one thread accumulates, merged by ezTaskSystem::GetStatistics().
+///
+/// The values are atomic, because they are read and reset from other threads, but usually only one thread modifies them.
+/// All times are in ticks of ezProfilingSystem::GetTicks().
+struct ezTaskThreadStatistics
+{
+  ezAtomicInteger64 m_iNumGroupsStarted[ezTaskPriority::ENUM_COUNT];
+  ezAtomicInteger64 m_iNumTasksExecuted[ezTaskPriority::ENUM_COUNT];
+  ezAtomicInteger64 m_iTotalQueueLatency[ezTaskPriority::ENUM_COUNT];
+  ezAtomicInteger64 m_iMaxQueueLatency[ezTaskPriority::ENUM_COUNT];
+  ezAtomicInteger64 m_iTotalExecutionTime[ezTaskPriority::ENUM_COUNT];
+
+  void TaskExecuted(ezTaskPriority::Enum priority, ezInt64 iQueueLatencyTicks, ezInt64 iExecutionTicks);
+
+  /// \brief Adds the values of \a other to this one.
+  void Accumulate(const ezTaskThreadStatistics& other);
+
+  void Reset();
+};
+
 /// \internal Internal task worker thread class.
 class ezTaskWorkerThread final : public ezThread
 {
@@ -53,6 +75,39 @@ private:
 
   ///@}
 
+  /// \name Statistics
+  ///@{
+
+public:
+  /// \brief Fills out how much time this thread spent in each state since the statistics were reset, see ezTaskSystem::GetStatistics().
+  void GetStatistics(ezTaskWorkerStatistics& out_Statistics, ezInt64 iNow, ezInt64 iResetTime) const;
+
+  /// \brief Resets the accumulated times and the number of executed tasks.
+  void ResetStatistics();
+
+  /// \brief Called by the task system for every task that this thread executed, including those executed while waiting.
+  void TaskExecuted() { m_iTotalTasksExecuted.Increment(); }
+
+  /// \brief The per priority statistics of the tasks that this thread started and executed.
+  const ezTaskThreadStatistics& GetTaskStatistics() const { return m_TaskStatistics; }
+
+  /// \brief Called by the task system when this thread starts and stops waiting for something, without helping with other tasks.
+  void BeginBlocked();
+  void EndBlocked();
+
+private:
+  // All times are in nanoseconds, as returned by ezTime::Now(). The 'since' values are zero while the thread is not in that state.
+  ezAtomicInteger64 m_iStartTime;
+  ezAtomicInteger64 m_iIdleTime;
+  ezAtomicInteger64 m_iIdleSince;
+  ezAtomicInteger64 m_iBlockedTime;
+  ezAtomicInteger64 m_iBlockedSince;
+  ezAtomicInteger64 m_iTotalTasksExecuted;
+
+  ezTaskThreadStatistics m_TaskStatistics;
+
+  ///@}
+
   /// \name Idle State
   ///@{
 
@@ -77,6 +132,18 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Work Stealing
+  ///@{
+
+public:
+  /// \brief Returns the work-stealing queues of this thread. Only short task workers have them, for all others this returns nullptr.
+  ezTaskWorkStealingQueues* GetLocalQueues() const { return m_pLocalQueues.Borrow(); }
+
+private:
+  ezUniquePtr<ezTaskWorkStealingQueues> m_pLocalQueues;
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -87,6 +154,10 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkerThread* m_pWorkerThread = nullptr;
+  ezTaskThreadStatistics* m_pStatistics = nullptr;
+  ezTaskWorkStealingQueues* m_pLocalQueues = nullptr;
+  ezUInt32 m_uiNextStealVictim = 0;
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
@@ -1,5 +1,6 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Logging/Log.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/Thread.h>
 
@@ -58,6 +59,7 @@ ezUInt32 RunThread(ezThread* pThread)
   pThread->m_ThreadStatus = ezThread::Finished;
 
   ezProfilingSystem::RemoveThread();
+  ezGlobalLog::RemoveThread();
 
   return uiReturnCode;
 }
@@ -76,9 +76,16 @@ public:
     ezTask* m_pTask = nullptr;
     ezTaskGroup* m_pBelongsToGroup = nullptr;
     ezUInt32 m_uiInvocation = 0;
+    ezUInt64 m_uiEnqueueTicks = 0; ///< When the task was queued in ezProfilingSystem::GetTicks(), used for the queue latency statistics.
   };
 
 private:
+  /// \brief Pops a task of the given priority from the work-stealing queue of this thread, or steals one from another thread.
+  static bool TakeStealableTask(ezUInt32 uiPriority, TaskData& out_td);
+
+  /// \brief Returns whether any task of priority between \a FirstPriority and \a LastPriority (inclusive) is currently queued.
+  static bool HasQueuedTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
   /// \brief Searches for a task of priority between \a FirstPriority and \a LastPriority (inclusive).
   static TaskData GetNextTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
@@ -178,7 +185,9 @@ public:
   /// \brief Sets the number of threads to use for the different task categories.
   ///
   /// \a uiShortTasks and \a uiLongTasks must be at least 1 and should not exceed the number of available CPU cores.
-  /// There will always be exactly one additional thread for file access tasks (ezTaskPriority::FileAccess).
+  /// \a iFileAccessTasks is the number of threads for file access tasks (ezTaskPriority::FileAccess). By default this is exactly one
+  /// thread, such that all file accesses are sequential. On storage that handles many requests well (e.g. SSDs) more threads allow
+  /// several files to be read in parallel, for example by the resource manager.
   ///
   /// If \a uiShortTasks or \a uiLongTasks is smaller than 1, a default number of threads will be used for that type of work.
   /// This number of threads depends on the number of available CPU cores.
@@ -186,7 +195,7 @@ public:
   /// this default configuration.
   /// Unless you have a good idea how to set up the number of worker threads to make good use of the available cores,
   /// it is a good idea to just use the default settings.
-  static void SetWorkerThreadCount(ezInt8 iShortTasks = -1, ezInt8 iLongTasks = -1); // [tested]
+  static void SetWorkerThreadCount(ezInt8 iShortTasks = -1, ezInt8 iLongTasks = -1, ezInt8 iFileAccessTasks = -1); // [tested]
 
   /// \brief Returns the maximum number of threads that should work on the given type of task at the same time.
   static ezUInt32 GetWorkerThreadCount(ezWorkerThreadType::Enum type);
@@ -207,6 +216,37 @@ public:
   /// Also optionally returns the number of tasks that were finished during the last frame.
   static double GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted = nullptr);
 
+  /// \brief Returns statistics about the executed tasks and the worker threads since the last call to ResetStatistics().
+  ///
+  /// For every priority this reports how many groups and task invocations were executed, how long they waited in the queue and how long
+  /// they took. For every allocated worker thread it reports how much time it spent active, idle and blocked.
+  /// Use this to decide on the number of worker threads (see SetWorkerThreadCount()) and on how much work to put into each task.
+  /// Worker threads that were shut down in the mean time, e.g. by SetWorkerThreadCount(), are not included in the worker statistics.
+  ///
+  /// The data that the task system records for this is very cheap, it is always collected.
+  static void GetStatistics(ezTaskSystemStatistics& out_Statistics); // [tested]
+
+  /// \brief Resets all statistics that are returned by GetStatistics().
+  static void ResetStatistics(); // [tested]
+
+  /// \brief Enables or disables work stealing for short tasks. It is disabled by default.
+  ///
+  /// When enabled, tasks of priority 'EarlyThisFrame' to 'LateThisFrame' that are flagged as ezTaskNesting::Never are not put into the
+  /// global task lists, but into a lock-free queue that is owned by the thread that started them (the main thread or a short task worker).
+  /// The owner takes the most recent tasks from its queue, idle short task workers steal the oldest ones from the other threads.
+  /// Picking such a task therefore never needs to lock the task system mutex, which reduces contention with many worker threads
+  /// and ParallelFor heavy workloads.
+  ///
+  /// All other tasks, and tasks started from threads that are not managed by the ezTaskSystem, still go through the global lists.
+  /// Priorities are respected either way, but within one priority the order of execution is not FIFO anymore.
+  /// Tasks in work-stealing queues cannot be removed by CancelTask(), they are skipped once a worker picks them up.
+  ///
+  /// This can be switched at any time, tasks that were already queued are executed either way.
+  static void SetWorkStealingEnabled(bool bEnable); // [tested]
+
+  /// \brief Returns whether work stealing is enabled. See SetWorkStealingEnabled().
+  static bool IsWorkStealingEnabled(); // [tested]
+
 private:
   friend class ezTaskWorkerThread;
 
@@ -222,6 +262,9 @@ private:
   /// \brief Uses a thread local variable to know the current thread type and to decide the range of task priorities that it may execute
   static void DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority);
 
+  /// \brief Returns the statistics that the calling thread accumulates. All threads that are not workers of the task system share one set.
+  static ezTaskThreadStatistics& GetThreadStatistics();
+
 private:
   static ezUniquePtr<ezTaskSystemThreadState> s_ThreadState;
 
@@ -255,10 +298,36 @@ public:
   template <typename ElemType, typename Callback>
   static void ParallelForSingleIndex(ezArrayPtr<ElemType> taskItems, Callback taskCallback, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
 
+  /// A helper function to combine all task items into a single result in a parallel fashion.
+  ///
+  /// Each task invocation folds its slice of the items into a partial result, starting with \a identity:
+  ///   - partial = foldCallback(partial, taskItem), with the signature ResultType(const ResultType&, const ElemType&)
+  ///
+  /// The partial results are then combined in order on the calling thread:
+  ///   - result = combineCallback(result, partial), with the signature ResultType(const ResultType&, const ResultType&)
+  ///
+  /// The operation must be associative and \a identity must not change a result when combined with it (e.g. 0 for sums).
+  /// The items are always split into the same slices for the same number of items and workers, so the result is deterministic,
+  /// even for floating point math.
+  template <typename ElemType, typename ResultType, typename FoldCallback, typename CombineCallback>
+  static ResultType ParallelReduce(ezArrayPtr<ElemType> taskItems, const ResultType& identity, FoldCallback foldCallback, CombineCallback combineCallback, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams()); // [tested]
+
+  /// A helper function to compute all prefix 'sums' of the task items in a parallel fashion.
+  ///
+  /// Writes the combination of taskItems[0] to taskItems[i] into out_Results[i] (for ezParallelScanMode::Inclusive),
+  /// or the combination of taskItems[0] to taskItems[i - 1] (for ezParallelScanMode::Exclusive).
+  /// \a foldCallback and \a combineCallback have the same meaning and the same requirements as for ParallelReduce().
+  /// This runs in two parallel passes over the items, one to compute the partial result of each slice and one to write the results.
+  template <typename ElemType, typename ResultType, typename FoldCallback, typename CombineCallback>
+  static void ParallelScan(ezArrayPtr<ElemType> taskItems, ezArrayPtr<ResultType> out_Results, const ResultType& identity, FoldCallback foldCallback, CombineCallback combineCallback, ezParallelScanMode mode = ezParallelScanMode::Inclusive, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams()); // [tested]
+
 private:
   template <typename ElemType>
   static void ParallelForInternal(ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config);
 
+  /// Implements ezParallelForSplitting::Adaptive for all the ParallelFor variants.
+  static void ParallelForAdaptive(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, const ezParallelForIndexedFunction& taskCallback, const char* taskName, const ezParallelForParams& params);
+
   ///@}
 
   /// \name Utilities
@@ -286,10 +355,16 @@ public:
 
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystem);
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, TaskSystemMetrics);
 
   static void Startup();
   static void Shutdown();
 
+  /// \brief Registers the metrics that FinishFrameTasks() updates. Done by a separate subsystem, since ezMetrics shuts down before the task system.
+  static void RegisterMetrics();
+  static void UnregisterMetrics();
+  static void UpdateMetrics();
+
 private:
   /// One mutex to rule them all.
   static ezMutex s_TaskSystemMutex;
@@ -42,6 +42,14 @@
 #  define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
 #endif
 
+#ifdef BUILDSYSTEM_USE_ALLOCATION_SAMPLING
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+#else
+#  undef EZ_USE_ALLOCATION_SAMPLING
+#  define EZ_USE_ALLOCATION_SAMPLING EZ_OFF
+#endif
+
 
 
 #if !defined(BUILDSYSTEM_IGNORE_USERCONFIG_HEADER)
@@ -79,4 +87,13 @@
 //#undef EZ_USE_GUARDED_ALLOCATIONS
 //#define EZ_USE_GUARDED_ALLOCATIONS EZ_ON
 
+// Uncomment to track a random sample of all allocations (see ezMemoryTracker::SetSamplingInterval). This is cheap enough for release
+// builds, where EZ_USE_ALLOCATION_TRACKING is too slow, and can be combined with it.
+//#undef EZ_USE_ALLOCATION_SAMPLING
+//#define EZ_USE_ALLOCATION_SAMPLING EZ_ON
+
+// Uncomment to serve small allocations of the default allocator from thread-local pools (see ezPoolAllocation) instead of the CRT heap.
+//#undef EZ_USE_POOL_ALLOCATIONS
+//#define EZ_USE_POOL_ALLOCATIONS EZ_ON
+
 #endif
@@ -0,0 +1,692 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Communication/Telemetry.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/JSONWriter.h>
+#include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
+#include <Foundation/Utilities/Metrics.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, Metrics)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "FileSystem"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezMetrics::Shutdown();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+namespace
+{
+  enum
+  {
+    // Threads are assigned to the shards round robin. More threads than shards is fine, they just share some cache lines then.
+    NUM_SHARDS = 8,
+
+    // Histogram buckets: the values 0 to 7 get a bucket each, every power of two above that is split into 8 buckets.
+    // Values of 2^48 and above all go into the last bucket, that is more than three days in nanoseconds.
+    SUB_BUCKET_BITS = 3,
+    NUM_SUB_BUCKETS = 1 << SUB_BUCKET_BITS,
+    MAX_EXPONENT = 47,
+    NUM_BUCKETS = NUM_SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * NUM_SUB_BUCKETS,
+  };
+
+  static ezAtomicInteger32 s_iNextShard;
+  static thread_local ezUInt32 s_uiShardIndex = 0xFFFFFFFF;
+
+  EZ_ALWAYS_INLINE ezUInt32 GetShardIndex()
+  {
+    if (s_uiShardIndex == 0xFFFFFFFF)
+    {
+      s_uiShardIndex = static_cast<ezUInt32>(s_iNextShard.Increment()) % NUM_SHARDS;
+    }
+
+    return s_uiShardIndex;
+  }
+
+  ezUInt32 FirstBitHigh64(ezUInt64 uiValue)
+  {
+    const ezUInt32 uiHigh = static_cast<ezUInt32>(uiValue >> 32);
+    return uiHigh != 0 ? 32 + ezMath::FirstBitHigh(uiHigh) : ezMath::FirstBitHigh(static_cast<ezUInt32>(uiValue));
+  }
+
+  ezUInt32 GetBucketIndex(ezUInt64 uiValue)
+  {
+    if (uiValue < NUM_SUB_BUCKETS)
+      return static_cast<ezUInt32>(uiValue);
+
+    const ezUInt32 uiExponent = FirstBitHigh64(uiValue);
+    if (uiExponent > MAX_EXPONENT)
+      return NUM_BUCKETS - 1;
+
+    const ezUInt32 uiSubBucket = static_cast<ezUInt32>(uiValue >> (uiExponent - SUB_BUCKET_BITS)) & (NUM_SUB_BUCKETS - 1);
+    return NUM_SUB_BUCKETS + (uiExponent - SUB_BUCKET_BITS) * NUM_SUB_BUCKETS + uiSubBucket;
+  }
+
+  /// Returns the smallest value of the bucket and the number of values that fall into it.
+  void GetBucketRange(ezUInt32 uiBucket, ezUInt64& out_uiFirstValue, ezUInt64& out_uiNumValues)
+  {
+    if (uiBucket < NUM_SUB_BUCKETS)
+    {
+      out_uiFirstValue = uiBucket;
+      out_uiNumValues = 1;
+      return;
+    }
+
+    const ezUInt32 uiShift = (uiBucket - NUM_SUB_BUCKETS) / NUM_SUB_BUCKETS;
+    const ezUInt32 uiSubBucket = (uiBucket - NUM_SUB_BUCKETS) % NUM_SUB_BUCKETS;
+
+    out_uiFirstValue = static_cast<ezUInt64>(NUM_SUB_BUCKETS + uiSubBucket) << uiShift;
+    out_uiNumValues = 1ull << uiShift;
+  }
+
+  double GetBucketCenter(ezUInt32 uiBucket)
+  {
+    ezUInt64 uiFirstValue, uiNumValues;
+    GetBucketRange(uiBucket, uiFirstValue, uiNumValues);
+    return static_cast<double>(uiFirstValue) + static_cast<double>(uiNumValues - 1) * 0.5;
+  }
+
+  double GetBucketMax(ezUInt32 uiBucket)
+  {
+    ezUInt64 uiFirstValue, uiNumValues;
+    GetBucketRange(uiBucket, uiFirstValue, uiNumValues);
+    return static_cast<double>(uiFirstValue + uiNumValues - 1);
+  }
+
+  double GetPercentile(const ezDynamicArray<ezUInt64>& buckets, ezUInt64 uiCount, double fPercentile)
+  {
+    if (uiCount == 0)
+      return 0.0;
+
+    // the rank of the value that is returned, at least 1
+    const ezUInt64 uiRank = ezMath::Max<ezUInt64>(1, static_cast<ezUInt64>(ezMath::Ceil(fPercentile * static_cast<double>(uiCount))));
+
+    ezUInt64 uiSeen = 0;
+    for (ezUInt32 i = 0; i < buckets.GetCount(); ++i)
+    {
+      uiSeen += buckets[i];
+
+      if (uiSeen >= uiRank)
+        return GetBucketCenter(i);
+    }
+
+    return GetBucketCenter(buckets.GetCount() - 1);
+  }
+
+  struct MetricEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    enum class Type
+    {
+      Counter,
+      Gauge,
+      Histogram,
+    };
+
+    Type m_Type;
+    ezUInt32 m_uiIndex;
+  };
+} // namespace
+
+namespace ezInternal
+{
+  struct EZ_ALIGN(MetricCounterShard, 64)
+  {
+    ezAtomicInteger64 m_iValue;
+  };
+
+  struct MetricCounterData
+  {
+    ezString m_sName;
+    MetricCounterShard m_Shards[NUM_SHARDS];
+  };
+
+  struct MetricGaugeData
+  {
+    ezString m_sName;
+    ezAtomicInteger64 m_iValueBits; // the bits of a double
+  };
+
+  struct EZ_ALIGN(MetricHistogramShard, 64)
+  {
+    ezAtomicInteger64 m_iSum;
+    ezAtomicInteger64 m_Buckets[NUM_BUCKETS];
+  };
+
+  struct MetricHistogramData
+  {
+    ezString m_sName;
+    MetricHistogramShard m_Shards[NUM_SHARDS];
+  };
+} // namespace ezInternal
+
+namespace
+{
+  static ezMutex s_MetricsMutex;
+  static ezHashTable<ezString, MetricEntry> s_MetricNames;
+  static ezDynamicArray<ezInternal::MetricCounterData*> s_Counters;
+  static ezDynamicArray<ezInternal::MetricGaugeData*> s_Gauges;
+  static ezDynamicArray<ezInternal::MetricHistogramData*> s_Histograms;
+
+  // The metric data is cache line aligned. It lives until shutdown, so it gets its own allocator instead of the shared aligned one.
+  static ezAlignedHeapAllocator* s_pMetricsAllocator = nullptr;
+
+  ezAllocatorBase* GetMetricsAllocator()
+  {
+    if (s_pMetricsAllocator == nullptr)
+    {
+      s_pMetricsAllocator = EZ_DEFAULT_NEW(ezAlignedHeapAllocator, "Metrics");
+    }
+
+    return s_pMetricsAllocator;
+  }
+
+  ezInt64 DoubleToBits(double fValue)
+  {
+    ezInt64 iBits;
+    ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&iBits), reinterpret_cast<const ezUInt8*>(&fValue), sizeof(double));
+    return iBits;
+  }
+
+  double BitsToDouble(ezInt64 iBits)
+  {
+    double fValue;
+    ezMemoryUtils::Copy(reinterpret_cast<ezUInt8*>(&fValue), reinterpret_cast<const ezUInt8*>(&iBits), sizeof(double));
+    return fValue;
+  }
+
+  /// Returns the index of the existing metric with the given name, or ezInvalidIndex if a new one has to be created.
+  /// Returns EZ_FAILURE if the name is used by another type of metric.
+  ezResult FindMetric(const char* szName, MetricEntry::Type type, ezUInt32& out_uiIndex)
+  {
+    out_uiIndex = ezInvalidIndex;
+
+    MetricEntry entry;
+    if (!s_MetricNames.TryGetValue(szName, entry))
+      return EZ_SUCCESS;
+
+    if (entry.m_Type != type)
+    {
+      ezLog::Error("The metric '{}' is already registered with a different type", szName);
+      return EZ_FAILURE;
+    }
+
+    out_uiIndex = entry.m_uiIndex;
+    return EZ_SUCCESS;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezMetricCounter::Add(ezInt64 iValue)
+{
+  if (m_pData != nullptr)
+  {
+    m_pData->m_Shards[GetShardIndex()].m_iValue.Add(iValue);
+  }
+}
+
+ezInt64 ezMetricCounter::GetValue() const
+{
+  if (m_pData == nullptr)
+    return 0;
+
+  ezInt64 iSum = 0;
+  for (ezUInt32 i = 0; i < NUM_SHARDS; ++i)
+  {
+    iSum += m_pData->m_Shards[i].m_iValue;
+  }
+
+  return iSum;
+}
+
+void ezMetricGauge::Set(double fValue)
+{
+  if (m_pData != nullptr)
+  {
+    m_pData->m_iValueBits = DoubleToBits(fValue);
+  }
+}
+
+void ezMetricGauge::Add(double fValue)
+{
+  if (m_pData == nullptr)
+    return;
+
+  ezInt64 iExpected = m_pData->m_iValueBits;
+  while (true)
+  {
+    const ezInt64 iPrevious = m_pData->m_iValueBits.CompareAndSwap(iExpected, DoubleToBits(BitsToDouble(iExpected) + fValue));
+    if (iPrevious == iExpected)
+      return;
+
+    iExpected = iPrevious;
+  }
+}
+
+double ezMetricGauge::GetValue() const
+{
+  return m_pData != nullptr ? BitsToDouble(m_pData->m_iValueBits) : 0.0;
+}
+
+void ezMetricHistogram::Record(ezUInt64 uiValue)
+{
+  if (m_pData != nullptr)
+  {
+    ezInternal::MetricHistogramShard& shard = m_pData->m_Shards[GetShardIndex()];
+    shard.m_Buckets[GetBucketIndex(uiValue)].Increment();
+    shard.m_iSum.Add(static_cast<ezInt64>(uiValue));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResult ezMetricsSnapshot::WriteJSON(ezStreamWriter& stream) const
+{
+  ezStandardJSONWriter writer;
+  writer.SetWhitespaceMode(ezJSONWriter::WhitespaceMode::None);
+  writer.SetOutputStream(&stream);
+
+  writer.BeginObject();
+  writer.AddVariableDouble("timestamp", m_Timestamp.GetSeconds());
+  writer.AddVariableDouble("period", m_Period.GetSeconds());
+
+  writer.BeginObject("counters");
+  for (const Counter& counter : m_Counters)
+  {
+    writer.AddVariableInt64(counter.m_sName, counter.m_iValue);
+  }
+  writer.EndObject();
+
+  writer.BeginObject("gauges");
+  for (const Gauge& gauge : m_Gauges)
+  {
+    writer.AddVariableDouble(gauge.m_sName, gauge.m_fValue);
+  }
+  writer.EndObject();
+
+  writer.BeginObject("histograms");
+  for (const Histogram& histogram : m_Histograms)
+  {
+    writer.BeginObject(histogram.m_sName);
+    writer.AddVariableUInt64("count", histogram.m_uiCount);
+    writer.AddVariableDouble("mean", histogram.m_fMean);
+    writer.AddVariableDouble("p50", histogram.m_fP50);
+    writer.AddVariableDouble("p90", histogram.m_fP90);
+    writer.AddVariableDouble("p99", histogram.m_fP99);
+    writer.AddVariableDouble("max", histogram.m_fMax);
+    writer.EndObject();
+  }
+  writer.EndObject();
+
+  writer.EndObject();
+
+  if (writer.HadWriteError())
+    return EZ_FAILURE;
+
+  // one snapshot per line, so that a file can simply be appended to
+  return stream.WriteBytes("\n", 1);
+}
+
+void ezMetricsSnapshot::SendTelemetry() const
+{
+  if (!ezTelemetry::IsConnectedToClient())
+    return;
+
+  // uses the same messages as ezStats, so that tools display the metrics along with the stats
+  auto SendValue = [this](const char* szName, const ezVariant& value) {
+    ezTelemetryMessage msg;
+    msg.SetMessageID('STAT', ' SET');
+    msg.GetWriter() << szName;
+    msg.GetWriter() << value;
+    msg.GetWriter() << m_Timestamp;
+
+    ezTelemetry::Broadcast(ezTelemetry::Unreliable, msg);
+  };
+
+  for (const Counter& counter : m_Counters)
+  {
+    SendValue(counter.m_sName, counter.m_iValue);
+  }
+
+  for (const Gauge& gauge : m_Gauges)
+  {
+    SendValue(gauge.m_sName, gauge.m_fValue);
+  }
+
+  ezStringBuilder sName;
+  for (const Histogram& histogram : m_Histograms)
+  {
+    sName.Set(histogram.m_sName, "/count");
+    SendValue(sName, histogram.m_uiCount);
+    sName.Set(histogram.m_sName, "/p50");
+    SendValue(sName, histogram.m_fP50);
+    sName.Set(histogram.m_sName, "/p90");
+    SendValue(sName, histogram.m_fP90);
+    sName.Set(histogram.m_sName, "/p99");
+    SendValue(sName, histogram.m_fP99);
+    sName.Set(histogram.m_sName, "/max");
+    SendValue(sName, histogram.m_fMax);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezMetricCounter ezMetrics::RegisterCounter(const char* szName)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricCounter handle;
+
+  ezUInt32 uiIndex;
+  if (FindMetric(szName, MetricEntry::Type::Counter, uiIndex).Failed())
+    return handle;
+
+  if (uiIndex == ezInvalidIndex)
+  {
+    uiIndex = s_Counters.GetCount();
+
+    ezInternal::MetricCounterData* pData = EZ_NEW(GetMetricsAllocator(), ezInternal::MetricCounterData);
+    pData->m_sName = szName;
+    s_Counters.PushBack(pData);
+    MetricEntry entry;
+    entry.m_Type = MetricEntry::Type::Counter;
+    entry.m_uiIndex = uiIndex;
+    s_MetricNames.Insert(szName, entry);
+  }
+
+  handle.m_pData = s_Counters[uiIndex];
+  return handle;
+}
+
+ezMetricGauge ezMetrics::RegisterGauge(const char* szName)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricGauge handle;
+
+  ezUInt32 uiIndex;
+  if (FindMetric(szName, MetricEntry::Type::Gauge, uiIndex).Failed())
+    return handle;
+
+  if (uiIndex == ezInvalidIndex)
+  {
+    uiIndex = s_Gauges.GetCount();
+
+    ezInternal::MetricGaugeData* pData = EZ_DEFAULT_NEW(ezInternal::MetricGaugeData);
+    pData->m_sName = szName;
+    pData->m_iValueBits = DoubleToBits(0.0);
+    s_Gauges.PushBack(pData);
+    MetricEntry entry;
+    entry.m_Type = MetricEntry::Type::Gauge;
+    entry.m_uiIndex = uiIndex;
+    s_MetricNames.Insert(szName, entry);
+  }
+
+  handle.m_pData = s_Gauges[uiIndex];
+  return handle;
+}
+
+ezMetricHistogram ezMetrics::RegisterHistogram(const char* szName)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricHistogram handle;
+
+  ezUInt32 uiIndex;
+  if (FindMetric(szName, MetricEntry::Type::Histogram, uiIndex).Failed())
+    return handle;
+
+  if (uiIndex == ezInvalidIndex)
+  {
+    uiIndex = s_Histograms.GetCount();
+
+    ezInternal::MetricHistogramData* pData = EZ_NEW(GetMetricsAllocator(), ezInternal::MetricHistogramData);
+    pData->m_sName = szName;
+    s_Histograms.PushBack(pData);
+    MetricEntry entry;
+    entry.m_Type = MetricEntry::Type::Histogram;
+    entry.m_uiIndex = uiIndex;
+    s_MetricNames.Insert(szName, entry);
+  }
+
+  handle.m_pData = s_Histograms[uiIndex];
+  return handle;
+}
+
+void ezMetrics::TakeSnapshot(ezMetricsSnapshot& out_Snapshot, const ezMetricsSnapshot* pPrevious /*= nullptr*/)
+{
+  out_Snapshot.m_Timestamp = ezTime::Now();
+  out_Snapshot.m_Period = pPrevious != nullptr ? out_Snapshot.m_Timestamp - pPrevious->m_Timestamp : ezTime::Zero();
+
+  // metrics are never removed, so only the arrays need to be protected
+  EZ_LOCK(s_MetricsMutex);
+
+  out_Snapshot.m_Counters.SetCount(s_Counters.GetCount());
+  for (ezUInt32 i = 0; i < s_Counters.GetCount(); ++i)
+  {
+    ezMetricCounter handle;
+    handle.m_pData = s_Counters[i];
+
+    out_Snapshot.m_Counters[i].m_sName = s_Counters[i]->m_sName;
+    out_Snapshot.m_Counters[i].m_iValue = handle.GetValue();
+  }
+
+  out_Snapshot.m_Gauges.SetCount(s_Gauges.GetCount());
+  for (ezUInt32 i = 0; i < s_Gauges.GetCount(); ++i)
+  {
+    out_Snapshot.m_Gauges[i].m_sName = s_Gauges[i]->m_sName;
+    out_Snapshot.m_Gauges[i].m_fValue = BitsToDouble(s_Gauges[i]->m_iValueBits);
+  }
+
+  ezDynamicArray<ezUInt64> periodBuckets;
+
+  out_Snapshot.m_Histograms.SetCount(s_Histograms.GetCount());
+  for (ezUInt32 i = 0; i < s_Histograms.GetCount(); ++i)
+  {
+    const ezInternal::MetricHistogramData* pData = s_Histograms[i];
+    ezMetricsSnapshot::Histogram& histogram = out_Snapshot.m_Histograms[i];
+
+    histogram.m_sName = pData->m_sName;
+    histogram.m_TotalBuckets.SetCount(NUM_BUCKETS);
+    histogram.m_uiTotalSum = 0;
+
+    for (ezUInt32 s = 0; s < NUM_SHARDS; ++s)
+    {
+      histogram.m_uiTotalSum += static_cast<ezUInt64>(pData->m_Shards[s].m_iSum);
+
+      for (ezUInt32 b = 0; b < NUM_BUCKETS; ++b)
+      {
+        histogram.m_TotalBuckets[b] += static_cast<ezUInt64>(pData->m_Shards[s].m_Buckets[b]);
+      }
+    }
+
+    // histograms are only ever appended, so the same index refers to the same histogram in an older snapshot
+    const ezMetricsSnapshot::Histogram* pPrevHistogram = nullptr;
+    if (pPrevious != nullptr && i < pPrevious->m_Histograms.GetCount() && pPrevious->m_Histograms[i].m_TotalBuckets.GetCount() == NUM_BUCKETS)
+    {
+      pPrevHistogram = &pPrevious->m_Histograms[i];
+    }
+
+    periodBuckets = histogram.m_TotalBuckets;
+    ezUInt64 uiPeriodSum = histogram.m_uiTotalSum;
+
+    if (pPrevHistogram != nullptr)
+    {
+      // the bucket and the sum are not updated together, so a value may be counted in one snapshot and its sum in the next
+      uiPeriodSum -= ezMath::Min(uiPeriodSum, pPrevHistogram->m_uiTotalSum);
+
+      for (ezUInt32 b = 0; b < NUM_BUCKETS; ++b)
+      {
+        periodBuckets[b] -= ezMath::Min(periodBuckets[b], pPrevHistogram->m_TotalBuckets[b]);
+      }
+    }
+
+    histogram.m_uiCount = 0;
+    histogram.m_fMax = 0.0;
+    for (ezUInt32 b = 0; b < NUM_BUCKETS; ++b)
+    {
+      histogram.m_uiCount += periodBuckets[b];
+
+      if (periodBuckets[b] > 0)
+      {
+        histogram.m_fMax = GetBucketMax(b);
+      }
+    }
+
+    histogram.m_fMean = histogram.m_uiCount > 0 ? static_cast<double>(uiPeriodSum) / static_cast<double>(histogram.m_uiCount) : 0.0;
+    histogram.m_fP50 = GetPercentile(periodBuckets, histogram.m_uiCount, 0.5);
+    histogram.m_fP90 = GetPercentile(periodBuckets, histogram.m_uiCount, 0.9);
+    histogram.m_fP99 = GetPercentile(periodBuckets, histogram.m_uiCount, 0.99);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  /// Periodically takes a snapshot of all metrics and exports it.
+  class MetricsExporterThread : public ezThread
+  {
+  public:
+    MetricsExporterThread()
+      : ezThread("Metrics Exporter")
+    {
+    }
+
+    ezMetrics::ExporterSettings m_Settings;
+    ezFileWriter m_File;
+
+    volatile bool m_bKeepRunning = true;
+    ezThreadSignal m_WakeUp;
+
+    ezMetricsSnapshot m_PreviousSnapshot;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (m_bKeepRunning)
+      {
+        m_WakeUp.WaitForSignal(m_Settings.m_Interval);
+        Export();
+      }
+
+      m_File.Close();
+      return 0;
+    }
+
+    void Export()
+    {
+      ezMetricsSnapshot snapshot;
+      ezMetrics::TakeSnapshot(snapshot, &m_PreviousSnapshot);
+
+      if (!m_Settings.m_sOutputFile.IsEmpty())
+      {
+        snapshot.WriteJSON(m_File).IgnoreResult();
+        m_File.Flush().IgnoreResult();
+      }
+
+      if (m_Settings.m_bSendTelemetry)
+      {
+        snapshot.SendTelemetry();
+      }
+
+      m_PreviousSnapshot = std::move(snapshot);
+    }
+  };
+
+  static MetricsExporterThread* s_pExporterThread = nullptr;
+} // namespace
+
+ezResult ezMetrics::StartExporter(const ExporterSettings& settings)
+{
+  if (s_pExporterThread != nullptr)
+  {
+    ezLog::Error("The metrics exporter is already running");
+    return EZ_FAILURE;
+  }
+
+  MetricsExporterThread* pThread = EZ_DEFAULT_NEW(MetricsExporterThread);
+
+  if (!settings.m_sOutputFile.IsEmpty() && pThread->m_File.Open(settings.m_sOutputFile).Failed())
+  {
+    ezLog::Error("Failed to open '{}' for exporting metrics", settings.m_sOutputFile);
+    EZ_DEFAULT_DELETE(pThread);
+    return EZ_FAILURE;
+  }
+
+  pThread->m_Settings = settings;
+
+  // the first export covers the time from now on
+  TakeSnapshot(pThread->m_PreviousSnapshot);
+
+  s_pExporterThread = pThread;
+  s_pExporterThread->Start();
+
+  return EZ_SUCCESS;
+}
+
+void ezMetrics::StopExporter()
+{
+  if (s_pExporterThread == nullptr)
+    return;
+
+  // the thread exports one last snapshot when it wakes up
+  s_pExporterThread->m_bKeepRunning = false;
+  s_pExporterThread->m_WakeUp.RaiseSignal();
+  s_pExporterThread->Join();
+
+  EZ_DEFAULT_DELETE(s_pExporterThread);
+}
+
+bool ezMetrics::IsExporterRunning()
+{
+  return s_pExporterThread != nullptr;
+}
+
+void ezMetrics::Shutdown()
+{
+  StopExporter();
+
+  EZ_LOCK(s_MetricsMutex);
+
+  for (ezInternal::MetricCounterData* pData : s_Counters)
+  {
+    EZ_DELETE(s_pMetricsAllocator, pData);
+  }
+
+  for (ezInternal::MetricGaugeData* pData : s_Gauges)
+  {
+    EZ_DEFAULT_DELETE(pData);
+  }
+
+  for (ezInternal::MetricHistogramData* pData : s_Histograms)
+  {
+    EZ_DELETE(s_pMetricsAllocator, pData);
+  }
+
+  s_Counters.Clear();
+  s_Counters.Compact();
+  s_Gauges.Clear();
+  s_Gauges.Compact();
+  s_Histograms.Clear();
+  s_Histograms.Compact();
+  s_MetricNames.Clear();
+  s_MetricNames.Compact();
+
+  EZ_DEFAULT_DELETE(s_pMetricsAllocator);
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Utilities_Implementation_Metrics);
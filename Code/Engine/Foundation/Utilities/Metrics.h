@@ -0,0 +1,182 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Time/Time.h>
+
+class ezStreamWriter;
+
+namespace ezInternal
+{
+  struct MetricCounterData;
+  struct MetricGaugeData;
+  struct MetricHistogramData;
+} // namespace ezInternal
+
+/// \brief Handle to a counter that was registered through ezMetrics::RegisterCounter().
+///
+/// Counters only ever accumulate. Each thread adds to its own shard, so adding is a single uncontended atomic operation.
+/// A default constructed handle is invalid, all operations on it are ignored.
+class EZ_FOUNDATION_DLL ezMetricCounter
+{
+public:
+  void Add(ezInt64 iValue);
+  void Increment() { Add(1); }
+
+  /// \brief Sums up all shards. This is much more expensive than Add(), it is meant for exporting the value.
+  ezInt64 GetValue() const;
+
+  bool IsValid() const { return m_pData != nullptr; }
+
+private:
+  friend class ezMetrics;
+  ezInternal::MetricCounterData* m_pData = nullptr;
+};
+
+/// \brief Handle to a gauge that was registered through ezMetrics::RegisterGauge().
+///
+/// A gauge stores a single value that is overwritten, for example the number of loaded resources.
+class EZ_FOUNDATION_DLL ezMetricGauge
+{
+public:
+  void Set(double fValue);
+
+  /// \brief Atomically adds to the current value. Contended gauges should rather be counters.
+  void Add(double fValue);
+
+  double GetValue() const;
+
+  bool IsValid() const { return m_pData != nullptr; }
+
+private:
+  friend class ezMetrics;
+  ezInternal::MetricGaugeData* m_pData = nullptr;
+};
+
+/// \brief Handle to a histogram that was registered through ezMetrics::RegisterHistogram().
+///
+/// The values are sorted into fixed, logarithmically spaced buckets, with eight buckets per power of two.
+/// Percentiles are therefore only estimates, but their relative error is below 7%. Recording a value never allocates or locks.
+class EZ_FOUNDATION_DLL ezMetricHistogram
+{
+public:
+  void Record(ezUInt64 uiValue);
+
+  /// \brief Records the time in nanoseconds.
+  void RecordTime(ezTime time) { Record(time.IsPositive() ? static_cast<ezUInt64>(time.GetNanoseconds()) : 0); }
+
+  bool IsValid() const { return m_pData != nullptr; }
+
+private:
+  friend class ezMetrics;
+  ezInternal::MetricHistogramData* m_pData = nullptr;
+};
+
+/// \brief The values of all registered metrics at one point in time, see ezMetrics::TakeSnapshot().
+struct EZ_FOUNDATION_DLL ezMetricsSnapshot
+{
+  struct Counter
+  {
+    ezString m_sName;
+    ezInt64 m_iValue = 0;
+  };
+
+  struct Gauge
+  {
+    ezString m_sName;
+    double m_fValue = 0.0;
+  };
+
+  struct Histogram
+  {
+    ezString m_sName;
+
+    /// \brief The number of values and the statistics of the period that the snapshot covers.
+    ezUInt64 m_uiCount = 0;
+    double m_fMean = 0.0;
+    double m_fP50 = 0.0;
+    double m_fP90 = 0.0;
+    double m_fP99 = 0.0;
+    double m_fMax = 0.0;
+
+    /// \brief The bucket counts and the sum of all values since the histogram was registered.
+    ///
+    /// These are needed to compute the statistics of the next period.
+    ezDynamicArray<ezUInt64> m_TotalBuckets;
+    ezUInt64 m_uiTotalSum = 0;
+  };
+
+  /// \brief The ezTime::Now() value when the snapshot was taken.
+  ezTime m_Timestamp;
+
+  /// \brief The time span that the histogram statistics cover. Zero if they cover everything since registration.
+  ezTime m_Period;
+
+  ezDynamicArray<Counter> m_Counters;
+  ezDynamicArray<Gauge> m_Gauges;
+  ezDynamicArray<Histogram> m_Histograms;
+
+  /// \brief Writes the snapshot as a single line JSON object.
+  ezResult WriteJSON(ezStreamWriter& stream) const;
+
+  /// \brief Sends all values as ezStats compatible telemetry messages, so they show up in tools like ezInspector.
+  ///
+  /// Histograms are sent as several values, e.g. 'Name/p50' and 'Name/p99'.
+  void SendTelemetry() const;
+};
+
+/// \brief A registry of metrics that are cheap enough to be updated per frame or per entity, as a complement to ezStats.
+///
+/// Metrics are registered once by name and afterwards only accessed through their handles, which avoids any string lookups, locks or
+/// events when a value changes. Counters and histograms are sharded across threads, such that threads that update the same metric
+/// don't contend on the same cache line. Reading the values is comparatively expensive, it is done by TakeSnapshot() or the exporter.
+///
+/// Names may contain slashes to define groups, like ezStats names. Metrics cannot be unregistered, handles stay valid until shutdown.
+class EZ_FOUNDATION_DLL ezMetrics
+{
+public:
+  /// \brief Registers a counter or returns the existing one with the same name.
+  ///
+  /// Returns an invalid handle and logs an error, if the name is already used by a different type of metric.
+  static ezMetricCounter RegisterCounter(const char* szName);
+
+  /// \brief Registers a gauge or returns the existing one with the same name.
+  static ezMetricGauge RegisterGauge(const char* szName);
+
+  /// \brief Registers a histogram or returns the existing one with the same name.
+  static ezMetricHistogram RegisterHistogram(const char* szName);
+
+  /// \brief Reads the current values of all metrics.
+  ///
+  /// If \a pPrevious is given, the histogram statistics only cover the values that were recorded after \a pPrevious was taken.
+  /// Otherwise they cover all values since the histograms were registered. Counters and gauges always report their current value.
+  static void TakeSnapshot(ezMetricsSnapshot& out_Snapshot, const ezMetricsSnapshot* pPrevious = nullptr);
+
+  /// \brief Settings for StartExporter().
+  struct ExporterSettings
+  {
+    /// \brief How often a snapshot is taken. The histogram statistics of each snapshot cover this period.
+    ezTime m_Interval = ezTime::Seconds(1);
+
+    /// \brief If not empty, every snapshot is appended as one line of JSON to this file. This goes through ezFileSystem.
+    ezString m_sOutputFile;
+
+    /// \brief Whether every snapshot is sent through ezTelemetry.
+    bool m_bSendTelemetry = true;
+  };
+
+  /// \brief Starts a background thread that periodically exports snapshots. Fails if the exporter is already running or the file cannot be opened.
+  static ezResult StartExporter(const ExporterSettings& settings);
+
+  /// \brief Exports a final snapshot and stops the background thread.
+  static void StopExporter();
+
+  /// \brief Returns whether StartExporter() was called without a matching StopExporter().
+  static bool IsExporterRunning();
+
+private:
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, Metrics);
+
+  static void Shutdown();
+};
@@ -4,6 +4,7 @@
 
 #include <Foundation/Application/Application.h>
 #include <Foundation/Types/UniquePtr.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <GameEngine/Configuration/PlatformProfile.h>
 #include <GameEngine/Console/ConsoleFunction.h>
 #include <GameEngine/GameApplication/WindowOutputTargetBase.h>
@@ -269,5 +270,17 @@ protected:
   void UpdateFrameTime();
 
   ezTime m_FrameTime;
+
+  /// \brief Time spent in each phase of Run(), recorded every frame. Registered in AfterCoreSystemsStartup().
+  struct FrameMetrics
+  {
+    ezMetricHistogram m_Input;
+    ezMetricHistogram m_WorldUpdateAndRender;
+    ezMetricHistogram m_Present;
+    ezMetricHistogram m_FinishFrame;
+    ezMetricHistogram m_Total;
+  };
+
+  FrameMetrics m_FrameMetrics;
   ///@}
 };
@@ -188,9 +188,8 @@ void ezGameApplication::Run_FinishFrame()
 
 void ezGameApplication::UpdateWorldsAndExtractViews()
 {
-  ezStringBuilder sb;
-  sb.Format("FRAME {}", ezRenderWorld::GetFrameCounter());
-  EZ_PROFILE_SCOPE(sb.GetData());
+  // scope names are interned, so they must not contain the frame number
+  EZ_PROFILE_SCOPE("FRAME");
 
   Run_BeforeWorldUpdate();
 
@@ -307,6 +307,12 @@ void ezGameApplicationBase::AfterCoreSystemsStartup()
 {
   SUPER::AfterCoreSystemsStartup();
 
+  m_FrameMetrics.m_Input = ezMetrics::RegisterHistogram("Frame/Input");
+  m_FrameMetrics.m_WorldUpdateAndRender = ezMetrics::RegisterHistogram("Frame/WorldUpdateAndRender");
+  m_FrameMetrics.m_Present = ezMetrics::RegisterHistogram("Frame/Present");
+  m_FrameMetrics.m_FinishFrame = ezMetrics::RegisterHistogram("Frame/FinishFrame");
+  m_FrameMetrics.m_Total = ezMetrics::RegisterHistogram("Frame/Total");
+
   ExecuteInitFunctions();
 
   ezStartup::StartupHighLevelSystems();
@@ -358,6 +364,9 @@ void ezGameApplicationBase::BeforeCoreSystemsShutdown()
 
   Deinit_ShutdownLogging();
 
+  // the metrics are freed together with the core systems
+  m_FrameMetrics = FrameMetrics();
+
   SUPER::BeforeCoreSystemsShutdown();
 }
 
@@ -389,8 +398,13 @@ ezApplication::ApplicationExecution ezGameApplicationBase::Run()
     m_ExecutionEvents.Broadcast(e);
   }
 
+  const ezTime tInputStart = ezTime::Now();
+
   Run_InputUpdate();
 
+  const ezTime tWorldStart = ezTime::Now();
+  m_FrameMetrics.m_Input.RecordTime(tWorldStart - tInputStart);
+
   Run_WorldUpdateAndRender();
 
   if (!s_bUpdatePluginsExecuted)
@@ -416,19 +430,30 @@ ezApplication::ApplicationExecution ezGameApplicationBase::Run()
     m_ExecutionEvents.Broadcast(e);
   }
 
+  const ezTime tPresentStart = ezTime::Now();
+  m_FrameMetrics.m_WorldUpdateAndRender.RecordTime(tPresentStart - tWorldStart);
+
   Run_Present();
 
+  m_FrameMetrics.m_Present.RecordTime(ezTime::Now() - tPresentStart);
+
   ezClock::GetGlobalClock()->Update();
   UpdateFrameTime();
 
+  m_FrameMetrics.m_Total.RecordTime(m_FrameTime);
+
   {
     ezGameApplicationExecutionEvent e;
     e.m_Type = ezGameApplicationExecutionEvent::Type::AfterPresent;
     m_ExecutionEvents.Broadcast(e);
   }
 
+  const ezTime tFinishStart = ezTime::Now();
+
   Run_FinishFrame();
 
+  m_FrameMetrics.m_FinishFrame.RecordTime(ezTime::Now() - tFinishStart);
+
   return ezApplication::Continue;
 }
 
@@ -343,6 +343,10 @@ void ezGreyBoxComponent::OnBuildStaticMesh(ezMsgBuildStaticMesh& msg) const
 
 void ezGreyBoxComponent::OnMsgExtractGeometry(ezMsgExtractGeometry& msg) const
 {
+  // grey boxes are not registered as occluders
+  if (msg.m_Mode == ezWorldGeoExtractionUtil::ExtractionMode::OcclusionMesh)
+    return;
+
   if (msg.m_Mode == ezWorldGeoExtractionUtil::ExtractionMode::CollisionMesh ||
       msg.m_Mode == ezWorldGeoExtractionUtil::ExtractionMode::NavMeshGeneration)
   {
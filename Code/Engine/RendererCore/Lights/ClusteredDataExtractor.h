@@ -6,6 +6,8 @@
 struct ezPerLightData;
 struct ezPerDecalData;
 struct ezPerClusterData;
+struct ezClusterCullingItem;
+struct ezClusterSphereBlock;
 
 class ezClusteredDataCPU : public ezRenderData
 {
@@ -47,6 +49,7 @@ public:
     ezExtractedRenderData& extractedRenderData) override;
 
 private:
+  void FillClusters(ezUInt32 uiFirstSlice, ezUInt32 uiEndSlice);
   void FillItemListAndClusterData(ezClusteredDataCPU* pData);
 
   template <ezUInt32 MaxData>
@@ -59,10 +62,13 @@ private:
 
   ezDynamicArray<ezPerLightData, ezAlignedAllocatorWrapper> m_TempLightData;
   ezDynamicArray<ezPerDecalData, ezAlignedAllocatorWrapper> m_TempDecalData;
+  ezDynamicArray<ezClusterCullingItem, ezAlignedAllocatorWrapper> m_TempLightCullingItems;
+  ezDynamicArray<ezClusterCullingItem, ezAlignedAllocatorWrapper> m_TempDecalCullingItems;
   ezDynamicArray<TempCluster<ezClusteredDataCPU::MAX_LIGHT_DATA>> m_TempLightsClusters;
   ezDynamicArray<TempCluster<ezClusteredDataCPU::MAX_DECAL_DATA>> m_TempDecalsClusters;
   ezDynamicArray<ezUInt32> m_TempClusterItemList;
 
   ezDynamicArray<ezSimdBSphere, ezAlignedAllocatorWrapper> m_ClusterBoundingSpheres;
+  ezDynamicArray<ezClusterSphereBlock, ezAlignedAllocatorWrapper> m_ClusterSphereBlocks;
 };
 
@@ -3,6 +3,7 @@
 #include <Core/Graphics/Camera.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Components/FogComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Lights/AmbientLightComponent.h>
@@ -133,6 +134,12 @@ namespace
 }
 #endif
 
+namespace
+{
+  // Below this number of lights and decals, filling the clusters is cheaper than distributing it over multiple threads.
+  static const ezUInt32 s_uiParallelRasterizationThreshold = 64;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezClusteredDataCPU, 1, ezRTTINoAllocator)
@@ -154,6 +161,7 @@ ezClusteredDataExtractor::ezClusteredDataExtractor(const char* szName)
   m_TempLightsClusters.SetCountUninitialized(NUM_CLUSTERS);
   m_TempDecalsClusters.SetCountUninitialized(NUM_CLUSTERS);
   m_ClusterBoundingSpheres.SetCountUninitialized(NUM_CLUSTERS);
+  m_ClusterSphereBlocks.SetCountUninitialized(NUM_CLUSTERS / 4);
 }
 
 ezClusteredDataExtractor::~ezClusteredDataExtractor() {}
@@ -164,7 +172,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
   const ezCamera* pCamera = view.GetCullingCamera();
   const float fAspectRatio = view.GetViewport().width / view.GetViewport().height;
 
-  FillClusterBoundingSpheres(*pCamera, fAspectRatio, m_ClusterBoundingSpheres);
+  FillClusterBoundingSpheres(*pCamera, fAspectRatio, m_ClusterBoundingSpheres, m_ClusterSphereBlocks);
   ezClusteredDataCPU* pData = EZ_NEW(ezFrameAllocator::GetCurrentAllocator(), ezClusteredDataCPU);
   pData->m_ClusterData = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezPerClusterData, NUM_CLUSTERS);
 
@@ -179,7 +187,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
   // Lights
   {
     m_TempLightData.Clear();
-    ezMemoryUtils::ZeroFill(m_TempLightsClusters.GetData(), NUM_CLUSTERS);
+    m_TempLightCullingItems.Clear();
 
     auto batchList = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::Light);
     const ezUInt32 uiBatchCount = batchList.GetBatchCount();
@@ -203,8 +211,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
 
           ezSimdBSphere pointLightSphere = ezSimdBSphere(ezSimdConversion::ToVec3(pPointLightRenderData->m_GlobalTransform.m_vPosition),
                                                          pPointLightRenderData->m_fRange);
-          RasterizePointLight(pointLightSphere, uiLightIndex, viewMatrix, projectionMatrix, m_TempLightsClusters.GetData(),
-                              m_ClusterBoundingSpheres.GetData());
+          PreparePointLight(pointLightSphere, viewMatrix, projectionMatrix, m_TempLightCullingItems.ExpandAndGetRef());
 
           if (false)
           {
@@ -229,14 +236,13 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
           cone.m_PositionAndRange.SetW(pSpotLightRenderData->m_fRange);
           cone.m_ForwardDir = ezSimdConversion::ToVec3(pSpotLightRenderData->m_GlobalTransform.m_qRotation * ezVec3(1.0f, 0.0f, 0.0f));
           cone.m_SinCosAngle = ezSimdVec4f(ezMath::Sin(halfAngle), ezMath::Cos(halfAngle), 0.0f);
-          RasterizeSpotLight(cone, uiLightIndex, viewMatrix, projectionMatrix, m_TempLightsClusters.GetData(),
-                             m_ClusterBoundingSpheres.GetData());
+          PrepareSpotLight(cone, viewMatrix, projectionMatrix, m_TempLightCullingItems.ExpandAndGetRef());
         }
         else if (auto pDirLightRenderData = ezDynamicCast<const ezDirectionalLightRenderData*>(it))
         {
           FillDirLightData(m_TempLightData.ExpandAndGetRef(), pDirLightRenderData);
 
-          RasterizeDirLight(pDirLightRenderData, uiLightIndex, m_TempLightsClusters.GetArrayPtr());
+          PrepareDirLight(m_TempLightCullingItems.ExpandAndGetRef());
         }
         else if (auto pFogRenderData = ezDynamicCast<const ezFogRenderData*>(it))
         {
@@ -272,7 +278,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
   // Decals
   {
     m_TempDecalData.Clear();
-    ezMemoryUtils::ZeroFill(m_TempDecalsClusters.GetData(), NUM_CLUSTERS);
+    m_TempDecalCullingItems.Clear();
 
     auto batchList = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::Decal);
     const ezUInt32 uiBatchCount = batchList.GetBatchCount();
@@ -294,8 +300,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
         {
           FillDecalData(m_TempDecalData.ExpandAndGetRef(), pDecalRenderData);
 
-          RasterizeDecal(pDecalRenderData, uiDecalIndex, viewProjectionMatrix, m_TempDecalsClusters.GetData(),
-                         m_ClusterBoundingSpheres.GetData());
+          PrepareDecal(pDecalRenderData, viewProjectionMatrix, m_TempDecalCullingItems.ExpandAndGetRef());
         }
         else
         {
@@ -308,6 +313,25 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
     pData->m_DecalData.CopyFrom(m_TempDecalData);
   }
 
+  // Rasterize lights and decals into the clusters. The depth slices are independent, so they are distributed over multiple threads.
+  {
+    const ezUInt32 uiNumItems = m_TempLightCullingItems.GetCount() + m_TempDecalCullingItems.GetCount();
+    if (uiNumItems >= s_uiParallelRasterizationThreshold)
+    {
+      ezParallelForParams params;
+      params.splitting = ezParallelForSplitting::Adaptive;
+      params.uiGrainSize = 1;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, NUM_CLUSTERS_Z, [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { FillClusters(uiStartIndex, uiEndIndex); },
+        "ClusteredDataExtractor::FillClusters", params);
+    }
+    else
+    {
+      FillClusters(0, NUM_CLUSTERS_Z);
+    }
+  }
+
   FillItemListAndClusterData(pData);
 
   extractedRenderData.AddFrameData(pData);
@@ -317,6 +341,17 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
 #endif
 }
 
+void ezClusteredDataExtractor::FillClusters(ezUInt32 uiFirstSlice, ezUInt32 uiEndSlice)
+{
+  const ezUInt32 uiFirstClusterIndex = uiFirstSlice * NUM_CLUSTERS_XY;
+  const ezUInt32 uiNumClusters = (uiEndSlice - uiFirstSlice) * NUM_CLUSTERS_XY;
+  ezMemoryUtils::ZeroFill(m_TempLightsClusters.GetData() + uiFirstClusterIndex, uiNumClusters);
+  ezMemoryUtils::ZeroFill(m_TempDecalsClusters.GetData() + uiFirstClusterIndex, uiNumClusters);
+
+  RasterizeItems(m_TempLightCullingItems.GetArrayPtr(), uiFirstSlice, uiEndSlice, m_ClusterSphereBlocks.GetData(), m_TempLightsClusters.GetData());
+  RasterizeItems(m_TempDecalCullingItems.GetArrayPtr(), uiFirstSlice, uiEndSlice, m_ClusterSphereBlocks.GetData(), m_TempDecalsClusters.GetData());
+}
+
 namespace
 {
   ezUInt32 PackIndex(ezUInt32 uiLightIndex, ezUInt32 uiDecalIndex) { return uiDecalIndex << 10 | uiLightIndex; }
@@ -17,6 +17,43 @@ EZ_DEFINE_AS_POD_TYPE(ezPerClusterData);
 #include <Foundation/SimdMath/SimdVec4i.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
+/// \brief The shape of a light or decal that is tested against the cluster bounding spheres and the range of clusters it can touch.
+struct ezClusterCullingItem
+{
+  EZ_DECLARE_POD_TYPE();
+
+  enum Type : ezUInt8
+  {
+    Sphere,     ///< m_Shape[0] is the center and radius
+    Cone,       ///< m_Shape[0] is the position and range, m_Shape[1] the forward direction and m_Shape[2] the sine and cosine of the half angle
+    DecalBox,   ///< m_Shape[0 - 2] are the rows of the world to decal matrix, m_Shape[3] is its max scale
+    Everything, ///< Overlaps all clusters
+  };
+
+  ezSimdVec4f m_Shape[4];
+
+  ezUInt8 m_uiType;
+  ezUInt8 m_uiMinX;
+  ezUInt8 m_uiMinY;
+  ezUInt8 m_uiMinZ;
+  ezUInt8 m_uiMaxX;
+  ezUInt8 m_uiMaxY;
+  ezUInt8 m_uiMaxZ;
+};
+
+/// \brief The bounding spheres of four neighboring clusters in a row, stored as SoA so they can be tested against an item at once.
+struct ezClusterSphereBlock
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezSimdVec4f m_x;
+  ezSimdVec4f m_y;
+  ezSimdVec4f m_z;
+  ezSimdVec4f m_r;
+};
+
+EZ_CHECK_AT_COMPILETIME_MSG(NUM_CLUSTERS_X % 4 == 0, "The cluster bounding spheres are tested in blocks of four per row");
+
 namespace
 {
   ///\todo Make this configurable.
@@ -72,7 +109,8 @@ namespace
     out_pCorners[7] = out_pCorners[6] + dirRight * fStepXn;
   }
 
-  void FillClusterBoundingSpheres(const ezCamera& camera, float fAspectRatio, ezArrayPtr<ezSimdBSphere> clusterBoundingSpheres)
+  void FillClusterBoundingSpheres(const ezCamera& camera, float fAspectRatio, ezArrayPtr<ezSimdBSphere> clusterBoundingSpheres,
+    ezArrayPtr<ezClusterSphereBlock> clusterSphereBlocks)
   {
     ///\todo proper implementation for orthographic views
     if (camera.IsOrthographic())
@@ -129,6 +167,20 @@ namespace
 
       fZn = fZf;
     }
+
+    for (ezUInt32 i = 0; i < clusterSphereBlocks.GetCount(); ++i)
+    {
+      const ezSimdBSphere* pSpheres = clusterBoundingSpheres.GetPtr() + i * 4;
+
+      ezSimdMat4f m(pSpheres[0].m_CenterAndRadius, pSpheres[1].m_CenterAndRadius, pSpheres[2].m_CenterAndRadius, pSpheres[3].m_CenterAndRadius);
+      m.Transpose();
+
+      ezClusterSphereBlock& block = clusterSphereBlocks[i];
+      block.m_x = m.m_col0;
+      block.m_y = m.m_col1;
+      block.m_z = m.m_col2;
+      block.m_r = m.m_col3;
+    }
   }
 
   EZ_ALWAYS_INLINE void FillLightData(ezPerLightData& perLightData, const ezLightRenderData* pLightRenderData, ezUInt32 uiType)
@@ -245,9 +297,7 @@ namespace
     return ezSimdBBox(mi, ma);
   }
 
-  template <typename Cluster, typename IntersectionFunc>
-  EZ_FORCE_INLINE void FillCluster(const ezSimdBBox& screenSpaceBounds, ezUInt32 uiBlockIndex, ezUInt32 uiMask, Cluster* clusters,
-    IntersectionFunc func)
+  EZ_FORCE_INLINE void SetClusterRange(const ezSimdBBox& screenSpaceBounds, ezClusterCullingItem& item)
   {
     ezSimdVec4f scale = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, -0.5f * NUM_CLUSTERS_Y, 1.0f, 1.0f);
     ezSimdVec4f bias = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, 0.5f * NUM_CLUSTERS_Y, 0.0f, 0.0f);
@@ -261,42 +311,22 @@ namespace
     minXY_maxXY = minXY_maxXY.CompMin(maxClusterIndex - ezSimdVec4i(1));
     minXY_maxXY = minXY_maxXY.CompMax(ezSimdVec4i::ZeroVector());
 
-    ezUInt32 xMin = minXY_maxXY.x();
-    ezUInt32 yMin = minXY_maxXY.w();
-
-    ezUInt32 xMax = minXY_maxXY.z();
-    ezUInt32 yMax = minXY_maxXY.y();
-
-    ezUInt32 zMin = GetSliceIndexFromDepth(screenSpaceBounds.m_Min.z());
-    ezUInt32 zMax = GetSliceIndexFromDepth(screenSpaceBounds.m_Max.z());
+    item.m_uiMinX = static_cast<ezUInt8>(minXY_maxXY.x());
+    item.m_uiMinY = static_cast<ezUInt8>(minXY_maxXY.w());
+    item.m_uiMinZ = static_cast<ezUInt8>(GetSliceIndexFromDepth(screenSpaceBounds.m_Min.z()));
 
-    for (ezUInt32 z = zMin; z <= zMax; ++z)
-    {
-      for (ezUInt32 y = yMin; y <= yMax; ++y)
-      {
-        for (ezUInt32 x = xMin; x <= xMax; ++x)
-        {
-          ezUInt32 uiClusterIndex = GetClusterIndexFromCoord(x, y, z);
-          if (func(uiClusterIndex))
-          {
-            clusters[uiClusterIndex].m_BitMask[uiBlockIndex] |= uiMask;
-          }
-        }
-      }
-    }
+    item.m_uiMaxX = static_cast<ezUInt8>(minXY_maxXY.z());
+    item.m_uiMaxY = static_cast<ezUInt8>(minXY_maxXY.y());
+    item.m_uiMaxZ = static_cast<ezUInt8>(GetSliceIndexFromDepth(screenSpaceBounds.m_Max.z()));
   }
 
-  template <typename Cluster>
-  void RasterizePointLight(const ezSimdBSphere& pointLightSphere, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
-    const ezSimdMat4f& projectionMatrix, Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  void PreparePointLight(const ezSimdBSphere& pointLightSphere, const ezSimdMat4f& viewMatrix, const ezSimdMat4f& projectionMatrix,
+    ezClusterCullingItem& out_Item)
   {
-    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix);
+    out_Item.m_Shape[0] = pointLightSphere.m_CenterAndRadius;
+    out_Item.m_uiType = ezClusterCullingItem::Sphere;
 
-    const ezUInt32 uiBlockIndex = uiLightIndex / 32;
-    const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
-
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters,
-      [&](ezUInt32 uiClusterIndex) { return pointLightSphere.Overlaps(clusterBoundingSpheres[uiClusterIndex]); });
+    SetClusterRange(GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix), out_Item);
   }
 
   struct BoundingCone
@@ -307,9 +337,8 @@ namespace
     ezSimdVec4f m_SinCosAngle;
   };
 
-  template <typename Cluster>
-  void RasterizeSpotLight(const BoundingCone& spotLightCone, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
-    const ezSimdMat4f& projectionMatrix, Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  void PrepareSpotLight(const BoundingCone& spotLightCone, const ezSimdMat4f& viewMatrix, const ezSimdMat4f& projectionMatrix,
+    ezClusterCullingItem& out_Item)
   {
     ezSimdVec4f position = spotLightCone.m_PositionAndRange;
     ezSimdFloat range = spotLightCone.m_PositionAndRange.w();
@@ -331,44 +360,29 @@ namespace
       bSphereCenter = position + forwardDir * bSphereRadius;
     }
 
-    ezSimdBSphere spotLightSphere(bSphereCenter, bSphereRadius);
-    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(spotLightSphere, viewMatrix, projectionMatrix);
-
-    const ezUInt32 uiBlockIndex = uiLightIndex / 32;
-    const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
-
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
-      ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
-      ezSimdFloat clusterRadius = clusterSphere.GetRadius();
-
-      ezSimdVec4f toConePos = clusterSphere.m_CenterAndRadius - position;
-      ezSimdFloat projected = forwardDir.Dot<3>(toConePos);
-      ezSimdFloat distToConeSq = toConePos.Dot<3>(toConePos);
-      ezSimdFloat distClosestP = cosAngle * (distToConeSq - projected * projected).GetSqrt() - projected * sinAngle;
-
-      bool angleCull = distClosestP > clusterRadius;
-      bool frontCull = projected > clusterRadius + range;
-      bool backCull = projected < -clusterRadius;
+    out_Item.m_Shape[0] = spotLightCone.m_PositionAndRange;
+    out_Item.m_Shape[1] = spotLightCone.m_ForwardDir;
+    out_Item.m_Shape[2] = spotLightCone.m_SinCosAngle;
+    out_Item.m_uiType = ezClusterCullingItem::Cone;
 
-      return !(angleCull || frontCull || backCull);
-    });
+    ezSimdBSphere spotLightSphere(bSphereCenter, bSphereRadius);
+    SetClusterRange(GetScreenSpaceBounds(spotLightSphere, viewMatrix, projectionMatrix), out_Item);
   }
 
-  template <typename Cluster>
-  void RasterizeDirLight(const ezDirectionalLightRenderData* pDirLightRenderData, ezUInt32 uiLightIndex, ezArrayPtr<Cluster> clusters)
+  void PrepareDirLight(ezClusterCullingItem& out_Item)
   {
-    const ezUInt32 uiBlockIndex = uiLightIndex / 32;
-    const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
+    out_Item.m_uiType = ezClusterCullingItem::Everything;
 
-    for (ezUInt32 i = 0; i < clusters.GetCount(); ++i)
-    {
-      clusters[i].m_BitMask[uiBlockIndex] |= uiMask;
-    }
+    out_Item.m_uiMinX = 0;
+    out_Item.m_uiMinY = 0;
+    out_Item.m_uiMinZ = 0;
+
+    out_Item.m_uiMaxX = NUM_CLUSTERS_X - 1;
+    out_Item.m_uiMaxY = NUM_CLUSTERS_Y - 1;
+    out_Item.m_uiMaxZ = NUM_CLUSTERS_Z - 1;
   }
 
-  template <typename Cluster>
-  void RasterizeDecal(const ezDecalRenderData* pDecalRenderData, ezUInt32 uiDecalIndex, const ezSimdMat4f& viewProjectionMatrix,
-    Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  void PrepareDecal(const ezDecalRenderData* pDecalRenderData, const ezSimdMat4f& viewProjectionMatrix, ezClusterCullingItem& out_Item)
   {
     ezSimdMat4f decalToWorld = ezSimdConversion::ToTransform(pDecalRenderData->m_GlobalTransform).GetAsMat4();
     ezSimdMat4f worldToDecal = decalToWorld.GetInverse();
@@ -400,17 +414,218 @@ namespace
       screenSpaceBounds.m_Max = ezSimdVec4f(1.0f).GetCombined<ezSwizzle::XYZW>(screenSpaceBounds.m_Max);
     }
 
-    ezSimdVec4f decalHalfExtents = ezSimdVec4f(1.0f);
-    ezSimdBBox localDecalBounds = ezSimdBBox(-decalHalfExtents, decalHalfExtents);
+    // same scale factor for the cluster sphere radius as ezSimdBSphere::Transform
+    ezSimdFloat maxScale = worldToDecal.m_col0.Dot<3>(worldToDecal.m_col0);
+    maxScale = maxScale.Max(worldToDecal.m_col1.Dot<3>(worldToDecal.m_col1));
+    maxScale = maxScale.Max(worldToDecal.m_col2.Dot<3>(worldToDecal.m_col2));
+
+    worldToDecal.Transpose();
+    out_Item.m_Shape[0] = worldToDecal.m_col0;
+    out_Item.m_Shape[1] = worldToDecal.m_col1;
+    out_Item.m_Shape[2] = worldToDecal.m_col2;
+    out_Item.m_Shape[3] = ezSimdVec4f(maxScale.GetSqrt());
+    out_Item.m_uiType = ezClusterCullingItem::DecalBox;
+
+    SetClusterRange(screenSpaceBounds, out_Item);
+  }
+
+  // The overlap tests below check one item against four neighboring clusters at once. The item is splatted into all lanes up front, since
+  // it is tested against many clusters in a row. They return the overlapping lanes as a bitmask.
+
+  struct SphereOverlapsClusters
+  {
+    EZ_ALWAYS_INLINE explicit SphereOverlapsClusters(const ezClusterCullingItem& item)
+    {
+      const ezSimdVec4f sphere = item.m_Shape[0];
+      m_x = ezSimdVec4f(sphere.x());
+      m_y = ezSimdVec4f(sphere.y());
+      m_z = ezSimdVec4f(sphere.z());
+      m_r = ezSimdVec4f(sphere.w());
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 operator()(const ezClusterSphereBlock& clusters) const
+    {
+      ezSimdVec4f dx = clusters.m_x - m_x;
+      ezSimdVec4f dy = clusters.m_y - m_y;
+      ezSimdVec4f dz = clusters.m_z - m_z;
+      ezSimdVec4f distSq = ezSimdVec4f::MulAdd(dz, dz, ezSimdVec4f::MulAdd(dy, dy, dx.CompMul(dx)));
+
+      ezSimdVec4f radius = clusters.m_r + m_r;
+
+      return (distSq < radius.CompMul(radius)).GetBitmask();
+    }
+
+    ezSimdVec4f m_x, m_y, m_z, m_r;
+  };
+
+  struct ConeOverlapsClusters
+  {
+    EZ_ALWAYS_INLINE explicit ConeOverlapsClusters(const ezClusterCullingItem& item)
+    {
+      const ezSimdVec4f position = item.m_Shape[0];
+      const ezSimdVec4f forwardDir = item.m_Shape[1];
+      const ezSimdVec4f sinCosAngle = item.m_Shape[2];
+
+      m_x = ezSimdVec4f(position.x());
+      m_y = ezSimdVec4f(position.y());
+      m_z = ezSimdVec4f(position.z());
+      m_range = ezSimdVec4f(position.w());
+      m_dirX = ezSimdVec4f(forwardDir.x());
+      m_dirY = ezSimdVec4f(forwardDir.y());
+      m_dirZ = ezSimdVec4f(forwardDir.z());
+      m_sinAngle = ezSimdVec4f(sinCosAngle.x());
+      m_cosAngleSq = ezSimdVec4f(sinCosAngle.y() * sinCosAngle.y());
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 operator()(const ezClusterSphereBlock& clusters) const
+    {
+      ezSimdVec4f dx = clusters.m_x - m_x;
+      ezSimdVec4f dy = clusters.m_y - m_y;
+      ezSimdVec4f dz = clusters.m_z - m_z;
+
+      ezSimdVec4f projected = ezSimdVec4f::MulAdd(dz, m_dirZ, ezSimdVec4f::MulAdd(dy, m_dirY, dx.CompMul(m_dirX)));
+      ezSimdVec4f distToConeSq = ezSimdVec4f::MulAdd(dz, dz, ezSimdVec4f::MulAdd(dy, dy, dx.CompMul(dx)));
+      ezSimdVec4f distToAxisSq = distToConeSq - projected.CompMul(projected);
+
+      // cos * sqrt(distToAxisSq) - projected * sin > radius, rearranged so no square root is needed. Once the back cull passed, the right
+      // hand side can't be negative.
+      ezSimdVec4f minDist = ezSimdVec4f::MulAdd(projected, m_sinAngle, clusters.m_r);
+      ezSimdVec4b angleCull = distToAxisSq.CompMul(m_cosAngleSq) > minDist.CompMul(minDist);
+      ezSimdVec4b frontCull = projected > clusters.m_r + m_range;
+      ezSimdVec4b backCull = projected < -clusters.m_r;
+
+      return ~(angleCull.GetBitmask() | frontCull.GetBitmask() | backCull.GetBitmask());
+    }
+
+    ezSimdVec4f m_x, m_y, m_z, m_range;
+    ezSimdVec4f m_dirX, m_dirY, m_dirZ;
+    ezSimdVec4f m_sinAngle, m_cosAngleSq;
+  };
+
+  struct DecalOverlapsClusters
+  {
+    EZ_ALWAYS_INLINE explicit DecalOverlapsClusters(const ezClusterCullingItem& item)
+    {
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        const ezSimdVec4f row = item.m_Shape[i];
+        m_Rows[i][0] = ezSimdVec4f(row.x());
+        m_Rows[i][1] = ezSimdVec4f(row.y());
+        m_Rows[i][2] = ezSimdVec4f(row.z());
+        m_Rows[i][3] = ezSimdVec4f(row.w());
+      }
+
+      m_Scale = item.m_Shape[3];
+    }
+
+    EZ_ALWAYS_INLINE ezUInt32 operator()(const ezClusterSphereBlock& clusters) const
+    {
+      const ezSimdVec4f one = ezSimdVec4f(1.0f);
+
+      // transform the cluster centers into the local space of the decal, where it is the box from -1 to 1, and measure the distance to that box
+      ezSimdVec4f distSq = ezSimdVec4f::ZeroVector();
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        ezSimdVec4f local = ezSimdVec4f::MulAdd(clusters.m_z, m_Rows[i][2], ezSimdVec4f::MulAdd(clusters.m_y, m_Rows[i][1], clusters.m_x.CompMul(m_Rows[i][0]))) + m_Rows[i][3];
 
-    const ezUInt32 uiBlockIndex = uiDecalIndex / 32;
-    const ezUInt32 uiMask = 1 << (uiDecalIndex - uiBlockIndex * 32);
+        ezSimdVec4f d = local - local.CompMin(one).CompMax(-one);
+        distSq = ezSimdVec4f::MulAdd(d, d, distSq);
+      }
+
+      ezSimdVec4f radius = clusters.m_r.CompMul(m_Scale);
+
+      return (distSq <= radius.CompMul(radius)).GetBitmask();
+    }
 
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
-      ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
-      clusterSphere.Transform(worldToDecal);
+    ezSimdVec4f m_Rows[3][4];
+    ezSimdVec4f m_Scale;
+  };
+
+  template <typename Cluster, typename OverlapFunc>
+  EZ_FORCE_INLINE void RasterizeItem(const ezClusterCullingItem& item, ezUInt32 uiFirstSlice, ezUInt32 uiLastSlice, ezUInt32 uiBlockIndex,
+    ezUInt32 uiMask, const ezClusterSphereBlock* clusterBoundingSpheres, Cluster* clusters, const OverlapFunc& func)
+  {
+    const ezUInt32 xMin = item.m_uiMinX;
+    const ezUInt32 xMax = item.m_uiMaxX;
+    const ezUInt32 yMin = item.m_uiMinY;
+    const ezUInt32 yMax = item.m_uiMaxY;
 
-      return localDecalBounds.Overlaps(clusterSphere);
-    });
+    for (ezUInt32 z = uiFirstSlice; z <= uiLastSlice; ++z)
+    {
+      for (ezUInt32 y = yMin; y <= yMax; ++y)
+      {
+        for (ezUInt32 x = xMin & ~3u; x <= xMax; x += 4)
+        {
+          const ezUInt32 uiFirstClusterIndex = GetClusterIndexFromCoord(x, y, z);
+
+          // only keep the lanes that are within the x range of the item
+          ezUInt32 uiLaneMask = 0xF;
+          if (x < xMin)
+            uiLaneMask &= 0xF << (xMin - x);
+          if (x + 3 > xMax)
+            uiLaneMask &= 0xF >> (x + 3 - xMax);
+
+          const ezUInt32 uiHitMask = func(clusterBoundingSpheres[uiFirstClusterIndex / 4]) & uiLaneMask;
+
+          // the number of clusters in a row is a multiple of four, so all lanes can be written without branching on the hit mask
+          Cluster* pClusters = clusters + uiFirstClusterIndex;
+          pClusters[0].m_BitMask[uiBlockIndex] |= uiMask & (0u - (uiHitMask & 1u));
+          pClusters[1].m_BitMask[uiBlockIndex] |= uiMask & (0u - ((uiHitMask >> 1) & 1u));
+          pClusters[2].m_BitMask[uiBlockIndex] |= uiMask & (0u - ((uiHitMask >> 2) & 1u));
+          pClusters[3].m_BitMask[uiBlockIndex] |= uiMask & (0u - (uiHitMask >> 3));
+        }
+      }
+    }
+  }
+
+  /// Adds the items to all clusters that they overlap in the depth slices from uiFirstSlice up to, but not including, uiEndSlice.
+  /// Item i sets bit i of the cluster bitmask. Different slices can be filled from different threads at the same time, since each slice only
+  /// touches its own clusters.
+  template <typename Cluster>
+  void RasterizeItems(ezArrayPtr<const ezClusterCullingItem> items, ezUInt32 uiFirstSlice, ezUInt32 uiEndSlice,
+    const ezClusterSphereBlock* clusterBoundingSpheres, Cluster* clusters)
+  {
+    for (ezUInt32 uiItemIndex = 0; uiItemIndex < items.GetCount(); ++uiItemIndex)
+    {
+      const ezClusterCullingItem& item = items[uiItemIndex];
+
+      const ezUInt32 zMin = ezMath::Max<ezUInt32>(item.m_uiMinZ, uiFirstSlice);
+      const ezUInt32 zMax = ezMath::Min<ezUInt32>(item.m_uiMaxZ, uiEndSlice - 1);
+      if (zMin > zMax)
+        continue;
+
+      const ezUInt32 uiBlockIndex = uiItemIndex / 32;
+      const ezUInt32 uiMask = 1u << (uiItemIndex - uiBlockIndex * 32);
+
+      switch (item.m_uiType)
+      {
+        case ezClusterCullingItem::Sphere:
+          RasterizeItem(item, zMin, zMax, uiBlockIndex, uiMask, clusterBoundingSpheres, clusters, SphereOverlapsClusters(item));
+          break;
+
+        case ezClusterCullingItem::Cone:
+          RasterizeItem(item, zMin, zMax, uiBlockIndex, uiMask, clusterBoundingSpheres, clusters, ConeOverlapsClusters(item));
+          break;
+
+        case ezClusterCullingItem::DecalBox:
+          RasterizeItem(item, zMin, zMax, uiBlockIndex, uiMask, clusterBoundingSpheres, clusters, DecalOverlapsClusters(item));
+          break;
+
+        case ezClusterCullingItem::Everything:
+        {
+          const ezUInt32 uiFirstClusterIndex = GetClusterIndexFromCoord(0, 0, zMin);
+          const ezUInt32 uiEndClusterIndex = GetClusterIndexFromCoord(0, 0, zMax + 1);
+
+          for (ezUInt32 i = uiFirstClusterIndex; i < uiEndClusterIndex; ++i)
+          {
+            clusters[i].m_BitMask[uiBlockIndex] |= uiMask;
+          }
+        }
+        break;
+
+        default:
+          EZ_ASSERT_NOT_IMPLEMENTED;
+      }
+    }
   }
 } // namespace
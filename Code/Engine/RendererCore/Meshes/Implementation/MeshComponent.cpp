@@ -1,6 +1,8 @@
 #include <RendererCorePCH.h>
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 #include <RendererCore/Meshes/CpuMeshResource.h>
 #include <RendererCore/Meshes/MeshComponent.h>
@@ -20,51 +22,195 @@ namespace
       tri.m_uiVertexIndices[2] = uiVertexIdxOffset + pTypedIndices[p * 3 + (flip ? 0 : 2)];
     }
   }
+
+  ezResult ExtractMeshGeometry(const ezMeshBufferResourceDescriptor& mb, const ezTransform& transform, ezWorldGeoExtractionUtil::Geometry& geo)
+  {
+    if (mb.GetTopology() != ezGALPrimitiveTopology::Triangles || mb.GetPrimitiveCount() == 0 || !mb.HasIndexBuffer())
+    {
+      ezLog::Warning("Unsupported CPU mesh topology {0}", (int)mb.GetTopology());
+      return EZ_FAILURE;
+    }
+
+    const ezVertexDeclarationInfo& vdi = mb.GetVertexDeclaration();
+    const ezUInt8* pRawVertexData = mb.GetVertexBufferData().GetData();
+
+    const float* pPositions = nullptr;
+
+    for (ezUInt32 vs = 0; vs < vdi.m_VertexStreams.GetCount(); ++vs)
+    {
+      if (vdi.m_VertexStreams[vs].m_Semantic == ezGALVertexAttributeSemantic::Position)
+      {
+        if (vdi.m_VertexStreams[vs].m_Format != ezGALResourceFormat::RGBFloat)
+        {
+          ezLog::Warning("Unsupported CPU mesh vertex position format {0}", (int)vdi.m_VertexStreams[vs].m_Format);
+          return EZ_FAILURE; // other position formats are not supported
+        }
+
+        pPositions = (const float*)(pRawVertexData + vdi.m_VertexStreams[vs].m_uiOffset);
+      }
+    }
+
+    if (pPositions == nullptr)
+    {
+      ezLog::Warning("No position stream found in CPU mesh");
+      return EZ_FAILURE;
+    }
+
+    const ezUInt32 uiElementStride = mb.GetVertexDataSize();
+
+    // remember the vertex index at the start
+    const ezUInt32 uiVertexIdxOffset = geo.m_Vertices.GetCount();
+
+    // write out all vertices
+    for (ezUInt32 i = 0; i < mb.GetVertexCount(); ++i)
+    {
+      const ezVec3 pos(pPositions[0], pPositions[1], pPositions[2]);
+      pPositions = ezMemoryUtils::AddByteOffset(pPositions, uiElementStride);
+
+      auto& vert = geo.m_Vertices.ExpandAndGetRef();
+      vert.m_vPosition = transform * pos;
+      // vert.m_TexCoord.SetZero();
+    }
+
+    const bool bFlipTriangles = ezGraphicsUtils::IsTriangleFlipRequired(transform.GetAsMat4().GetRotationalPart());
+    if (bFlipTriangles)
+    {
+      if (mb.Uses32BitIndices())
+      {
+        FillIndices<ezUInt32, true>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
+      }
+      else
+      {
+        FillIndices<ezUInt16, true>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
+      }
+    }
+    else
+    {
+      if (mb.Uses32BitIndices())
+      {
+        FillIndices<ezUInt32, false>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
+      }
+      else
+      {
+        FillIndices<ezUInt16, false>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
+      }
+    }
+
+    return EZ_SUCCESS;
+  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
 
 // clang-format off
 
-EZ_BEGIN_COMPONENT_TYPE(ezMeshComponent, 3, ezComponentMode::Static)
+EZ_BEGIN_COMPONENT_TYPE(ezMeshComponent, 4, ezComponentMode::Static)
 {
   EZ_BEGIN_PROPERTIES
   {
     EZ_ACCESSOR_PROPERTY("Mesh", GetMeshFile, SetMeshFile)->AddAttributes(new ezAssetBrowserAttribute("Mesh;Animated Mesh")),
     EZ_ACCESSOR_PROPERTY("Color", GetColor, SetColor)->AddAttributes(new ezExposeColorAlphaAttribute()),
     EZ_ARRAY_ACCESSOR_PROPERTY("Materials", Materials_GetCount, Materials_GetValue, Materials_SetValue, Materials_Insert, Materials_Remove)->AddAttributes(new ezAssetBrowserAttribute("Material")),
+    EZ_ACCESSOR_PROPERTY("Occluder", GetOccluder, SetOccluder),
   }
   EZ_END_PROPERTIES;
   EZ_BEGIN_MESSAGEHANDLERS
   {
-    EZ_MESSAGE_HANDLER(ezMsgExtractGeometry, OnMsgExtractGeometry)
+    EZ_MESSAGE_HANDLER(ezMsgExtractGeometry, OnMsgExtractGeometry),
+    EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds),
   }
   EZ_END_MESSAGEHANDLERS;
 }
 EZ_END_COMPONENT_TYPE
 // clang-format on
 
+struct ezMeshComponent::OccluderCache
+{
+  ezMutex m_Mutex;
+  ezMeshResourceHandle m_hMesh;
+  ezCpuMeshResourceHandle m_hCpuMesh;
+  ezUInt32 m_uiCpuMeshChangeCounter = 0;
+  ezTransform m_Transform;
+  bool m_bValid = false;
+  ezWorldGeoExtractionUtil::Geometry m_Geometry;
+};
+
 ezMeshComponent::ezMeshComponent() = default;
 ezMeshComponent::~ezMeshComponent() = default;
+ezMeshComponent& ezMeshComponent::operator=(ezMeshComponent&& other) = default;
 
-void ezMeshComponent::OnMsgExtractGeometry(ezMsgExtractGeometry& msg) const
+void ezMeshComponent::SerializeComponent(ezWorldWriter& stream) const
+{
+  SUPER::SerializeComponent(stream);
+  ezStreamWriter& s = stream.GetStream();
+
+  s << m_bOccluder;
+}
+
+void ezMeshComponent::DeserializeComponent(ezWorldReader& stream)
 {
-  if (msg.m_Mode != ezWorldGeoExtractionUtil::ExtractionMode::RenderMesh)
+  SUPER::DeserializeComponent(stream);
+  const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
+
+  ezStreamReader& s = stream.GetStream();
+
+  if (uiVersion >= 4)
+  {
+    bool bOccluder = false;
+    s >> bOccluder;
+    SetOccluder(bOccluder);
+  }
+}
+
+void ezMeshComponent::SetOccluder(bool bOccluder)
+{
+  if (m_bOccluder == bOccluder)
     return;
 
-  // ignore invalid and created resources
+  m_bOccluder = bOccluder;
+
+  if (m_bOccluder)
+    m_pOccluderCache = EZ_DEFAULT_NEW(OccluderCache);
+  else
+    m_pOccluderCache.Clear();
+
+  TriggerLocalBoundsUpdate();
+}
+
+void ezMeshComponent::OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
+{
+  SUPER::OnUpdateLocalBounds(msg);
+
+  if (m_bOccluder)
   {
-    ezMeshResourceHandle hRenderMesh = GetMesh();
-    if (!hRenderMesh.IsValid())
-      return;
+    ezBoundingBoxSphere bounds;
+    bounds.SetInvalid();
 
-    ezResourceLock<ezMeshResource> pRenderMesh(hRenderMesh, ezResourceAcquireMode::PointerOnly);
-    if (pRenderMesh->GetBaseResourceFlags().IsAnySet(ezResourceFlags::IsCreatedResource))
-      return;
+    bool bAlwaysVisible = false;
+
+    if (GetLocalBounds(bounds, bAlwaysVisible).Succeeded() && bounds.IsValid())
+    {
+      msg.AddBounds(bounds, ezDefaultSpatialDataCategories::Occluder);
+    }
   }
+}
 
-  const char* szMesh = GetMeshFile();
+void ezMeshComponent::OnMsgExtractGeometry(ezMsgExtractGeometry& msg) const
+{
+  if (msg.m_Mode == ezWorldGeoExtractionUtil::ExtractionMode::OcclusionMesh)
+  {
+    if (m_pOccluderCache != nullptr)
+    {
+      ExtractOccluderGeometry(msg);
+    }
 
+    return;
+  }
+
+  if (msg.m_Mode != ezWorldGeoExtractionUtil::ExtractionMode::RenderMesh || !HasExtractableMesh())
+    return;
+
+  const char* szMesh = GetMeshFile();
 
   EZ_LOG_BLOCK("ExtractWorldGeometry_RenderMesh", szMesh);
 
@@ -78,81 +224,92 @@ void ezMeshComponent::OnMsgExtractGeometry(ezMsgExtractGeometry& msg) const
     return;
   }
 
-  const auto& mb = pCpuMesh->GetDescriptor().MeshBufferDesc();
+  ExtractMeshGeometry(pCpuMesh->GetDescriptor().MeshBufferDesc(), GetOwner()->GetGlobalTransform(), *msg.m_pWorldGeometry).IgnoreResult();
+}
 
-  if (mb.GetTopology() != ezGALPrimitiveTopology::Triangles || mb.GetPrimitiveCount() == 0 || !mb.HasIndexBuffer())
-  {
-    ezLog::Warning("Unsupported CPU mesh topology {0}", (int)mb.GetTopology());
-    return;
-  }
+bool ezMeshComponent::HasExtractableMesh() const
+{
+  ezMeshResourceHandle hRenderMesh = GetMesh();
+  if (!hRenderMesh.IsValid())
+    return false;
 
-  const ezTransform transform = GetOwner()->GetGlobalTransform();
+  // ignore created resources, there is no CPU mesh for them
+  ezResourceLock<ezMeshResource> pRenderMesh(hRenderMesh, ezResourceAcquireMode::PointerOnly);
+  return !pRenderMesh->GetBaseResourceFlags().IsAnySet(ezResourceFlags::IsCreatedResource);
+}
 
-  const ezVertexDeclarationInfo& vdi = mb.GetVertexDeclaration();
-  const ezUInt8* pRawVertexData = mb.GetVertexBufferData().GetData();
+void ezMeshComponent::ExtractOccluderGeometry(ezMsgExtractGeometry& msg) const
+{
+  OccluderCache& cache = *m_pOccluderCache;
 
-  const float* pPositions = nullptr;
+  // the views are extracted in parallel
+  EZ_LOCK(cache.m_Mutex);
 
-  for (ezUInt32 vs = 0; vs < vdi.m_VertexStreams.GetCount(); ++vs)
+  if (cache.m_hMesh != GetMesh())
   {
-    if (vdi.m_VertexStreams[vs].m_Semantic == ezGALVertexAttributeSemantic::Position)
-    {
-      if (vdi.m_VertexStreams[vs].m_Format != ezGALResourceFormat::RGBFloat)
-      {
-        ezLog::Warning("Unsupported CPU mesh vertex position format {0}", (int)vdi.m_VertexStreams[vs].m_Format);
-        return; // other position formats are not supported
-      }
+    cache.m_hMesh = GetMesh();
+    cache.m_hCpuMesh.Invalidate();
+    cache.m_bValid = false;
 
-      pPositions = (const float*)(pRawVertexData + vdi.m_VertexStreams[vs].m_uiOffset);
+    if (HasExtractableMesh())
+    {
+      cache.m_hCpuMesh = ezResourceManager::LoadResource<ezCpuMeshResource>(GetMeshFile());
     }
   }
 
-  if (pPositions == nullptr)
+  if (!cache.m_hCpuMesh.IsValid())
+    return;
+
+  // never wait for the CPU mesh here, the occluder is skipped until it is loaded
+  const ezResourceState cpuMeshState = ezResourceManager::GetLoadingState(cache.m_hCpuMesh);
+  if (cpuMeshState != ezResourceState::Loaded)
   {
-    ezLog::Warning("No position stream found in CPU mesh");
+    if (cpuMeshState != ezResourceState::LoadedResourceMissing)
+    {
+      ezResourceManager::PreloadResource(cache.m_hCpuMesh);
+    }
+
+    cache.m_bValid = false;
     return;
   }
 
-  const ezUInt32 uiElementStride = mb.GetVertexDataSize();
+  const ezTransform transform = GetOwner()->GetGlobalTransform();
+
+  {
+    ezResourceLock<ezCpuMeshResource> pCpuMesh(cache.m_hCpuMesh, ezResourceAcquireMode::PointerOnly);
+
+    // the triangles are kept in world space and only computed again when the mesh or the transform changes
+    if (!cache.m_bValid || cache.m_uiCpuMeshChangeCounter != pCpuMesh->GetCurrentResourceChangeCounter() || cache.m_Transform != transform)
+    {
+      cache.m_Geometry.m_Vertices.Clear();
+      cache.m_Geometry.m_Triangles.Clear();
+      cache.m_uiCpuMeshChangeCounter = pCpuMesh->GetCurrentResourceChangeCounter();
+      cache.m_Transform = transform;
+      cache.m_bValid = true;
+
+      if (ExtractMeshGeometry(pCpuMesh->GetDescriptor().MeshBufferDesc(), transform, cache.m_Geometry).Failed())
+      {
+        cache.m_Geometry.m_Vertices.Clear();
+        cache.m_Geometry.m_Triangles.Clear();
+      }
+    }
+  }
 
   auto& geo = *msg.m_pWorldGeometry;
 
-  // remember the vertex index at the start
   const ezUInt32 uiVertexIdxOffset = geo.m_Vertices.GetCount();
 
-  // write out all vertices
-  for (ezUInt32 i = 0; i < mb.GetVertexCount(); ++i)
+  for (const auto& vertex : cache.m_Geometry.m_Vertices)
   {
-    const ezVec3 pos(pPositions[0], pPositions[1], pPositions[2]);
-    pPositions = ezMemoryUtils::AddByteOffset(pPositions, uiElementStride);
-
-    auto& vert = geo.m_Vertices.ExpandAndGetRef();
-    vert.m_vPosition = transform * pos;
-    // vert.m_TexCoord.SetZero();
+    geo.m_Vertices.PushBack(vertex);
   }
 
-  const bool bFlipTriangles = ezGraphicsUtils::IsTriangleFlipRequired(transform.GetAsMat4().GetRotationalPart());
-  if (bFlipTriangles)
-  {
-    if (mb.Uses32BitIndices())
-    {
-      FillIndices<ezUInt32, true>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
-    }
-    else
-    {
-      FillIndices<ezUInt16, true>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
-    }
-  }
-  else
+  for (const auto& triangle : cache.m_Geometry.m_Triangles)
   {
-    if (mb.Uses32BitIndices())
-    {
-      FillIndices<ezUInt32, false>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
-    }
-    else
-    {
-      FillIndices<ezUInt16, false>(mb.GetIndexBufferData().GetData(), mb.GetPrimitiveCount(), uiVertexIdxOffset, geo);
-    }
+    auto& tri = geo.m_Triangles.ExpandAndGetRef();
+    tri.m_uiVertexIndices[0] = uiVertexIdxOffset + triangle.m_uiVertexIndices[0];
+    tri.m_uiVertexIndices[1] = uiVertexIdxOffset + triangle.m_uiVertexIndices[1];
+    tri.m_uiVertexIndices[2] = uiVertexIdxOffset + triangle.m_uiVertexIndices[2];
   }
 }
 
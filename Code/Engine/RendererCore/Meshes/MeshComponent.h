@@ -9,13 +9,39 @@ class EZ_RENDERERCORE_DLL ezMeshComponent : public ezMeshComponentBase
 {
   EZ_DECLARE_COMPONENT_TYPE(ezMeshComponent, ezMeshComponentBase, ezMeshComponentManager);
 
+  //////////////////////////////////////////////////////////////////////////
+  // ezComponent
+
+public:
+  virtual void SerializeComponent(ezWorldWriter& stream) const override;
+  virtual void DeserializeComponent(ezWorldReader& stream) override;
+
   //////////////////////////////////////////////////////////////////////////
   // ezMeshComponent
 
 public:
   ezMeshComponent();
   ~ezMeshComponent();
+  ezMeshComponent& operator=(ezMeshComponent&& other);
 
-  /// \brief Extracts the render geometry for export etc.
+  /// \brief Extracts the render geometry for export etc. and the occluder geometry for occlusion culling.
   void OnMsgExtractGeometry(ezMsgExtractGeometry& msg) const; // [ msg handler ]
+
+  /// \brief Occluders are rasterized into the CPU occlusion buffer (see r_OcclusionCulling) to cull the objects behind them.
+  ///
+  /// Only large, simple and opaque meshes, like walls or terrain chunks, make good occluders.
+  void SetOccluder(bool bOccluder);                      // [ property ]
+  bool GetOccluder() const { return m_bOccluder; }       // [ property ]
+
+  void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg); // [ msg handler ]
+
+protected:
+  bool HasExtractableMesh() const;
+  void ExtractOccluderGeometry(ezMsgExtractGeometry& msg) const;
+
+  bool m_bOccluder = false;
+
+  // world space occluder triangles, only allocated for occluders
+  struct OccluderCache;
+  ezUniquePtr<OccluderCache> m_pOccluderCache;
 };
@@ -85,6 +85,9 @@ private:
   {
     ezDynamicArray< ezRenderDataBatch > m_Batches;
     ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData;
+    ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortingScratch;
+
+    void SortAndBatch();
   };
 
   ezCamera m_Camera;
@@ -1,6 +1,7 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
 ezExtractedRenderData::ezExtractedRenderData() {}
@@ -19,10 +20,17 @@ void ezExtractedRenderData::AddFrameData(const ezRenderData* pFrameData)
   m_FrameData.PushBack(pFrameData);
 }
 
-void ezExtractedRenderData::SortAndBatch()
+namespace
 {
-  EZ_PROFILE_SCOPE("SortAndBatch");
+  // Below this many render data items a category is sorted with QuickSort, the fixed cost of the radix sort doesn't pay off.
+  constexpr ezUInt32 s_uiRadixSortThreshold = 256;
+
+  // Below this many render data items in total all categories are sorted on the calling thread.
+  constexpr ezUInt32 s_uiParallelSortThreshold = 4096;
+} // namespace
 
+void ezExtractedRenderData::DataPerCategory::SortAndBatch()
+{
   struct RenderDataComparer
   {
     EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
@@ -36,37 +44,102 @@ void ezExtractedRenderData::SortAndBatch()
     }
   };
 
-  for (auto& dataPerCategory : m_DataPerCategory)
+  struct BatchIdComparer
   {
-    if (dataPerCategory.m_SortableRenderData.IsEmpty())
-      continue;
+    EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
+    {
+      return a.m_pRenderData->m_uiBatchId < b.m_pRenderData->m_uiBatchId;
+    }
+  };
+
+  if (m_SortableRenderData.IsEmpty())
+    return;
 
-    auto& data = dataPerCategory.m_SortableRenderData;
+  auto& data = m_SortableRenderData;
 
-    // Sort
+  // Sort
+  if (data.GetCount() < s_uiRadixSortThreshold)
+  {
     data.Sort(RenderDataComparer());
+  }
+  else
+  {
+    m_SortingScratch.SetCountUninitialized(data.GetCount());
 
-    // Find batches
-    ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
-    ezUInt32 uiCurrentBatchStartIndex = 0;
-    const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+    ezSorting::RadixSort(data.GetArrayPtr(), m_SortingScratch.GetArrayPtr(),
+      [](const ezRenderDataBatch::SortableRenderData& renderData) { return renderData.m_uiSortingKey; });
 
-    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+    // Items with the same sorting key are ordered by batch id. Only the render data of those items has to be touched for that.
+    ezUInt32 uiRunStart = 0;
+    for (ezUInt32 i = 1; i <= data.GetCount(); ++i)
     {
-      auto pRenderData = data[i].m_pRenderData;
-
-      if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
+      if (i == data.GetCount() || data[i].m_uiSortingKey != data[uiRunStart].m_uiSortingKey)
       {
-        dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+        if (i - uiRunStart > 1)
+        {
+          ezArrayPtr<ezRenderDataBatch::SortableRenderData> run = data.GetArrayPtr().GetSubArray(uiRunStart, i - uiRunStart);
+          ezSorting::QuickSort(run, BatchIdComparer());
+        }
 
-        uiCurrentBatchId = pRenderData->m_uiBatchId;
-        uiCurrentBatchStartIndex = i;
-        pCurrentBatchType = pRenderData->GetDynamicRTTI();
+        uiRunStart = i;
       }
     }
+  }
 
-    dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
-        ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
+  // Find batches
+  ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
+  ezUInt32 uiCurrentBatchStartIndex = 0;
+  const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+
+  for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+  {
+    auto pRenderData = data[i].m_pRenderData;
+
+    if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
+    {
+      m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+
+      uiCurrentBatchId = pRenderData->m_uiBatchId;
+      uiCurrentBatchStartIndex = i;
+      pCurrentBatchType = pRenderData->GetDynamicRTTI();
+    }
+  }
+
+  m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
+}
+
+void ezExtractedRenderData::SortAndBatch()
+{
+  EZ_PROFILE_SCOPE("SortAndBatch");
+
+  ezUInt32 uiTotalCount = 0;
+  for (const auto& dataPerCategory : m_DataPerCategory)
+  {
+    uiTotalCount += dataPerCategory.m_SortableRenderData.GetCount();
+  }
+
+  if (uiTotalCount < s_uiParallelSortThreshold)
+  {
+    for (auto& dataPerCategory : m_DataPerCategory)
+    {
+      dataPerCategory.SortAndBatch();
+    }
+  }
+  else
+  {
+    // the categories differ a lot in size, so let idle workers pick up the remaining ones
+    ezParallelForParams params;
+    params.splitting = ezParallelForSplitting::Adaptive;
+    params.uiGrainSize = 1;
+
+    ezTaskSystem::ParallelFor(m_DataPerCategory.GetArrayPtr(),
+      [](ezArrayPtr<DataPerCategory> categories) {
+        for (auto& dataPerCategory : categories)
+        {
+          dataPerCategory.SortAndBatch();
+        }
+      },
+      "SortAndBatch", params);
   }
 }
 
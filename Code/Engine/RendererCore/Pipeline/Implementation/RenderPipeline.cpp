@@ -1,5 +1,6 @@
 #include <RendererCorePCH.h>
 
+#include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <RendererCore/Debug/DebugRenderer.h>
@@ -20,6 +21,9 @@ ezCVarBool ezRenderPipeline::s_DebugCulling("r_DebugCulling", false, ezCVarFlags
 ezCVarBool CVarCullingStats("r_CullingStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
 #endif
 
+ezCVarBool CVarOcclusionCulling("r_OcclusionCulling", false, ezCVarFlags::Save,
+  "Culls objects that are hidden behind occluder meshes, which are rasterized into a small depth buffer on the CPU");
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -934,14 +938,17 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
+  const ezOcclusionBuffer* pOcclusionBuffer = CVarOcclusionCulling ? RasterizeOccluders(view, frustum) : nullptr;
+
+  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView =
     (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
   const bool bRecordStats = CVarCullingStats && bIsMainView;
   ezSpatialSystem::QueryStats stats;
 
-  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
-  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr, pOcclusionBuffer);
 
   ezViewHandle hView = view.GetHandle();
 
@@ -965,17 +972,53 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
     sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 260), ezColor::LimeGreen);
 
+    sb.Format("Num Objects Occluded: {0} ({1} occluder triangles)", stats.m_uiNumObjectsOccluded,
+      pOcclusionBuffer != nullptr ? pOcclusionBuffer->GetNumRasterizedTriangles() : 0);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
     // Exponential moving average for better readability.
     m_AverageCullingTime = ezMath::Lerp(m_AverageCullingTime, stats.m_TimeTaken, 0.05f);
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
-    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr, pOcclusionBuffer);
 #endif
 }
 
+const ezOcclusionBuffer* ezRenderPipeline::RasterizeOccluders(const ezView& view, const ezFrustum& frustum)
+{
+  EZ_PROFILE_SCOPE("Rasterize Occluders");
+
+  m_Occluders.Clear();
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, ezDefaultSpatialDataCategories::Occluder.GetBitmask(), m_Occluders);
+
+  if (m_Occluders.IsEmpty())
+    return nullptr;
+
+  m_OccluderGeometry.m_Vertices.Clear();
+  m_OccluderGeometry.m_Triangles.Clear();
+
+  ezMsgExtractGeometry msg;
+  msg.m_Mode = ezWorldGeoExtractionUtil::ExtractionMode::OcclusionMesh;
+  msg.m_pWorldGeometry = &m_OccluderGeometry;
+
+  for (const ezGameObject* pOccluder : m_Occluders)
+  {
+    pOccluder->SendMessage(msg);
+  }
+
+  ezMat4 viewProjection;
+  view.ComputeCullingViewProjectionMatrix(viewProjection);
+
+  m_OcclusionBuffer.Clear(viewProjection);
+  m_OcclusionBuffer.RasterizeGeometry(m_OccluderGeometry);
+  m_OcclusionBuffer.BuildHierarchy();
+
+  return &m_OcclusionBuffer;
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
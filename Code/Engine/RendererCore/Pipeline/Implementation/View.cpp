@@ -137,6 +137,14 @@ void ezView::ExtractData()
 }
 
 void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
+{
+  ezMat4 viewProjectionMatrix;
+  ComputeCullingViewProjectionMatrix(viewProjectionMatrix);
+
+  out_Frustum.SetFrustum(viewProjectionMatrix);
+}
+
+void ezView::ComputeCullingViewProjectionMatrix(ezMat4& out_ViewProjection) const
 {
   const ezCamera* pCamera = GetCullingCamera();
   const float fViewportAspectRatio = m_Data.m_ViewPortRect.width / m_Data.m_ViewPortRect.height;
@@ -146,7 +154,7 @@ void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
   ezMat4 projectionMatrix;
   pCamera->GetProjectionMatrix(fViewportAspectRatio, projectionMatrix);
 
-  out_Frustum.SetFrustum(projectionMatrix * viewMatrix);
+  out_ViewProjection = projectionMatrix * viewMatrix;
 }
 
 void ezView::SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value)
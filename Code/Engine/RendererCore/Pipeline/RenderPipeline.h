@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Core/Graphics/OcclusionBuffer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
@@ -7,6 +8,7 @@
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
+class ezFrustum;
 class ezProfilingId;
 class ezView;
 class ezRenderPipelinePass;
@@ -79,6 +81,7 @@ private:
 
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
+  const ezOcclusionBuffer* RasterizeOccluders(const ezView& view, const ezFrustum& frustum);
 
   void Render(ezRenderContext* pRenderer);
 
@@ -91,6 +94,11 @@ private: // Member data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
 
+  // Occlusion culling data
+  ezDynamicArray<const ezGameObject*> m_Occluders;
+  ezWorldGeoExtractionUtil::Geometry m_OccluderGeometry;
+  ezOcclusionBuffer m_OcclusionBuffer;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
 #endif
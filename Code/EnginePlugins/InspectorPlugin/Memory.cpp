@@ -54,6 +54,35 @@ namespace MemoryDetail
     ezMemoryTracker::ResetPerFrameAllocatorStats();
   }
 
+  static void BroadcastSampledAllocations()
+  {
+    // the callstacks are sent unresolved, which is too much data to do every frame
+    static ezTime LastBroadcast;
+
+    const ezTime tNow = ezTime::Now();
+    if (ezMemoryTracker::GetSamplingInterval() == 0 || tNow - LastBroadcast < ezTime::Seconds(1))
+      return;
+
+    LastBroadcast = tNow;
+
+    ezMemoryTracker::EnumerateSampledAllocations([](const ezMemoryTracker::SampledAllocationGroup& group, void*) {
+      ezTelemetryMessage msg;
+      msg.SetMessageID(' MEM', 'SMPL');
+      msg.GetWriter() << group.m_AllocatorId.m_Data;
+      msg.GetWriter() << group.m_uiEstimatedSize;
+      msg.GetWriter() << group.m_uiEstimatedCount;
+      msg.GetWriter() << group.m_uiNumSamples;
+
+      msg.GetWriter() << group.m_StackTrace.GetCount();
+      for (void* pFrame : group.m_StackTrace)
+      {
+        msg.GetWriter() << static_cast<ezUInt64>(reinterpret_cast<size_t>(pFrame));
+      }
+
+      ezTelemetry::Broadcast(ezTelemetry::Unreliable, msg);
+    });
+  }
+
   static void PerframeUpdateHandler(const ezGameApplicationExecutionEvent& e)
   {
     if (!ezTelemetry::IsConnectedToClient())
@@ -63,6 +92,7 @@ namespace MemoryDetail
     {
       case ezGameApplicationExecutionEvent::Type::AfterPresent:
         BroadcastMemoryStats();
+        BroadcastSampledAllocations();
         break;
 
       default:
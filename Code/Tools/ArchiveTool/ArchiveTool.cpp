@@ -27,6 +27,11 @@ For unpacking the target should be a folder (may or may not exist) into which th
 
 If no -out is specified, it is determined to be where the input file is located.
 
+When packing, small files of the same type are compressed with a shared zstd dictionary, which is built from those files
+and stored in the archive. -nodict disables this.
+
+Files with identical content are only stored once in the archive. -nodedup disables this.
+
 If neither -pack nor -unpack is specified, the mode is detected automatically from the list of inputs.
 If all inputs are folders, mode is going to be 'pack'.
 If all inputs are files, mode is going to be 'unpack'.
@@ -99,6 +104,8 @@ public:
 
   ezDynamicArray<ezString> m_sInputs;
   ezString m_sOutput;
+  bool m_bUseDictionaries = true;
+  bool m_bDeduplicateFiles = true;
 
   ezArchiveTool()
     : ezApplication("ArchiveTool")
@@ -116,6 +123,8 @@ public:
     ezCommandLineUtils& cmd = *ezCommandLineUtils::GetGlobalInstance();
 
     m_sOutput = cmd.GetStringOption("-out");
+    m_bUseDictionaries = cmd.GetOptionIndex("-nodict") < 0;
+    m_bDeduplicateFiles = cmd.GetOptionIndex("-nodedup") < 0;
 
     ezStringBuilder path;
 
@@ -172,6 +181,9 @@ public:
       {
         const char* szArg = GetArgument(a);
 
+        if (ezStringUtils::IsEqual_NoCase(szArg, "-nodict") || ezStringUtils::IsEqual_NoCase(szArg, "-nodedup"))
+          continue;
+
         if (ezStringUtils::IsEqual_NoCase(szArg, "-out"))
           break;
 
@@ -250,6 +262,14 @@ public:
   {
     ezArchiveBuilderImpl archive;
 
+    if (m_bUseDictionaries)
+    {
+      // material, prefab and shader permutation files are typically only a few KB and compress poorly on their own
+      archive.m_uiMaxDictionaryFileSize = 16 * 1024;
+    }
+
+    archive.m_bDeduplicateFiles = m_bDeduplicateFiles;
+
     for (const auto& folder : m_sInputs)
     {
       archive.AddFolder(folder, ezArchiveCompressionMode::Compressed_zstd, PackFileCallback);
@@ -1,12 +1,19 @@
 #include <CoreTestPCH.h>
 
+#include <Core/Collection/CollectionUtils.h>
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/Thread.h>
 #include <Foundation/Types/ScopeExit.h>
+#include <Foundation/Utilities/ConversionUtils.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
 
 namespace
 {
+  /// Length of the chain of "Deep-{n}" resources, each of which references the next one.
+  static constexpr ezUInt32 s_uiDeepChainLength = 8;
+
   typedef ezTypedResourceHandle<class TestResource> TestResourceHandle;
 
   class TestResource : public ezResource
@@ -23,6 +30,9 @@ namespace
   protected:
     virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override
     {
+      m_Data.Clear();
+      m_Data.Compact();
+
       ezResourceLoadDesc ld;
       ld.m_State = ezResourceState::Unloaded;
       ld.m_uiQualityLevelsDiscardable = 0;
@@ -57,6 +67,25 @@ namespace
         EZ_ASSERT_ALWAYS(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final, "");
       }
 
+      if (GetResourceID() == "Chain-A")
+      {
+        m_Nested = ezResourceManager::LoadResource<TestResource>("Chain-B");
+      }
+
+      if (GetResourceID() == "Chain-B")
+      {
+        m_Nested = ezResourceManager::LoadResource<TestResource>("Chain-C");
+      }
+
+      ezUInt32 uiDeepLevel = 0;
+      if (GetResourceID().StartsWith("Deep-") && ezConversionUtils::StringToUInt(GetResourceID().GetData() + 5, uiDeepLevel).Succeeded() &&
+          uiDeepLevel + 1 < s_uiDeepChainLength)
+      {
+        ezStringBuilder sNext;
+        sNext.Format("Deep-{}", uiDeepLevel + 1);
+        m_Nested = ezResourceManager::LoadResource<TestResource>(sNext);
+      }
+
       m_Data.SetCountUninitialized(uiNumElements);
 
       for (ezUInt32 i = 0; i < uiNumElements; ++i)
@@ -69,7 +98,7 @@ namespace
 
     virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override
     {
-      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(TestResource);
+      out_NewMemoryUsage.m_uiMemoryCPU = m_Data.GetCount() * sizeof(ezUInt32);
       out_NewMemoryUsage.m_uiMemoryGPU = 0;
     }
 
@@ -87,25 +116,37 @@ namespace
   class TestResourceTypeLoader : public ezResourceTypeLoader
   {
   public:
+    TestResourceTypeLoader(ezUInt32 uiNumElements = 1024 * 10)
+      : m_uiNumElements(uiNumElements)
+    {
+    }
+
     struct LoadedData
     {
       ezMemoryStreamStorage m_StreamData;
       ezMemoryStreamReader m_Reader;
     };
 
+    /// Every read waits this long, like a read from a cold disk.
+    ezTime m_ReadLatency;
+
     virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
     {
+      if (m_ReadLatency.IsPositive())
+      {
+        ezThreadUtils::Sleep(m_ReadLatency);
+      }
+
       LoadedData* pData = EZ_DEFAULT_NEW(LoadedData);
 
-      const ezUInt32 uiNumElements = 1024 * 10;
-      pData->m_StreamData.Reserve(uiNumElements * sizeof(ezUInt32) + 1);
+      pData->m_StreamData.Reserve(m_uiNumElements * sizeof(ezUInt32) + 1);
 
       ezMemoryStreamWriter writer(&pData->m_StreamData);
       pData->m_Reader.SetStorage(&pData->m_StreamData);
 
-      writer << uiNumElements;
+      writer << m_uiNumElements;
 
-      for (ezUInt32 i = 0; i < uiNumElements; ++i)
+      for (ezUInt32 i = 0; i < m_uiNumElements; ++i)
       {
         writer << i;
       }
@@ -123,8 +164,102 @@ namespace
       LoadedData* pData = static_cast<LoadedData*>(LoaderData.m_pCustomLoaderData);
       EZ_DEFAULT_DELETE(pData);
     }
+
+  private:
+    ezUInt32 m_uiNumElements;
   };
 
+  /// Looks up already existing resources over and over, like gameplay code that spawns many objects.
+  class LookupThread : public ezThread
+  {
+  public:
+    const ezDynamicArray<ezString>* m_pResourceIDs = nullptr;
+    ezUInt32 m_uiNumLookups = 0;
+    ezAtomicInteger32* m_pNumFinished = nullptr;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      const ezDynamicArray<ezString>& ids = *m_pResourceIDs;
+
+      for (ezUInt32 i = 0; i < m_uiNumLookups; ++i)
+      {
+        TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(ids[i % ids.GetCount()]);
+        EZ_ASSERT_ALWAYS(hResource.IsValid(), "");
+      }
+
+      m_pNumFinished->Increment();
+      return 0;
+    }
+  };
+
+  /// Runs uiNumLookups lookups on each of the given number of threads and returns the lookups per second.
+  double MeasureLookupsPerSecond(const ezDynamicArray<ezString>& resourceIDs, ezUInt32 uiNumThreads, ezUInt32 uiNumLookups)
+  {
+    ezAtomicInteger32 iNumFinished;
+    ezDynamicArray<LookupThread*> threads;
+
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      LookupThread* pThread = EZ_DEFAULT_NEW(LookupThread);
+      pThread->m_pResourceIDs = &resourceIDs;
+      pThread->m_uiNumLookups = uiNumLookups;
+      pThread->m_pNumFinished = &iNumFinished;
+
+      threads.PushBack(pThread);
+    }
+
+    const ezTime tStart = ezTime::Now();
+
+    for (LookupThread* pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    for (LookupThread* pThread : threads)
+    {
+      pThread->Join();
+      EZ_DEFAULT_DELETE(pThread);
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+
+    return (double)uiNumThreads * uiNumLookups / tDuration.GetSeconds();
+  }
+
+  /// Acquires the "Deep-{n}" resources one after another, like code that only learns about a resource from the one that references it.
+  /// Returns how long it took until all of them were loaded.
+  ezTime MeasureDeepChainLoad()
+  {
+    const ezTime tStart = ezTime::Now();
+
+    {
+      ezHybridArray<TestResourceHandle, s_uiDeepChainLength> hResources;
+      ezStringBuilder sResourceID;
+
+      for (ezUInt32 i = 0; i < s_uiDeepChainLength; ++i)
+      {
+        sResourceID.Format("Deep-{}", i);
+        hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+        ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+        EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+      }
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    return tDuration;
+  }
+
   EZ_RESOURCE_IMPLEMENT_COMMON_CODE(TestResource);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestResource, 1, ezRTTIDefaultAllocator<TestResource>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
@@ -191,6 +326,50 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
 
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ConcurrentDataLoads")
+  {
+    // by default as many resources are read at the same time as there are file access threads
+    ezTaskSystem::SetWorkerThreadCount(-1, -1, 4);
+    EZ_SCOPE_EXIT(ezTaskSystem::SetWorkerThreadCount());
+    EZ_TEST_INT(ezResourceManager::GetMaxConcurrentDataLoads(), 4);
+
+    ezResourceManager::SetMaxConcurrentDataLoads(3);
+    EZ_SCOPE_EXIT(ezResourceManager::SetMaxConcurrentDataLoads(0));
+    EZ_TEST_INT(ezResourceManager::GetMaxConcurrentDataLoads(), 3);
+
+    const ezUInt32 uiNumResources = 200;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Concurrent-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+
+      pTestResource->Test();
+    }
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
@@ -289,3 +468,492 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, LoadingPriority)
+{
+  // a lot of resources are queued here, keep them small
+  TestResourceTypeLoader TypeLoader(1);
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "PriorityBump")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    const ezUInt32 uiNumResources = 50000;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Stress-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    // the last queued resource is suddenly needed urgently
+    const ezTime tStart = ezTime::Now();
+    {
+      ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::PointerOnly);
+      pTestResource->SetPriority(ezResourcePriority::Critical);
+    }
+
+    while (ezResourceManager::GetLoadingState(hResources.PeekBack()) != ezResourceState::Loaded)
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    const ezTime tTimeToLoad = ezTime::Now() - tStart;
+
+    ezUInt32 uiNumLoaded = 0;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      if (ezResourceManager::GetLoadingState(hResources[i]) == ezResourceState::Loaded)
+        ++uiNumLoaded;
+    }
+
+    ezLog::Info("Priority-bumped resource was loaded after {0} ms, {1} of {2} queued resources were loaded by then", ezArgF(tTimeToLoad.GetMilliseconds(), 2), uiNumLoaded, uiNumResources);
+
+    // it must not wait for the rest of the queue
+    EZ_TEST_BOOL(uiNumLoaded < uiNumResources / 2);
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "HighestPriority")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    const ezUInt32 uiNumResources = 50000;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Waiting-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::PointerOnly);
+      pTestResource->SetPriority(ezResourcePriority::Critical);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    // waiting for a resource must move it in front of everything else, even in front of other critical resources
+    {
+      ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    ezUInt32 uiNumLoaded = 0;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      if (ezResourceManager::GetLoadingState(hResources[i]) == ezResourceState::Loaded)
+        ++uiNumLoaded;
+    }
+
+    EZ_TEST_BOOL(uiNumLoaded < uiNumResources / 2);
+
+    hResources.Clear();
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, MemoryBudget)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TypeBudget")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+    const ezUInt32 uiNumResources = 10;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Budget-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      // acquire every resource in a different frame, so that they have different last acquire times
+      ezResourceManager::PerFrameUpdate();
+
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    ezUInt64 uiResourceSize = 0;
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[0], ezResourceAcquireMode::PointerOnly);
+      uiResourceSize = pTestResource->GetMemoryUsage().m_uiMemoryCPU;
+    }
+
+    ezHybridArray<ezResourceManagerEvent, 4> events;
+    ezEventSubscriptionID subscription = ezResourceManager::GetManagerEvents().AddEventHandler([&events](const ezResourceManagerEvent& e) {
+      if (e.m_Type == ezResourceManagerEvent::Type::MemoryBudgetExceeded)
+        events.PushBack(e);
+    });
+    EZ_SCOPE_EXIT(ezResourceManager::GetManagerEvents().RemoveEventHandler(subscription));
+
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(uiResourceSize * 4, 0);
+    ezResourceManager::PerFrameUpdate();
+
+    // the least recently acquired resources are unloaded, until the budget is met
+    if (EZ_TEST_INT(events.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_BOOL(events[0].m_pResourceType == ezGetStaticRTTI<TestResource>());
+      EZ_TEST_INT(events[0].m_uiMemoryCPU, uiResourceSize * uiNumResources);
+      EZ_TEST_INT(events[0].m_uiFreedMemoryCPU, uiResourceSize * 6);
+      EZ_TEST_INT(events[0].m_uiNumUnloadedResources, 6);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      const ezResourceState expectedState = i < 6 ? ezResourceState::Unloaded : ezResourceState::Loaded;
+      EZ_TEST_BOOL(ezResourceManager::GetLoadingState(hResources[i]) == expectedState);
+    }
+
+    // within budget now
+    events.Clear();
+    ezResourceManager::PerFrameUpdate();
+    EZ_TEST_INT(events.GetCount(), 0);
+
+    {
+      // resources that are in use can't be unloaded, a budget that stays exceeded is only reported once
+      ezResourceLock<TestResource> pResource6(hResources[6], ezResourceAcquireMode::PointerOnly);
+      ezResourceLock<TestResource> pResource7(hResources[7], ezResourceAcquireMode::PointerOnly);
+      ezResourceLock<TestResource> pResource8(hResources[8], ezResourceAcquireMode::PointerOnly);
+      ezResourceLock<TestResource> pResource9(hResources[9], ezResourceAcquireMode::PointerOnly);
+
+      ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(uiResourceSize * 2, 0);
+      ezResourceManager::PerFrameUpdate();
+
+      if (EZ_TEST_INT(events.GetCount(), 1).Succeeded())
+      {
+        EZ_TEST_INT(events[0].m_uiNumUnloadedResources, 0);
+      }
+
+      events.Clear();
+      ezResourceManager::PerFrameUpdate();
+      EZ_TEST_INT(events.GetCount(), 0);
+    }
+
+    // reported again as soon as something gets unloaded
+    ezResourceManager::PerFrameUpdate();
+
+    if (EZ_TEST_INT(events.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_INT(events[0].m_uiNumUnloadedResources, 2);
+    }
+
+    events.Clear();
+    ezResourceManager::PerFrameUpdate();
+    EZ_TEST_INT(events.GetCount(), 0);
+
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(0, 0);
+
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, Dependencies)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::AllowResourceTypeAcquireDuringUpdateContent<TestResource, TestResource>();
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+  EZ_SCOPE_EXIT(ezResourceManager::ClearResourceDependencies());
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Record")
+  {
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    ezResourceManager::SetRecordResourceDependencies(true);
+
+    const char* szChain[] = {"Chain-A", "Chain-B", "Chain-C"};
+    for (const char* szResourceID : szChain)
+    {
+      TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>(szResourceID);
+      ezResourceLock<TestResource> pTestResource(hResource, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    ezResourceManager::SetRecordResourceDependencies(false);
+
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+#else
+    ezResourceManager::RegisterResourceDependency("Chain-A", ezGetStaticRTTI<TestResource>(), "Chain-B");
+    ezResourceManager::RegisterResourceDependency("Chain-B", ezGetStaticRTTI<TestResource>(), "Chain-C");
+#endif
+
+    ezDynamicArray<ezResourceManager::ResourceDependency> dependencies;
+    ezResourceManager::GetResourceDependencies("Chain-A", dependencies);
+    if (EZ_TEST_INT(dependencies.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_BOOL(dependencies[0].m_pResourceType == ezGetStaticRTTI<TestResource>());
+      EZ_TEST_STRING(dependencies[0].m_sResourceID, "Chain-B");
+    }
+
+    ezResourceManager::GetResourceDependencies("Chain-C", dependencies);
+    EZ_TEST_INT(dependencies.GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Preload")
+  {
+    TestResourceHandle hResource = ezResourceManager::LoadResource<TestResource>("Chain-A");
+    ezResourceManager::PreloadResource(hResource);
+
+    // the whole chain is queued right away, before Chain-A has been loaded
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 3);
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    }
+
+    EZ_TEST_BOOL(ezResourceManager::GetLoadingState(ezResourceManager::LoadResource<TestResource>("Chain-C")) == ezResourceState::Loaded);
+
+    hResource.Invalidate();
+    ezResourceManager::FreeAllUnusedResources();
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Collection")
+  {
+    ezResourceManager::RegisterResourceForAssetType("TestResourceAsset", ezGetStaticRTTI<TestResource>());
+
+    ezCollectionResourceDescriptor collection;
+    collection.m_Resources.ExpandAndGetRef().m_sResourceID = "Chain-A";
+    collection.m_Resources[0].m_sAssetTypeName.Assign("TestResourceAsset");
+
+    ezCollectionUtils::AddResourceDependencies(collection);
+
+    if (EZ_TEST_INT(collection.m_Resources.GetCount(), 3).Succeeded())
+    {
+      EZ_TEST_STRING(collection.m_Resources[1].m_sResourceID, "Chain-B");
+      EZ_TEST_STRING(collection.m_Resources[2].m_sResourceID, "Chain-C");
+      EZ_TEST_STRING(collection.m_Resources[2].m_sAssetTypeName.GetString(), "testresourceasset");
+      EZ_TEST_BOOL(collection.m_Resources[0].m_Dependencies.GetCount() == 1 && collection.m_Resources[0].m_Dependencies[0] == 1);
+      EZ_TEST_BOOL(collection.m_Resources[1].m_Dependencies.GetCount() == 1 && collection.m_Resources[1].m_Dependencies[0] == 2);
+      EZ_TEST_BOOL(collection.m_Resources[2].m_Dependencies.IsEmpty());
+    }
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+    collection.Save(writer);
+
+    ezCollectionResourceDescriptor loaded;
+    loaded.Load(reader);
+
+    if (EZ_TEST_INT(loaded.m_Resources.GetCount(), 3).Succeeded())
+    {
+      EZ_TEST_BOOL(loaded.m_Resources[0].m_Dependencies == collection.m_Resources[0].m_Dependencies);
+      EZ_TEST_BOOL(loaded.m_Resources[1].m_Dependencies == collection.m_Resources[1].m_Dependencies);
+    }
+
+    // merging remaps the dependency indices to the merged entries
+    ezCollectionResourceDescriptor other;
+    other.m_Resources.ExpandAndGetRef().m_sResourceID = "Chain-C";
+    other.m_Resources.ExpandAndGetRef().m_sResourceID = "Chain-D";
+    other.m_Resources[0].m_Dependencies.PushBack(1);
+
+    const ezCollectionResourceDescriptor* inputs[] = {&other, &collection};
+    ezCollectionResourceDescriptor merged;
+    ezCollectionUtils::MergeCollections(merged, ezMakeArrayPtr(inputs));
+
+    if (EZ_TEST_INT(merged.m_Resources.GetCount(), 4).Succeeded())
+    {
+      EZ_TEST_STRING(merged.m_Resources[2].m_sResourceID, "Chain-A");
+      EZ_TEST_BOOL(merged.m_Resources[0].m_Dependencies.GetCount() == 1 && merged.m_Resources[0].m_Dependencies[0] == 1);
+      EZ_TEST_BOOL(merged.m_Resources[2].m_Dependencies.GetCount() == 1 && merged.m_Resources[2].m_Dependencies[0] == 3);
+      EZ_TEST_BOOL(merged.m_Resources[3].m_Dependencies.GetCount() == 1 && merged.m_Resources[3].m_Dependencies[0] == 0);
+    }
+
+    // a loaded collection registers its dependencies again
+    ezResourceManager::ClearResourceDependencies();
+
+    ezCollectionResourceHandle hCollection = ezResourceManager::CreateResource<ezCollectionResource>("ChainCollection", std::move(loaded));
+
+    ezDynamicArray<ezResourceManager::ResourceDependency> dependencies;
+    ezResourceManager::GetResourceDependencies("Chain-B", dependencies);
+    if (EZ_TEST_INT(dependencies.GetCount(), 1).Succeeded())
+    {
+      EZ_TEST_STRING(dependencies[0].m_sResourceID, "Chain-C");
+    }
+
+    hCollection.Invalidate();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cold Load")
+  {
+    TypeLoader.m_ReadLatency = ezTime::Milliseconds(20);
+
+    ezTaskSystem::SetWorkerThreadCount(-1, -1, 4);
+    EZ_SCOPE_EXIT(ezTaskSystem::SetWorkerThreadCount());
+
+    // without known dependencies every read only starts once the resource that references it has been loaded
+    ezResourceManager::ClearResourceDependencies();
+    const ezTime tSerialized = MeasureDeepChainLoad();
+
+    // the collection asset transform stores the references of each asset like this
+    ezCollectionResourceDescriptor collection;
+    collection.m_Resources.ExpandAndGetRef().m_sResourceID = "Deep-0";
+    collection.m_Resources[0].m_sAssetTypeName.Assign("TestResourceAsset");
+
+    ezCollectionUtils::AddResourceDependencies(collection, [](const char* szResourceID, ezDynamicArray<ezCollectionUtils::Dependency>& out_Dependencies) {
+      ezUInt32 uiDeepLevel = 0;
+      if (ezConversionUtils::StringToUInt(szResourceID + 5, uiDeepLevel).Succeeded() && uiDeepLevel + 1 < s_uiDeepChainLength)
+      {
+        ezStringBuilder sNext;
+        sNext.Format("Deep-{}", uiDeepLevel + 1);
+
+        auto& dependency = out_Dependencies.ExpandAndGetRef();
+        dependency.m_sAssetTypeName = "TestResourceAsset";
+        dependency.m_sResourceID = sNext;
+      }
+    });
+
+    EZ_TEST_INT(collection.m_Resources.GetCount(), s_uiDeepChainLength);
+
+    ezCollectionResourceHandle hCollection = ezResourceManager::CreateResource<ezCollectionResource>("DeepCollection", std::move(collection));
+
+    // the first acquire now queues the whole chain, so the reads overlap
+    const ezTime tPreloaded = MeasureDeepChainLoad();
+
+    ezLog::Info("[test]Cold load of {0} chained resources: {1} ms serialized, {2} ms with collection dependencies", s_uiDeepChainLength,
+      ezArgF(tSerialized.GetMilliseconds(), 1), ezArgF(tPreloaded.GetMilliseconds(), 1));
+
+    EZ_TEST_BOOL(tSerialized.GetMilliseconds() >= s_uiDeepChainLength * 20.0);
+    EZ_TEST_BOOL(tPreloaded < tSerialized);
+
+    TypeLoader.m_ReadLatency.SetZero();
+    hCollection.Invalidate();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+}
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, ConcurrentLookup)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  ezDynamicArray<ezString> resourceIDs;
+  ezDynamicArray<TestResourceHandle> hResources;
+
+  ezStringBuilder sResourceID;
+  for (ezUInt32 i = 0; i < 16; ++i)
+  {
+    sResourceID.Format("Hot-{}", i);
+    resourceIDs.PushBack(sResourceID);
+    hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lookup")
+  {
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("Hot-3") == hResources[3]);
+    EZ_TEST_BOOL(ezResourceManager::GetExistingResource<TestResource>("Hot-5") == hResources[5]);
+    EZ_TEST_BOOL(ezResourceManager::LoadResourceByType(ezGetStaticRTTI<TestResource>(), "Hot-7") == hResources[7]);
+    EZ_TEST_BOOL(!ezResourceManager::GetExistingResource<TestResource>("Cold-0").IsValid());
+
+    // a named resource takes precedence over a resource with the same ID
+    ezResourceManager::RegisterNamedResource("Hot-0", "Hot-1");
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("Hot-0") == hResources[1]);
+    ezResourceManager::UnregisterNamedResource("Hot-0");
+    EZ_TEST_BOOL(ezResourceManager::LoadResource<TestResource>("Hot-0") == hResources[0]);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Locked Manager")
+  {
+    // looking up existing resources must not wait for the resource manager mutex, which loading tasks and PerFrameUpdate() hold
+    const ezUInt32 uiNumThreads = 4;
+
+    ezAtomicInteger32 iNumFinished;
+    LookupThread threads[uiNumThreads];
+
+    {
+      EZ_LOCK(ezResourceManager::GetMutex());
+
+      for (LookupThread& thread : threads)
+      {
+        thread.m_pResourceIDs = &resourceIDs;
+        thread.m_uiNumLookups = 1000;
+        thread.m_pNumFinished = &iNumFinished;
+        thread.Start();
+      }
+
+      const ezTime tStart = ezTime::Now();
+      while (iNumFinished < uiNumThreads && ezTime::Now() - tStart < ezTime::Seconds(10))
+      {
+        ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+      }
+
+      EZ_TEST_INT(iNumFinished, uiNumThreads);
+    }
+
+    for (LookupThread& thread : threads)
+    {
+      thread.Join();
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Contention")
+  {
+    const ezUInt32 threadCounts[] = {1, 2, 4, 8, 16};
+
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      const double fLookups = MeasureLookupsPerSecond(resourceIDs, uiThreads, 1000000);
+
+      ezLog::Info("[test]LoadResource, {0} threads: {1} lookups/sec", uiThreads, ezArgF(fLookups, 0));
+    }
+  }
+
+  hResources.Clear();
+  ezResourceManager::FreeAllUnusedResources();
+  EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+}
@@ -0,0 +1,192 @@
+#include <CoreTestPCH.h>
+
+#include <Core/Graphics/OcclusionBuffer.h>
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/World.h>
+#include <Foundation/Utilities/GraphicsUtils.h>
+
+namespace
+{
+  typedef ezComponentManager<class OcclusionTestComponent, ezBlockStorageType::Compact> OcclusionTestComponentManager;
+
+  class OcclusionTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(OcclusionTestComponent, ezComponent, OcclusionTestComponentManager);
+
+  public:
+    virtual void Initialize() override { GetOwner()->UpdateLocalBounds(); }
+
+    void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) { msg.AddBounds(m_Bounds, m_Category); }
+
+    ezBoundingBox m_Bounds;
+    ezSpatialData::Category m_Category = ezDefaultSpatialDataCategories::RenderStatic;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(OcclusionTestComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds)
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  // A 10x10 wall at x = 10, facing the camera at the origin which looks along +X.
+  void RasterizeWall(ezOcclusionBuffer& buffer)
+  {
+    const ezVec3 a(10, -5, -5);
+    const ezVec3 b(10, 5, -5);
+    const ezVec3 c(10, 5, 5);
+    const ezVec3 d(10, -5, 5);
+
+    buffer.RasterizeTriangle(a, b, c);
+    buffer.RasterizeTriangle(a, d, c); // opposite winding
+  }
+
+  ezBoundingBox MakeBox(const ezVec3& vCenter, float fHalfExtent)
+  {
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(vCenter, ezVec3(fHalfExtent));
+    return box;
+  }
+
+  const ezGameObject* CreateObject(ezWorld& world, const ezBoundingBox& bounds, ezSpatialData::Category category)
+  {
+    ezGameObjectDesc desc;
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    OcclusionTestComponent* pComponent = nullptr;
+    OcclusionTestComponent::CreateComponent(pObject, pComponent);
+    pComponent->m_Bounds = bounds;
+    pComponent->m_Category = category;
+
+    return pObject;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, OcclusionBuffer)
+{
+  const ezMat4 viewMatrix = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Perspective")
+  {
+    const ezClipSpaceDepthRange::Enum depthRanges[] = {ezClipSpaceDepthRange::ZeroToOne, ezClipSpaceDepthRange::MinusOneToOne};
+
+    for (ezClipSpaceDepthRange::Enum depthRange : depthRanges)
+    {
+      const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(90), 2.0f, 0.1f, 1000.0f, depthRange);
+
+      ezOcclusionBuffer buffer;
+      buffer.SetResolution(127, 64);
+      EZ_TEST_INT(buffer.GetWidth(), 128);
+      EZ_TEST_INT(buffer.GetHeight(), 64);
+
+      buffer.Clear(projection * viewMatrix, depthRange);
+      buffer.BuildHierarchy();
+
+      // nothing rasterized yet
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(20, 0, 0), 1)));
+
+      RasterizeWall(buffer);
+      buffer.BuildHierarchy();
+
+      EZ_TEST_INT(buffer.GetNumRasterizedTriangles(), 2);
+
+      // the top level contains the farthest depth of the whole buffer, which is not covered by the wall
+      ezUInt32 uiWidth, uiHeight;
+      ezArrayPtr<const float> topLevel = buffer.GetDepthValues(buffer.GetNumLevels() - 1, uiWidth, uiHeight);
+      EZ_TEST_INT(uiWidth, 1);
+      EZ_TEST_INT(uiHeight, 1);
+      EZ_TEST_FLOAT(topLevel[0], ezMath::MaxValue<float>(), 0);
+
+      // behind the wall
+      EZ_TEST_BOOL(buffer.IsOccluded(MakeBox(ezVec3(20, 0, 0), 1)));
+      EZ_TEST_BOOL(buffer.IsOccluded(MakeBox(ezVec3(100, 0, 0), 20)));
+      EZ_TEST_BOOL(buffer.IsOccluded(MakeBox(ezVec3(11, 3, -3), 0.5f)));
+
+      // in front of the wall or intersecting it
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(5, 0, 0), 1)));
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(10, 0, 0), 1)));
+
+      // behind the wall, but visible next to it
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(20, 12, 0), 1)));
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(100, 0, 0), 60)));
+
+      // crossing the near plane
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(0, 0, 0), 1)));
+
+      // a triangle that crosses the near plane is not rasterized
+      buffer.RasterizeTriangle(ezVec3(-1, -50, -50), ezVec3(50, 50, -50), ezVec3(50, 0, 50));
+      EZ_TEST_INT(buffer.GetNumRasterizedTriangles(), 2);
+
+      // clearing removes all occluders
+      buffer.Clear(projection * viewMatrix, depthRange);
+      buffer.BuildHierarchy();
+      EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(20, 0, 0), 1)));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Orthographic")
+  {
+    const ezMat4 projection = ezGraphicsUtils::CreateOrthographicProjectionMatrix(40.0f, 20.0f, 0.1f, 1000.0f);
+
+    ezOcclusionBuffer buffer;
+    buffer.Clear(projection * viewMatrix);
+
+    RasterizeWall(buffer);
+    buffer.BuildHierarchy();
+
+    EZ_TEST_BOOL(buffer.IsOccluded(MakeBox(ezVec3(20, 0, 0), 1)));
+    EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(5, 0, 0), 1)));
+    EZ_TEST_BOOL(!buffer.IsOccluded(MakeBox(ezVec3(20, 8, 0), 1)));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    const ezGameObject* pWall = CreateObject(world, ezBoundingBox(ezVec3(10, -5, -5), ezVec3(10, 5, 5)), ezDefaultSpatialDataCategories::Occluder);
+    const ezGameObject* pVisible = CreateObject(world, MakeBox(ezVec3(5, 0, 0), 1), ezDefaultSpatialDataCategories::RenderStatic);
+    const ezGameObject* pHidden = CreateObject(world, MakeBox(ezVec3(20, 0, 0), 1), ezDefaultSpatialDataCategories::RenderStatic);
+    const ezGameObject* pHiddenOccluder = CreateObject(world, MakeBox(ezVec3(30, 0, 0), 1), ezDefaultSpatialDataCategories::Occluder);
+
+    world.Update();
+
+    const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::Degree(90), 2.0f, 0.1f, 1000.0f);
+
+    ezFrustum frustum;
+    frustum.SetFrustum(projection * viewMatrix);
+
+    ezOcclusionBuffer buffer;
+    buffer.Clear(projection * viewMatrix);
+    RasterizeWall(buffer);
+    buffer.BuildHierarchy();
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::Occluder.GetBitmask();
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+    EZ_TEST_INT(visibleObjects.GetCount(), 4);
+
+    visibleObjects.Clear();
+    ezSpatialSystem::QueryStats stats;
+    world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, &stats, &buffer);
+
+    EZ_TEST_INT(visibleObjects.GetCount(), 3);
+    EZ_TEST_BOOL(visibleObjects.Contains(pWall));
+    EZ_TEST_BOOL(visibleObjects.Contains(pVisible));
+    EZ_TEST_BOOL(!visibleObjects.Contains(pHidden));
+    EZ_TEST_BOOL(visibleObjects.Contains(pHiddenOccluder));
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    EZ_TEST_INT(stats.m_uiNumObjectsOccluded, 1);
+    EZ_TEST_INT(stats.m_uiNumObjectsPassed, 3);
+#endif
+  }
+}
@@ -1,6 +1,8 @@
 #include <CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_Octree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
@@ -55,12 +57,24 @@ namespace
   }
   EZ_END_COMPONENT_TYPE;
   // clang-format on
+
+  bool IsSphereInFrustum(const ezFrustum& frustum, const ezBoundingSphere& sphere)
+  {
+    for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+    {
+      if (frustum.GetPlane(i).GetDistanceTo(sphere.m_vCenter) > sphere.m_fRadius)
+        return false;
+    }
+
+    return true;
+  }
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezUniquePtr<ezSpatialSystem> pSpatialSystem)
 {
   ezWorldDesc worldDesc("Test");
   worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_pSpatialSystem = std::move(pSpatialSystem);
 
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
@@ -207,6 +221,104 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezFrustum testFrustum;
+    testFrustum.SetFrustum(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(1.0f, 0.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 1.0f, 8000.0f);
+
+    ezSpatialSystem_RegularGrid* pGrid = ezDynamicCast<ezSpatialSystem_RegularGrid*>(world.GetSpatialSystem());
+    const ezUInt32 uiOldThreshold = pGrid != nullptr ? pGrid->GetMultithreadedCullingThreshold() : 0;
+
+    ezDynamicArray<const ezGameObject*> singleThreadedResult;
+
+    // 0 culls all cells on this thread, 1 distributes them over the task system
+    for (ezUInt32 uiThreshold = 0; uiThreshold < (pGrid != nullptr ? 2u : 1u); ++uiThreshold)
+    {
+      if (pGrid != nullptr)
+      {
+        pGrid->SetMultithreadedCullingThreshold(uiThreshold);
+      }
+
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      ezHashSet<const ezGameObject*> uniqueObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrustum, uiCategoryBitmask, visibleObjects);
+
+      EZ_TEST_BOOL(!visibleObjects.IsEmpty());
+
+      for (auto pObject : visibleObjects)
+      {
+        EZ_TEST_BOOL(IsSphereInFrustum(testFrustum, pObject->GetGlobalBounds().GetSphere()));
+        EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+        EZ_TEST_BOOL(pObject->IsStatic());
+      }
+
+      // Check for missing objects
+      for (auto it = world.GetObjects(); it.IsValid(); ++it)
+      {
+        if (IsSphereInFrustum(testFrustum, it->GetGlobalBounds().GetSphere()))
+        {
+          EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+        }
+      }
+
+      if (uiThreshold == 0)
+      {
+        singleThreadedResult = visibleObjects;
+      }
+      else
+      {
+        // the result must not depend on the number of threads
+        EZ_TEST_BOOL(singleThreadedResult == visibleObjects);
+      }
+    }
+
+    if (pGrid != nullptr)
+    {
+      pGrid->SetMultithreadedCullingThreshold(uiOldThreshold);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Move dynamic objects")
+  {
+    // the transform update collects the spatial data changes of all dynamic objects and applies them afterwards
+    for (ezUInt32 i = 500; i < objects.GetCount(); ++i)
+    {
+      float x = (float)rng.DoubleMinMax(-range, range);
+      float y = (float)rng.DoubleMinMax(-range, range);
+      float z = (float)rng.DoubleMinMax(-range, range);
+
+      objects[i]->SetLocalPosition(ezVec3(x, y, z));
+    }
+
+    world.Update();
+
+    ezBoundingBox testBox;
+    testBox.SetCenterAndHalfExtents(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(3000.0f));
+
+    ezDynamicArray<ezGameObject*> objectsInBox;
+    ezHashSet<ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindObjectsInBox(testBox, ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask(), objectsInBox);
+
+    for (auto pObject : objectsInBox)
+    {
+      ezBoundingBox objBox = pObject->GetGlobalBounds().GetBox();
+
+      EZ_TEST_BOOL(testBox.Overlaps(objBox));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsDynamic());
+    }
+
+    // Check for missing objects
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      ezBoundingBox objBox = it->GetGlobalBounds().GetBox();
+      if (testBox.Overlaps(objBox))
+      {
+        EZ_TEST_BOOL(it->IsStatic() || uniqueObjects.Contains(it));
+      }
+    }
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -248,3 +360,14 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(nullptr);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_Octree)
+{
+  // Small bounds and nodes, so that objects outside of the octree as well as splitting and merging of nodes are covered.
+  TestSpatialSystem(EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_Octree, 16384.0f, 8));
+}
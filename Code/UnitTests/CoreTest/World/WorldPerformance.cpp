@@ -1,6 +1,9 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_Octree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -114,6 +117,200 @@ namespace
     }
   }
 
+  struct ObjectDistribution
+  {
+    enum Enum
+    {
+      Uniform,   ///< Small objects spread evenly over the whole range.
+      Clustered, ///< Small objects packed into a few dense towns.
+      LargeScale ///< A very sparse open world, mostly tiny props plus a few huge terrain chunks.
+    };
+  };
+
+  EZ_ALWAYS_INLINE ezSimdBBoxSphere GetRandomBounds(ezRandom& rng, const ezVec3& vCenter, double fMinHalfExtents, double fMaxHalfExtents)
+  {
+    const float fHalfExtents = (float)rng.DoubleMinMax(fMinHalfExtents, fMaxHalfExtents);
+    const ezSimdVec4f center(vCenter.x, vCenter.y, vCenter.z);
+
+    return ezSimdBBoxSphere(ezSimdBBox(center - ezSimdVec4f(fHalfExtents), center + ezSimdVec4f(fHalfExtents)));
+  }
+
+  void AddRandomSpatialData(ezSpatialSystem& spatialSystem, ezUInt32 uiNumObjects, float fRange,
+    ObjectDistribution::Enum distribution = ObjectDistribution::Uniform, ezDynamicArray<ezSpatialDataHandle>* out_pHandles = nullptr)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezHybridArray<ezVec3, 64> clusterCenters;
+    for (ezUInt32 i = 0; i < 64; ++i)
+    {
+      clusterCenters.PushBack(ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), 0.0f));
+    }
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezSimdBBoxSphere bounds;
+
+      if (distribution == ObjectDistribution::Clustered)
+      {
+        const ezVec3& vClusterCenter = clusterCenters[rng.UIntInRange(clusterCenters.GetCount())];
+        const float fClusterRange = fRange * 0.02f;
+
+        const ezVec3 vOffset((float)rng.DoubleMinMax(-fClusterRange, fClusterRange), (float)rng.DoubleMinMax(-fClusterRange, fClusterRange),
+          (float)rng.DoubleMinMax(-fClusterRange * 0.1, fClusterRange * 0.1));
+
+        bounds = GetRandomBounds(rng, vClusterCenter + vOffset, 0.5, 5.0);
+      }
+      else if (distribution == ObjectDistribution::LargeScale)
+      {
+        const float fLargeRange = fRange * 8.0f;
+        const ezVec3 vCenter((float)rng.DoubleMinMax(-fLargeRange, fLargeRange), (float)rng.DoubleMinMax(-fLargeRange, fLargeRange),
+          (float)rng.DoubleMinMax(-fRange * 0.1, fRange * 0.1));
+
+        // one in a hundred objects is a terrain chunk
+        if ((i % 100) == 0)
+          bounds = GetRandomBounds(rng, vCenter, 200.0, 1000.0);
+        else
+          bounds = GetRandomBounds(rng, vCenter, 0.1, 2.0);
+      }
+      else
+      {
+        const ezVec3 vCenter((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange * 0.1, fRange * 0.1));
+
+        bounds = GetRandomBounds(rng, vCenter, 0.5, 5.0);
+      }
+
+      // the queries don't care about the game object, the results are only counted
+      ezSpatialDataHandle hData = spatialSystem.CreateSpatialData(bounds, nullptr, uiCategoryBitmask);
+
+      if (out_pHandles != nullptr)
+      {
+        out_pHandles->PushBack(hData);
+      }
+    }
+  }
+
+  /// Culls the spatial system with a camera that turns around once in 16 steps and returns the average time per view.
+  ezTime MeasureCullingTime(const ezSpatialSystem& spatialSystem, float fFarPlane, ezUInt32& out_uiNumVisibleObjects)
+  {
+    const ezUInt32 uiNumViews = 16;
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    out_uiNumVisibleObjects = 0;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumViews; ++i)
+    {
+      const ezAngle angle = ezAngle::Degree(360.0f * i / uiNumViews);
+      const ezVec3 vForward(ezMath::Cos(angle), ezMath::Sin(angle), 0.0f);
+
+      ezFrustum frustum;
+      frustum.SetFrustum(ezVec3::ZeroVector(), vForward, ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, fFarPlane);
+
+      visibleObjects.Clear();
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+
+      out_uiNumVisibleObjects += visibleObjects.GetCount();
+    }
+
+    out_uiNumVisibleObjects /= uiNumViews;
+    return sw.GetRunningTotal() / (double)uiNumViews;
+  }
+
+  void MeasureCulling(ezUInt32 uiNumObjects, float fRange)
+  {
+    ezSpatialSystem_RegularGrid spatialSystem;
+    AddRandomSpatialData(spatialSystem, uiNumObjects, fRange);
+
+    ezUInt32 uiNumVisibleObjects = 0;
+
+    spatialSystem.SetMultithreadedCullingThreshold(0);
+    const ezTime tSingleThreaded = MeasureCullingTime(spatialSystem, fRange, uiNumVisibleObjects);
+
+    spatialSystem.SetMultithreadedCullingThreshold(1);
+    const ezTime tMultiThreaded = MeasureCullingTime(spatialSystem, fRange, uiNumVisibleObjects);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Culling %u objects (%u visible): %.2fms single-threaded, %.2fms multi-threaded", uiNumObjects,
+      uiNumVisibleObjects, tSingleThreaded.GetMilliseconds(), tMultiThreaded.GetMilliseconds());
+  }
+
+  /// Measures inserting, moving and querying the given number of objects in the given spatial system. All queries run on a single thread.
+  void MeasureSpatialSystem(const char* szName, ezSpatialSystem& spatialSystem, ObjectDistribution::Enum distribution, ezUInt32 uiNumObjects, float fRange)
+  {
+    static const char* s_szDistributionNames[] = {"uniform", "clustered", "large-scale"};
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<ezSpatialDataHandle> handles;
+    handles.Reserve(uiNumObjects);
+
+    ezStopwatch sw;
+
+    AddRandomSpatialData(spatialSystem, uiNumObjects, fRange, distribution, &handles);
+
+    const ezTime tInsert = sw.Checkpoint();
+
+    // move every tenth object a bit, like the dynamic objects of a typical frame
+    ezRandom rng;
+    rng.Initialize(23);
+
+    for (ezUInt32 i = 0; i < handles.GetCount(); i += 10)
+    {
+      const ezSpatialData* pData = nullptr;
+      spatialSystem.TryGetSpatialData(handles[i], pData);
+
+      ezSimdBBoxSphere bounds = pData->m_Bounds;
+      bounds.m_CenterAndRadius += ezSimdVec4f((float)rng.DoubleMinMax(-10.0, 10.0), (float)rng.DoubleMinMax(-10.0, 10.0), 0.0f, 0.0f);
+
+      spatialSystem.UpdateSpatialData(handles[i], bounds, nullptr, uiCategoryBitmask);
+    }
+
+    const ezTime tUpdate = sw.Checkpoint();
+
+    ezUInt32 uiNumVisibleObjects = 0;
+    const ezTime tCulling = MeasureCullingTime(spatialSystem, fRange, uiNumVisibleObjects);
+
+    sw.Checkpoint();
+
+    const ezUInt32 uiNumSphereQueries = 1000;
+    ezUInt32 uiNumObjectsInSpheres = 0;
+
+    for (ezUInt32 i = 0; i < uiNumSphereQueries; ++i)
+    {
+      const ezBoundingSphere sphere(ezVec3((float)rng.DoubleMinMax(-fRange, fRange), (float)rng.DoubleMinMax(-fRange, fRange), 0.0f), 50.0f);
+
+      spatialSystem.FindObjectsInSphere(sphere, uiCategoryBitmask, [&](ezGameObject* pObject) {
+        ++uiNumObjectsInSpheres;
+        return ezVisitorExecution::Continue;
+      });
+    }
+
+    const ezTime tSphereQueries = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration,
+      "%s, %u %s objects: insert %.2fms, move %u %.2fms, cull %.2fms/view (%u visible), %u sphere queries %.2fms (%u found)", szName, uiNumObjects,
+      s_szDistributionNames[distribution], tInsert.GetMilliseconds(), (handles.GetCount() + 9) / 10, tUpdate.GetMilliseconds(), tCulling.GetMilliseconds(),
+      uiNumVisibleObjects, uiNumSphereQueries, tSphereQueries.GetMilliseconds(), uiNumObjectsInSpheres);
+  }
+
+  void CompareSpatialSystems(ObjectDistribution::Enum distribution, ezUInt32 uiNumObjects, float fRange)
+  {
+    {
+      ezSpatialSystem_RegularGrid spatialSystem;
+      spatialSystem.SetMultithreadedCullingThreshold(0);
+
+      MeasureSpatialSystem("Regular grid", spatialSystem, distribution, uiNumObjects, fRange);
+    }
+
+    {
+      ezSpatialSystem_Octree spatialSystem;
+      MeasureSpatialSystem("Loose octree", spatialSystem, distribution, uiNumObjects, fRange);
+    }
+  }
 } // namespace
 
 
@@ -249,7 +446,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
   EZ_TEST_BLOCK(EnableInRelease, "MT Update 250,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
-    worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
+    worldDesc.m_bAutoCreateSpatialSystem = false; // no spatial data updates at all
     ezWorld world(worldDesc);
     MeasureCreationTime(true, 200, 5, 6, 0, &world);
 
@@ -270,7 +467,7 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
   EZ_TEST_BLOCK(EnableInRelease, "MT Update 1,000,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
-    worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
+    worldDesc.m_bAutoCreateSpatialSystem = false; // no spatial data updates at all
     ezWorld world(worldDesc);
     MeasureCreationTime(true, 100, 1, 3, 1, &world);
 
@@ -288,3 +485,37 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_Culling)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Cull 100,000 objects")
+  {
+    MeasureCulling(100000, 2000.0f);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Cull 1,000,000 objects")
+  {
+    MeasureCulling(1000000, 6000.0f);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystems)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Uniform distribution")
+  {
+    CompareSpatialSystems(ObjectDistribution::Uniform, 100000, 2000.0f);
+    CompareSpatialSystems(ObjectDistribution::Uniform, 1000000, 6000.0f);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Clustered distribution")
+  {
+    CompareSpatialSystems(ObjectDistribution::Clustered, 100000, 2000.0f);
+    CompareSpatialSystems(ObjectDistribution::Clustered, 1000000, 6000.0f);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Large-scale distribution")
+  {
+    CompareSpatialSystems(ObjectDistribution::LargeScale, 100000, 2000.0f);
+    CompareSpatialSystems(ObjectDistribution::LargeScale, 1000000, 6000.0f);
+  }
+}
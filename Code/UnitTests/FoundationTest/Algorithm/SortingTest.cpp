@@ -52,4 +52,62 @@ EZ_CREATE_SIMPLE_TEST(Algorithm, Sorting)
       EZ_TEST_BOOL(a2[i - 1] >= a2[i]);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort")
+  {
+    struct Item
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt64 m_uiKey;
+      ezUInt32 m_uiIndex;
+    };
+
+    ezDynamicArray<Item> items;
+    for (ezUInt32 i = 0; i < a1.GetCount(); ++i)
+    {
+      // only a few distinct values in the lower bytes, so that stability can be checked
+      items.PushBack({((ezUInt64)a1[i] << 40) | (a1[i] % 7), i});
+    }
+
+    ezDynamicArray<Item> temp;
+    temp.SetCountUninitialized(items.GetCount());
+
+    ezSorting::RadixSort(items.GetArrayPtr(), temp.GetArrayPtr(), [](const Item& item) { return item.m_uiKey; });
+
+    EZ_TEST_INT(items.GetCount(), a1.GetCount());
+    for (ezUInt32 i = 1; i < items.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(items[i - 1].m_uiKey <= items[i].m_uiKey);
+
+      if (items[i - 1].m_uiKey == items[i].m_uiKey)
+      {
+        EZ_TEST_BOOL(items[i - 1].m_uiIndex < items[i].m_uiIndex);
+      }
+    }
+
+    // sort by a smaller key, which is already sorted in its upper bytes
+    ezSorting::RadixSort(items.GetArrayPtr(), temp.GetArrayPtr(), [](const Item& item) { return (ezUInt16)item.m_uiIndex; });
+
+    for (ezUInt32 i = 0; i < items.GetCount(); ++i)
+    {
+      EZ_TEST_INT(items[i].m_uiIndex, i);
+    }
+
+    ezDynamicArray<ezUInt32> values;
+    for (ezInt32 value : a1)
+    {
+      values.PushBack((ezUInt32)value);
+    }
+
+    ezDynamicArray<ezUInt32> tempValues;
+    tempValues.SetCountUninitialized(values.GetCount());
+
+    ezSorting::RadixSort(values.GetArrayPtr(), tempValues.GetArrayPtr(), [](ezUInt32 value) { return value; });
+
+    for (ezUInt32 i = 1; i < values.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(values[i - 1] <= values[i]);
+    }
+  }
 }
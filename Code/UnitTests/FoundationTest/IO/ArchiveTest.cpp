@@ -1,6 +1,8 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveBuilder.h>
+#include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/DataDirTypeArchive.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
@@ -153,3 +155,536 @@ EZ_CREATE_SIMPLE_TEST(IO, Archive)
 }
 
 #endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveChunked)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveChunkedTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::CreateDirectoryStructure(sOutputFolder);
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  const ezUInt32 uiChunkSize = 1024 * 64;
+  const ezUInt64 uiNumLargeValues = (uiChunkSize * 10 + 1000) / sizeof(ezUInt64); // the last chunk is only partially filled
+  const ezUInt64 uiNumSmallValues = 1000;
+
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Chunked.ezArchive");
+
+  // every file stores increasing 64 bit values, so the value at any position is known
+  auto WriteFile = [&](const char* szFile, ezUInt64 uiNumValues) {
+    ezFileWriter file;
+    if (EZ_TEST_BOOL(file.Open(szFile).Succeeded()).Failed())
+      return;
+
+    for (ezUInt64 i = 0; i < uiNumValues; ++i)
+    {
+      file << i;
+    }
+  };
+
+  auto ReadAndCompare = [&](ezStreamReader& reader, ezUInt64 uiFirstValue, ezUInt64 uiNumValues) {
+    ezDynamicArray<ezUInt64> values;
+    values.SetCountUninitialized(static_cast<ezUInt32>(uiNumValues));
+
+    if (EZ_TEST_INT(reader.ReadBytes(values.GetData(), uiNumValues * sizeof(ezUInt64)), uiNumValues * sizeof(ezUInt64)).Failed())
+      return;
+
+    for (ezUInt32 i = 0; i < values.GetCount(); ++i)
+    {
+      if (EZ_TEST_INT(values[i], uiFirstValue + i).Failed())
+        return;
+    }
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    WriteFile(":output/Data/Large.bin", uiNumLargeValues);
+    WriteFile(":output/Data/Small.bin", uiNumSmallValues);
+
+    ezArchiveBuilder builder;
+    builder.m_uiChunkSize = uiChunkSize;
+
+    auto& large = builder.m_Entries.ExpandAndGetRef();
+    large.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/Large.bin");
+    large.m_sRelTargetPath = "Large.bin";
+    large.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+
+    auto& small = builder.m_Entries.ExpandAndGetRef();
+    small.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/Small.bin");
+    small.m_sRelTargetPath = "Small.bin";
+    small.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+
+    EZ_TEST_BOOL(builder.WriteArchive(":output/Chunked.ezArchive").Succeeded());
+  }
+
+  ezArchiveReader archive;
+  if (EZ_TEST_BOOL(archive.OpenArchive(sArchiveFile).Succeeded()).Failed())
+    return;
+
+  const ezArchiveTOC& toc = archive.GetArchiveTOC();
+  const ezUInt32 uiLargeEntry = toc.FindEntry("Large.bin");
+  const ezUInt32 uiSmallEntry = toc.FindEntry("Small.bin");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TOC")
+  {
+    EZ_TEST_INT(toc.m_uiChunkSize, uiChunkSize);
+
+    EZ_TEST_BOOL(toc.m_Entries[uiLargeEntry].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked);
+    EZ_TEST_INT(toc.GetNumChunks(toc.m_Entries[uiLargeEntry]), 11);
+    EZ_TEST_INT(toc.m_Entries[uiLargeEntry].m_uiUncompressedDataSize, uiNumLargeValues * sizeof(ezUInt64));
+
+    // files that fit into a single chunk are compressed as one stream
+    EZ_TEST_BOOL(toc.m_Entries[uiSmallEntry].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd);
+    EZ_TEST_INT(toc.GetNumChunks(toc.m_Entries[uiSmallEntry]), 0);
+
+    EZ_TEST_INT(toc.m_ChunkOffsets.GetCount(), 11);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Sequentially")
+  {
+    ezUniquePtr<ezStreamReader> pLarge = archive.CreateEntryReader(uiLargeEntry);
+    ReadAndCompare(*pLarge, 0, uiNumLargeValues);
+
+    ezUInt8 uiByte = 0;
+    EZ_TEST_INT(pLarge->ReadBytes(&uiByte, 1), 0);
+
+    ezUniquePtr<ezStreamReader> pSmall = archive.CreateEntryReader(uiSmallEntry);
+    ReadAndCompare(*pSmall, 0, uiNumSmallValues);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Small Pieces")
+  {
+    // reads that straddle chunk boundaries
+    ezUniquePtr<ezStreamReader> pLarge = archive.CreateEntryReader(uiLargeEntry);
+
+    for (ezUInt64 i = 0; i < uiNumLargeValues; i += 777)
+    {
+      ReadAndCompare(*pLarge, i, ezMath::Min<ezUInt64>(777, uiNumLargeValues - i));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Seek")
+  {
+    ezArchiveChunkedReaderZstd reader;
+    archive.ConfigureChunkedReader(uiLargeEntry, reader);
+
+    EZ_TEST_INT(reader.GetByteCount(), uiNumLargeValues * sizeof(ezUInt64));
+
+    reader.SetReadPosition(uiChunkSize * 7 + 8 * 3);
+    ReadAndCompare(reader, uiChunkSize * 7 / 8 + 3, 10);
+
+    reader.SetReadPosition(8 * 5);
+    ReadAndCompare(reader, 5, 10);
+
+    EZ_TEST_INT(reader.SkipBytes(uiChunkSize * 5), uiChunkSize * 5);
+    EZ_TEST_INT(reader.GetReadPosition(), 8 * 15 + uiChunkSize * 5);
+    ReadAndCompare(reader, 15 + uiChunkSize * 5 / 8, 10);
+
+    // a read that covers several entire chunks, which are decompressed in parallel
+    reader.SetReadPosition(uiChunkSize * 2 - 8);
+    ReadAndCompare(reader, uiChunkSize * 2 / 8 - 1, uiChunkSize * 7 / 8 + 2);
+
+    // skipping stops at the end of the entry
+    const ezUInt64 uiBytesLeft = reader.GetByteCount() - reader.GetReadPosition();
+    EZ_TEST_INT(reader.SkipBytes(uiChunkSize * 100), uiBytesLeft);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "Clear", "archive", ezFileSystem::ReadOnly) == EZ_SUCCESS).Failed())
+      return;
+
+    ezFileReader file;
+    if (EZ_TEST_BOOL(file.Open(":archive/Large.bin", 1024 * 4).Succeeded()).Failed())
+      return;
+
+    ReadAndCompare(file, 0, 10);
+
+    EZ_TEST_INT(file.SkipBytes(uiChunkSize * 8), uiChunkSize * 8);
+    ReadAndCompare(file, 10 + uiChunkSize, 10);
+
+    EZ_TEST_INT(file.SkipBytes(8 * 3), 8 * 3);
+    ReadAndCompare(file, 23 + uiChunkSize, uiNumLargeValues - 23 - uiChunkSize);
+
+    ezUInt8 uiByte = 0;
+    EZ_TEST_INT(file.ReadBytes(&uiByte, 1), 0);
+
+    EZ_TEST_FILES(":output/Data/Small.bin", ":archive/Small.bin", "Unpacked file should be identical");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadAsync")
+  {
+    // the read covers several entire chunks, which are decompressed in parallel from within the read task
+    const ezUInt64 uiFirstValue = uiChunkSize * 2 / 8 - 1;
+    const ezUInt64 uiNumValues = uiChunkSize * 7 / 8 + 2;
+
+    ezDynamicArray<ezUInt64> values;
+    values.SetCount(static_cast<ezUInt32>(uiNumValues));
+
+    ezResult result = EZ_FAILURE;
+    ezUInt64 uiBytesRead = 0;
+
+    ezFileSystem::ReadAsync(":archive/Large.bin", uiFirstValue * sizeof(ezUInt64), uiNumValues * sizeof(ezUInt64), values.GetData(), [&](ezResult res, ezUInt64 uiRead) {
+      result = res;
+      uiBytesRead = uiRead;
+    });
+
+    ezFileSystem::WaitForAsyncReads();
+
+    EZ_TEST_BOOL(result.Succeeded());
+    EZ_TEST_INT(uiBytesRead, uiNumValues * sizeof(ezUInt64));
+
+    for (ezUInt32 i = 0; i < values.GetCount(); ++i)
+    {
+      if (EZ_TEST_INT(values[i], uiFirstValue + i).Failed())
+        break;
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveDictionary)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveDictionaryTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::CreateDirectoryStructure(sOutputFolder);
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  const ezUInt32 uiNumMaterials = 16;
+
+  ezArchiveBuilder builder;
+  builder.m_uiMaxDictionaryFileSize = 16 * 1024;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generate Data")
+  {
+    ezStringBuilder sFile, sContent;
+
+    // many small files of the same type, which share most of their content
+    for (ezUInt32 i = 0; i < uiNumMaterials; ++i)
+    {
+      sContent.Format("Material{}\nShader = \"Shaders/Materials/DefaultMaterial.ezShader\"\nBlendMode = \"BLEND_MODE_OPAQUE\"\nShadingMode = "
+                      "\"SHADING_MODE_LIT\"\nTwoSided = {}\nBaseColor = Color(1.0, {}, 0.5, 1.0)\nBaseTexture = \"Textures/Material{}_D.dds\"\n"
+                      "NormalTexture = \"Textures/Material{}_N.dds\"\nRoughnessTexture = \"Textures/Material{}_R.dds\"\nMetallicValue = 0.0\n"
+                      "RoughnessValue = 0.{}\nMaskThreshold = 0.25\nUseBaseTexture = true\nUseNormalTexture = true\n",
+        i, i % 2 == 0 ? "false" : "true", i * 0.05f, i, i, i, i);
+
+      sFile.Format(":output/Data/Material{}.ezMaterialBin", i);
+
+      ezFileWriter file;
+      if (EZ_TEST_BOOL(file.Open(sFile).Succeeded()).Failed())
+        return;
+
+      file.WriteBytes(sContent.GetData(), sContent.GetElementCount()).IgnoreResult();
+
+      auto& e = builder.m_Entries.ExpandAndGetRef();
+      sFile.Format("{}/Data/Material{}.ezMaterialBin", sOutputFolder, i);
+      e.m_sAbsSourcePath = sFile;
+      sFile.Format("Material{}.ezMaterialBin", i);
+      e.m_sRelTargetPath = sFile;
+      e.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    // too few files of this type to build a dictionary for them
+    {
+      ezFileWriter file;
+      if (EZ_TEST_BOOL(file.Open(":output/Data/Single.txt").Succeeded()).Failed())
+        return;
+
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        file.WriteBytes(sContent.GetData(), sContent.GetElementCount()).IgnoreResult();
+      }
+
+      auto& e = builder.m_Entries.ExpandAndGetRef();
+      e.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/Single.txt");
+      e.m_sRelTargetPath = "Single.txt";
+      e.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(":output/Dictionary.ezArchive").Succeeded());
+
+    builder.m_uiMaxDictionaryFileSize = 0;
+    EZ_TEST_BOOL(builder.WriteArchive(":output/NoDictionary.ezArchive").Succeeded());
+  }
+
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Dictionary.ezArchive");
+
+  ezArchiveReader archive;
+  if (EZ_TEST_BOOL(archive.OpenArchive(sArchiveFile).Succeeded()).Failed())
+    return;
+
+  const ezArchiveTOC& toc = archive.GetArchiveTOC();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TOC")
+  {
+    EZ_TEST_INT(toc.m_Dictionaries.GetCount(), 1);
+
+    for (ezUInt32 i = 0; i < uiNumMaterials; ++i)
+    {
+      EZ_TEST_BOOL(toc.m_Entries[i].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_dictionary);
+      EZ_TEST_INT(toc.m_Entries[i].m_uiDictionary, 0);
+    }
+
+    EZ_TEST_BOOL(toc.m_Entries[uiNumMaterials].m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd);
+
+    // the dictionary has to pay off
+    ezArchiveReader archiveNoDict;
+    if (EZ_TEST_BOOL(archiveNoDict.OpenArchive(ezStringBuilder(sOutputFolder, "/NoDictionary.ezArchive")).Succeeded()).Failed())
+      return;
+
+    ezUInt64 uiStoredSize = toc.m_Dictionaries[0].GetCount();
+    ezUInt64 uiStoredSizeNoDict = 0;
+
+    for (ezUInt32 i = 0; i < uiNumMaterials; ++i)
+    {
+      uiStoredSize += toc.m_Entries[i].m_uiStoredDataSize;
+      uiStoredSizeNoDict += archiveNoDict.GetArchiveTOC().m_Entries[i].m_uiStoredDataSize;
+    }
+
+    EZ_TEST_BOOL(uiStoredSize < uiStoredSizeNoDict);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read Entries")
+  {
+    ezDynamicArray<ezUInt8> expected, actual;
+
+    for (ezUInt32 i = 0; i < toc.m_Entries.GetCount(); ++i)
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(ezStringBuilder(":output/Data/", toc.GetEntryPathString(i))).Succeeded()).Failed())
+        return;
+
+      expected.SetCountUninitialized(static_cast<ezUInt32>(file.GetFileSize()));
+      file.ReadBytes(expected.GetData(), expected.GetCount());
+
+      ezUniquePtr<ezStreamReader> pReader = archive.CreateEntryReader(i);
+
+      actual.SetCountUninitialized(expected.GetCount() + 16);
+      EZ_TEST_INT(pReader->ReadBytes(actual.GetData(), actual.GetCount()), expected.GetCount());
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(expected.GetData(), actual.GetData(), expected.GetCount()));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "Clear", "archive", ezFileSystem::ReadOnly) == EZ_SUCCESS).Failed())
+      return;
+
+    ezStringBuilder sFileSrc, sFileDst;
+
+    for (ezUInt32 i = 0; i < toc.m_Entries.GetCount(); ++i)
+    {
+      sFileSrc.Set(":output/Data/", toc.GetEntryPathString(i));
+      sFileDst.Set(":archive/", toc.GetEntryPathString(i));
+
+      EZ_TEST_FILES(sFileSrc, sFileDst, "Unpacked file should be identical");
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveDeduplication)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveDeduplicationTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::CreateDirectoryStructure(sOutputFolder);
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  const ezUInt32 uiChunkSize = 1024 * 16;
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Dedup.ezArchive");
+
+  // the value of every element depends on the seed, so files with different seeds have the same size but different content
+  auto WriteFile = [&](const char* szFile, ezUInt32 uiNumValues, ezUInt32 uiSeed) {
+    ezFileWriter file;
+    if (EZ_TEST_BOOL(file.Open(szFile).Succeeded()).Failed())
+      return;
+
+    for (ezUInt32 i = 0; i < uiNumValues; ++i)
+    {
+      file << (i * 7 + uiSeed);
+    }
+  };
+
+  const char* szFiles[] = {"Large.bin", "Small.bin", "LargeCopy.bin", "SmallCopy.bin", "SmallOther.bin", "SmallCopy2.bin"};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    WriteFile(":output/Data/Large.bin", uiChunkSize, 1);
+    WriteFile(":output/Data/LargeCopy.bin", uiChunkSize, 1);
+    WriteFile(":output/Data/Small.bin", 100, 2);
+    WriteFile(":output/Data/SmallCopy.bin", 100, 2);
+    WriteFile(":output/Data/SmallCopy2.bin", 100, 2);
+    WriteFile(":output/Data/SmallOther.bin", 100, 3);
+
+    ezArchiveBuilder builder;
+    builder.m_uiChunkSize = uiChunkSize;
+    builder.m_bDeduplicateFiles = true;
+
+    for (const char* szFile : szFiles)
+    {
+      auto& e = builder.m_Entries.ExpandAndGetRef();
+      e.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/", szFile);
+      e.m_sRelTargetPath = szFile;
+      e.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+    }
+
+    EZ_TEST_BOOL(builder.WriteArchive(":output/Dedup.ezArchive").Succeeded());
+  }
+
+  ezArchiveReader archive;
+  if (EZ_TEST_BOOL(archive.OpenArchive(sArchiveFile).Succeeded()).Failed())
+    return;
+
+  const ezArchiveTOC& toc = archive.GetArchiveTOC();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "TOC")
+  {
+    const ezArchiveEntry& large = toc.m_Entries[toc.FindEntry("Large.bin")];
+    const ezArchiveEntry& largeCopy = toc.m_Entries[toc.FindEntry("LargeCopy.bin")];
+    const ezArchiveEntry& small = toc.m_Entries[toc.FindEntry("Small.bin")];
+
+    EZ_TEST_BOOL(large.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked);
+    EZ_TEST_BOOL(largeCopy.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_chunked);
+    EZ_TEST_INT(largeCopy.m_uiDataStartOffset, large.m_uiDataStartOffset);
+    EZ_TEST_INT(toc.GetNumChunks(largeCopy), toc.GetNumChunks(large));
+
+    EZ_TEST_INT(toc.m_Entries[toc.FindEntry("SmallCopy.bin")].m_uiDataStartOffset, small.m_uiDataStartOffset);
+    EZ_TEST_INT(toc.m_Entries[toc.FindEntry("SmallCopy2.bin")].m_uiDataStartOffset, small.m_uiDataStartOffset);
+    EZ_TEST_BOOL(toc.m_Entries[toc.FindEntry("SmallOther.bin")].m_uiDataStartOffset != small.m_uiDataStartOffset);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "Clear", "archive", ezFileSystem::ReadOnly) == EZ_SUCCESS).Failed())
+      return;
+
+    ezStringBuilder sFileSrc, sFileDst;
+
+    for (const char* szFile : szFiles)
+    {
+      sFileSrc.Set(":output/Data/", szFile);
+      sFileDst.Set(":archive/", szFile);
+
+      EZ_TEST_FILES(sFileSrc, sFileDst, "Unpacked file should be identical");
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveDirectView)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveDirectViewTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::CreateDirectoryStructure(sOutputFolder);
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "Clear", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  ezDynamicArray<ezUInt8> content;
+  content.SetCountUninitialized(1024 * 100);
+
+  for (ezUInt32 i = 0; i < content.GetCount(); ++i)
+  {
+    content[i] = static_cast<ezUInt8>(i % 251);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezFileWriter file;
+    if (EZ_TEST_BOOL(file.Open(":output/Data/Content.bin").Succeeded()).Failed())
+      return;
+
+    file.WriteBytes(content.GetData(), content.GetCount()).IgnoreResult();
+    file.Close();
+
+    ezArchiveBuilder builder;
+
+    auto& raw = builder.m_Entries.ExpandAndGetRef();
+    raw.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/Content.bin");
+    raw.m_sRelTargetPath = "Raw.bin";
+    raw.m_CompressionMode = ezArchiveCompressionMode::Uncompressed;
+
+    auto& compressed = builder.m_Entries.ExpandAndGetRef();
+    compressed.m_sAbsSourcePath = ezStringBuilder(sOutputFolder, "/Data/Content.bin");
+    compressed.m_sRelTargetPath = "Compressed.bin";
+    compressed.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+
+    EZ_TEST_BOOL(builder.WriteArchive(":output/DirectView.ezArchive").Succeeded());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GetDirectView")
+  {
+    if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(ezStringBuilder(sOutputFolder, "/DirectView.ezArchive"), "Clear", "archive", ezFileSystem::ReadOnly) == EZ_SUCCESS).Failed())
+      return;
+
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":archive/Raw.bin").Succeeded()).Failed())
+        return;
+
+      ezArrayPtr<const ezUInt8> view = file.GetDirectView();
+      EZ_TEST_INT(view.GetCount(), content.GetCount());
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(view.GetPtr(), content.GetData(), content.GetCount()));
+
+      // the view is independent of the read position
+      ezUInt8 uiTemp[16];
+      EZ_TEST_INT(file.SkipBytes(1000), 1000);
+      EZ_TEST_INT(file.ReadBytes(uiTemp, 16), 16);
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(uiTemp, content.GetData() + 1000, 16));
+      EZ_TEST_BOOL(file.GetDirectView().GetPtr() == view.GetPtr());
+    }
+
+    // compressed data has to be read
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":archive/Compressed.bin").Succeeded()).Failed())
+        return;
+
+      EZ_TEST_BOOL(file.GetDirectView().IsEmpty());
+    }
+
+    // as do ordinary files
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":output/Data/Content.bin").Succeeded()).Failed())
+        return;
+
+      EZ_TEST_BOOL(file.GetDirectView().IsEmpty());
+      EZ_TEST_INT(file.ReadBytes(content.GetData(), content.GetCount()), content.GetCount());
+    }
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("Clear");
+}
+
+#endif
@@ -147,6 +147,58 @@ Only concrete and clocks.\n\
     FileIn.Close();
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ReadAsync")
+  {
+    struct Request
+    {
+      ezUInt64 m_uiOffset;
+      ezUInt64 m_uiBytes;
+      char m_szBuffer[64];
+      ezResult m_Result = EZ_FAILURE;
+      ezUInt64 m_uiBytesRead = 0;
+      bool m_bFinished = false;
+    };
+
+    const ezUInt64 uiFileSize = sFileContent.GetElementCount();
+
+    // unsorted and overlapping, the last one reaches past the end of the file
+    Request requests[] = {{40, 20}, {0, 10}, {5, 30}, {100, 64}, {uiFileSize - 8, 64}};
+    Request missingFile = {0, 10};
+    Request pastTheEnd = {uiFileSize + 10, 10};
+
+    auto Issue = [](const char* szFile, Request& r) {
+      ezFileSystem::ReadAsync(szFile, r.m_uiOffset, r.m_uiBytes, r.m_szBuffer, [&r](ezResult res, ezUInt64 uiBytesRead) {
+        r.m_Result = res;
+        r.m_uiBytesRead = uiBytesRead;
+        r.m_bFinished = true;
+      });
+    };
+
+    for (Request& r : requests)
+    {
+      Issue("FileSystemTest.txt", r);
+    }
+
+    Issue("DoesNotExist.txt", missingFile);
+    Issue("FileSystemTest.txt", pastTheEnd);
+
+    ezFileSystem::WaitForAsyncReads();
+
+    for (const Request& r : requests)
+    {
+      EZ_TEST_BOOL(r.m_bFinished);
+      EZ_TEST_BOOL(r.m_Result.Succeeded());
+      EZ_TEST_INT(r.m_uiBytesRead, ezMath::Min(r.m_uiBytes, uiFileSize - r.m_uiOffset));
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(r.m_szBuffer, sFileContent.GetData() + r.m_uiOffset, static_cast<size_t>(r.m_uiBytesRead)));
+    }
+
+    EZ_TEST_BOOL(missingFile.m_bFinished);
+    EZ_TEST_BOOL(missingFile.m_Result.Failed());
+
+    EZ_TEST_BOOL(pastTheEnd.m_bFinished);
+    EZ_TEST_BOOL(pastTheEnd.m_Result.Failed());
+  }
+
 #if EZ_DISABLED(EZ_PLATFORM_WINDOWS_UWP)
 
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read File (Absolute Path)")
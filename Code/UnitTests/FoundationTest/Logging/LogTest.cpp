@@ -6,7 +6,9 @@
 #include <Foundation/Logging/HTMLWriter.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Logging/VisualStudioWriter.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadUtils.h>
 #include <TestFramework/Utilities/TestLogInterface.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Logging);
@@ -254,3 +256,167 @@ EZ_CREATE_SIMPLE_TEST(Logging, GlobalTestLog)
     }
   }
 }
+
+namespace
+{
+  struct AsyncLogRecorder
+  {
+    void LogMessageHandler(const ezLoggingEventData& le)
+    {
+      if (ezStringUtils::IsEqual(le.m_szTag, "AsyncTest"))
+      {
+        EZ_LOCK(m_Mutex);
+        m_Messages.PushBack(le.m_szText);
+        m_ThreadIds.PushBack(le.m_uiThreadId);
+        m_Times.PushBack(le.m_Time);
+      }
+      else if (le.m_EventType == ezLogMsgType::WarningMsg && ezStringUtils::FindSubString(le.m_szText, "were dropped") != nullptr)
+      {
+        EZ_LOCK(m_Mutex);
+        m_uiNumDropWarnings++;
+      }
+    }
+
+    ezMutex m_Mutex;
+    ezDynamicArray<ezString> m_Messages;
+    ezDynamicArray<ezUInt64> m_ThreadIds;
+    ezDynamicArray<ezTime> m_Times;
+    ezUInt32 m_uiNumDropWarnings = 0;
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Logging, AsyncLog)
+{
+  ezLog::GetThreadLocalLogSystem()->SetLogLevel(ezLogMsgType::All);
+
+  AsyncLogRecorder recorder;
+  ezGlobalLog::AddLogWriter(ezMakeDelegate(&AsyncLogRecorder::LogMessageHandler, &recorder));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Order")
+  {
+    ezGlobalLog::AsyncSettings settings;
+    settings.m_WriteInterval = ezTime::Seconds(10);
+    EZ_TEST_BOOL(ezGlobalLog::EnableAsyncMode(settings).Succeeded());
+    EZ_TEST_BOOL(ezGlobalLog::IsAsyncModeEnabled());
+
+    {
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+      log.ExpectMessage("The asynchronous log mode is already enabled", ezLogMsgType::ErrorMsg);
+
+      EZ_TEST_BOOL(ezGlobalLog::EnableAsyncMode(settings).Failed());
+    }
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      ezLog::Info("[AsyncTest]{}", i);
+    }
+
+    ezGlobalLog::FlushAsyncQueue();
+
+    EZ_LOCK(recorder.m_Mutex);
+    if (EZ_TEST_INT(recorder.m_Messages.GetCount(), 10).Succeeded())
+    {
+      for (ezUInt32 i = 0; i < 10; ++i)
+      {
+        ezStringBuilder sExpected;
+        sExpected.Format("{}", i);
+        EZ_TEST_STRING(recorder.m_Messages[i], sExpected);
+        EZ_TEST_BOOL(recorder.m_ThreadIds[i] == (ezUInt64)ezThreadUtils::GetCurrentThreadID());
+        EZ_TEST_BOOL(i == 0 || recorder.m_Times[i] >= recorder.m_Times[i - 1]);
+      }
+    }
+
+    recorder.m_Messages.Clear();
+    recorder.m_ThreadIds.Clear();
+    recorder.m_Times.Clear();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Block")
+  {
+    ezGlobalLog::DisableAsyncMode();
+    EZ_TEST_BOOL(!ezGlobalLog::IsAsyncModeEnabled());
+
+    // tiny queues, such that the threads have to wait for the writer all the time
+    ezGlobalLog::AsyncSettings settings;
+    settings.m_uiQueueSize = 2;
+    settings.m_OverflowPolicy = ezGlobalLog::AsyncOverflowPolicy::Block;
+    EZ_TEST_BOOL(ezGlobalLog::EnableAsyncMode(settings).Succeeded());
+
+    class LogThread : public ezThread
+    {
+    public:
+      virtual ezUInt32 Run() override
+      {
+        for (ezUInt32 i = 0; i < 25; ++i)
+        {
+          ezLog::Info("[AsyncTest]{}", i);
+        }
+        return 0;
+      }
+    };
+
+    LogThread thread[4];
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].Start();
+    }
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      thread[i].Join();
+    }
+
+    ezGlobalLog::DisableAsyncMode();
+
+    EZ_LOCK(recorder.m_Mutex);
+    EZ_TEST_INT(recorder.m_Messages.GetCount(), 100);
+    EZ_TEST_INT(recorder.m_uiNumDropWarnings, 0);
+
+    recorder.m_Messages.Clear();
+    recorder.m_ThreadIds.Clear();
+    recorder.m_Times.Clear();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Drop")
+  {
+    ezGlobalLog::AsyncSettings settings;
+    settings.m_uiQueueSize = 4;
+    settings.m_OverflowPolicy = ezGlobalLog::AsyncOverflowPolicy::Drop;
+    settings.m_WriteInterval = ezTime::Seconds(10);
+    EZ_TEST_BOOL(ezGlobalLog::EnableAsyncMode(settings).Succeeded());
+
+    const ezUInt32 uiDroppedBefore = ezGlobalLog::GetNumDroppedAsyncMessages();
+
+    {
+      // the writer gets stuck on the first message while the recorder is locked, so the queue runs full
+      EZ_LOCK(recorder.m_Mutex);
+
+      for (ezUInt32 i = 0; i < 22; ++i)
+      {
+        ezLog::Info("[AsyncTest]{}", i);
+      }
+    }
+
+    ezGlobalLog::FlushAsyncQueue();
+
+    const ezUInt32 uiDropped = ezGlobalLog::GetNumDroppedAsyncMessages() - uiDroppedBefore;
+    EZ_TEST_BOOL(uiDropped >= 18);
+
+    EZ_LOCK(recorder.m_Mutex);
+    EZ_TEST_INT(recorder.m_Messages.GetCount(), 22 - uiDropped);
+    EZ_TEST_INT(recorder.m_uiNumDropWarnings, 1);
+
+    // the messages that made it are the oldest ones
+    for (ezUInt32 i = 0; i < recorder.m_Messages.GetCount(); ++i)
+    {
+      ezStringBuilder sExpected;
+      sExpected.Format("{}", i);
+      EZ_TEST_STRING(recorder.m_Messages[i], sExpected);
+    }
+  }
+
+  ezGlobalLog::DisableAsyncMode();
+  ezGlobalLog::RemoveLogWriter(ezMakeDelegate(&AsyncLogRecorder::LogMessageHandler, &recorder));
+}
@@ -3,6 +3,7 @@
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/Thread.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -235,4 +236,234 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "PoolAllocator")
+  {
+    ezPoolAllocator allocator("TestPoolAllocator");
+
+    // all size classes, plus sizes that are passed through to the heap
+    ezDynamicArray<ezUInt8*> allocs;
+    for (ezUInt32 uiSize = 1; uiSize <= 2 * ezMemoryPolicies::ezPoolAllocation::MaxPooledSize; uiSize += 7)
+    {
+      ezUInt8* ptr = static_cast<ezUInt8*>(allocator.Allocate(uiSize, EZ_ALIGNMENT_MINIMUM));
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(ptr, EZ_ALIGNMENT_MINIMUM));
+      ezMemoryUtils::PatternFill(ptr, static_cast<ezUInt8>(uiSize), uiSize);
+
+      allocs.PushBack(ptr);
+    }
+
+    for (ezUInt32 i = 0; i < allocs.GetCount(); ++i)
+    {
+      const ezUInt32 uiSize = 1 + i * 7;
+
+      bool bIntact = true;
+      for (ezUInt32 j = 0; j < uiSize; ++j)
+      {
+        bIntact &= allocs[i][j] == static_cast<ezUInt8>(uiSize);
+      }
+
+      EZ_TEST_BOOL_MSG(bIntact, "Allocation of size {0} was overwritten", uiSize);
+
+      allocator.Deallocate(allocs[i]);
+    }
+
+    EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+
+    // growing keeps the content, both within the pool and when moving to the heap
+    {
+      ezUInt32* ptr = static_cast<ezUInt32*>(allocator.Allocate(sizeof(ezUInt32) * 4, sizeof(ezUInt32)));
+      for (ezUInt32 i = 0; i < 4; ++i)
+        ptr[i] = i;
+
+      ptr = static_cast<ezUInt32*>(allocator.Reallocate(ptr, sizeof(ezUInt32) * 4, sizeof(ezUInt32) * 100, sizeof(ezUInt32)));
+      for (ezUInt32 i = 4; i < 100; ++i)
+        ptr[i] = i;
+
+      ptr = static_cast<ezUInt32*>(allocator.Reallocate(ptr, sizeof(ezUInt32) * 100, sizeof(ezUInt32) * 1000, sizeof(ezUInt32)));
+      for (ezUInt32 i = 0; i < 100; ++i)
+        EZ_TEST_INT(ptr[i], i);
+
+      allocator.Deallocate(ptr);
+    }
+
+    // memory that is freed on another thread is handed back to the thread that allocated it
+    {
+      class FreeThread : public ezThread
+      {
+      public:
+        ezAllocatorBase* m_pAllocator = nullptr;
+        ezDynamicArray<ezUInt8*>* m_pAllocs = nullptr;
+
+      private:
+        virtual ezUInt32 Run() override
+        {
+          for (ezUInt8* ptr : *m_pAllocs)
+          {
+            m_pAllocator->Deallocate(ptr);
+          }
+
+          // some allocations of our own, which are still alive when the thread exits
+          for (ezUInt32 i = 0; i < 100; ++i)
+          {
+            m_pAllocs->PushBack(static_cast<ezUInt8*>(m_pAllocator->Allocate(32, EZ_ALIGNMENT_MINIMUM)));
+          }
+
+          return 0;
+        }
+      };
+
+      allocs.Clear();
+      for (ezUInt32 i = 0; i < 1000; ++i)
+      {
+        allocs.PushBack(static_cast<ezUInt8*>(allocator.Allocate(32, EZ_ALIGNMENT_MINIMUM)));
+      }
+
+      FreeThread thread;
+      thread.m_pAllocator = &allocator;
+      thread.m_pAllocs = &allocs;
+      allocs.Reserve(2000);
+      thread.Start();
+      thread.Join();
+
+      // the allocations made by the other thread now belong to an abandoned slab
+      allocs.RemoveAtAndCopy(0, 1000);
+      for (ezUInt8* ptr : allocs)
+      {
+        allocator.Deallocate(ptr);
+      }
+
+      allocs.Clear();
+      for (ezUInt32 i = 0; i < 1000; ++i)
+      {
+        allocs.PushBack(static_cast<ezUInt8*>(allocator.Allocate(32, EZ_ALIGNMENT_MINIMUM)));
+      }
+
+      for (ezUInt8* ptr : allocs)
+      {
+        allocator.Deallocate(ptr);
+      }
+    }
+
+    EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sampled Tracking")
+  {
+    typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::SampleAllocations> SampledAllocator;
+
+    struct Result
+    {
+      ezAllocatorId m_AllocatorId;
+      ezUInt32 m_uiNumGroups = 0;
+      ezUInt64 m_uiEstimatedSize = 0;
+      ezUInt32 m_uiNumSamples = 0;
+    };
+
+    auto CollectSamples = [](const ezMemoryTracker::SampledAllocationGroup& group, void* pPassThrough) {
+      Result& result = *static_cast<Result*>(pPassThrough);
+      if (group.m_AllocatorId == result.m_AllocatorId)
+      {
+        result.m_uiNumGroups++;
+        result.m_uiEstimatedSize += group.m_uiEstimatedSize;
+        result.m_uiNumSamples += group.m_uiNumSamples;
+      }
+    };
+
+    const ezUInt32 uiPrevInterval = ezMemoryTracker::GetSamplingInterval();
+
+    {
+      SampledAllocator allocator("TestSampledAllocator");
+
+      // with an interval this small every allocation is sampled
+      ezMemoryTracker::SetSamplingInterval(1);
+
+      // more allocations than fit into one sample buffer
+      ezDynamicArray<void*> allocs;
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        allocs.PushBack(allocator.Allocate(64, EZ_ALIGNMENT_MINIMUM));
+      }
+
+      Result result;
+      result.m_AllocatorId = allocator.GetId();
+      ezMemoryTracker::EnumerateSampledAllocations(CollectSamples, &result);
+
+      EZ_TEST_INT(result.m_uiNumSamples, 100);
+      EZ_TEST_INT(result.m_uiEstimatedSize, 100 * 64);
+      EZ_TEST_BOOL(result.m_uiNumGroups >= 1);
+
+      for (ezUInt32 i = 0; i < 50; ++i)
+      {
+        allocator.Deallocate(allocs[i]);
+      }
+
+      result = Result();
+      result.m_AllocatorId = allocator.GetId();
+      ezMemoryTracker::EnumerateSampledAllocations(CollectSamples, &result);
+
+      EZ_TEST_INT(result.m_uiNumSamples, 50);
+
+      // deallocations on other threads are buffered there and must still find their allocation
+      {
+        class FreeThread : public ezThread
+        {
+        public:
+          ezAllocatorBase* m_pAllocator = nullptr;
+          ezArrayPtr<void*> m_Allocs;
+
+        private:
+          virtual ezUInt32 Run() override
+          {
+            for (void* ptr : m_Allocs)
+            {
+              m_pAllocator->Deallocate(ptr);
+            }
+
+            return 0;
+          }
+        };
+
+        FreeThread thread;
+        thread.m_pAllocator = &allocator;
+        thread.m_Allocs = allocs.GetArrayPtr().GetSubArray(50);
+        thread.Start();
+        thread.Join();
+      }
+
+      result = Result();
+      result.m_AllocatorId = allocator.GetId();
+      ezMemoryTracker::EnumerateSampledAllocations(CollectSamples, &result);
+
+      EZ_TEST_INT(result.m_uiNumSamples, 0);
+
+      // with a larger interval only a few allocations are sampled, but the estimate should still be close
+      ezMemoryTracker::SetSamplingInterval(4 * 1024);
+
+      allocs.Clear();
+      for (ezUInt32 i = 0; i < 4096; ++i)
+      {
+        allocs.PushBack(allocator.Allocate(1024, EZ_ALIGNMENT_MINIMUM));
+      }
+
+      result = Result();
+      result.m_AllocatorId = allocator.GetId();
+      ezMemoryTracker::EnumerateSampledAllocations(CollectSamples, &result);
+
+      EZ_TEST_BOOL(result.m_uiNumSamples > 0 && result.m_uiNumSamples < 4096);
+      EZ_TEST_BOOL(result.m_uiEstimatedSize > 4096 * 1024 / 2 && result.m_uiEstimatedSize < 4096 * 1024 * 2);
+
+      for (void* ptr : allocs)
+      {
+        allocator.Deallocate(ptr);
+      }
+
+      result = Result();
+      result.m_AllocatorId = allocator.GetId();
+      ezMemoryTracker::EnumerateSampledAllocations(CollectSamples, &result);
+
+      EZ_TEST_INT(result.m_uiNumSamples, 0);
+    }
+
+    ezMemoryTracker::SetSamplingInterval(uiPrevInterval);
+  }
 }
@@ -0,0 +1,119 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum AllocatorConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    ALLOCATOR_NUM_ROUNDS = 20,
+#else
+    ALLOCATOR_NUM_ROUNDS = 200,
+#endif
+    ALLOCATOR_NUM_ALLOCATIONS = 1024,
+  };
+
+  // no tracking, so that only the allocation policies are compared
+  typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::None> ezUntrackedHeapAllocator;
+  typedef ezAllocator<ezMemoryPolicies::ezPoolAllocation, ezMemoryTrackingFlags::None> ezUntrackedPoolAllocator;
+
+  class ezAllocationBenchmarkThread : public ezThread
+  {
+  public:
+    ezAllocatorBase* m_pAllocator = nullptr;
+    ezUInt32 m_uiSeed = 0;
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      void* allocations[ALLOCATOR_NUM_ALLOCATIONS];
+      ezUInt32 uiRandom = m_uiSeed;
+
+      for (ezUInt32 round = 0; round < ALLOCATOR_NUM_ROUNDS; ++round)
+      {
+        // typical small object sizes between 8 and 256 bytes
+        for (ezUInt32 i = 0; i < ALLOCATOR_NUM_ALLOCATIONS; ++i)
+        {
+          uiRandom = uiRandom * 1664525u + 1013904223u;
+          allocations[i] = m_pAllocator->Allocate(8 + ((uiRandom >> 16) & 0xF8), EZ_ALIGNMENT_MINIMUM);
+        }
+
+        // free every other allocation first, so that the free lists don't stay in allocation order
+        for (ezUInt32 i = 0; i < ALLOCATOR_NUM_ALLOCATIONS; i += 2)
+        {
+          m_pAllocator->Deallocate(allocations[i]);
+        }
+
+        for (ezUInt32 i = 1; i < ALLOCATOR_NUM_ALLOCATIONS; i += 2)
+        {
+          m_pAllocator->Deallocate(allocations[i]);
+        }
+      }
+
+      return 0;
+    }
+  };
+
+  /// Runs ALLOCATOR_NUM_ROUNDS rounds of ALLOCATOR_NUM_ALLOCATIONS allocations and deallocations on each of the given number of threads.
+  double MeasureAllocationsPerSecond(ezAllocatorBase* pAllocator, ezUInt32 uiNumThreads)
+  {
+    ezDynamicArray<ezAllocationBenchmarkThread*> threads;
+
+    for (ezUInt32 i = 0; i < uiNumThreads; ++i)
+    {
+      ezAllocationBenchmarkThread* pThread = EZ_DEFAULT_NEW(ezAllocationBenchmarkThread);
+      pThread->m_pAllocator = pAllocator;
+      pThread->m_uiSeed = i;
+
+      threads.PushBack(pThread);
+    }
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezAllocationBenchmarkThread* pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    for (ezAllocationBenchmarkThread* pThread : threads)
+    {
+      pThread->Join();
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+
+    for (ezAllocationBenchmarkThread* pThread : threads)
+    {
+      EZ_DEFAULT_DELETE(pThread);
+    }
+
+    return (double)uiNumThreads * ALLOCATOR_NUM_ROUNDS * ALLOCATOR_NUM_ALLOCATIONS / tDuration.GetSeconds();
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Allocator)
+{
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Heap vs. Pool")
+  {
+    ezUntrackedHeapAllocator heapAllocator("HeapBenchmark");
+    ezUntrackedPoolAllocator poolAllocator("PoolBenchmark");
+
+    const ezUInt32 threadCounts[] = {1, 2, 4, 8, 16, 32};
+
+    for (ezUInt32 uiThreads : threadCounts)
+    {
+      const double fHeap = MeasureAllocationsPerSecond(&heapAllocator, uiThreads);
+      const double fPool = MeasureAllocationsPerSecond(&poolAllocator, uiThreads);
+
+      ezLog::Info("[test]Alloc/Free, {0} threads: heap {1} allocations/sec, pool {2} allocations/sec", uiThreads, ezArgF(fHeap, 0), ezArgF(fPool, 0));
+    }
+  }
+}
@@ -0,0 +1,117 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum FileSystemConstants
+  {
+    FILESYSTEM_FILE_SIZE = 1024 * 1024 * 16,
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    FILESYSTEM_NUM_READS = 512,
+#else
+    FILESYSTEM_NUM_READS = 4096,
+#endif
+  };
+
+  /// Scatters the reads over the whole file, like a loader that streams pieces of many different resources.
+  ezUInt64 GetReadOffset(ezUInt32 uiRead, ezUInt32 uiReadSize) { return (static_cast<ezUInt64>(uiRead) * 2654435761u) % (FILESYSTEM_FILE_SIZE - uiReadSize); }
+
+  /// Every read opens the file on a task and blocks that task until the data is there.
+  double MeasureBlockingReadsPerSecond(const char* szFile, ezUInt32 uiReadSize, ezDynamicArray<ezUInt8>& buffer)
+  {
+    const ezTime tStart = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(0, FILESYSTEM_NUM_READS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        ezFileReader file;
+        if (file.Open(szFile).Failed())
+          return;
+
+        file.SkipBytes(GetReadOffset(i, uiReadSize));
+        file.ReadBytes(buffer.GetData() + i * uiReadSize, uiReadSize);
+      }
+    });
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+    return (double)FILESYSTEM_NUM_READS / tDuration.GetSeconds();
+  }
+
+  /// All reads are issued at once and executed in batches on the file access thread.
+  double MeasureAsyncReadsPerSecond(const char* szFile, ezUInt32 uiReadSize, ezDynamicArray<ezUInt8>& buffer)
+  {
+    ezAtomicInteger32 iFinished;
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < FILESYSTEM_NUM_READS; ++i)
+    {
+      ezFileSystem::ReadAsync(szFile, GetReadOffset(i, uiReadSize), uiReadSize, buffer.GetData() + i * uiReadSize, [&iFinished](ezResult, ezUInt64) { iFinished.Increment(); });
+    }
+
+    ezFileSystem::WaitForAsyncReads();
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+    EZ_TEST_INT(iFinished, FILESYSTEM_NUM_READS);
+
+    return (double)FILESYSTEM_NUM_READS / tDuration.GetSeconds();
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, FileSystem)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.MakeCleanPath();
+
+  if (EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "FileSystemPerf", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS).Failed())
+    return;
+
+  const char* szFile = ":output/FileSystemPerf.bin";
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Blocking vs. Async Reads")
+  {
+    {
+      ezDynamicArray<ezUInt8> content;
+      content.SetCountUninitialized(FILESYSTEM_FILE_SIZE);
+
+      for (ezUInt32 i = 0; i < content.GetCount(); ++i)
+      {
+        content[i] = static_cast<ezUInt8>(i * 7);
+      }
+
+      ezFileWriter file;
+      if (EZ_TEST_BOOL(file.Open(szFile).Succeeded()).Failed())
+        return;
+
+      file.WriteBytes(content.GetData(), content.GetCount()).IgnoreResult();
+    }
+
+    const ezUInt32 readSizes[] = {1024, 1024 * 16, 1024 * 256};
+
+    ezDynamicArray<ezUInt8> buffer;
+
+    for (ezUInt32 uiReadSize : readSizes)
+    {
+      buffer.SetCountUninitialized(FILESYSTEM_NUM_READS * uiReadSize);
+
+      const double fBlocking = MeasureBlockingReadsPerSecond(szFile, uiReadSize, buffer);
+      const double fAsync = MeasureAsyncReadsPerSecond(szFile, uiReadSize, buffer);
+
+      ezLog::Info("[test]{0} KB reads: blocking {1} reads/sec ({2} MB/sec), async {3} reads/sec ({4} MB/sec)", uiReadSize / 1024, ezArgF(fBlocking, 0),
+        ezArgF(fBlocking * uiReadSize / (1024.0 * 1024.0), 1), ezArgF(fAsync, 0), ezArgF(fAsync * uiReadSize / (1024.0 * 1024.0), 1));
+    }
+
+    ezFileSystem::DeleteFile(szFile);
+  }
+
+  ezFileSystem::RemoveDataDirectoryGroup("FileSystemPerf");
+}
@@ -0,0 +1,84 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum ProfilingConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    PROFILING_NUM_SCOPES = 1000 * 100,
+#else
+    PROFILING_NUM_SCOPES = 1000 * 1000,
+#endif
+  };
+
+  /// Returns the average cost of one scope in nanoseconds.
+  double MeasureScopeOverhead()
+  {
+    volatile ezUInt32 uiCounter = 0;
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < PROFILING_NUM_SCOPES; ++i)
+    {
+      EZ_PROFILE_SCOPE("Profiled Scope");
+      uiCounter = uiCounter + 1;
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+    EZ_TEST_INT(uiCounter, PROFILING_NUM_SCOPES);
+
+    return tDuration.GetNanoseconds() / PROFILING_NUM_SCOPES;
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Profiling)
+{
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Clock Queries")
+  {
+    ezUInt64 uiSum = 0;
+
+    ezTime tStart = ezTime::Now();
+    for (ezUInt32 i = 0; i < PROFILING_NUM_SCOPES; ++i)
+    {
+      uiSum += static_cast<ezUInt64>(ezTime::Now().GetNanoseconds());
+    }
+    const double fTimeNow = (ezTime::Now() - tStart).GetNanoseconds() / PROFILING_NUM_SCOPES;
+
+    tStart = ezTime::Now();
+    for (ezUInt32 i = 0; i < PROFILING_NUM_SCOPES; ++i)
+    {
+      uiSum += ezProfilingSystem::GetTicks();
+    }
+    const double fGetTicks = (ezTime::Now() - tStart).GetNanoseconds() / PROFILING_NUM_SCOPES;
+
+    EZ_TEST_BOOL(uiSum != 0);
+
+    ezLog::Info("[test]ezTime::Now(): {0} ns, ezProfilingSystem::GetTicks(): {1} ns", ezArgF(fTimeNow, 1), ezArgF(fGetTicks, 1));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Scope Overhead")
+  {
+    ezProfilingSystem::Clear();
+
+    // every scope is discarded, this is what most scopes cost
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+    const double fDiscarded = MeasureScopeOverhead();
+
+    // every scope is recorded
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Zero());
+    const double fRecorded = MeasureScopeOverhead();
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+    ezProfilingSystem::Clear();
+
+    ezLog::Info("[test]Discarded scope: {0} ns, recorded scope: {1} ns, {2} bytes per recorded scope", ezArgF(fDiscarded, 1), ezArgF(fRecorded, 1),
+      (ezUInt32)sizeof(ezProfilingSystem::CPUScope));
+  }
+}
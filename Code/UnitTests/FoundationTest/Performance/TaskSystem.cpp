@@ -0,0 +1,144 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum TaskSystemConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    TASKSYSTEM_NUM_ROUNDS = 20,
+#else
+    TASKSYSTEM_NUM_ROUNDS = 200,
+#endif
+    TASKSYSTEM_NUM_INVOCATIONS = 512,
+    TASKSYSTEM_NUM_CHILDREN = 16,
+  };
+
+  EZ_FORCE_INLINE void DoSomeWork(ezUInt32 uiSeed)
+  {
+    // roughly a microsecond of work, small enough that the scheduling overhead dominates
+    volatile ezUInt32 uiValue = uiSeed;
+    for (ezUInt32 i = 0; i < 200; ++i)
+    {
+      uiValue = uiValue * 1664525u + 1013904223u;
+    }
+  }
+
+  class ezFlatBenchmarkTask final : public ezTask
+  {
+  public:
+    ezFlatBenchmarkTask() { ConfigureTask("ezFlatBenchmarkTask", ezTaskNesting::Never); }
+
+  private:
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override { DoSomeWork(uiInvocation); }
+  };
+
+  class ezNestedBenchmarkTask final : public ezTask
+  {
+  public:
+    ezNestedBenchmarkTask() { ConfigureTask("ezNestedBenchmarkTask", ezTaskNesting::Never); }
+
+    ezFlatBenchmarkTask m_Children[TASKSYSTEM_NUM_INVOCATIONS];
+
+  private:
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+    {
+      // every invocation starts its own group of child tasks from within a worker thread
+      ezFlatBenchmarkTask& child = const_cast<ezFlatBenchmarkTask&>(m_Children[uiInvocation]);
+      child.SetMultiplicity(TASKSYSTEM_NUM_CHILDREN);
+
+      ezTaskSystem::StartSingleTask(&child, ezTaskPriority::EarlyThisFrame);
+    }
+  };
+
+  /// Runs TASKSYSTEM_NUM_ROUNDS rounds of one task with TASKSYSTEM_NUM_INVOCATIONS invocations, started from the main thread.
+  double MeasureFlatTasksPerSecond()
+  {
+    ezFlatBenchmarkTask task;
+    task.SetMultiplicity(TASKSYSTEM_NUM_INVOCATIONS);
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 round = 0; round < TASKSYSTEM_NUM_ROUNDS; ++round)
+    {
+      ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(&task, ezTaskPriority::EarlyThisFrame));
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+    return (double)TASKSYSTEM_NUM_ROUNDS * TASKSYSTEM_NUM_INVOCATIONS / tDuration.GetSeconds();
+  }
+
+  /// Same as MeasureFlatTasksPerSecond(), but every invocation starts TASKSYSTEM_NUM_CHILDREN more tasks from the worker thread.
+  double MeasureNestedTasksPerSecond()
+  {
+    ezNestedBenchmarkTask* pTask = EZ_DEFAULT_NEW(ezNestedBenchmarkTask);
+    pTask->SetMultiplicity(TASKSYSTEM_NUM_INVOCATIONS);
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 round = 0; round < TASKSYSTEM_NUM_ROUNDS; ++round)
+    {
+      ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::EarlyThisFrame));
+
+      ezTaskSystem::WaitForCondition([pTask]() {
+        for (const ezFlatBenchmarkTask& child : pTask->m_Children)
+        {
+          if (!child.IsTaskFinished())
+            return false;
+        }
+        return true;
+      });
+    }
+
+    const ezTime tDuration = ezTime::Now() - tStart;
+
+    EZ_DEFAULT_DELETE(pTask);
+    return (double)TASKSYSTEM_NUM_ROUNDS * TASKSYSTEM_NUM_INVOCATIONS * (TASKSYSTEM_NUM_CHILDREN + 1) / tDuration.GetSeconds();
+  }
+} // namespace
+
+// Enable when needed
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const ezInt8 workerCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Flat Tasks")
+  {
+    for (ezInt8 iWorkers : workerCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(iWorkers, 1);
+
+      ezTaskSystem::SetWorkStealingEnabled(false);
+      const double fGlobalQueue = MeasureFlatTasksPerSecond();
+
+      ezTaskSystem::SetWorkStealingEnabled(true);
+      const double fWorkStealing = MeasureFlatTasksPerSecond();
+
+      ezLog::Info("[test]Flat Tasks, {0} workers: global queue {1} tasks/sec, work stealing {2} tasks/sec", iWorkers, ezArgF(fGlobalQueue, 0), ezArgF(fWorkStealing, 0));
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Nested Tasks")
+  {
+    for (ezInt8 iWorkers : workerCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(iWorkers, 1);
+
+      ezTaskSystem::SetWorkStealingEnabled(false);
+      const double fGlobalQueue = MeasureNestedTasksPerSecond();
+
+      ezTaskSystem::SetWorkStealingEnabled(true);
+      const double fWorkStealing = MeasureNestedTasksPerSecond();
+
+      ezLog::Info("[test]Nested Tasks, {0} workers: global queue {1} tasks/sec, work stealing {2} tasks/sec", iWorkers, ezArgF(fGlobalQueue, 0), ezArgF(fWorkStealing, 0));
+    }
+  }
+
+  ezTaskSystem::SetWorkStealingEnabled(false);
+  ezTaskSystem::SetWorkerThreadCount();
+}
@@ -1,9 +1,11 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
 
 namespace
 {
@@ -20,6 +22,22 @@ namespace
       ezLog::Info("Profiling capture saved to '{0}'.", fileWriter.GetFilePathAbsolute().GetData());
     }
   }
+
+  ezUInt32 CountScopes(const ezProfilingSystem::ProfilingData& profilingData, const char* szName)
+  {
+    ezUInt32 uiCount = 0;
+
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& e : eventBuffer.m_Data)
+      {
+        if (profilingData.m_ScopeNames[e.GetNameId()].m_sName == szName)
+          ++uiCount;
+      }
+    }
+
+    return uiCount;
+  }
 }
 
 EZ_CREATE_SIMPLE_TEST_GROUP(Profiling);
@@ -51,4 +69,103 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Streaming")
+  {
+    ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "ProfilingStream", "profilingstream", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Zero());
+
+    // continuous mode
+    {
+      ezProfilingSystem::StreamingSettings settings;
+      settings.m_sOutputFile = ":profilingstream/profilingStream.ezProfile";
+      settings.m_DrainInterval = ezTime::Milliseconds(5);
+
+      EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(settings).Succeeded());
+      EZ_TEST_BOOL(ezProfilingSystem::IsStreaming());
+
+      {
+        ezTestLogInterface log;
+        ezTestLogSystemScope logSystemScope(&log);
+        log.ExpectMessage("already being streamed", ezLogMsgType::ErrorMsg);
+
+        EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(settings).Failed());
+      }
+
+      for (ezUInt32 i = 0; i < 100; ++i)
+      {
+        EZ_PROFILE_SCOPE("Streamed scope");
+
+        if (i % 10 == 0)
+        {
+          ezProfilingSystem::StartNewFrame();
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        }
+      }
+
+      ezProfilingSystem::StopStreaming();
+      EZ_TEST_BOOL(!ezProfilingSystem::IsStreaming());
+
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":profilingstream/profilingStream.ezProfile").Succeeded()).Succeeded())
+      {
+        ezProfilingSystem::ProfilingData profilingData;
+        EZ_TEST_BOOL(ezProfilingSystem::ReadStream(file, profilingData).Succeeded());
+        EZ_TEST_INT(CountScopes(profilingData, "Streamed scope"), 100);
+        EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), 10);
+
+        ezFileWriter fileWriter;
+        if (EZ_TEST_BOOL(fileWriter.Open(":profilingstream/profilingStream.json").Succeeded()).Succeeded())
+        {
+          EZ_TEST_BOOL(profilingData.Write(fileWriter).Succeeded());
+        }
+      }
+    }
+
+    // keep mode, only the window around the trigger is written
+    {
+      ezProfilingSystem::StreamingSettings settings;
+      settings.m_sOutputFile = ":profilingstream/profilingStreamWindow.ezProfile";
+      settings.m_KeepDuration = ezTime::Milliseconds(50);
+      settings.m_FlushDelay = ezTime::Seconds(10);
+      settings.m_HitchThreshold = ezTime::Milliseconds(100);
+      settings.m_DrainInterval = ezTime::Milliseconds(5);
+
+      EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(settings).Succeeded());
+
+      {
+        EZ_PROFILE_SCOPE("Old scope");
+      }
+
+      ezThreadUtils::Sleep(ezTime::Milliseconds(200));
+
+      ezProfilingSystem::StartNewFrame();
+
+      {
+        EZ_PROFILE_SCOPE("Hitch scope");
+        ezThreadUtils::Sleep(ezTime::Milliseconds(150));
+      }
+
+      // the long frame triggers the flush, stopping writes it without waiting for the delay
+      ezProfilingSystem::StartNewFrame();
+      ezProfilingSystem::StopStreaming();
+
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":profilingstream/profilingStreamWindow.ezProfile").Succeeded()).Succeeded())
+      {
+        ezProfilingSystem::ProfilingData profilingData;
+        EZ_TEST_BOOL(ezProfilingSystem::ReadStream(file, profilingData).Succeeded());
+        EZ_TEST_INT(CountScopes(profilingData, "Old scope"), 0);
+        EZ_TEST_INT(CountScopes(profilingData, "Hitch scope"), 1);
+        EZ_TEST_INT(profilingData.m_FrameStartTimes.GetCount(), 2);
+      }
+    }
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::Milliseconds(0.1));
+    ezFileSystem::RemoveDataDirectoryGroup("ProfilingStream");
+  }
+#endif
 }
@@ -1,6 +1,7 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/SimdMath/SimdVec4b.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
 
 EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4b)
 {
@@ -91,4 +92,16 @@ EZ_CREATE_SIMPLE_TEST(SimdMath, SimdVec4b)
     EZ_TEST_BOOL(a.AllSet<1>());
     EZ_TEST_BOOL(b.NoneSet<1>());
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GetBitmask")
+  {
+    EZ_TEST_INT(ezSimdVec4b(true, false, true, false).GetBitmask(), 0x5);
+    EZ_TEST_INT(ezSimdVec4b(false, true, true, true).GetBitmask(), 0xE);
+    EZ_TEST_INT(ezSimdVec4b(true).GetBitmask(), 0xF);
+    EZ_TEST_INT(ezSimdVec4b(false).GetBitmask(), 0);
+
+    ezSimdVec4f a(1.0f, 2.0f, 3.0f, 4.0f);
+    ezSimdVec4f b(4.0f, 3.0f, 2.0f, 1.0f);
+    EZ_TEST_INT((a < b).GetBitmask(), 0x3);
+  }
 }
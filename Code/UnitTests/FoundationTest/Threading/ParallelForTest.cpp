@@ -204,4 +204,154 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     // check the resulting sum
     EZ_TEST_INT(uiNumbersSum, 4 * uiNumbersCheckSum);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Indexed, Adaptive)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.uiBinSize = 1;
+    adaptiveParams.uiGrainSize = 3;
+    adaptiveParams.splitting = ezParallelForSplitting::Adaptive;
+
+    ezStaticArray<ezUInt32, ::s_uiTotalNumberOfTaskItems> visited;
+    visited.SetCount(::s_uiTotalNumberOfTaskItems, 0);
+
+    // the ranges are not known up front, but every index has to be visited exactly once
+    ezTaskSystem::ParallelForIndexed(0, ::s_uiTotalNumberOfTaskItems,
+      [&dataAccessMutex, &uiNumbersSum, &numbers, &visited](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        EZ_LOCK(dataAccessMutex);
+
+        EZ_TEST_BOOL(uiStartIndex < uiEndIndex);
+        EZ_TEST_BOOL(uiEndIndex - uiStartIndex <= 3);
+
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          ++visited[i];
+          uiNumbersSum += numbers[i];
+        }
+      },
+      "ParallelForIndexed Adaptive Test", adaptiveParams);
+
+    for (ezUInt32 i = 0; i < ::s_uiTotalNumberOfTaskItems; ++i)
+    {
+      EZ_TEST_INT(visited[i], 1);
+    }
+
+    EZ_TEST_INT(uiNumbersSum, uiNumbersCheckSum);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Array, Adaptive)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.uiBinSize = 1;
+    adaptiveParams.uiGrainSize = 4;
+    adaptiveParams.splitting = ezParallelForSplitting::Adaptive;
+
+    ezTaskSystem::ParallelFor(numbers.GetArrayPtr(),
+      [&dataAccessMutex, &uiNumbersSum, &numbers](ezArrayPtr<ezUInt32> taskItemSlice) {
+        EZ_LOCK(dataAccessMutex);
+
+        EZ_TEST_BOOL(taskItemSlice.GetCount() > 0 && taskItemSlice.GetCount() <= 4);
+        EZ_TEST_BOOL(taskItemSlice.GetPtr() >= numbers.GetData());
+        EZ_TEST_BOOL(taskItemSlice.GetEndPtr() <= numbers.GetData() + numbers.GetCount());
+
+        for (ezUInt32& uiNumber : taskItemSlice)
+        {
+          uiNumber *= 2;
+          uiNumbersSum += uiNumber;
+        }
+      },
+      "ParallelFor Array Adaptive Test", adaptiveParams);
+
+    EZ_TEST_INT(uiNumbersSum, 2 * uiNumbersCheckSum);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Reduce")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams reduceParams;
+    reduceParams.uiBinSize = 7;
+
+    const ezUInt64 uiSum = ezTaskSystem::ParallelReduce(
+      numbers.GetArrayPtr(), ezUInt64(0), [](ezUInt64 uiAcc, ezUInt32 uiNumber) { return uiAcc + uiNumber; },
+      [](ezUInt64 a, ezUInt64 b) { return a + b; }, "ParallelReduce Test", reduceParams);
+
+    EZ_TEST_INT(uiSum, uiNumbersCheckSum);
+
+    // the combine step must be applied in order, which is verified with a non-commutative operation
+    ezStaticArray<ezUInt32, ::s_uiTotalNumberOfTaskItems> indices;
+    indices.SetCount(::s_uiTotalNumberOfTaskItems);
+    for (ezUInt32 i = 0; i < ::s_uiTotalNumberOfTaskItems; ++i)
+      indices[i] = i;
+
+    struct Range
+    {
+      ezInt32 m_iFirst = -1;
+      ezInt32 m_iLast = -1;
+      bool m_bContiguous = true;
+    };
+
+    auto appendRange = [](const Range& a, const Range& b) -> Range {
+      if (a.m_iFirst < 0)
+        return b;
+      if (b.m_iFirst < 0)
+        return a;
+
+      Range res;
+      res.m_iFirst = a.m_iFirst;
+      res.m_iLast = b.m_iLast;
+      res.m_bContiguous = a.m_bContiguous && b.m_bContiguous && a.m_iLast + 1 == b.m_iFirst;
+      return res;
+    };
+
+    reduceParams.splitting = ezParallelForSplitting::Adaptive;
+
+    const Range range = ezTaskSystem::ParallelReduce(
+      indices.GetArrayPtr(), Range(), [&](const Range& acc, ezUInt32 uiIndex) {
+        Range single;
+        single.m_iFirst = uiIndex;
+        single.m_iLast = uiIndex;
+        return appendRange(acc, single); },
+      appendRange, "ParallelReduce Order Test", reduceParams);
+
+    EZ_TEST_INT(range.m_iFirst, 0);
+    EZ_TEST_INT(range.m_iLast, ::s_uiTotalNumberOfTaskItems - 1);
+    EZ_TEST_BOOL(range.m_bContiguous);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Scan")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams scanParams;
+    scanParams.uiBinSize = 9;
+
+    ezStaticArray<ezUInt32, ::s_uiTotalNumberOfTaskItems> prefixSums;
+    prefixSums.SetCount(::s_uiTotalNumberOfTaskItems);
+
+    auto add = [](ezUInt32 a, ezUInt32 b) { return a + b; };
+
+    ezTaskSystem::ParallelScan(numbers.GetArrayPtr(), prefixSums.GetArrayPtr(), 0u, add, add, ezParallelScanMode::Inclusive, "ParallelScan Inclusive Test", scanParams);
+
+    for (ezUInt32 i = 0; i < ::s_uiTotalNumberOfTaskItems; ++i)
+    {
+      // numbers are 1..n
+      EZ_TEST_INT(prefixSums[i], (i + 1) * (i + 2) / 2);
+    }
+
+    ezTaskSystem::ParallelScan(numbers.GetArrayPtr(), prefixSums.GetArrayPtr(), 0u, add, add, ezParallelScanMode::Exclusive, "ParallelScan Exclusive Test", scanParams);
+
+    for (ezUInt32 i = 0; i < ::s_uiTotalNumberOfTaskItems; ++i)
+    {
+      EZ_TEST_INT(prefixSums[i], i * (i + 1) / 2);
+    }
+  }
 }
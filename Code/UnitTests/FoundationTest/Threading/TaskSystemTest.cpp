@@ -2,9 +2,11 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
+#include <Foundation/Utilities/Metrics.h>
 
 class ezTestTask final : public ezTask
 {
@@ -66,6 +68,41 @@ private:
   }
 };
 
+class ezSpawningTestTask final : public ezTask
+{
+public:
+  ezSpawningTestTask(ezTestTask* pChildren, ezTaskGroupID* pChildGroups)
+    : m_pChildren(pChildren)
+    , m_pChildGroups(pChildGroups)
+  {
+    ConfigureTask("ezSpawningTestTask", ezTaskNesting::Never);
+  }
+
+private:
+  virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+  {
+    m_pChildGroups[uiInvocation] = ezTaskSystem::StartSingleTask(&m_pChildren[uiInvocation], ezTaskPriority::EarlyThisFrame);
+  }
+
+  ezTestTask* m_pChildren;
+  ezTaskGroupID* m_pChildGroups;
+};
+
+class ezWaitingTestTask final : public ezTask
+{
+public:
+  ezWaitingTestTask(ezTaskGroupID groupToWaitFor)
+    : m_GroupToWaitFor(groupToWaitFor)
+  {
+    ConfigureTask("ezWaitingTestTask", ezTaskNesting::Maybe);
+  }
+
+private:
+  virtual void Execute() override { ezTaskSystem::WaitForGroup(m_GroupToWaitFor); }
+
+  ezTaskGroupID m_GroupToWaitFor;
+};
+
 class TaskCallbacks
 {
 public:
@@ -521,6 +558,219 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2].IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Work Stealing")
+  {
+    EZ_TEST_BOOL(!ezTaskSystem::IsWorkStealingEnabled());
+    ezTaskSystem::SetWorkStealingEnabled(true);
+    EZ_TEST_BOOL(ezTaskSystem::IsWorkStealingEnabled());
+
+    // tasks started on the main thread go into its work-stealing queues, the workers have to steal them from there
+    {
+      ezTestTask t[4];
+      ezTaskGroupID tg[4];
+
+      t[0].ConfigureTask("Task 0", ezTaskNesting::Never);
+      t[1].ConfigureTask("Task 1", ezTaskNesting::Maybe); // tasks that may wait still go through the global lists
+      t[2].ConfigureTask("Task 2", ezTaskNesting::Never);
+      t[3].ConfigureTask("Task 3", ezTaskNesting::Never);
+
+      t[0].SetMultiplicity(10);
+      t[1].SetMultiplicity(100);
+      t[2].SetMultiplicity(2000); // more than fits into one queue, the rest has to go into the global lists
+      t[3].SetMultiplicity(100);
+
+      tg[0] = ezTaskSystem::StartSingleTask(&t[0], ezTaskPriority::LateThisFrame);
+      tg[1] = ezTaskSystem::StartSingleTask(&t[1], ezTaskPriority::ThisFrame);
+      tg[2] = ezTaskSystem::StartSingleTask(&t[2], ezTaskPriority::EarlyThisFrame);
+      tg[3] = ezTaskSystem::StartSingleTask(&t[3], ezTaskPriority::NextFrame); // not a 'this frame' priority, not stealable
+
+      ezTaskSystem::FinishFrameTasks();
+
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        ezTaskSystem::WaitForGroup(tg[i]);
+        EZ_TEST_BOOL(t[i].IsMultiplicityDone());
+      }
+    }
+
+    // tasks that are started from within other tasks go into the queues of the worker thread that runs the parent task
+    {
+      const ezUInt32 uiNumChildren = 64;
+      ezTestTask children[uiNumChildren];
+      ezTaskGroupID childGroups[uiNumChildren];
+
+      for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+      {
+        children[i].m_uiIterations = 1;
+      }
+
+      ezSpawningTestTask spawner(children, childGroups);
+      spawner.SetMultiplicity(uiNumChildren);
+
+      ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(&spawner, ezTaskPriority::EarlyThisFrame));
+
+      for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+      {
+        ezTaskSystem::WaitForGroup(childGroups[i]);
+        EZ_TEST_BOOL(children[i].IsDone());
+      }
+    }
+
+    // changing the number of workers must not lose the tasks that are still queued on them
+    {
+      const ezUInt32 uiNumChildren = 32;
+      ezTestTask children[uiNumChildren];
+      ezTaskGroupID childGroups[uiNumChildren];
+
+      for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+      {
+        children[i].m_uiIterations = 10;
+      }
+
+      ezSpawningTestTask spawner(children, childGroups);
+      spawner.SetMultiplicity(uiNumChildren);
+
+      ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(&spawner, ezTaskPriority::EarlyThisFrame));
+
+      ezTaskSystem::SetWorkerThreadCount(iWorkersShort + 1, iWorkersLong);
+
+      for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+      {
+        ezTaskSystem::WaitForGroup(childGroups[i]);
+        EZ_TEST_BOOL(children[i].IsDone());
+      }
+
+      ezTaskSystem::SetWorkerThreadCount(iWorkersShort, iWorkersLong);
+    }
+
+    ezTaskSystem::SetWorkStealingEnabled(false);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Statistics")
+  {
+    ezTaskSystem::ResetStatistics();
+
+    ezTestTask t[2];
+    t[0].ConfigureTask("Task 0", ezTaskNesting::Never);
+    t[1].ConfigureTask("Task 1", ezTaskNesting::Never);
+    t[0].m_uiIterations = 5;
+    t[1].SetMultiplicity(10);
+
+    const ezTaskGroupID g0 = ezTaskSystem::StartSingleTask(&t[0], ezTaskPriority::LateThisFrame);
+    const ezTaskGroupID g1 = ezTaskSystem::StartSingleTask(&t[1], ezTaskPriority::EarlyThisFrame, g0);
+
+    // a long running task that has to wait for the short tasks, without being able to help, blocks its worker
+    ezWaitingTestTask waiting(g1);
+    const ezTaskGroupID g2 = ezTaskSystem::StartSingleTask(&waiting, ezTaskPriority::LongRunning);
+
+    ezTaskSystem::WaitForGroup(g2);
+    EZ_TEST_BOOL(t[0].IsDone());
+    EZ_TEST_BOOL(t[1].IsMultiplicityDone());
+
+    ezTaskSystemStatistics stats;
+    ezTaskSystem::GetStatistics(stats);
+
+    EZ_TEST_BOOL(stats.m_Duration.GetMilliseconds() >= 5.0);
+    EZ_TEST_INT(stats.m_uiNumDependencyReleases, 1);
+
+    const ezTaskPriorityStatistics& late = stats.m_Priorities[ezTaskPriority::LateThisFrame];
+    EZ_TEST_INT(late.m_uiNumGroupsStarted, 1);
+    EZ_TEST_INT(late.m_uiNumTasksExecuted, 1);
+    EZ_TEST_BOOL(late.m_TotalExecutionTime.GetMilliseconds() >= 5.0);
+    EZ_TEST_BOOL(late.m_MaxQueueLatency <= late.m_TotalQueueLatency);
+
+    const ezTaskPriorityStatistics& early = stats.m_Priorities[ezTaskPriority::EarlyThisFrame];
+    EZ_TEST_INT(early.m_uiNumGroupsStarted, 1);
+    EZ_TEST_INT(early.m_uiNumTasksExecuted, 10);
+    EZ_TEST_DOUBLE(early.GetAverageTasksPerGroup(), 10.0, 0.0);
+    EZ_TEST_BOOL(early.GetAverageQueueLatency() <= early.m_MaxQueueLatency);
+
+    EZ_TEST_INT(stats.m_Priorities[ezTaskPriority::LongRunning].m_uiNumTasksExecuted, 1);
+    EZ_TEST_INT(stats.m_Priorities[ezTaskPriority::NextFrame].m_uiNumTasksExecuted, 0);
+
+    const ezUInt32 uiNumWorkers = ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::ShortTasks) + ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::LongTasks) + ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::FileAccess);
+    EZ_TEST_INT(stats.m_Workers.GetCount(), uiNumWorkers);
+
+    ezUInt64 uiTasksOnWorkers = 0;
+    ezTime blockedTime;
+    for (const ezTaskWorkerStatistics& worker : stats.m_Workers)
+    {
+      uiTasksOnWorkers += worker.m_uiNumTasksExecuted;
+
+      if (worker.m_WorkerType == ezWorkerThreadType::LongTasks)
+      {
+        blockedTime += worker.m_BlockedTime;
+      }
+
+      // allow for some rounding
+      EZ_TEST_BOOL(worker.m_ActiveTime + worker.m_IdleTime + worker.m_BlockedTime <= stats.m_Duration + ezTime::Milliseconds(1));
+      EZ_TEST_BOOL(worker.GetUtilization() >= 0.0 && worker.GetUtilization() <= 1.0);
+    }
+
+    // the main thread only executes main thread tasks
+    EZ_TEST_INT(uiTasksOnWorkers, 12);
+    EZ_TEST_BOOL(blockedTime.IsPositive());
+
+#if EZ_ENABLED(EZ_USE_PROFILING)
+    // the dependency is recorded as a flow from the first task to the second
+    {
+      const ezProfilingSystem::ProfilingData profilingData = ezProfilingSystem::Capture();
+
+      bool bFoundFlow = false;
+      for (const ezProfilingSystem::FlowEvent& start : profilingData.m_FlowEvents)
+      {
+        if (!start.m_bStart)
+          continue;
+
+        for (const ezProfilingSystem::FlowEvent& finish : profilingData.m_FlowEvents)
+        {
+          if (!finish.m_bStart && finish.m_uiFlowId == start.m_uiFlowId && finish.m_uiTicks >= start.m_uiTicks)
+          {
+            bFoundFlow = true;
+          }
+        }
+      }
+
+      EZ_TEST_BOOL(bFoundFlow);
+    }
+#endif
+
+    ezTaskSystem::ResetStatistics();
+    ezTaskSystem::GetStatistics(stats);
+
+    EZ_TEST_INT(stats.m_uiNumDependencyReleases, 0);
+    EZ_TEST_INT(stats.m_Priorities[ezTaskPriority::EarlyThisFrame].m_uiNumTasksExecuted, 0);
+    EZ_TEST_BOOL(stats.m_Priorities[ezTaskPriority::EarlyThisFrame].m_MaxQueueLatency.IsZero());
+
+    for (const ezTaskWorkerStatistics& worker : stats.m_Workers)
+    {
+      EZ_TEST_INT(worker.m_uiNumTasksExecuted, 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Metrics")
+  {
+    // registering again returns the metric that the task system publishes to
+    ezMetricCounter tasksExecuted = ezMetrics::RegisterCounter("TaskSystem/TasksExecuted");
+    ezMetricCounter groupsStarted = ezMetrics::RegisterCounter("TaskSystem/GroupsStarted");
+
+    ezTaskSystem::FinishFrameTasks();
+
+    const ezInt64 iTasksBefore = tasksExecuted.GetValue();
+    const ezInt64 iGroupsBefore = groupsStarted.GetValue();
+
+    ezTestTask t;
+    t.ConfigureTask("Metrics Task", ezTaskNesting::Never);
+    t.SetMultiplicity(3);
+    ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(&t, ezTaskPriority::EarlyThisFrame));
+
+    // the metrics are only updated once per frame
+    ezTaskSystem::FinishFrameTasks();
+
+    EZ_TEST_BOOL(tasksExecuted.GetValue() >= iTasksBefore + 3);
+    EZ_TEST_BOOL(groupsStarted.GetValue() >= iGroupsBefore + 1);
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
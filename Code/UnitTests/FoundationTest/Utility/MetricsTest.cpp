@@ -0,0 +1,192 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Metrics.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
+
+namespace
+{
+  const ezMetricsSnapshot::Histogram* FindHistogram(const ezMetricsSnapshot& snapshot, const char* szName)
+  {
+    for (const auto& histogram : snapshot.m_Histograms)
+    {
+      if (histogram.m_sName == szName)
+        return &histogram;
+    }
+
+    return nullptr;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Utility, Metrics)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Register")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/Register");
+    EZ_TEST_BOOL(counter.IsValid());
+
+    // the same name returns the same metric
+    ezMetricCounter counter2 = ezMetrics::RegisterCounter("MetricsTest/Register");
+    const ezInt64 iStart = counter.GetValue();
+    counter2.Add(5);
+    EZ_TEST_INT(counter.GetValue(), iStart + 5);
+
+    {
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+      log.ExpectMessage("is already registered with a different type", ezLogMsgType::ErrorMsg);
+
+      ezMetricGauge gauge = ezMetrics::RegisterGauge("MetricsTest/Register");
+      EZ_TEST_BOOL(!gauge.IsValid());
+
+      // invalid handles are ignored
+      gauge.Set(1.0);
+      EZ_TEST_DOUBLE(gauge.GetValue(), 0.0, 0.0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Counter")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/Counter");
+    const ezInt64 iStart = counter.GetValue();
+
+    ezTaskSystem::ParallelForIndexed(0, 10000, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        counter.Increment();
+      }
+    });
+
+    EZ_TEST_INT(counter.GetValue(), iStart + 10000);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Gauge")
+  {
+    ezMetricGauge gauge = ezMetrics::RegisterGauge("MetricsTest/Gauge");
+
+    gauge.Set(2.5);
+    EZ_TEST_DOUBLE(gauge.GetValue(), 2.5, 0.0);
+
+    gauge.Add(-1.0);
+    EZ_TEST_DOUBLE(gauge.GetValue(), 1.5, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Histogram")
+  {
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Histogram");
+
+    ezMetricsSnapshot before;
+    ezMetrics::TakeSnapshot(before);
+
+    for (ezUInt64 i = 1; i <= 100; ++i)
+    {
+      histogram.Record(i);
+    }
+
+    ezMetricsSnapshot after;
+    ezMetrics::TakeSnapshot(after, &before);
+
+    const ezMetricsSnapshot::Histogram* pHistogram = FindHistogram(after, "MetricsTest/Histogram");
+    if (EZ_TEST_BOOL(pHistogram != nullptr).Succeeded())
+    {
+      EZ_TEST_INT(pHistogram->m_uiCount, 100);
+      EZ_TEST_DOUBLE(pHistogram->m_fMean, 50.5, 0.0001);
+
+      // the percentiles are estimated from the buckets
+      EZ_TEST_DOUBLE(pHistogram->m_fP50, 50.0, 50.0 * 0.07);
+      EZ_TEST_DOUBLE(pHistogram->m_fP90, 90.0, 90.0 * 0.07);
+      EZ_TEST_DOUBLE(pHistogram->m_fP99, 99.0, 99.0 * 0.07);
+      EZ_TEST_BOOL(pHistogram->m_fMax >= 100.0 && pHistogram->m_fMax <= 107.0);
+    }
+
+    // small values are exact
+    histogram.Record(3);
+
+    ezMetricsSnapshot last;
+    ezMetrics::TakeSnapshot(last, &after);
+
+    pHistogram = FindHistogram(last, "MetricsTest/Histogram");
+    if (EZ_TEST_BOOL(pHistogram != nullptr).Succeeded())
+    {
+      EZ_TEST_INT(pHistogram->m_uiCount, 1);
+      EZ_TEST_DOUBLE(pHistogram->m_fP50, 3.0, 0.0);
+      EZ_TEST_DOUBLE(pHistogram->m_fMax, 3.0, 0.0);
+      EZ_TEST_BOOL(last.m_Period.IsPositive());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "WriteJSON")
+  {
+    ezMetrics::RegisterCounter("MetricsTest/JSON").Add(42);
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    EZ_TEST_BOOL(snapshot.WriteJSON(writer).Succeeded());
+
+    ezMemoryStreamReader reader(&storage);
+    ezJSONReader json;
+    if (EZ_TEST_BOOL(json.Parse(reader).Succeeded()).Succeeded())
+    {
+      const ezVariantDictionary& counters = json.GetTopLevelObject().GetValue("counters")->Get<ezVariantDictionary>();
+      EZ_TEST_DOUBLE(counters.GetValue("MetricsTest/JSON")->ConvertTo<double>(), 42.0, 0.0);
+      EZ_TEST_BOOL(json.GetTopLevelObject().GetValue("histograms")->Get<ezVariantDictionary>().Contains("MetricsTest/Histogram"));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Exporter")
+  {
+    ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "MetricsTest", "metrics", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+
+    ezMetrics::ExporterSettings settings;
+    settings.m_Interval = ezTime::Milliseconds(10);
+    settings.m_sOutputFile = ":metrics/metrics.jsonl";
+    settings.m_bSendTelemetry = false;
+
+    EZ_TEST_BOOL(ezMetrics::StartExporter(settings).Succeeded());
+    EZ_TEST_BOOL(ezMetrics::IsExporterRunning());
+
+    {
+      ezTestLogInterface log;
+      ezTestLogSystemScope logSystemScope(&log);
+      log.ExpectMessage("The metrics exporter is already running", ezLogMsgType::ErrorMsg);
+
+      EZ_TEST_BOOL(ezMetrics::StartExporter(settings).Failed());
+    }
+
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Exporter");
+    for (ezUInt32 i = 0; i < 50; ++i)
+    {
+      histogram.RecordTime(ezTime::Microseconds(i));
+    }
+
+    ezThreadUtils::Sleep(ezTime::Milliseconds(30));
+
+    ezMetrics::StopExporter();
+    EZ_TEST_BOOL(!ezMetrics::IsExporterRunning());
+
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":metrics/metrics.jsonl").Succeeded()).Succeeded())
+      {
+        ezStringBuilder sContent;
+        sContent.ReadAll(file);
+
+        // at least the final snapshot is always written, one per line
+        ezDynamicArray<ezStringView> lines;
+        sContent.Split(false, lines, "\n");
+        EZ_TEST_BOOL(lines.GetCount() >= 1);
+        EZ_TEST_BOOL(sContent.FindSubString("\"MetricsTest/Exporter\"") != nullptr);
+      }
+    }
+
+    ezFileSystem::RemoveDataDirectoryGroup("MetricsTest");
+  }
+}
@@ -0,0 +1,304 @@
+#include <RendererTestPCH.h>
+
+#include <Foundation/Math/Random.h>
+#include <RendererCore/Lights/ClusteredDataExtractor.h>
+#include <RendererCore/Lights/Implementation/ClusteredDataUtils.h>
+
+namespace
+{
+  struct TestCluster
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_BitMask[ezClusteredDataCPU::MAX_LIGHT_DATA / 32];
+  };
+
+  // The rasterization that ezClusteredDataExtractor used before it worked per depth slice, one cluster at a time.
+  // The results have to stay the same, so it is kept here as the reference.
+
+  template <typename Cluster, typename IntersectionFunc>
+  void ReferenceFillCluster(const ezSimdBBox& screenSpaceBounds, ezUInt32 uiBlockIndex, ezUInt32 uiMask, Cluster* clusters, IntersectionFunc func)
+  {
+    ezSimdVec4f scale = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, -0.5f * NUM_CLUSTERS_Y, 1.0f, 1.0f);
+    ezSimdVec4f bias = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, 0.5f * NUM_CLUSTERS_Y, 0.0f, 0.0f);
+
+    ezSimdVec4f mi = ezSimdVec4f::MulAdd(screenSpaceBounds.m_Min, scale, bias);
+    ezSimdVec4f ma = ezSimdVec4f::MulAdd(screenSpaceBounds.m_Max, scale, bias);
+
+    ezSimdVec4i minXY_maxXY = ezSimdVec4i::Truncate(mi.GetCombined<ezSwizzle::XYXY>(ma));
+
+    ezSimdVec4i maxClusterIndex = ezSimdVec4i(NUM_CLUSTERS_X, NUM_CLUSTERS_Y, NUM_CLUSTERS_X, NUM_CLUSTERS_Y);
+    minXY_maxXY = minXY_maxXY.CompMin(maxClusterIndex - ezSimdVec4i(1));
+    minXY_maxXY = minXY_maxXY.CompMax(ezSimdVec4i::ZeroVector());
+
+    ezUInt32 xMin = minXY_maxXY.x();
+    ezUInt32 yMin = minXY_maxXY.w();
+
+    ezUInt32 xMax = minXY_maxXY.z();
+    ezUInt32 yMax = minXY_maxXY.y();
+
+    ezUInt32 zMin = GetSliceIndexFromDepth(screenSpaceBounds.m_Min.z());
+    ezUInt32 zMax = GetSliceIndexFromDepth(screenSpaceBounds.m_Max.z());
+
+    for (ezUInt32 z = zMin; z <= zMax; ++z)
+    {
+      for (ezUInt32 y = yMin; y <= yMax; ++y)
+      {
+        for (ezUInt32 x = xMin; x <= xMax; ++x)
+        {
+          ezUInt32 uiClusterIndex = GetClusterIndexFromCoord(x, y, z);
+          if (func(uiClusterIndex))
+          {
+            clusters[uiClusterIndex].m_BitMask[uiBlockIndex] |= uiMask;
+          }
+        }
+      }
+    }
+  }
+
+  template <typename Cluster>
+  void ReferenceRasterizePointLight(const ezSimdBSphere& pointLightSphere, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
+    const ezSimdMat4f& projectionMatrix, Cluster* clusters, const ezSimdBSphere* clusterBoundingSpheres)
+  {
+    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix);
+
+    const ezUInt32 uiBlockIndex = uiLightIndex / 32;
+    const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
+
+    ReferenceFillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters,
+      [&](ezUInt32 uiClusterIndex) { return pointLightSphere.Overlaps(clusterBoundingSpheres[uiClusterIndex]); });
+  }
+
+  template <typename Cluster>
+  void ReferenceRasterizeSpotLight(const BoundingCone& spotLightCone, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
+    const ezSimdMat4f& projectionMatrix, Cluster* clusters, const ezSimdBSphere* clusterBoundingSpheres)
+  {
+    ezSimdVec4f position = spotLightCone.m_PositionAndRange;
+    ezSimdFloat range = spotLightCone.m_PositionAndRange.w();
+    ezSimdVec4f forwardDir = spotLightCone.m_ForwardDir;
+    ezSimdFloat sinAngle = spotLightCone.m_SinCosAngle.x();
+    ezSimdFloat cosAngle = spotLightCone.m_SinCosAngle.y();
+
+    ezSimdVec4f bSphereCenter;
+    ezSimdFloat bSphereRadius;
+    if (sinAngle > 0.707107f) // sin(45)
+    {
+      bSphereCenter = position + forwardDir * cosAngle * range;
+      bSphereRadius = sinAngle * range;
+    }
+    else
+    {
+      bSphereRadius = range / (cosAngle + cosAngle);
+      bSphereCenter = position + forwardDir * bSphereRadius;
+    }
+
+    ezSimdBSphere spotLightSphere(bSphereCenter, bSphereRadius);
+    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(spotLightSphere, viewMatrix, projectionMatrix);
+
+    const ezUInt32 uiBlockIndex = uiLightIndex / 32;
+    const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
+
+    ReferenceFillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
+      ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
+      ezSimdFloat clusterRadius = clusterSphere.GetRadius();
+
+      ezSimdVec4f toConePos = clusterSphere.m_CenterAndRadius - position;
+      ezSimdFloat projected = forwardDir.Dot<3>(toConePos);
+      ezSimdFloat distToConeSq = toConePos.Dot<3>(toConePos);
+      ezSimdFloat distClosestP = cosAngle * (distToConeSq - projected * projected).GetSqrt() - projected * sinAngle;
+
+      bool angleCull = distClosestP > clusterRadius;
+      bool frontCull = projected > clusterRadius + range;
+      bool backCull = projected < -clusterRadius;
+
+      return !(angleCull || frontCull || backCull);
+    });
+  }
+
+  template <typename Cluster>
+  void ReferenceRasterizeDecal(const ezDecalRenderData* pDecalRenderData, ezUInt32 uiDecalIndex, const ezSimdMat4f& viewProjectionMatrix,
+    Cluster* clusters, const ezSimdBSphere* clusterBoundingSpheres)
+  {
+    ezSimdMat4f decalToWorld = ezSimdConversion::ToTransform(pDecalRenderData->m_GlobalTransform).GetAsMat4();
+    ezSimdMat4f worldToDecal = decalToWorld.GetInverse();
+
+    ezVec3 corners[8];
+    ezBoundingBox(ezVec3(-1), ezVec3(1)).GetCorners(corners);
+
+    ezSimdMat4f decalToScreen = viewProjectionMatrix * decalToWorld;
+    ezSimdBBox screenSpaceBounds;
+    screenSpaceBounds.SetInvalid();
+    bool bInsideBox = false;
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      ezSimdVec4f corner = ezSimdConversion::ToVec3(corners[i]);
+      ezSimdVec4f screenSpaceCorner = decalToScreen.TransformPosition(corner);
+      ezSimdFloat depth = screenSpaceCorner.w();
+      bInsideBox |= depth < ezSimdFloat::Zero();
+
+      screenSpaceCorner /= depth;
+      screenSpaceCorner = screenSpaceCorner.GetCombined<ezSwizzle::XYZW>(ezSimdVec4f(depth));
+
+      screenSpaceBounds.m_Min = screenSpaceBounds.m_Min.CompMin(screenSpaceCorner);
+      screenSpaceBounds.m_Max = screenSpaceBounds.m_Max.CompMax(screenSpaceCorner);
+    }
+
+    if (bInsideBox)
+    {
+      screenSpaceBounds.m_Min = ezSimdVec4f(-1.0f).GetCombined<ezSwizzle::XYZW>(screenSpaceBounds.m_Min);
+      screenSpaceBounds.m_Max = ezSimdVec4f(1.0f).GetCombined<ezSwizzle::XYZW>(screenSpaceBounds.m_Max);
+    }
+
+    ezSimdVec4f decalHalfExtents = ezSimdVec4f(1.0f);
+    ezSimdBBox localDecalBounds = ezSimdBBox(-decalHalfExtents, decalHalfExtents);
+
+    const ezUInt32 uiBlockIndex = uiDecalIndex / 32;
+    const ezUInt32 uiMask = 1 << (uiDecalIndex - uiBlockIndex * 32);
+
+    ReferenceFillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
+      ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
+      clusterSphere.Transform(worldToDecal);
+
+      return localDecalBounds.Overlaps(clusterSphere);
+    });
+  }
+
+  ezVec3 GetRandomPosition(ezRandom& rng)
+  {
+    return ezVec3((float)rng.DoubleMinMax(-20.0, 150.0), (float)rng.DoubleMinMax(-60.0, 60.0), (float)rng.DoubleMinMax(-30.0, 30.0));
+  }
+
+  ezQuat GetRandomRotation(ezRandom& rng)
+  {
+    ezVec3 vAxis((float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0));
+    if (vAxis.NormalizeIfNotZero(ezVec3(1, 0, 0)).Failed())
+      vAxis.Set(1, 0, 0);
+
+    ezQuat qRotation;
+    qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Degree((float)rng.DoubleMinMax(0.0, 360.0)));
+    return qRotation;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST_GROUP(Lights);
+
+EZ_CREATE_SIMPLE_TEST(Lights, ClusteredData)
+{
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 1000.0f);
+  camera.LookAt(ezVec3(-10, 5, 2), ezVec3(50, -3, 0), ezVec3(0, 0, 1));
+
+  const float fAspectRatio = 16.0f / 9.0f;
+
+  ezDynamicArray<ezSimdBSphere, ezAlignedAllocatorWrapper> clusterBoundingSpheres;
+  ezDynamicArray<ezClusterSphereBlock, ezAlignedAllocatorWrapper> clusterSphereBlocks;
+  clusterBoundingSpheres.SetCountUninitialized(NUM_CLUSTERS);
+  clusterSphereBlocks.SetCountUninitialized(NUM_CLUSTERS / 4);
+  FillClusterBoundingSpheres(camera, fAspectRatio, clusterBoundingSpheres, clusterSphereBlocks);
+
+  ezMat4 tmp = camera.GetViewMatrix();
+  const ezSimdMat4f viewMatrix = ezSimdConversion::ToMat4(tmp);
+
+  camera.GetProjectionMatrix(fAspectRatio, tmp);
+  const ezSimdMat4f projectionMatrix = ezSimdConversion::ToMat4(tmp);
+
+  const ezSimdMat4f viewProjectionMatrix = projectionMatrix * viewMatrix;
+
+  ezDynamicArray<TestCluster> referenceClusters;
+  ezDynamicArray<TestCluster> clusters;
+  referenceClusters.SetCount(NUM_CLUSTERS);
+  clusters.SetCount(NUM_CLUSTERS);
+
+  ezDynamicArray<ezClusterCullingItem, ezAlignedAllocatorWrapper> items;
+
+  ezRandom rng;
+  rng.Initialize(42);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Lights")
+  {
+    for (ezUInt32 uiLightIndex = 0; uiLightIndex < ezClusteredDataCPU::MAX_LIGHT_DATA; ++uiLightIndex)
+    {
+      if (uiLightIndex == 0)
+      {
+        PrepareDirLight(items.ExpandAndGetRef());
+
+        for (auto& cluster : referenceClusters)
+        {
+          cluster.m_BitMask[0] |= 1;
+        }
+      }
+      else if (uiLightIndex % 2 == 0)
+      {
+        ezSimdBSphere pointLightSphere(ezSimdConversion::ToVec3(GetRandomPosition(rng)), (float)rng.DoubleMinMax(0.5, 30.0));
+
+        PreparePointLight(pointLightSphere, viewMatrix, projectionMatrix, items.ExpandAndGetRef());
+        ReferenceRasterizePointLight(pointLightSphere, uiLightIndex, viewMatrix, projectionMatrix, referenceClusters.GetData(), clusterBoundingSpheres.GetData());
+      }
+      else
+      {
+        const ezAngle halfAngle = ezAngle::Degree((float)rng.DoubleMinMax(5.0, 85.0));
+
+        BoundingCone cone;
+        cone.m_PositionAndRange = ezSimdConversion::ToVec3(GetRandomPosition(rng));
+        cone.m_PositionAndRange.SetW((float)rng.DoubleMinMax(1.0, 40.0));
+        cone.m_ForwardDir = ezSimdConversion::ToVec3(GetRandomRotation(rng) * ezVec3(1.0f, 0.0f, 0.0f));
+        cone.m_SinCosAngle = ezSimdVec4f(ezMath::Sin(halfAngle), ezMath::Cos(halfAngle), 0.0f);
+
+        PrepareSpotLight(cone, viewMatrix, projectionMatrix, items.ExpandAndGetRef());
+        ReferenceRasterizeSpotLight(cone, uiLightIndex, viewMatrix, projectionMatrix, referenceClusters.GetData(), clusterBoundingSpheres.GetData());
+      }
+    }
+
+    // in two halves, like two tasks would
+    RasterizeItems(items.GetArrayPtr(), 0, NUM_CLUSTERS_Z / 2, clusterSphereBlocks.GetData(), clusters.GetData());
+    RasterizeItems(items.GetArrayPtr(), NUM_CLUSTERS_Z / 2, NUM_CLUSTERS_Z, clusterSphereBlocks.GetData(), clusters.GetData());
+
+    ezUInt32 uiNumHits = 0;
+    for (ezUInt32 i = 0; i < NUM_CLUSTERS; ++i)
+    {
+      for (ezUInt32 j = 0; j < EZ_ARRAY_SIZE(clusters[i].m_BitMask); ++j)
+      {
+        uiNumHits += ezMath::CountBits(referenceClusters[i].m_BitMask[j]);
+      }
+
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(&clusters[i], &referenceClusters[i]));
+    }
+
+    // make sure the lights actually cover a good part of the clusters, not only the directional light
+    EZ_TEST_BOOL(uiNumHits > NUM_CLUSTERS * 2);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Decals")
+  {
+    items.Clear();
+    ezMemoryUtils::ZeroFill(referenceClusters.GetData(), referenceClusters.GetCount());
+    ezMemoryUtils::ZeroFill(clusters.GetData(), clusters.GetCount());
+
+    ezDecalRenderData decalRenderData;
+
+    for (ezUInt32 uiDecalIndex = 0; uiDecalIndex < ezClusteredDataCPU::MAX_DECAL_DATA; ++uiDecalIndex)
+    {
+      decalRenderData.m_GlobalTransform.m_vPosition = GetRandomPosition(rng);
+      decalRenderData.m_GlobalTransform.m_qRotation = GetRandomRotation(rng);
+      decalRenderData.m_GlobalTransform.m_vScale.Set((float)rng.DoubleMinMax(0.2, 8.0), (float)rng.DoubleMinMax(0.2, 8.0), (float)rng.DoubleMinMax(0.2, 8.0));
+
+      PrepareDecal(&decalRenderData, viewProjectionMatrix, items.ExpandAndGetRef());
+      ReferenceRasterizeDecal(&decalRenderData, uiDecalIndex, viewProjectionMatrix, referenceClusters.GetData(), clusterBoundingSpheres.GetData());
+    }
+
+    RasterizeItems(items.GetArrayPtr(), 0, NUM_CLUSTERS_Z, clusterSphereBlocks.GetData(), clusters.GetData());
+
+    ezUInt32 uiNumHits = 0;
+    for (ezUInt32 i = 0; i < NUM_CLUSTERS; ++i)
+    {
+      for (ezUInt32 j = 0; j < EZ_ARRAY_SIZE(clusters[i].m_BitMask); ++j)
+      {
+        uiNumHits += ezMath::CountBits(referenceClusters[i].m_BitMask[j]);
+      }
+
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(&clusters[i], &referenceClusters[i]));
+    }
+
+    EZ_TEST_BOOL(uiNumHits > 0);
+  }
+}